@@ -0,0 +1,150 @@
+#include "adaptive_concurrency_limiter.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include "default_clock.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Returns whether the status code at pos of the lowercased message stands on its own and follows an HTTP version,
+// "http", "status" or "code", e.g. "HTTP 503", "HTTP/1.1 429" or "status code: 429".
+bool IsHttpStatusAt(const string &message, idx_t pos, idx_t length) {
+	const auto is_alnum = [](char c) {
+		return StringUtil::CharacterIsAlpha(c) || StringUtil::CharacterIsDigit(c);
+	};
+	if ((pos > 0 && is_alnum(message[pos - 1])) ||
+	    (pos + length < message.size() && is_alnum(message[pos + length]))) {
+		return false;
+	}
+	auto end = pos;
+	while (end > 0 && StringUtil::CharacterIsSpace(message[end - 1])) {
+		--end;
+	}
+	if (end > 0 && (message[end - 1] == ':' || message[end - 1] == '=')) {
+		--end;
+	}
+	while (end > 0 && StringUtil::CharacterIsSpace(message[end - 1])) {
+		--end;
+	}
+	const auto prefix = message.substr(0, end);
+	for (const auto *marker : {"http", "http/1.0", "http/1.1", "http/2", "http/3", "status", "code"}) {
+		if (StringUtil::EndsWith(prefix, marker)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+AdaptiveConcurrencyLimiter::AdaptiveConcurrencyLimiter(int64_t min_limit_p, int64_t max_limit_p,
+                                                       shared_ptr<BaseClock> clock_p)
+    : min_limit(min_limit_p), max_limit(max_limit_p), clock(clock_p ? std::move(clock_p) : CreateDefaultClock()),
+      semaphore(make_shared_ptr<CountingSemaphore>(min_limit_p)),
+      limit(min_limit_p), completions_since_increase(0), completions_since_decrease(0),
+      baseline_latency(Duration::max()), window_min_latency(Duration::max()), window_completions(0) {
+	if (min_limit < 1) {
+		throw InvalidInputException("Adaptive max requests minimum must be a positive integer, got %lld", min_limit);
+	}
+	if (max_limit < min_limit) {
+		throw InvalidInputException("Adaptive max requests maximum %lld must not be below the minimum %lld", max_limit,
+		                            min_limit);
+	}
+}
+
+const shared_ptr<CountingSemaphore> &AdaptiveConcurrencyLimiter::GetSemaphore() const {
+	return semaphore;
+}
+
+void AdaptiveConcurrencyLimiter::OnSuccess(Duration latency) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	++completions_since_decrease;
+
+	baseline_latency = MinValue(baseline_latency, latency);
+	window_min_latency = MinValue(window_min_latency, latency);
+	if (++window_completions >= BASELINE_WINDOW) {
+		// Let the baseline rise again if the backend got slower for good.
+		baseline_latency = window_min_latency;
+		window_min_latency = Duration::max();
+		window_completions = 0;
+	}
+
+	if (latency > baseline_latency * LATENCY_TOLERANCE) {
+		Decrease(LATENCY_BACKOFF_RATIO);
+		return;
+	}
+	if (++completions_since_increase >= static_cast<idx_t>(limit) && limit < max_limit) {
+		ApplyLimit(limit + 1);
+	}
+}
+
+void AdaptiveConcurrencyLimiter::OnFailure(const string &error_message) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	++completions_since_decrease;
+	if (IsThrottleError(error_message)) {
+		Decrease(THROTTLE_BACKOFF_RATIO);
+	}
+}
+
+void AdaptiveConcurrencyLimiter::Decrease(double ratio) {
+	if (completions_since_decrease < static_cast<idx_t>(limit)) {
+		return;
+	}
+	completions_since_decrease = 0;
+	ApplyLimit(MaxValue(static_cast<int64_t>(static_cast<double>(limit) * ratio), min_limit));
+}
+
+void AdaptiveConcurrencyLimiter::ApplyLimit(int64_t new_limit) {
+	completions_since_increase = 0;
+	if (new_limit == limit) {
+		return;
+	}
+	limit = new_limit;
+	semaphore->SetMax(new_limit);
+}
+
+int64_t AdaptiveConcurrencyLimiter::GetLimit() const {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	return limit;
+}
+
+int64_t AdaptiveConcurrencyLimiter::GetMinLimit() const {
+	return min_limit;
+}
+
+int64_t AdaptiveConcurrencyLimiter::GetMaxLimit() const {
+	return max_limit;
+}
+
+bool AdaptiveConcurrencyLimiter::IsThrottleError(const string &error_message) {
+	const auto message = StringUtil::Lower(error_message);
+	for (const auto *marker : {"slowdown", "slow down", "too many requests", "service unavailable", "throttl"}) {
+		if (StringUtil::Contains(message, marker)) {
+			return true;
+		}
+	}
+	for (const string status : {"429", "503"}) {
+		for (auto pos = message.find(status); pos != string::npos; pos = message.find(status, pos + 1)) {
+			if (IsHttpStatusAt(message, pos, status.size())) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+AdaptiveConcurrencyLimiter::SuccessReporter::SuccessReporter(AdaptiveConcurrencyLimiter &limiter_p)
+    : limiter(limiter_p), uncaught_exceptions(std::uncaught_exceptions()), start(limiter.clock->Now()) {
+}
+
+AdaptiveConcurrencyLimiter::SuccessReporter::~SuccessReporter() {
+	if (std::uncaught_exceptions() == uncaught_exceptions) {
+		limiter.OnSuccess(limiter.clock->Now() - start);
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,91 @@
+#include "block_cache.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+size_t BlockCacheKeyHash::operator()(const BlockCacheKey &key) const {
+	size_t hash = std::hash<string>()(key.path);
+	hash ^= std::hash<string>()(key.version_tag) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<idx_t>()(key.block_index) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+BlockCache::BlockCache(idx_t block_size_p, idx_t capacity_p)
+    : block_size(block_size_p), capacity(capacity_p), memory_usage(0), hits(0), misses(0) {
+	if (block_size == 0) {
+		throw InvalidInputException("Block cache block size must be positive");
+	}
+	if (capacity == 0) {
+		throw InvalidInputException("Block cache capacity must be positive");
+	}
+}
+
+idx_t BlockCache::GetBlockSize() const {
+	return block_size;
+}
+
+shared_ptr<const CachedBlock> BlockCache::Get(const BlockCacheKey &key) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = index.find(key);
+	if (it == index.end()) {
+		++misses;
+		return nullptr;
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, it->second);
+	return it->second->block;
+}
+
+void BlockCache::Put(const BlockCacheKey &key, shared_ptr<const CachedBlock> block) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = index.find(key);
+	if (it != index.end()) {
+		memory_usage -= it->second->block->size;
+		entries.erase(it->second);
+		index.erase(it);
+	}
+	memory_usage += block->size;
+	entries.push_front(Entry {key, std::move(block)});
+	index.emplace(key, entries.begin());
+	Evict();
+}
+
+void BlockCache::ErasePath(const string &path) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->key.path != path) {
+			++it;
+			continue;
+		}
+		memory_usage -= it->block->size;
+		index.erase(it->key);
+		it = entries.erase(it);
+	}
+}
+
+BlockCacheStats BlockCache::GetStats() const {
+	BlockCacheStats stats;
+	stats.block_size = block_size;
+	stats.capacity = capacity;
+
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	stats.memory_usage = memory_usage;
+	stats.block_count = entries.size();
+	stats.hits = hits;
+	stats.misses = misses;
+	return stats;
+}
+
+void BlockCache::Evict() {
+	while (memory_usage > capacity && !entries.empty()) {
+		auto &victim = entries.back();
+		memory_usage -= victim.block->size;
+		index.erase(victim.key);
+		entries.pop_back();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,90 @@
+#include "coarse_clock.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/map.hpp"
+
+#include "no_destructor.hpp"
+
+namespace duckdb {
+
+namespace {
+
+int64_t ToNanos(TimePoint time_point) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+}
+
+// Coarse clocks by resolution in nanoseconds, alive as long as a limiter uses them.
+struct CoarseClockRegistry {
+	concurrency::mutex lock;
+	map<int64_t, weak_ptr<BaseClock>> clocks DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace
+
+CoarseClock::CoarseClock(Duration resolution_p)
+    : resolution(resolution_p), now_nanos(ToNanos(std::chrono::steady_clock::now())), running(true) {
+	if (resolution <= Duration::zero() || resolution > MAX_RESOLUTION) {
+		const auto max_ms = std::chrono::duration_cast<std::chrono::milliseconds>(MAX_RESOLUTION).count();
+		throw InvalidInputException("Coarse clock resolution must be positive and at most %lld ms",
+		                            static_cast<long long>(max_ms));
+	}
+	refresh_thread = make_uniq<thread>([this]() { RunRefreshThread(); });
+}
+
+CoarseClock::~CoarseClock() {
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		running = false;
+	}
+	cv.notify_all();
+	refresh_thread->join();
+}
+
+TimePoint CoarseClock::Now() const {
+	return TimePoint(Duration(now_nanos.load(std::memory_order_acquire)));
+}
+
+void CoarseClock::SleepFor(Duration duration) const {
+	std::this_thread::sleep_for(duration);
+	Observe(std::chrono::steady_clock::now());
+}
+
+void CoarseClock::SleepUntil(TimePoint time_point) const {
+	std::this_thread::sleep_until(time_point);
+	Observe(time_point);
+}
+
+void CoarseClock::Observe(TimePoint time_point) const {
+	const auto nanos = ToNanos(time_point);
+	auto current = now_nanos.load(std::memory_order_relaxed);
+	while (current < nanos && !now_nanos.compare_exchange_weak(current, nanos, std::memory_order_release)) {
+	}
+}
+
+Duration CoarseClock::GetResolution() const {
+	return resolution;
+}
+
+void CoarseClock::RunRefreshThread() {
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (running) {
+		Observe(std::chrono::steady_clock::now());
+		cv.wait_for(guard, resolution);
+	}
+}
+
+shared_ptr<BaseClock> GetCoarseClock(Duration resolution) {
+	// Never destroyed, like the default RateLimitTimer, so limiters can still be built while the process exits.
+	static NoDestructor<CoarseClockRegistry> registry;
+	concurrency::lock_guard<concurrency::mutex> guard(registry->lock);
+	auto &entry = registry->clocks[resolution.count()];
+	auto clock = entry.lock();
+	if (!clock) {
+		clock = make_shared_ptr<CoarseClock>(resolution);
+		entry = clock;
+	}
+	return clock;
+}
+
+} // namespace duckdb
@@ -4,29 +4,57 @@
 
 namespace duckdb {
 
-CountingSemaphore::CountingSemaphore(int64_t max_count) : max_count(max_count), current_count(0) {
+CountingSemaphore::CountingSemaphore(int64_t max_count) : max_count(max_count), current_count(0), waiter_count(0) {
 }
 
-void CountingSemaphore::Acquire() {
-	concurrency::unique_lock<concurrency::mutex> lock(mtx);
-	if (max_count == UNLIMITED) {
+bool CountingSemaphore::TryAcquire() {
+	auto current = current_count.load();
+	while (true) {
+		const auto max = max_count.load();
+		if (max == UNLIMITED) {
+			return true;
+		}
+		if (current >= max) {
+			return false;
+		}
+		if (current_count.compare_exchange_weak(current, current + 1)) {
+			return true;
+		}
+	}
+}
+
+void CountingSemaphore::WakeWaiters(bool notify_all) {
+	// Waiters register and re-check the count under the mutex, so taking it here guarantees a waiter which missed the
+	// update is already parked and receives the notification.
+	if (waiter_count.load() == 0) {
 		return;
 	}
-	cv.wait(lock, [this] { return current_count < max_count || max_count == UNLIMITED; });
-	if (max_count != UNLIMITED) {
-		++current_count;
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(mtx);
+	}
+	if (notify_all) {
+		cv.notify_all();
+	} else {
+		cv.notify_one();
 	}
 }
 
+void CountingSemaphore::Acquire() {
+	if (TryAcquire()) {
+		return;
+	}
+	concurrency::unique_lock<concurrency::mutex> lock(mtx);
+	waiter_count.fetch_add(1);
+	cv.wait(lock, [this] { return TryAcquire(); });
+	waiter_count.fetch_sub(1);
+}
+
 void CountingSemaphore::Release() {
-	{
-		concurrency::lock_guard<concurrency::mutex> guard(mtx);
-		if (max_count == UNLIMITED) {
-			return;
-		}
-		--current_count;
+	if (max_count.load() == UNLIMITED) {
+		return;
 	}
-	cv.notify_one();
+	current_count.fetch_sub(1);
+	WakeWaiters(/*notify_all=*/false);
 }
 
 SemaphoreGuard CountingSemaphore::AcquireGuard() {
@@ -37,21 +65,16 @@ SemaphoreGuard CountingSemaphore::AcquireGuard() {
 }
 
 void CountingSemaphore::SetMax(int64_t new_max) {
-	{
-		concurrency::lock_guard<concurrency::mutex> guard(mtx);
-		max_count = new_max;
-	}
-	cv.notify_all();
+	max_count.store(new_max);
+	WakeWaiters(/*notify_all=*/true);
 }
 
 int64_t CountingSemaphore::GetMax() const {
-	concurrency::lock_guard<concurrency::mutex> guard(mtx);
-	return max_count;
+	return max_count.load();
 }
 
 int64_t CountingSemaphore::GetCurrent() const {
-	concurrency::lock_guard<concurrency::mutex> guard(mtx);
-	return current_count;
+	return current_count.load();
 }
 
 SemaphoreGuard::SemaphoreGuard() : sem(nullptr) {
@@ -63,13 +86,19 @@ SemaphoreGuard::SemaphoreGuard(CountingSemaphore *sem) : sem(sem) {
 	}
 }
 
+SemaphoreGuard::SemaphoreGuard(shared_ptr<CountingSemaphore> sem_p) : sem(sem_p.get()), owner(std::move(sem_p)) {
+	if (sem) {
+		sem->Acquire();
+	}
+}
+
 SemaphoreGuard::~SemaphoreGuard() {
 	if (sem) {
 		sem->Release();
 	}
 }
 
-SemaphoreGuard::SemaphoreGuard(SemaphoreGuard &&other) noexcept : sem(other.sem) {
+SemaphoreGuard::SemaphoreGuard(SemaphoreGuard &&other) noexcept : sem(other.sem), owner(std::move(other.owner)) {
 	other.sem = nullptr;
 }
 
@@ -79,6 +108,7 @@ SemaphoreGuard &SemaphoreGuard::operator=(SemaphoreGuard &&other) noexcept {
 			sem->Release();
 		}
 		sem = other.sem;
+		owner = std::move(other.owner);
 		other.sem = nullptr;
 	}
 	return *this;
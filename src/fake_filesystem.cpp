@@ -1,7 +1,9 @@
 #include "fake_filesystem.hpp"
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/local_file_system.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "default_clock.hpp"
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -54,7 +56,8 @@ RateLimitFsFakeFsHandle::RateLimitFsFakeFsHandle(string path, unique_ptr<FileHan
       internal_file_handle(std::move(internal_file_handle_p)) {
 }
 
-RateLimitFsFakeFileSystem::RateLimitFsFakeFileSystem() : local_filesystem(FileSystem::CreateLocal()) {
+RateLimitFsFakeFileSystem::RateLimitFsFakeFileSystem(shared_ptr<BaseClock> clock_p)
+    : local_filesystem(FileSystem::CreateLocal()), clock(clock_p ? std::move(clock_p) : CreateDefaultClock()) {
 	// Create the fake directory if it doesn't exist
 	const auto fake_filesystem_directory = GetFakeFileSystemDirectory();
 	if (!local_filesystem->DirectoryExists(fake_filesystem_directory)) {
@@ -68,41 +71,49 @@ bool RateLimitFsFakeFileSystem::CanHandleFile(const string &path) {
 
 unique_ptr<FileHandle> RateLimitFsFakeFileSystem::OpenFile(const string &path, FileOpenFlags flags,
                                                            optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::OPEN, path);
 	auto file_handle = local_filesystem->OpenFile(path, flags, opener);
 	return make_uniq<RateLimitFsFakeFsHandle>(path, std::move(file_handle), *this);
 }
 
 void RateLimitFsFakeFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	InjectFaults(FileSystemOperation::READ, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	local_filesystem->Read(*local_filesystem_handle, buffer, nr_bytes, location);
 }
 
 int64_t RateLimitFsFakeFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	InjectFaults(FileSystemOperation::READ, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->Read(*local_filesystem_handle, buffer, nr_bytes);
 }
 
 void RateLimitFsFakeFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	InjectFaults(FileSystemOperation::WRITE, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	local_filesystem->Write(*local_filesystem_handle, buffer, nr_bytes, location);
 }
 
 int64_t RateLimitFsFakeFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	InjectFaults(FileSystemOperation::WRITE, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->Write(*local_filesystem_handle, buffer, nr_bytes);
 }
 
 FileMetadata RateLimitFsFakeFileSystem::Stats(FileHandle &handle) {
+	InjectFaults(FileSystemOperation::STAT, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->Stats(*local_filesystem_handle);
 }
 
 int64_t RateLimitFsFakeFileSystem::GetFileSize(FileHandle &handle) {
+	InjectFaults(FileSystemOperation::STAT, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->GetFileSize(*local_filesystem_handle);
 }
 
 void RateLimitFsFakeFileSystem::FileSync(FileHandle &handle) {
+	InjectFaults(FileSystemOperation::SYNC, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	local_filesystem->FileSync(*local_filesystem_handle);
 }
@@ -122,21 +133,25 @@ bool RateLimitFsFakeFileSystem::CanSeek() {
 }
 
 bool RateLimitFsFakeFileSystem::Trim(FileHandle &handle, idx_t offset_bytes, idx_t length_bytes) {
+	InjectFaults(FileSystemOperation::WRITE, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->Trim(*local_filesystem_handle, offset_bytes, length_bytes);
 }
 
 timestamp_t RateLimitFsFakeFileSystem::GetLastModifiedTime(FileHandle &handle) {
+	InjectFaults(FileSystemOperation::STAT, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->GetLastModifiedTime(*local_filesystem_handle);
 }
 
 FileType RateLimitFsFakeFileSystem::GetFileType(FileHandle &handle) {
+	InjectFaults(FileSystemOperation::STAT, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	return local_filesystem->GetFileType(*local_filesystem_handle);
 }
 
 void RateLimitFsFakeFileSystem::Truncate(FileHandle &handle, int64_t new_size) {
+	InjectFaults(FileSystemOperation::WRITE, handle.GetPath());
 	auto &local_filesystem_handle = handle.Cast<RateLimitFsFakeFsHandle>().internal_file_handle;
 	local_filesystem->Truncate(*local_filesystem_handle, new_size);
 }
@@ -152,14 +167,17 @@ void RateLimitFsFakeFileSystem::Reset(FileHandle &handle) {
 }
 
 bool RateLimitFsFakeFileSystem::IsPipe(const string &filename, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::STAT, filename);
 	return local_filesystem->IsPipe(filename, opener);
 }
 
 bool RateLimitFsFakeFileSystem::TryRemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::DELETE, filename);
 	return local_filesystem->TryRemoveFile(filename, opener);
 }
 
 void RateLimitFsFakeFileSystem::MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::WRITE, source);
 	local_filesystem->MoveFile(source, target, opener);
 }
 
@@ -168,33 +186,90 @@ string RateLimitFsFakeFileSystem::PathSeparator(const string &path) {
 }
 
 bool RateLimitFsFakeFileSystem::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::STAT, directory);
 	return local_filesystem->DirectoryExists(directory, opener);
 }
 
 void RateLimitFsFakeFileSystem::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::MKDIR, directory);
 	local_filesystem->CreateDirectory(directory, opener);
 }
 
 void RateLimitFsFakeFileSystem::RemoveDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::DELETE, directory);
 	local_filesystem->RemoveDirectory(directory, opener);
 }
 
 bool RateLimitFsFakeFileSystem::ListFiles(const string &directory,
                                           const std::function<void(const string &, bool)> &callback,
                                           FileOpener *opener) {
+	InjectFaults(FileSystemOperation::LIST, directory);
 	return local_filesystem->ListFiles(directory, callback, opener);
 }
 
 bool RateLimitFsFakeFileSystem::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::STAT, filename);
 	return local_filesystem->FileExists(filename, opener);
 }
 
 void RateLimitFsFakeFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	InjectFaults(FileSystemOperation::DELETE, filename);
 	local_filesystem->RemoveFile(filename, opener);
 }
 
 vector<OpenFileInfo> RateLimitFsFakeFileSystem::Glob(const string &path, FileOpener *opener) {
+	InjectFaults(FileSystemOperation::LIST, path);
 	return local_filesystem->Glob(path, opener);
 }
 
+void RateLimitFsFakeFileSystem::SetFaults(FileSystemOperation operation, FakeFsFaults faults_p) {
+	if (faults_p.latency < Duration::zero() || faults_p.jitter < Duration::zero()) {
+		throw InvalidInputException("Injected latency and jitter must be non-negative");
+	}
+	if (!(faults_p.throttle_error_rate >= 0 && faults_p.throttle_error_rate <= 1)) {
+		throw InvalidInputException("Injected throttle error rate must be between 0 and 1, got %f",
+		                            faults_p.throttle_error_rate);
+	}
+	concurrency::lock_guard<concurrency::mutex> guard(fault_lock);
+	faults[static_cast<idx_t>(operation)] = faults_p;
+	has_faults = true;
+}
+
+FakeFsFaults RateLimitFsFakeFileSystem::GetFaults(FileSystemOperation operation) const {
+	concurrency::lock_guard<concurrency::mutex> guard(fault_lock);
+	return faults[static_cast<idx_t>(operation)];
+}
+
+idx_t RateLimitFsFakeFileSystem::GetInjectedErrorCount() const {
+	return injected_errors.load();
+}
+
+void RateLimitFsFakeFileSystem::InjectFaults(FileSystemOperation operation, const string &path) {
+	if (!has_faults.load(std::memory_order_relaxed)) {
+		return;
+	}
+	Duration delay;
+	bool throttled;
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(fault_lock);
+		const auto &op_faults = faults[static_cast<idx_t>(operation)];
+		delay = op_faults.latency;
+		if (op_faults.jitter > Duration::zero()) {
+			delay += Duration(static_cast<Duration::rep>(random_engine.NextRandom() *
+			                                             static_cast<double>(op_faults.jitter.count())));
+		}
+		throttled = op_faults.throttle_error_rate > 0 && random_engine.NextRandom() < op_faults.throttle_error_rate;
+	}
+	// Slept outside of the lock, so that concurrent calls overlap like requests to a remote backend.
+	if (delay > Duration::zero()) {
+		clock->SleepFor(delay);
+	}
+	if (throttled) {
+		++injected_errors;
+		// Worded like an S3 SlowDown response, so it's classified as a throttle error.
+		throw IOException("HTTP 503 SlowDown: injected throttle error on %s of '%s'",
+		                  FileSystemOperationToString(operation), path);
+	}
+}
+
 } // namespace duckdb
@@ -5,14 +5,10 @@
 
 namespace duckdb {
 
-namespace {
-
 string GetValidOperationsString() {
-	return "stat, read, write, list, delete, mkdir";
+	return "stat, read, write, list, delete, mkdir, sync, open";
 }
 
-} // namespace
-
 FileSystemOperation ParseFileSystemOperation(const string &op_str) {
 	auto lower = StringUtil::Lower(op_str);
 
@@ -34,6 +30,12 @@ FileSystemOperation ParseFileSystemOperation(const string &op_str) {
 	if (lower == "mkdir") {
 		return FileSystemOperation::MKDIR;
 	}
+	if (lower == "sync") {
+		return FileSystemOperation::SYNC;
+	}
+	if (lower == "open") {
+		return FileSystemOperation::OPEN;
+	}
 
 	throw InvalidInputException("Invalid operation '%s'. Valid operations are: %s", op_str, GetValidOperationsString());
 }
@@ -54,6 +56,10 @@ string FileSystemOperationToString(FileSystemOperation op) {
 		return "delete";
 	case FileSystemOperation::MKDIR:
 		return "mkdir";
+	case FileSystemOperation::SYNC:
+		return "sync";
+	case FileSystemOperation::OPEN:
+		return "open";
 	default:
 		throw InternalException("Unknown FileSystemOperation value");
 	}
@@ -0,0 +1,159 @@
+#include "handle_pool.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/exception.hpp"
+
+#include "default_clock.hpp"
+
+namespace duckdb {
+
+HandlePool::HandlePool(Duration ttl_p, idx_t capacity_p, shared_ptr<BaseClock> clock_p)
+    : ttl(ttl_p), capacity(capacity_p), clock(clock_p ? std::move(clock_p) : CreateDefaultClock()), retired(false),
+      hits(0), misses(0) {
+	if (ttl <= Duration::zero()) {
+		throw InvalidInputException("Handle pool TTL must be positive");
+	}
+	if (capacity == 0) {
+		throw InvalidInputException("Handle pool capacity must be positive");
+	}
+}
+
+bool HandlePool::CanPool(FileOpenFlags flags) {
+	return flags.OpenForReading() && !flags.OpenForWriting() && !flags.OpenForAppending() &&
+	       !flags.CreateFileIfNotExists() && !flags.OverwriteExistingFile() && flags.Lock() == FileLockType::NO_LOCK;
+}
+
+bool HandlePool::SameFlags(FileOpenFlags lhs, FileOpenFlags rhs) {
+	return lhs.GetFlagsInternal() == rhs.GetFlagsInternal() && lhs.Compression() == rhs.Compression();
+}
+
+PooledHandle HandlePool::Take(idx_t owner, const string &path, FileOpenFlags flags,
+                              const string &expected_version_tag) {
+	const auto now = clock->Now();
+	// Closed once the lock is released.
+	vector<unique_ptr<FileHandle>> closed;
+	PooledHandle result;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = index.find(path);
+	if (it != index.end()) {
+		// Copied, since removing entries edits the index.
+		const auto candidates = it->second;
+		for (auto &entry : candidates) {
+			const bool stale = entry->expiry <= now ||
+			                   (!expected_version_tag.empty() && entry->handle.version_tag != expected_version_tag);
+			if (stale) {
+				Remove(entry, closed);
+			} else if (!result.handle && entry->owner == owner && SameFlags(entry->flags, flags)) {
+				result = std::move(entry->handle);
+				Remove(entry, closed);
+			}
+		}
+	}
+	if (result.handle) {
+		++hits;
+	} else {
+		++misses;
+	}
+	return result;
+}
+
+void HandlePool::Put(idx_t owner, const string &path, FileOpenFlags flags, PooledHandle handle) {
+	const auto now = clock->Now();
+	vector<unique_ptr<FileHandle>> closed;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	if (retired) {
+		closed.push_back(std::move(handle.handle));
+		return;
+	}
+	while (entries.size() >= capacity) {
+		Remove(std::prev(entries.end()), closed);
+	}
+	Entry entry;
+	entry.owner = owner;
+	entry.path = path;
+	entry.flags = flags;
+	entry.expiry = now + ttl;
+	entry.handle = std::move(handle);
+	entries.push_front(std::move(entry));
+	index[path].push_back(entries.begin());
+}
+
+void HandlePool::Erase(const string &path) {
+	vector<unique_ptr<FileHandle>> closed;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = index.find(path);
+	if (it == index.end()) {
+		return;
+	}
+	for (auto &entry : it->second) {
+		closed.push_back(std::move(entry->handle.handle));
+		entries.erase(entry);
+	}
+	index.erase(it);
+}
+
+void HandlePool::ErasePrefix(const string &prefix) {
+	vector<unique_ptr<FileHandle>> closed;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	for (auto it = index.begin(); it != index.end();) {
+		if (it->first.compare(0, prefix.size(), prefix) != 0) {
+			++it;
+			continue;
+		}
+		for (auto &entry : it->second) {
+			closed.push_back(std::move(entry->handle.handle));
+			entries.erase(entry);
+		}
+		it = index.erase(it);
+	}
+}
+
+void HandlePool::EraseOwner(idx_t owner) {
+	vector<unique_ptr<FileHandle>> closed;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	for (auto it = entries.begin(); it != entries.end();) {
+		auto entry = it++;
+		if (entry->owner == owner) {
+			Remove(entry, closed);
+		}
+	}
+}
+
+void HandlePool::Retire() {
+	vector<unique_ptr<FileHandle>> closed;
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	retired = true;
+	for (auto &entry : entries) {
+		closed.push_back(std::move(entry.handle.handle));
+	}
+	entries.clear();
+	index.clear();
+}
+
+HandlePoolStats HandlePool::GetStats() const {
+	HandlePoolStats stats;
+	stats.ttl = ttl;
+	stats.capacity = capacity;
+
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	stats.handle_count = entries.size();
+	stats.hits = hits;
+	stats.misses = misses;
+	return stats;
+}
+
+void HandlePool::Remove(EntryList::iterator entry, vector<unique_ptr<FileHandle>> &closed) {
+	auto it = index.find(entry->path);
+	D_ASSERT(it != index.end());
+	auto &path_entries = it->second;
+	path_entries.erase(std::find(path_entries.begin(), path_entries.end(), entry));
+	if (path_entries.empty()) {
+		index.erase(it);
+	}
+	if (entry->handle.handle) {
+		closed.push_back(std::move(entry->handle.handle));
+	}
+	entries.erase(entry);
+}
+
+} // namespace duckdb
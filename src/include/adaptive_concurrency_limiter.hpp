@@ -0,0 +1,91 @@
+#pragma once
+
+#include <exception>
+
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include "base_clock.hpp"
+#include "counting_semaphore.hpp"
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Concurrency limit which tunes itself from the latency and throttling responses of the requests it admits, so
+// max_requests doesn't need to be re-tuned by hand as backend capacity changes.
+//
+// The limit follows AIMD: it grows by one after each round of `limit` completions whose latency stays within
+// LATENCY_TOLERANCE times the baseline latency. A completion above the tolerance shrinks it by
+// LATENCY_BACKOFF_RATIO, and a throttling error (see IsThrottleError) by THROTTLE_BACKOFF_RATIO. Decreases apply
+// at most once per round, since requests admitted before a decrease still complete against the old limit. The
+// baseline is the lowest latency seen, re-measured every BASELINE_WINDOW completions so it follows the backend.
+class AdaptiveConcurrencyLimiter {
+public:
+	static constexpr double LATENCY_TOLERANCE = 2.0;
+	static constexpr double LATENCY_BACKOFF_RATIO = 0.9;
+	static constexpr double THROTTLE_BACKOFF_RATIO = 0.5;
+	static constexpr idx_t BASELINE_WINDOW = 1000;
+
+	// Starts at min_limit. Throws InvalidInputException unless 1 <= min_limit <= max_limit. Call latencies are timed
+	// with the clock, the default clock if nullptr.
+	AdaptiveConcurrencyLimiter(int64_t min_limit, int64_t max_limit, shared_ptr<BaseClock> clock = nullptr);
+
+	AdaptiveConcurrencyLimiter(const AdaptiveConcurrencyLimiter &) = delete;
+	AdaptiveConcurrencyLimiter &operator=(const AdaptiveConcurrencyLimiter &) = delete;
+
+	// Returns the semaphore enforcing the current limit.
+	const shared_ptr<CountingSemaphore> &GetSemaphore() const;
+
+	// Records a request which completed successfully after the given latency.
+	void OnSuccess(Duration latency);
+
+	// Records a request which failed with the given error message. Only throttling errors shrink the limit; other
+	// errors (e.g. a missing file) say nothing about backend load.
+	void OnFailure(const string &error_message);
+
+	int64_t GetLimit() const;
+	int64_t GetMinLimit() const;
+	int64_t GetMaxLimit() const;
+
+	// Returns whether an error message reports backend throttling: an HTTP 429 or 503 status, following "HTTP",
+	// "status" or "code", or a throttling response such as S3's "SlowDown". Other numbers containing those digits, in
+	// a file name or a byte count, don't count.
+	static bool IsThrottleError(const string &error_message);
+
+	// Times a call to the inner filesystem, and reports it as a success unless it exits by exception.
+	class SuccessReporter {
+	public:
+		explicit SuccessReporter(AdaptiveConcurrencyLimiter &limiter_p);
+		~SuccessReporter();
+
+	private:
+		AdaptiveConcurrencyLimiter &limiter;
+		const int uncaught_exceptions;
+		const TimePoint start;
+	};
+
+private:
+	// Shrinks the limit by the given ratio, unless it already shrank during the current round.
+	void Decrease(double ratio) DUCKDB_REQUIRES(lock);
+	// Pushes a new limit to the semaphore.
+	void ApplyLimit(int64_t new_limit) DUCKDB_REQUIRES(lock);
+
+	const int64_t min_limit;
+	const int64_t max_limit;
+	const shared_ptr<BaseClock> clock;
+	const shared_ptr<CountingSemaphore> semaphore;
+
+	mutable concurrency::mutex lock;
+	int64_t limit DUCKDB_GUARDED_BY(lock);
+	// Completions within the latency tolerance since the last change of the limit.
+	idx_t completions_since_increase DUCKDB_GUARDED_BY(lock);
+	// Completions since the last decrease.
+	idx_t completions_since_decrease DUCKDB_GUARDED_BY(lock);
+	Duration baseline_latency DUCKDB_GUARDED_BY(lock);
+	// Lowest latency and number of completions in the current baseline window.
+	Duration window_min_latency DUCKDB_GUARDED_BY(lock);
+	idx_t window_completions DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -29,6 +29,11 @@ public:
 
 	// Sleeps until the specified time point.
 	virtual void SleepUntil(TimePoint time_point) const = 0;
+
+	// Tells the clock a time point is known to have passed, e.g. the deadline a timer task just ran for. Clocks which
+	// cache the current time move forward to it; others ignore it.
+	virtual void Observe(TimePoint time_point) const {
+	}
 };
 
 } // namespace duckdb
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Identifies one block of one version of a file.
+struct BlockCacheKey {
+	string path;
+	// Version tag reported by the wrapped filesystem (e.g. an ETag), so a rewritten object misses the cache.
+	string version_tag;
+	idx_t block_index;
+
+	bool operator==(const BlockCacheKey &other) const {
+		return block_index == other.block_index && path == other.path && version_tag == other.version_tag;
+	}
+};
+
+struct BlockCacheKeyHash {
+	size_t operator()(const BlockCacheKey &key) const;
+};
+
+// Contents of a cached block. Shorter than the block size for the last block of a file.
+struct CachedBlock {
+	unsafe_unique_array<data_t> data;
+	idx_t size = 0;
+};
+
+// Point-in-time counters of a BlockCache.
+struct BlockCacheStats {
+	idx_t block_size = 0;
+	idx_t capacity = 0;
+	idx_t memory_usage = 0;
+	idx_t block_count = 0;
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+};
+
+// In-memory LRU cache of fixed-size file blocks, bounded to a byte capacity. Reads served from it never reach the
+// wrapped filesystem, so they don't spend any rate limit: only misses consume quota, which keeps repeatedly read
+// blocks such as Parquet footers and dictionary pages from competing with the scan for tokens. Thread-safe.
+class BlockCache {
+public:
+	// Throws InvalidInputException if block_size or capacity is 0.
+	BlockCache(idx_t block_size, idx_t capacity);
+
+	BlockCache(const BlockCache &) = delete;
+	BlockCache &operator=(const BlockCache &) = delete;
+
+	idx_t GetBlockSize() const;
+
+	// Returns the cached block and marks it most recently used, or nullptr on a miss.
+	shared_ptr<const CachedBlock> Get(const BlockCacheKey &key);
+
+	// Inserts or replaces a block, evicting least recently used blocks until the cache fits its capacity.
+	void Put(const BlockCacheKey &key, shared_ptr<const CachedBlock> block);
+
+	// Drops every block of a path, whatever its version, e.g. after a write through a handle of it.
+	void ErasePath(const string &path);
+
+	BlockCacheStats GetStats() const;
+
+private:
+	struct Entry {
+		BlockCacheKey key;
+		shared_ptr<const CachedBlock> block;
+	};
+
+	void Evict() DUCKDB_REQUIRES(lock);
+
+	const idx_t block_size;
+	const idx_t capacity;
+	mutable concurrency::mutex lock;
+	// Most recently used entry first.
+	list<Entry> entries DUCKDB_GUARDED_BY(lock);
+	unordered_map<BlockCacheKey, list<Entry>::iterator, BlockCacheKeyHash> index DUCKDB_GUARDED_BY(lock);
+	idx_t memory_usage DUCKDB_GUARDED_BY(lock);
+	uint64_t hits DUCKDB_GUARDED_BY(lock);
+	uint64_t misses DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Clock whose Now() is a single atomic load of a cached monotonic timestamp, for limiters acquired at rates where
+// reading steady_clock on every call is a notable part of their cost. A background thread refreshes the timestamp
+// every resolution, so Now() lags real time by at most about one resolution. The clock is also self-clocking:
+// sleeping on it, or observing a passed deadline, moves the timestamp forward right away, so a woken waiter never sees
+// a time before its deadline and retries immediately instead of waiting for the next refresh.
+//
+// Time points are those of steady_clock, so the clock can be mixed with the default one, e.g. by a limiter chain or
+// the default RateLimitTimer. Admissions may come up to one resolution late, but a limiter's long-term rate is
+// unchanged, since its TAT advances by the exact emission interval of every admitted byte whatever the clock reads.
+class CoarseClock : public BaseClock {
+public:
+	// Largest resolution, beyond which admission delays would become noticeable.
+	static constexpr Duration MAX_RESOLUTION = std::chrono::milliseconds(100);
+
+	// Starts the refresh thread. Throws InvalidInputException unless 0 < resolution <= MAX_RESOLUTION.
+	explicit CoarseClock(Duration resolution);
+	// Stops and joins the refresh thread.
+	~CoarseClock() override;
+
+	CoarseClock(const CoarseClock &) = delete;
+	CoarseClock &operator=(const CoarseClock &) = delete;
+
+	TimePoint Now() const override;
+	void SleepFor(Duration duration) const override;
+	void SleepUntil(TimePoint time_point) const override;
+	// Moves the cached timestamp forward to the time point, if it's behind it. Never moves it back.
+	void Observe(TimePoint time_point) const override;
+
+	Duration GetResolution() const;
+
+private:
+	void RunRefreshThread();
+
+	const Duration resolution;
+	// Nanoseconds since the steady_clock epoch.
+	mutable atomic<int64_t> now_nanos;
+	concurrency::mutex lock;
+	std::condition_variable_any cv;
+	bool running DUCKDB_GUARDED_BY(lock);
+	unique_ptr<thread> refresh_thread;
+};
+
+// Returns the process-wide coarse clock of a resolution, shared by every limiter using that resolution so that they
+// share one refresh thread. The clock is stopped once no limiter uses it.
+shared_ptr<BaseClock> GetCoarseClock(Duration resolution);
+
+} // namespace duckdb
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 
+#include "duckdb/common/shared_ptr.hpp"
 #include "mutex.hpp"
 
 namespace duckdb {
@@ -11,6 +13,10 @@ namespace duckdb {
 class SemaphoreGuard;
 
 // Thread-safe counting semaphore. When max_count is UNLIMITED (-1), Acquire/Release are no-ops.
+//
+// Slots are taken and returned with atomic operations, so an uncontended Acquire/Release pair never locks. The mutex
+// and condition variable are only used once the semaphore is saturated, to park waiters until a slot is released or
+// the maximum is raised.
 class CountingSemaphore {
 	friend class SemaphoreGuard;
 
@@ -28,10 +34,17 @@ public:
 	int64_t GetCurrent() const;
 
 private:
-	mutable concurrency::mutex mtx;
-	std::condition_variable_any cv DUCKDB_GUARDED_BY(mtx);
-	int64_t max_count DUCKDB_GUARDED_BY(mtx);
-	int64_t current_count DUCKDB_GUARDED_BY(mtx);
+	// Takes a slot if one is free or the semaphore is unlimited, without blocking.
+	bool TryAcquire();
+	// Wakes parked waiters, if any; notify_all wakes all of them rather than one.
+	void WakeWaiters(bool notify_all);
+
+	std::atomic<int64_t> max_count;
+	std::atomic<int64_t> current_count;
+	// Number of threads parked in the slow path, so Release only takes the mutex when someone may be waiting.
+	std::atomic<int64_t> waiter_count;
+	concurrency::mutex mtx;
+	std::condition_variable_any cv;
 };
 
 // RAII guard for CountingSemaphore.
@@ -39,6 +52,9 @@ class SemaphoreGuard {
 public:
 	SemaphoreGuard();
 	explicit SemaphoreGuard(CountingSemaphore *sem);
+	// Shares ownership of the semaphore, so the slot can be released even if every other reference is dropped while
+	// the guarded operation is in flight.
+	explicit SemaphoreGuard(shared_ptr<CountingSemaphore> sem_p);
 	~SemaphoreGuard();
 
 	SemaphoreGuard(SemaphoreGuard &&other) noexcept;
@@ -49,6 +65,7 @@ public:
 
 private:
 	CountingSemaphore *sem;
+	shared_ptr<CountingSemaphore> owner;
 };
 
 } // namespace duckdb
@@ -2,11 +2,30 @@
 
 #pragma once
 
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/random_engine.hpp"
+#include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/string.hpp"
 
+#include "base_clock.hpp"
+#include "file_system_operation.hpp"
+#include "mutex.hpp"
+
 namespace duckdb {
 
+// Faults injected into every call of one operation, to make the fake filesystem behave like remote storage.
+struct FakeFsFaults {
+	// Added to every call.
+	Duration latency = Duration::zero();
+	// Upper bound of a uniformly distributed delay added on top of the latency.
+	Duration jitter = Duration::zero();
+	// Fraction of calls in [0, 1] which fail with a throttle error after the delay, before reaching the local
+	// filesystem.
+	double throttle_error_rate = 0;
+};
+
 // Forward declaration.
 class RateLimitFsFakeFileSystem;
 
@@ -24,7 +43,8 @@ public:
 // WARNING: fake filesystem is used for testing purpose and shouldn't be used in production.
 class RateLimitFsFakeFileSystem : public FileSystem {
 public:
-	RateLimitFsFakeFileSystem();
+	// Injected delays are slept on the clock, the default clock if null.
+	explicit RateLimitFsFakeFileSystem(shared_ptr<BaseClock> clock_p = nullptr);
 	bool CanHandleFile(const string &path) override;
 	string GetName() const override {
 		return "RateLimitFsFakeFileSystem";
@@ -65,8 +85,27 @@ public:
 	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener) override;
 	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener) override;
 
+	// Sets the faults injected into the calls of an operation, replacing the previous ones. The calls of each
+	// FileSystemOperation are the ones the rate limit filesystem charges against it, with OpenFile under OPEN; seeking
+	// isn't delayed. Throws InvalidInputException on negative durations or an error rate outside [0, 1].
+	void SetFaults(FileSystemOperation operation, FakeFsFaults faults);
+	FakeFsFaults GetFaults(FileSystemOperation operation) const;
+
+	// Returns how many throttle errors have been injected.
+	idx_t GetInjectedErrorCount() const;
+
 private:
+	// Sleeps off the injected delay of a call, and throws an injected throttle error if one is drawn.
+	void InjectFaults(FileSystemOperation operation, const string &path);
+
 	unique_ptr<FileSystem> local_filesystem;
+	shared_ptr<BaseClock> clock;
+	mutable concurrency::mutex fault_lock;
+	array<FakeFsFaults, FILE_SYSTEM_OPERATION_COUNT> faults DUCKDB_GUARDED_BY(fault_lock);
+	RandomEngine random_engine DUCKDB_GUARDED_BY(fault_lock);
+	// Skips taking the lock on every call as long as no faults were ever set.
+	atomic<bool> has_faults {false};
+	atomic<idx_t> injected_errors {0};
 };
 
 } // namespace duckdb
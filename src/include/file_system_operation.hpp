@@ -13,16 +13,35 @@ enum class FileSystemOperation : uint8_t {
 	STAT,
 	// Reading data from files
 	READ,
-	// Writing data to files (including Truncate, MoveFile)
+	// Writing data to files (including Truncate, Trim, MoveFile)
 	WRITE,
 	// Listing directory contents (Glob, ListFiles)
 	LIST,
 	// Deleting files or directories
 	DELETE,
 	// Creating directories
-	MKDIR
+	MKDIR,
+	// Flushing written data to durable storage (FileSync)
+	SYNC,
+	// Opening files (OpenFile), charged as STAT unless OPEN has a config
+	OPEN
 };
 
+// Number of FileSystemOperation values (including NONE), used to size per-operation lookup tables.
+static constexpr idx_t FILE_SYSTEM_OPERATION_COUNT = static_cast<idx_t>(FileSystemOperation::OPEN) + 1;
+
+// Set of FileSystemOperations, one bit per operation.
+using FileSystemOperationMask = uint32_t;
+static_assert(FILE_SYSTEM_OPERATION_COUNT <= 32, "FileSystemOperationMask has a bit per operation");
+
+// Returns the bit of an operation in a FileSystemOperationMask.
+inline constexpr FileSystemOperationMask GetOperationBit(FileSystemOperation op) {
+	return FileSystemOperationMask(1) << static_cast<uint8_t>(op);
+}
+
+// Returns the operation names ParseFileSystemOperation accepts, comma separated.
+string GetValidOperationsString();
+
 // Converts a string to FileSystemOperation. Throws InvalidInputException on invalid input.
 FileSystemOperation ParseFileSystemOperation(const string &op_str);
 
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// An inner file handle kept open after its wrapper was closed, with what was known about the file then.
+struct PooledHandle {
+	unique_ptr<FileHandle> handle;
+	// Version tag reported by the wrapped filesystem when the handle was opened, empty if it reports none.
+	string version_tag;
+	// -1 if unknown.
+	int64_t file_size = -1;
+};
+
+// Point-in-time counters of a HandlePool.
+struct HandlePoolStats {
+	Duration ttl {0};
+	idx_t capacity = 0;
+	idx_t handle_count = 0;
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+};
+
+// Time-bounded pool of closed read-only inner file handles, so reopening a recently read object reuses its handle,
+// and the metadata its open fetched, instead of opening it again. A handle is only handed out for the same path and
+// open flags, and is dropped once it has been idle for ttl, once the object's version tag changed, or once the path
+// is changed through the wrapper. Handles are kept per owner, the wrapped filesystem whose inner filesystem opened
+// them, since every filesystem of the same name shares the pool. Holds at most capacity handles: once full, the
+// longest idle handle is closed. Thread-safe.
+class HandlePool {
+public:
+	// Throws InvalidInputException if ttl or capacity is 0.
+	HandlePool(Duration ttl, idx_t capacity, shared_ptr<BaseClock> clock);
+
+	HandlePool(const HandlePool &) = delete;
+	HandlePool &operator=(const HandlePool &) = delete;
+
+	// Returns whether handles opened with the flags may be pooled: read-only, without a lock and without creating the
+	// file.
+	static bool CanPool(FileOpenFlags flags);
+
+	// Takes an idle handle of the owner for the path opened with the same flags, closing expired ones. If
+	// expected_version_tag isn't empty, handles of another version of the object are closed rather than handed out.
+	// Returns a PooledHandle without a handle on a miss.
+	PooledHandle Take(idx_t owner, const string &path, FileOpenFlags flags, const string &expected_version_tag);
+
+	// Adds the handle of a closed wrapper, closing the longest idle handle if the pool is full. Closes the handle
+	// instead once the pool is retired.
+	void Put(idx_t owner, const string &path, FileOpenFlags flags, PooledHandle handle);
+
+	// Closes every idle handle of a path, whatever its owner, e.g. after a write or removal through the wrapper.
+	void Erase(const string &path);
+
+	// Closes every idle handle of every path starting with the prefix, e.g. those under a directory removed through
+	// the wrapper.
+	void ErasePrefix(const string &prefix);
+
+	// Closes every idle handle of an owner, which is about to be destroyed along with its inner filesystem.
+	void EraseOwner(idx_t owner);
+
+	// Closes every idle handle and every handle put afterwards, once the pool was replaced or its config cleared.
+	// Wrappers opened before keep a reference to the pool until they are closed.
+	void Retire();
+
+	HandlePoolStats GetStats() const;
+
+private:
+	struct Entry {
+		idx_t owner;
+		string path;
+		FileOpenFlags flags;
+		TimePoint expiry;
+		PooledHandle handle;
+	};
+	using EntryList = list<Entry>;
+
+	// Returns whether two sets of open flags open handles which behave the same.
+	static bool SameFlags(FileOpenFlags lhs, FileOpenFlags rhs);
+	// Unlinks an entry, moving its handle into closed so it's closed once the lock is released.
+	void Remove(EntryList::iterator entry, vector<unique_ptr<FileHandle>> &closed) DUCKDB_REQUIRES(lock);
+
+	const Duration ttl;
+	const idx_t capacity;
+	const shared_ptr<BaseClock> clock;
+	mutable concurrency::mutex lock;
+	// Most recently pooled entry first.
+	EntryList entries DUCKDB_GUARDED_BY(lock);
+	// Entries of each path, in no particular order.
+	unordered_map<string, vector<EntryList::iterator>> index DUCKDB_GUARDED_BY(lock);
+	bool retired DUCKDB_GUARDED_BY(lock);
+	uint64_t hits DUCKDB_GUARDED_BY(lock);
+	uint64_t misses DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include <functional>
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Metadata observed for one path. Each field is only known once a call or listing has reported it.
+struct CachedMetadata {
+	bool has_exists = false;
+	bool exists = false;
+	// -1 if unknown.
+	int64_t file_size = -1;
+	bool has_last_modified = false;
+	timestamp_t last_modified;
+	bool has_file_type = false;
+	FileType file_type = FileType::FILE_TYPE_INVALID;
+	bool has_version_tag = false;
+	string version_tag;
+};
+
+// Point-in-time counters of a MetadataCache.
+struct MetadataCacheStats {
+	Duration ttl {0};
+	idx_t max_entries = 0;
+	idx_t entry_count = 0;
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+};
+
+// Time-bounded cache of per-path metadata, so repeated existence, size, modification time and version tag lookups of
+// the same objects are answered without a STAT call. An entry expires ttl after it was created, whatever was merged
+// into it since, which bounds how stale an answer can be; changes made through the wrapper erase the path right away.
+// Holds at most max_entries paths: once full, expired entries are purged and new paths beyond it aren't cached.
+// Thread-safe.
+class MetadataCache {
+public:
+	// Throws InvalidInputException if ttl or max_entries is 0.
+	MetadataCache(Duration ttl, idx_t max_entries, shared_ptr<BaseClock> clock);
+
+	MetadataCache(const MetadataCache &) = delete;
+	MetadataCache &operator=(const MetadataCache &) = delete;
+
+	// Passes the live entry of a path to lookup, which returns whether the entry holds what it was looking for and
+	// copies it out. Returns false if there is no live entry or lookup returned false, i.e. on a miss.
+	bool Get(const string &path, const std::function<bool(const CachedMetadata &)> &lookup);
+
+	// Merges observed fields into the entry of a path, starting a new entry if it has none or it expired.
+	void Update(const string &path, const std::function<void(CachedMetadata &)> &update);
+
+	// Drops the entry of a path, e.g. after a write or removal through the wrapper.
+	void Erase(const string &path);
+
+	// Drops the entries of every path starting with the prefix, e.g. those under a directory removed through the
+	// wrapper.
+	void ErasePrefix(const string &prefix);
+
+	MetadataCacheStats GetStats() const;
+
+private:
+	struct Entry {
+		TimePoint expiry;
+		CachedMetadata metadata;
+	};
+
+	// Drops every expired entry.
+	void PurgeExpired(TimePoint now) DUCKDB_REQUIRES(lock);
+
+	const Duration ttl;
+	const idx_t max_entries;
+	const shared_ptr<BaseClock> clock;
+	mutable concurrency::mutex lock;
+	unordered_map<string, Entry> entries DUCKDB_GUARDED_BY(lock);
+	uint64_t hits DUCKDB_GUARDED_BY(lock);
+	uint64_t misses DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -1,12 +1,14 @@
 #pragma once
 
+#include <atomic>
+
 #include "base_clock.hpp"
 
 namespace duckdb {
 
 // Mock clock for testing purposes.
 // Allows manual control of time for deterministic testing.
-// Not thread-safe - intended for single-threaded test scenarios.
+// Sleeping threads advance it concurrently without ever moving it backwards, e.g. the chunks of a split read.
 class MockClock : public BaseClock {
 public:
 	explicit MockClock(TimePoint initial_time = TimePoint {});
@@ -22,7 +24,7 @@ public:
 	void SetTime(TimePoint time_point);
 
 private:
-	mutable TimePoint current_time;
+	mutable std::atomic<TimePoint> current_time;
 };
 
 // Creates a mock clock instance for testing with an optional initial time point.
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "duckdb/common/types.hpp"
+
+#include "file_system_operation.hpp"
+
+namespace duckdb {
+
+// Cost model converting a call into the tokens charged against its operation's rate limiter, so that one budget in
+// backend cost units can govern operations of very different cost, e.g. a recursive glob and a FileExists. Without a
+// cost model, READ and WRITE are charged one token per byte and every other operation one token per call.
+//
+// A call is charged call_cost, plus byte_cost per byte it transfers (READ and WRITE only), plus item_cost per
+// result item: every entry a LIST returns, and every directory level a recursive MKDIR creates. Tokens are rounded up
+// per call. Items are only known once the call completes, so they are booked afterwards without waiting.
+struct OperationCost {
+	double call_cost = 0;
+	double byte_cost = 0;
+	double item_cost = 0;
+
+	// Returns true if a cost model is set; all costs 0 means none.
+	bool IsSet() const {
+		return call_cost != 0 || byte_cost != 0 || item_cost != 0;
+	}
+
+	// Returns the tokens of the given number of calls, bytes and items, rounded up.
+	idx_t GetTokens(idx_t calls, idx_t bytes, idx_t items) const;
+
+	// Returns how many bytes one call may transfer without exceeding the tokens, 0 if not even an empty call fits. The
+	// maximum idx_t if bytes are free.
+	idx_t GetMaxBytes(idx_t tokens) const;
+
+	// Returns how many calls without bytes or items fit the tokens. The maximum idx_t if calls are free.
+	idx_t GetMaxCalls(idx_t tokens) const;
+};
+
+// Returns true for operations whose calls transfer bytes, READ and WRITE.
+bool IsByteOperation(FileSystemOperation operation);
+
+// Returns true for operations whose calls produce result items, LIST and MKDIR.
+bool IsItemOperation(FileSystemOperation operation);
+
+} // namespace duckdb
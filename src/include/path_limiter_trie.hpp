@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "file_system_operation.hpp"
+#include "rate_limiter.hpp"
+
+namespace duckdb {
+
+// Rate limiters that apply to one path, indexed by FileSystemOperation; nullptr where no rule matches.
+using PathLimiters = array<SharedRateLimiter, FILE_SYSTEM_OPERATION_COUNT>;
+
+// Character trie from path prefixes (e.g. a bucket 's3://hot-bucket/' or a key prefix 's3://bucket/logs/') to the
+// rate limiters of the limiter groups assigned to them. A path is charged against the rule with the longest prefix of
+// it, separately per operation, and a lookup walks the path once, so it is O(path length) whatever the number of
+// rules. Built once per config version and immutable afterwards, so lookups need no synchronization.
+class PathLimiterTrie {
+public:
+	PathLimiterTrie();
+	~PathLimiterTrie();
+
+	PathLimiterTrie(const PathLimiterTrie &) = delete;
+	PathLimiterTrie &operator=(const PathLimiterTrie &) = delete;
+
+	// Adds a rule. A later rule for the same prefix and operation replaces the earlier one.
+	void Insert(const string &prefix, FileSystemOperation operation, SharedRateLimiter rate_limiter);
+
+	// Returns the rate limiter of the longest matching rule for the operation, nullptr if none.
+	SharedRateLimiter Match(const string &path, FileSystemOperation operation) const;
+
+	// Returns the rate limiters of the longest matching rule for every operation, in a single walk of the path.
+	PathLimiters MatchAll(const string &path) const;
+
+	bool IsEmpty() const;
+
+private:
+	struct Node {
+		// Sorted by character; paths are mostly ASCII and nodes have few children, so binary search over a flat
+		// vector beats a hash map.
+		vector<std::pair<char, unique_ptr<Node>>> children;
+		PathLimiters rate_limiters;
+
+		static bool ChildBefore(const std::pair<char, unique_ptr<Node>> &child, char key);
+		const Node *FindChild(char c) const;
+		Node &GetOrCreateChild(char c);
+	};
+
+	Node root;
+	idx_t rule_count;
+};
+
+} // namespace duckdb
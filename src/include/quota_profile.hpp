@@ -0,0 +1,43 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include "base_clock.hpp"
+
+namespace duckdb {
+
+// Minutes in a day; times of day are minutes since midnight UTC.
+static constexpr idx_t MINUTES_PER_DAY = 24 * 60;
+
+// Bandwidth and burst replacing the quota and burst of an operation during a daily time window, e.g. a nightly
+// backup window. The window starts at start_minute and ends before end_minute, and wraps around midnight if it ends
+// earlier than it starts.
+struct QuotaProfile {
+	idx_t start_minute = 0;
+	idx_t end_minute = 0;
+	idx_t bandwidth = 0;
+	idx_t burst = 0;
+
+	// Returns true if the minute of day falls inside the window.
+	bool Contains(idx_t minute) const {
+		if (start_minute <= end_minute) {
+			return minute >= start_minute && minute < end_minute;
+		}
+		return minute >= start_minute || minute < end_minute;
+	}
+};
+
+// Parses a time of day in 'HH:MM' format into minutes since midnight. Throws InvalidInputException on invalid input.
+idx_t ParseTimeOfDay(const string &time_str);
+
+// Formats minutes since midnight as 'HH:MM'.
+string TimeOfDayToString(idx_t minute);
+
+// Returns the current minute of day in UTC, from the system clock.
+idx_t GetCurrentMinuteOfDay();
+
+// Returns the time left until the next minute of the system clock starts.
+Duration GetTimeUntilNextMinute();
+
+} // namespace duckdb
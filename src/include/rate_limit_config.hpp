@@ -1,17 +1,32 @@
 #pragma once
 
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/optional_idx.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
 #include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
 #include "duckdb/storage/object_cache.hpp"
 
+#include "adaptive_concurrency_limiter.hpp"
+#include "block_cache.hpp"
 #include "base_clock.hpp"
 #include "counting_semaphore.hpp"
 #include "file_system_operation.hpp"
+#include "handle_pool.hpp"
+#include "metadata_cache.hpp"
 #include "mutex.hpp"
+#include "operation_cost.hpp"
+#include "path_limiter_trie.hpp"
+#include "quota_profile.hpp"
 #include "rate_limit_mode.hpp"
+#include "rate_limit_stats.hpp"
 #include "rate_limiter.hpp"
+#include "throttle_backoff.hpp"
 
 namespace duckdb {
 
@@ -20,26 +35,119 @@ class ClientContext;
 class DatabaseInstance;
 
 struct OperationConfig {
+	// Max wait of bounded mode operations which don't set one.
+	static constexpr Duration DEFAULT_MAX_WAIT = std::chrono::seconds(1);
+
 	string filesystem_name;
 	FileSystemOperation operation;
 	idx_t quota;
 	RateLimitMode mode;
 	idx_t burst;
 	SharedRateLimiter rate_limiter;
+	// Calls per second for READ and WRITE, whose quota is in bytes per second; 0 = no request rate limit.
+	idx_t request_quota;
+	// Charges one token per call, alongside rate_limiter which charges one per byte.
+	SharedRateLimiter request_rate_limiter;
 	// -1 = unlimited (default), positive = max concurrent operations
 	int64_t max_requests;
 	shared_ptr<CountingSemaphore> semaphore;
+	// Tunes the semaphore between a minimum and max_requests if set, nullptr for a static max_requests.
+	shared_ptr<AdaptiveConcurrencyLimiter> adaptive_limiter;
+	// Slows rate_limiter down on throttling errors of the inner filesystem, nullptr for a static quota.
+	shared_ptr<ThrottleBackoff> throttle_backoff;
+	// Limiter group the operation is additionally charged against, empty if none.
+	string group_name;
+	// READ only: bytes a small positional read may fetch ahead into its handle's buffer, 0 = no read-ahead.
+	idx_t read_ahead_buffer_size;
+	// READ only: how far past the end of the previous read a read may start to still count as sequential.
+	idx_t read_ahead_window;
+	// READ only: how long a handle keeps its READ concurrency slot between reads, zero if handles don't keep one.
+	Duration stream_idle_timeout;
+	// WRITE only: bytes each handle opened for writing may buffer ahead of the wrapped filesystem, 0 = write through.
+	idx_t write_behind_buffer_size;
+	// READ only: cache of file blocks in front of the filesystem, nullptr if disabled.
+	shared_ptr<BlockCache> block_cache;
+	// STAT only: cache of file metadata in front of the filesystem, nullptr if disabled.
+	shared_ptr<MetadataCache> metadata_cache;
+	// OPEN only: pool of closed read-only handles reopened without another open, nullptr if disabled.
+	shared_ptr<HandlePool> handle_pool;
+	// Bytes (or calls) each thread shard of rate_limiter leases at once, 0 = unsharded.
+	idx_t shard_lease;
+	// Per NUMA node partitions rate_limiter is split into, 0 = unpartitioned.
+	idx_t partitions;
+	// Refresh interval of the coarse clock rate_limiter and request_rate_limiter read, zero for the config's clock.
+	Duration clock_resolution;
+	// Converts calls into rate limiter tokens, unset for one token per byte (READ, WRITE) or call.
+	OperationCost cost;
+	// Bounded mode only: longest a call may wait for each limiter, zero for DEFAULT_MAX_WAIT.
+	Duration max_wait;
+	// One in this many operations has its inner calls traced, 0 = tracing disabled.
+	idx_t trace_sample_every;
+	// Profiles replacing quota and burst during their time window, ordered by start time.
+	vector<QuotaProfile> schedule;
+	// Index of the profile in effect, invalid if quota and burst apply.
+	optional_idx active_profile;
+	// TAT states of rate_limiter and request_rate_limiter, carried over when they are rebuilt so that their debt
+	// survives reconfiguration; nullptr until the limiter is first built.
+	shared_ptr<RateLimiterState> rate_limiter_state;
+	shared_ptr<RateLimiterState> request_rate_limiter_state;
 
 	OperationConfig()
 	    : filesystem_name(), operation(FileSystemOperation::NONE), quota(0), mode(RateLimitMode::NONE), burst(0),
-	      rate_limiter(nullptr), max_requests(CountingSemaphore::UNLIMITED), semaphore(nullptr) {
+	      rate_limiter(nullptr), request_quota(0), request_rate_limiter(nullptr),
+	      max_requests(CountingSemaphore::UNLIMITED), semaphore(nullptr), adaptive_limiter(nullptr),
+	      throttle_backoff(nullptr), group_name(), read_ahead_buffer_size(0), read_ahead_window(0),
+	      stream_idle_timeout(Duration::zero()), write_behind_buffer_size(0), block_cache(nullptr),
+	      metadata_cache(nullptr), handle_pool(nullptr), shard_lease(0), partitions(0),
+	      clock_resolution(Duration::zero()), cost(), max_wait(Duration::zero()), trace_sample_every(0), schedule(),
+	      active_profile(), rate_limiter_state(nullptr), request_rate_limiter_state(nullptr) {
 	}
 
 	bool IsEmpty() const {
-		return quota == 0 && burst == 0 && max_requests == CountingSemaphore::UNLIMITED;
+		return quota == 0 && burst == 0 && request_quota == 0 && max_requests == CountingSemaphore::UNLIMITED &&
+		       !throttle_backoff && group_name.empty() && read_ahead_buffer_size == 0 &&
+		       stream_idle_timeout == Duration::zero() && write_behind_buffer_size == 0 && !block_cache &&
+		       !metadata_cache && !handle_pool && shard_lease == 0 && partitions == 0 &&
+		       clock_resolution == Duration::zero() && !cost.IsSet() && max_wait == Duration::zero() &&
+		       trace_sample_every == 0 && schedule.empty();
+	}
+
+	// Returns the quota in effect, from the active profile if there is one.
+	idx_t GetEffectiveQuota() const {
+		return active_profile.IsValid() ? schedule[active_profile.GetIndex()].bandwidth : quota;
+	}
+
+	// Returns the burst in effect, from the active profile if there is one.
+	idx_t GetEffectiveBurst() const {
+		return active_profile.IsValid() ? schedule[active_profile.GetIndex()].burst : burst;
+	}
+};
+
+// A named rate limiter shared by every (filesystem, operation) assigned to it, e.g. a host-wide NIC budget charged
+// by both READ and WRITE of several filesystems. Groups can nest under a parent group; a request must then pass its
+// own limits, its group's, and every ancestor group's.
+struct LimiterGroupConfig {
+	string name;
+	idx_t bandwidth;
+	idx_t burst;
+	// Parent group name, empty for a root group.
+	string parent_name;
+	SharedRateLimiter rate_limiter;
+	// TAT state of rate_limiter, carried over when it is rebuilt.
+	shared_ptr<RateLimiterState> rate_limiter_state;
+
+	LimiterGroupConfig()
+	    : name(), bandwidth(0), burst(0), parent_name(), rate_limiter(nullptr), rate_limiter_state(nullptr) {
 	}
 };
 
+// Charges calls of one operation on every path starting with a prefix against a limiter group, one token per call.
+struct PathGroupConfig {
+	string prefix;
+	FileSystemOperation operation;
+	string group_name;
+};
+
 // Per-DuckDB-instance rate limit configuration storage.
 class RateLimitConfig : public ObjectCacheEntry {
 public:
@@ -66,9 +174,120 @@ public:
 	// Sets the burst for an operation on a specific filesystem.
 	void SetBurst(const string &filesystem_name, FileSystemOperation operation, idx_t value);
 
+	// Sets the calls per second for READ or WRITE on a specific filesystem, enforced together with the byte quota.
+	// Operations without a mode become blocking. Throws InvalidInputException for other operations.
+	void SetRequestQuota(const string &filesystem_name, FileSystemOperation operation, idx_t value);
+
+	// Coalesces small positional reads on a specific filesystem: a read starting at most window bytes past the end of
+	// the previous read on its handle fetches buffer_size bytes at once, and later reads within them are served from
+	// the handle without an inner read. A buffer_size of 0 disables read-ahead.
+	void SetReadAhead(const string &filesystem_name, idx_t buffer_size, idx_t window);
+
+	// Lets handles of a specific filesystem keep their READ concurrency slot across reads, so a stream of reads takes
+	// the max requests semaphore once instead of on every call. A handle gives its slot back when closed, or once it
+	// hasn't started a read for idle_timeout. An idle_timeout of 0 disables stream slots.
+	void SetStreamSlot(const string &filesystem_name, Duration idle_timeout);
+
+	// Lets handles of a specific filesystem opened for writing buffer up to buffer_size bytes of writes, which a shared
+	// pool of flushers issues at the WRITE rate, so writers only wait once the buffer is full. Applies to handles
+	// opened afterwards. A buffer_size of 0 writes through.
+	void SetWriteBehind(const string &filesystem_name, idx_t buffer_size);
+
+	// Caches reads of a specific filesystem in blocks of block_size bytes, keeping at most capacity bytes in memory.
+	// A capacity of 0 disables the cache. Every change starts a new, empty cache.
+	void SetBlockCache(const string &filesystem_name, idx_t block_size, idx_t capacity);
+
+	// Caches metadata lookups of a specific filesystem (existence, size, modification time, type and version tag) for
+	// ttl, keeping at most max_entries paths. A ttl of 0 disables the cache. Every change starts a new, empty cache.
+	void SetMetadataCache(const string &filesystem_name, Duration ttl, idx_t max_entries);
+
+	// Keeps the inner handles of closed read-only files of a specific filesystem open for ttl, at most capacity of
+	// them, so reopening one of those files within ttl reuses its handle instead of opening it again. A ttl of 0
+	// disables the pool. Every change starts a new, empty pool.
+	void SetHandlePool(const string &filesystem_name, Duration ttl, idx_t capacity);
+
+	// Shards the rate limiter of an operation on a specific filesystem: each thread shard leases value bytes (or calls)
+	// at once and hands them out without touching the shared limiter state, which lets very high call rates scale
+	// across threads at the cost of a burst overshoot of up to RateLimiter::LEASE_SHARD_COUNT leases. A value of 0
+	// disables sharding. Rebuilds the operation's rate limiter.
+	void SetShardLease(const string &filesystem_name, FileSystemOperation operation, idx_t value);
+
+	// Splits the rate limiter of an operation on a specific filesystem into count partitions, chosen by the NUMA node
+	// of the acquiring thread, whose bandwidths are rebalanced by use. Keeps the TAT traffic of each socket's threads
+	// on a cache line of their own, at the cost of every idle partition admitting a request of up to the full burst.
+	// 0 or 1 disables partitioning, which is also ignored while limits are shared across processes. Throws
+	// InvalidInputException above RateLimiter::MAX_PARTITIONS. Rebuilds the operation's rate limiter.
+	void SetPartitions(const string &filesystem_name, FileSystemOperation operation, idx_t count);
+
+	// Makes the rate limiters of an operation on a specific filesystem read a CoarseClock refreshed every resolution
+	// instead of steady_clock, which takes the clock read off their hot path at the cost of admitting calls up to one
+	// resolution late. Only applies while the config uses the default clock. A zero resolution goes back to the
+	// default clock. Throws InvalidInputException for a resolution above CoarseClock::MAX_RESOLUTION. Rebuilds the
+	// operation's rate limiters.
+	void SetClockResolution(const string &filesystem_name, FileSystemOperation operation, Duration resolution);
+
+	// Charges calls of an operation on a specific filesystem with a cost model instead of one token per byte or call,
+	// so its quota and burst are in cost units; all costs 0 remove the cost model. Throws InvalidInputException for
+	// negative costs, a byte cost on operations other than READ and WRITE, or an item cost on operations other than
+	// LIST and MKDIR.
+	void SetCost(const string &filesystem_name, FileSystemOperation operation, const OperationCost &cost);
+
+	// Sets how long a bounded mode call of an operation on a specific filesystem may wait for each limiter before it
+	// fails instead; zero restores OperationConfig::DEFAULT_MAX_WAIT. Has no effect in other modes.
+	void SetMaxWait(const string &filesystem_name, FileSystemOperation operation, Duration max_wait);
+
+	// Traces one in sample_every operations of a specific filesystem, recording the latency of their inner calls in
+	// the stats and logging each traced call. A sample_every of 0 disables tracing.
+	void SetTracing(const string &filesystem_name, FileSystemOperation operation, idx_t sample_every);
+
+	// Replaces the quota and burst of an operation on a specific filesystem with bandwidth and burst every day between
+	// start_minute and end_minute (UTC), replacing any profile starting at the same time. A bandwidth and burst of 0
+	// remove the profile. Operations without a mode become blocking. Switching profiles keeps the limiter's debt, so
+	// a transition doesn't hand out a fresh burst. Throws InvalidInputException for an empty or overlapping window, or
+	// a burst on an operation other than READ and WRITE.
+	void SetQuotaProfile(const string &filesystem_name, FileSystemOperation operation, idx_t start_minute,
+	                     idx_t end_minute, idx_t bandwidth, idx_t burst);
+
+	// Activates the profiles in effect at the given minute of day, and returns the number of operations whose limits
+	// changed. With the default clock this runs every minute against the system clock; with another clock, callers
+	// drive it themselves.
+	idx_t ApplyQuotaProfiles(idx_t minute);
+
 	// Sets the max requests for an operation on a specific filesystem.
 	void SetMaxRequests(const string &filesystem_name, FileSystemOperation operation, int64_t value);
 
+	// Lets the max requests for an operation on a specific filesystem adapt between min_value and max_value, driven by
+	// the latency and throttling errors of the inner filesystem. A later SetMaxRequests makes it static again.
+	// Throws InvalidInputException unless 1 <= min_value <= max_value.
+	void SetAdaptiveMaxRequests(const string &filesystem_name, FileSystemOperation operation, int64_t min_value,
+	                            int64_t max_value);
+
+	// Makes throttling errors of the inner filesystem cut the quota of an operation on a specific filesystem down to
+	// min_ratio of the configured one, recovering over recovery_interval steps, and retries throttled calls up to
+	// max_retries times; see ThrottleBackoff. Replacing the backoff restores the full quota. A zero recovery_interval
+	// disables it. Throws InvalidInputException unless 0 < min_ratio <= 1.
+	void SetThrottleBackoff(const string &filesystem_name, FileSystemOperation operation, double min_ratio,
+	                        Duration recovery_interval, idx_t max_retries);
+
+	// Creates or updates a limiter group. An empty parent_name makes it a root group. Setting both bandwidth and
+	// burst to 0 removes the group, which is only allowed once nothing references it.
+	// Throws InvalidInputException if the parent doesn't exist or would create a cycle.
+	void SetGroup(const string &group_name, idx_t bandwidth, idx_t burst, const string &parent_name);
+
+	// Assigns an operation on a specific filesystem to a limiter group; an empty group_name unassigns it.
+	// Throws InvalidInputException if the group doesn't exist.
+	void SetGroupAssignment(const string &filesystem_name, FileSystemOperation operation, const string &group_name);
+
+	// Returns all limiter groups.
+	vector<LimiterGroupConfig> GetAllGroups() const;
+
+	// Charges calls of an operation on paths starting with the prefix against a limiter group, in every filesystem; an
+	// empty group_name removes the rule. Throws InvalidInputException for an empty prefix or a missing group.
+	void SetPathGroup(const string &prefix, FileSystemOperation operation, const string &group_name);
+
+	// Returns all path rules, ordered by prefix and operation.
+	vector<PathGroupConfig> GetAllPathGroups() const;
+
 	const OperationConfig *GetConfig(const string &filesystem_name, FileSystemOperation operation) const;
 
 	SharedRateLimiter GetOrCreateRateLimiter(const string &filesystem_name, FileSystemOperation operation);
@@ -80,14 +299,58 @@ public:
 	// Avoids TOCTOU races and dangling-pointer issues from separate Get*/GetOrCreate* calls.
 	struct RateLimitSnapshot {
 		SharedRateLimiter rate_limiter;
+		SharedRateLimiter request_rate_limiter;
 		shared_ptr<CountingSemaphore> semaphore;
+		shared_ptr<AdaptiveConcurrencyLimiter> adaptive_limiter;
+		shared_ptr<ThrottleBackoff> throttle_backoff;
 		RateLimitMode mode = RateLimitMode::NONE;
+		idx_t read_ahead_buffer_size = 0;
+		idx_t read_ahead_window = 0;
+		Duration stream_idle_timeout = Duration::zero();
+		idx_t write_behind_buffer_size = 0;
+		shared_ptr<BlockCache> block_cache;
+		shared_ptr<MetadataCache> metadata_cache;
+		shared_ptr<HandlePool> handle_pool;
+		OperationCost cost;
+		Duration max_wait = OperationConfig::DEFAULT_MAX_WAIT;
+		idx_t trace_sample_every = 0;
+		// Clock timing traced calls, nullptr if tracing is disabled.
+		shared_ptr<BaseClock> trace_clock;
 	};
 
 	// Atomically retrieves all rate-limit state needed for a single operation.
 	// Returns a snapshot with rate_limiter==nullptr if no config exists for this filesystem/operation.
 	RateLimitSnapshot GetRateLimitSnapshot(const string &filesystem_name, FileSystemOperation operation);
 
+	// Immutable view of every operation's rate-limit state for one filesystem, indexed by FileSystemOperation.
+	// Tagged with the config version it was built from, so holders can cheaply tell whether it is stale.
+	struct FilesystemSnapshot {
+		uint64_t version = 0;
+		array<RateLimitSnapshot, FILE_SYSTEM_OPERATION_COUNT> operations;
+		// Rate limiters of the path rules, nullptr if there are none.
+		shared_ptr<const PathLimiterTrie> path_limiters;
+
+		const RateLimitSnapshot &Get(FileSystemOperation operation) const {
+			return operations[static_cast<idx_t>(operation)];
+		}
+	};
+
+	// Returns the id of a filesystem name, interning it on first use. Ids are small, dense and stay valid for the
+	// lifetime of the config, so a wrapped filesystem interns its name once and looks its state up by id from then on.
+	idx_t InternFilesystem(const string &filesystem_name);
+
+	// Builds a snapshot of all operations for an interned filesystem, under one lock acquisition.
+	shared_ptr<const FilesystemSnapshot> GetFilesystemSnapshot(idx_t filesystem_id);
+
+	// Returns the config version, which is bumped on every mutation. A FilesystemSnapshot whose version equals the
+	// current one is up to date; this is a single atomic load, so it is safe to call on every I/O.
+	uint64_t GetVersion() const;
+
+	// Returns the operations of an interned filesystem that have a config or a path rule, creating the set on first
+	// use. The set is updated in place on every mutation, before the version is bumped, so the I/O path can skip all
+	// limiter lookups of an operation without any with a single relaxed load.
+	shared_ptr<const atomic<FileSystemOperationMask>> GetConfiguredOperations(idx_t filesystem_id);
+
 	// Returns all configured operations across all filesystems.
 	vector<OperationConfig> GetAllConfigs() const;
 
@@ -100,11 +363,32 @@ public:
 	// Clears all configurations for a specific filesystem.
 	void ClearFilesystem(const string &filesystem_name);
 
-	// Clears all configurations.
+	// Clears all configurations, including limiter groups.
 	void ClearAll();
 
+	// Returns the counters of a filesystem, creating them on first use. Counters outlive configuration changes and are
+	// only zeroed by ResetStats().
+	shared_ptr<FilesystemStats> GetOrCreateStats(const string &filesystem_name);
+
+	// Returns the counters of every filesystem.
+	vector<shared_ptr<FilesystemStats>> GetAllStats() const;
+
+	// Returns the burst of a READ or WRITE operation on a specific filesystem which admits percentile percent of the
+	// requests seen since the stats were last reset, in the tokens of the operation's cost model if it has one; 0 if no
+	// requests with data were seen. The percentile is in (0, 100].
+	idx_t RecommendBurst(const string &filesystem_name, FileSystemOperation operation, double percentile);
+
+	// Sets the burst of a READ or WRITE operation on a specific filesystem to RecommendBurst, and returns it. Throws
+	// if no requests with data were seen.
+	idx_t AutoTuneBurst(const string &filesystem_name, FileSystemOperation operation, double percentile);
+
+	// Zeroes the counters of every filesystem.
+	void ResetStats();
+
 	// Gets or creates the config from the client context's object cache.
 	static shared_ptr<RateLimitConfig> GetOrCreate(ClientContext &context);
+	// Gets or creates the config from the database's object cache, e.g. while the extension is loaded.
+	static shared_ptr<RateLimitConfig> GetOrCreate(DatabaseInstance &db);
 
 	// Gets the config from the client context's object cache. Returns nullptr if not exists.
 	static shared_ptr<RateLimitConfig> Get(ClientContext &context);
@@ -112,38 +396,155 @@ public:
 	// Sets the clock to use for rate limiters (for testing with MockClock).
 	void SetClock(shared_ptr<BaseClock> clock_p);
 
+	// Returns the clock used for rate limiters, nullptr for the default clock.
+	shared_ptr<BaseClock> GetClock() const;
+
+	// Keeps the state of every filesystem, request and group rate limiter in a memory-mapped file in the directory, so
+	// all DuckDB processes on the host using the same directory share their limits; an empty directory keeps state in
+	// process memory again. Rebuilds every rate limiter. Throws IOException, leaving the config unchanged, if the
+	// state files can't be created.
+	void SetSharedStateDirectory(const string &directory);
+
+	// Returns the shared state directory, empty if rate limiter state is process-local.
+	string GetSharedStateDirectory() const;
+
 	// Gets the database instance for logging.
 	// Throws InternalException if the database instance is no longer available.
 	shared_ptr<DatabaseInstance> GetDatabaseInstance() const;
 
 private:
-	// Key for the config map
-	struct ConfigKey {
-		string filesystem_name;
-		FileSystemOperation operation;
+	// Configs of one interned filesystem.
+	struct FilesystemConfigs {
+		explicit FilesystemConfigs(string filesystem_name_p) : filesystem_name(std::move(filesystem_name_p)) {
+		}
 
-		bool operator==(const ConfigKey &other) const {
-			return filesystem_name == other.filesystem_name && operation == other.operation;
+		unique_ptr<OperationConfig> &Get(FileSystemOperation operation) {
+			return operations[static_cast<idx_t>(operation)];
+		}
+		const unique_ptr<OperationConfig> &Get(FileSystemOperation operation) const {
+			return operations[static_cast<idx_t>(operation)];
 		}
+
+		const string filesystem_name;
+		// Indexed by FileSystemOperation, nullptr for operations without a config.
+		array<unique_ptr<OperationConfig>, FILE_SYSTEM_OPERATION_COUNT> operations;
+		// Configured operations, nullptr until first requested and then kept up to date by BumpVersion().
+		shared_ptr<atomic<FileSystemOperationMask>> configured_operations;
 	};
 
-	struct ConfigKeyHash {
-		size_t operator()(const ConfigKey &key) const {
-			return std::hash<string>()(key.filesystem_name) ^
-			       (std::hash<uint8_t>()(static_cast<uint8_t>(key.operation)) << 1);
-		}
+	// Lets the schedule ticker call into a config until the config is destroyed.
+	struct ScheduleHandle {
+		concurrency::mutex lock;
+		RateLimitConfig *config DUCKDB_GUARDED_BY(lock);
 	};
 
+	// Activates the profiles in effect at the given minute of day, and returns the number of changed operations.
+	idx_t ApplyQuotaProfilesLocked(idx_t minute) DUCKDB_REQUIRES(config_lock);
+
+	// Starts the per-minute schedule ticker unless it is running or the clock isn't the default one.
+	void StartScheduleTicker() DUCKDB_REQUIRES(config_lock);
+
+	// Schedules the next tick of the schedule ticker at the start of the next minute.
+	static void ScheduleTick(shared_ptr<ScheduleHandle> handle);
+
+	// Runs one tick: applies the profiles of the current minute and keeps ticking while any operation has a schedule.
+	void OnScheduleTick();
+
+	// Returns the state slot's state, creating it in the shared state directory or process memory if empty.
+	shared_ptr<RateLimiterState> GetOrCreateState(shared_ptr<RateLimiterState> &slot, const string &key)
+	    DUCKDB_REQUIRES(config_lock);
+
+	// Returns the clock the rate limiters of an operation read: the config's clock if set, otherwise the shared coarse
+	// clock of the operation's resolution, or nullptr for the default clock.
+	shared_ptr<BaseClock> GetLimiterClock(const OperationConfig &config) const DUCKDB_REQUIRES(config_lock);
+
 	// Updates the rate limiter for an operation based on current config.
 	void UpdateRateLimiter(OperationConfig &config) DUCKDB_REQUIRES(config_lock);
 
+	// Applies a changed quota or burst of an operation to its rate limiter in place, keeping its state and every holder
+	// of it up to date. Falls back to UpdateRateLimiter if the operation has no limiter of its own yet.
+	void ReconfigureRateLimiter(OperationConfig &config) DUCKDB_REQUIRES(config_lock);
+
+	// Applies a changed request quota to the request rate limiter in place, see ReconfigureRateLimiter.
+	void ReconfigureRequestRateLimiter(OperationConfig &config) DUCKDB_REQUIRES(config_lock);
+
+	// Updates the request rate limiter for an operation based on current config.
+	void UpdateRequestRateLimiter(OperationConfig &config) DUCKDB_REQUIRES(config_lock);
+
+	// Recreates a group's rate limiter, then those of its child groups and assigned operations, which point at it.
+	void RebuildGroup(LimiterGroupConfig &group) DUCKDB_REQUIRES(config_lock);
+
+	// Recreates every group, filesystem and request rate limiter with new states, e.g. after the clock changed.
+	void RebuildRateLimiters() DUCKDB_REQUIRES(config_lock);
+
+	// Returns the rate limiter of a group, or nullptr for an empty group name.
+	SharedRateLimiter GetGroupRateLimiter(const string &group_name) const DUCKDB_REQUIRES(config_lock);
+
+	// Fills a snapshot from an operation config, creating the rate limiter if it is missing.
+	void FillSnapshot(OperationConfig &op_config, RateLimitSnapshot &snapshot) DUCKDB_REQUIRES(config_lock);
+
+	// Returns the id of a filesystem name, interning it on first use.
+	idx_t InternFilesystemLocked(const string &filesystem_name) DUCKDB_REQUIRES(config_lock);
+
+	// Returns the config slot of an operation, interning the filesystem; the slot is nullptr if there is no config.
+	unique_ptr<OperationConfig> &GetConfigSlot(const string &filesystem_name, FileSystemOperation operation)
+	    DUCKDB_REQUIRES(config_lock);
+
+	// Returns the config of an operation, nullptr if there is none. Doesn't intern the filesystem.
+	OperationConfig *FindConfig(const string &filesystem_name, FileSystemOperation operation) const
+	    DUCKDB_REQUIRES(config_lock);
+
+	// Calls func with every config, ordered by filesystem id and operation.
+	template <class FUNC>
+	void ForEachConfig(FUNC &&func) const DUCKDB_REQUIRES(config_lock) {
+		for (const auto &filesystem : filesystems) {
+			for (const auto &config : filesystem->operations) {
+				if (config) {
+					func(*config);
+				}
+			}
+		}
+	}
+
+	// Returns the trie of path rules for the current version, rebuilding it if rules or groups changed since.
+	shared_ptr<const PathLimiterTrie> GetPathLimiters() DUCKDB_REQUIRES(config_lock);
+
+	// Returns the configured operations of a filesystem, from configs and path rules.
+	FileSystemOperationMask ComputeConfiguredOperations(const FilesystemConfigs &filesystem) const
+	    DUCKDB_REQUIRES(config_lock);
+
+	// Invalidates all outstanding filesystem snapshots and refreshes the configured operation sets; must be called
+	// after every mutation of configs or clock.
+	void BumpVersion() DUCKDB_REQUIRES(config_lock);
+
 	mutable concurrency::mutex config_lock;
-	// Maps from (filesystem_name, operation) to its configuration.
-	unordered_map<ConfigKey, OperationConfig, ConfigKeyHash> configs DUCKDB_GUARDED_BY(config_lock);
+	// Maps from filesystem name to its id, the index of its configs in filesystems. Names are never removed, so ids
+	// held by wrapped filesystems stay valid.
+	unordered_map<string, idx_t> filesystem_ids DUCKDB_GUARDED_BY(config_lock);
+	vector<unique_ptr<FilesystemConfigs>> filesystems DUCKDB_GUARDED_BY(config_lock);
+	// Maps from group name to its limiter group.
+	unordered_map<string, LimiterGroupConfig> groups DUCKDB_GUARDED_BY(config_lock);
+	// Maps from (prefix, operation) to the limiter group its calls are charged against.
+	map<std::pair<string, FileSystemOperation>, string> path_groups DUCKDB_GUARDED_BY(config_lock);
+	// Path rule trie and the version it was built for.
+	shared_ptr<const PathLimiterTrie> path_limiters DUCKDB_GUARDED_BY(config_lock);
+	uint64_t path_limiters_version DUCKDB_GUARDED_BY(config_lock);
+	// Maps from filesystem name to its counters.
+	unordered_map<string, shared_ptr<FilesystemStats>> stats DUCKDB_GUARDED_BY(config_lock);
 	// Clock to use for rate limiters (nullptr means use default clock).
 	shared_ptr<BaseClock> clock DUCKDB_GUARDED_BY(config_lock);
+	// Directory of shared rate limiter state files, empty for process-local state.
+	string shared_state_directory DUCKDB_GUARDED_BY(config_lock);
+	// Minute of day the quota profiles were last applied at.
+	idx_t schedule_minute DUCKDB_GUARDED_BY(config_lock);
+	// True while the schedule ticker is scheduled.
+	bool schedule_ticker_running DUCKDB_GUARDED_BY(config_lock);
+	// Shared with pending ticks, which stop once the config is destroyed.
+	shared_ptr<ScheduleHandle> schedule_handle;
 	// Weak pointer to database instance for logging, stored as weak pointer to avoid circular references.
 	weak_ptr<DatabaseInstance> db_instance DUCKDB_GUARDED_BY(config_lock);
+	// Only written under config_lock, but read lock-free by the I/O hot path.
+	atomic<uint64_t> version;
 };
 
 } // namespace duckdb
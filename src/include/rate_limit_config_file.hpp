@@ -0,0 +1,64 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "file_system_operation.hpp"
+#include "rate_limit_mode.hpp"
+
+namespace duckdb {
+
+class RateLimitConfig;
+
+// Path of a config file applied when the extension is loaded, and again whenever the setting is changed. Also read
+// from the environment variable of the same name in upper case, for processes which can't pass settings at startup.
+constexpr const char *RATE_LIMIT_FS_CONFIG_FILE_SETTING = "rate_limit_fs_config_file";
+constexpr const char *RATE_LIMIT_FS_CONFIG_FILE_ENV = "RATE_LIMIT_FS_CONFIG_FILE";
+
+// Limits settable from a config file, each matching the SQL function of the same name.
+enum class RateLimitConfigFileKey : uint8_t { QUOTA, BURST, REQUEST_QUOTA, MAX_REQUESTS, MAX_WAIT_MS };
+
+// One "<operation>.<key> = <value>" line of a filesystem section.
+struct RateLimitConfigFileSetting {
+	string filesystem_name;
+	FileSystemOperation operation = FileSystemOperation::NONE;
+	RateLimitConfigFileKey key = RateLimitConfigFileKey::QUOTA;
+	idx_t value = 0;
+	// Only set for QUOTA, BLOCKING unless given after the value.
+	RateLimitMode mode = RateLimitMode::BLOCKING;
+	// 1-based line in the file, for error messages.
+	idx_t line = 0;
+};
+
+// Declarative rate limit configuration, in an INI-like format:
+//
+//   # Filesystems wrapped at load, by the name rate_limit_fs_list_filesystems() reports.
+//   wrap = S3FileSystem, HTTPFileSystem
+//
+//   [RateLimitFileSystem - S3FileSystem]
+//   read.quota = 104857600 blocking
+//   read.burst = 8388608
+//   read.request_quota = 100
+//   stat.quota = 50
+//   read.max_requests = 16
+//   read.max_wait_ms = 500
+//
+// Section names are those of wrapped filesystems, as passed to the SQL functions. Blank lines and lines starting with
+// '#' or ';' are ignored.
+struct RateLimitConfigFile {
+	vector<string> wrap;
+	// In file order, so later lines override earlier ones.
+	vector<RateLimitConfigFileSetting> settings;
+};
+
+// Parses a config file. Throws InvalidInputException naming the line of the first malformed line, unknown key or
+// invalid value and the expected form, but never the line's content, which may come from a file the caller can't read.
+RateLimitConfigFile ParseRateLimitConfigFile(const string &content);
+
+// Applies the settings of a parsed config file in file order. Filesystems don't have to be registered yet, since
+// limits are looked up by name when a wrapped filesystem is used. Throws InvalidInputException if the config rejects a
+// setting, after applying the settings before it.
+void ApplyRateLimitConfigFile(const RateLimitConfigFile &file, RateLimitConfig &config);
+
+} // namespace duckdb
@@ -1,18 +1,58 @@
 #pragma once
 
+#include <functional>
+
 #include "counting_semaphore.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/multi_file/multi_file_list.hpp"
 #include "duckdb/common/optional_ptr.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/unique_ptr.hpp"
+#include "handle_pool.hpp"
+#include "mutex.hpp"
 #include "rate_limit_config.hpp"
+#include "rate_limit_scope.hpp"
+#include "rate_limit_stats.hpp"
+#include "write_behind_buffer.hpp"
 
 namespace duckdb {
 
 // Forward declaration.
 class RateLimitFileSystem;
 
+// Byte range of a file to prefetch.
+struct PrefetchRange {
+	idx_t offset;
+	idx_t length;
+};
+
+// Bytes fetched for a prefetched range.
+struct PrefetchedRange {
+	unsafe_unique_array<data_t> data;
+	idx_t size;
+};
+
+// READ concurrency slot a handle keeps between reads when stream slots are enabled. Shared with the timer task which
+// gives the slot back once the handle has been idle for idle_timeout.
+struct StreamSlot {
+	concurrency::mutex lock;
+	// Semaphore the slot was taken from, nullptr while no slot is held.
+	shared_ptr<CountingSemaphore> semaphore DUCKDB_GUARDED_BY(lock);
+	SemaphoreGuard guard DUCKDB_GUARDED_BY(lock);
+	Duration idle_timeout DUCKDB_GUARDED_BY(lock) = Duration::zero();
+	// Start of the last read under the slot, by the clock of the default RateLimitTimer.
+	TimePoint last_used DUCKDB_GUARDED_BY(lock);
+
+	// Gives the slot back, if one is held.
+	void Release() DUCKDB_REQUIRES(lock) {
+		guard = SemaphoreGuard();
+		semaphore = nullptr;
+	}
+};
+
 // ==========================================================================
 // RateLimitFileHandle
 // ==========================================================================
@@ -26,17 +66,153 @@ public:
 
 	void Close() override;
 
+	// Forwarded to the inner handle, so compressed or remote handles keep reporting their own.
+	idx_t GetProgress() override;
+	FileCompressionType GetFileCompressionType() override;
+
 	// Returns the inner file handle.
 	FileHandle &GetInnerHandle();
 
+	// Sentinel for a file size which hasn't been fetched yet, or was invalidated by a write through this handle.
+	static constexpr int64_t UNKNOWN_FILE_SIZE = -1;
+
+	// Returns the cached file size, or UNKNOWN_FILE_SIZE.
+	int64_t GetCachedFileSize() const;
+	void SetCachedFileSize(int64_t file_size);
+	void InvalidateCachedFileSize();
+
+	// Returns the connection-level scope reads and writes through this handle are charged against.
+	const RateLimitScope &GetScope() const;
+	// Replaces the scope. Only valid before the handle is used for I/O.
+	void SetScope(RateLimitScope scope_p);
+
+	// Returns the path rule limiter calls of the operation through this handle are charged against, if any.
+	optional_ptr<RateLimiter> GetPathLimiter(FileSystemOperation operation) const;
+	// Replaces the path rule limiters, resolved once when the file is opened. Only valid before the handle is used.
+	void SetPathLimiters(PathLimiters path_limiters_p);
+
+	// Records a positional read, and returns whether it starts at most window bytes past the end of the previous one.
+	bool RecordRead(idx_t nr_bytes, idx_t location, idx_t window);
+	// Copies the requested bytes from the read-ahead buffer, and returns false if it doesn't hold all of them.
+	bool ReadFromBuffer(void *buffer, idx_t nr_bytes, idx_t location);
+	// Replaces the read-ahead buffer with size bytes fetched at location.
+	void SetReadBuffer(unsafe_unique_array<data_t> data, idx_t size, idx_t location);
+	// Drops the read-ahead buffer, e.g. after a write through this handle.
+	void InvalidateReadBuffer();
+
+	// Reads the ranges concurrently, as many at once as the READ max requests allows, each charged like a positional
+	// read. Positional reads within one prefetched range are then served from memory without being charged again,
+	// until the next prefetch replaces the ranges or a write through this handle drops them. Bytes past the end of the
+	// file aren't prefetched.
+	void Prefetch(const vector<PrefetchRange> &ranges);
+	// Copies the requested bytes from a prefetched range, and returns false if no range holds all of them.
+	bool ReadFromPrefetched(void *buffer, idx_t nr_bytes, idx_t location);
+	// Replaces the prefetched ranges with the given buffers, keyed by their offset.
+	void SetPrefetchedRanges(map<idx_t, PrefetchedRange> ranges);
+	// Drops the prefetched ranges.
+	void InvalidatePrefetchedRanges();
+
+	// Returns the READ concurrency slot the handle keeps between reads when stream slots are enabled.
+	const shared_ptr<StreamSlot> &GetStreamSlot() const;
+
+	// Returns whether positional reads through this handle go through the filesystem's block cache, which is decided
+	// when the file is opened.
+	bool IsBlockCacheEnabled() const;
+	// Returns the version tag of the file when it was opened, which keys its cached blocks.
+	const string &GetCacheVersionTag() const;
+	// Enables the block cache for this handle. Only valid before the handle is used for I/O.
+	void EnableBlockCache(string version_tag);
+
+	// Returns the buffer writes through this handle are queued in, nullptr if write-behind is disabled.
+	optional_ptr<WriteBehindBuffer> GetWriteBehind() const;
+	// Enables write-behind for this handle. Only valid before the handle is used for I/O.
+	void EnableWriteBehind(unique_ptr<WriteBehindBuffer> write_behind_p);
+	// Waits until every write queued through this handle has reached the inner handle, and throws the error of a
+	// failed flush, if any.
+	void DrainWriteBehind();
+
+	// Returns the inner handle to the pool on close instead of closing it, keyed by the owner, along with its version
+	// tag. Only valid for handles opened read-only, before the handle is used for I/O.
+	void EnableHandlePool(shared_ptr<HandlePool> handle_pool_p, idx_t owner, string version_tag);
+
 private:
+	// Hands the inner handle, its version tag and the cached file size over to the handle pool.
+	void ReturnToPool();
+
 	unique_ptr<FileHandle> inner_handle;
+	RateLimitScope scope;
+	PathLimiters path_limiters;
+	// Size used to clamp the bytes charged for positional reads, so they don't need an inner GetFileSize each time.
+	// Atomic since positional reads may be issued concurrently on one handle.
+	atomic<int64_t> cached_file_size;
+	// Read-ahead state, shared by positional reads which may be issued concurrently on one handle.
+	concurrency::mutex read_buffer_lock;
+	unsafe_unique_array<data_t> read_buffer DUCKDB_GUARDED_BY(read_buffer_lock);
+	idx_t read_buffer_start DUCKDB_GUARDED_BY(read_buffer_lock);
+	idx_t read_buffer_size DUCKDB_GUARDED_BY(read_buffer_lock);
+	idx_t last_read_end DUCKDB_GUARDED_BY(read_buffer_lock);
+	// Prefetched ranges by offset. The flag lets reads skip the lock on handles that never prefetched.
+	concurrency::mutex prefetch_lock;
+	map<idx_t, PrefetchedRange> prefetched_ranges DUCKDB_GUARDED_BY(prefetch_lock);
+	atomic<bool> has_prefetched_ranges;
+	shared_ptr<StreamSlot> stream_slot;
+	bool block_cache_enabled;
+	string cache_version_tag;
+	unique_ptr<WriteBehindBuffer> write_behind;
+	// Pool the inner handle is returned to on close, nullptr to close it.
+	shared_ptr<HandlePool> handle_pool;
+	idx_t pool_owner;
+	string pool_version_tag;
+};
+
+// ==========================================================================
+// RateLimitMultiFileList
+// ==========================================================================
+
+// Glob result that pulls files from the inner filesystem's list one page of LIST_PAGE_SIZE entries at a time, as the
+// scan reaches them, so scanning starts on the first files while the listing continues. Each page is fetched under a
+// LIST concurrency slot of its own, and every page after the first, which the glob call was charged for, is charged
+// as a LIST call before its files are handed out.
+class RateLimitMultiFileList : public MultiFileList {
+public:
+	RateLimitMultiFileList(RateLimitFileSystem &fs_p, const string &pattern, FileGlobInput glob_input_p,
+	                       unique_ptr<MultiFileList> inner_list_p, SharedRateLimiter path_limiter_p);
+
+	vector<OpenFileInfo> GetAllFiles() override;
+	FileExpandResult GetExpandResult() override;
+	idx_t GetTotalFileCount() override;
+
+protected:
+	OpenFileInfo GetFile(idx_t i) override;
+
+private:
+	// Fetches the next page from the inner list, marking the list exhausted once a page comes back short.
+	void FetchPage() DUCKDB_REQUIRES(lock);
+	// Fetches pages until the list holds more than the given number of files or is exhausted.
+	void ExpandTo(idx_t count) DUCKDB_REQUIRES(lock);
+
+	RateLimitFileSystem &fs;
+	const SharedRateLimiter path_limiter;
+	concurrency::mutex lock;
+	unique_ptr<MultiFileList> inner_list DUCKDB_GUARDED_BY(lock);
+	MultiFileListScanData scan_data DUCKDB_GUARDED_BY(lock);
+	vector<OpenFileInfo> files DUCKDB_GUARDED_BY(lock);
+	bool exhausted DUCKDB_GUARDED_BY(lock);
 };
 
 // A file system wrapper that applies rate limiting to operations.
 // Wraps an inner file system and applies rate limits based on the configuration.
 class RateLimitFileSystem : public FileSystem {
+	friend class RateLimitMultiFileList;
+
 public:
+	// Entries an object store returns per list request (S3 ListObjectsV2, GCS and Azure all page by 1000 or more).
+	// Listings are charged one LIST call per page of this size.
+	static constexpr idx_t LIST_PAGE_SIZE = 1000;
+	// Most reads a prefetch, or chunks a positional read or write in split mode, issues at once without a max
+	// requests. The calling thread issues one, and workers shared by every caller the others.
+	static constexpr idx_t MAX_TRANSFER_THREADS = 16;
+
 	// Creates a rate limit file system wrapping the given inner file system and config.
 	// Rate limit configs are looked up using the inner filesystem's name.
 	RateLimitFileSystem(unique_ptr<FileSystem> inner_fs_p, shared_ptr<RateLimitConfig> config_p);
@@ -52,6 +228,9 @@ public:
 	int64_t Read(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
 	int64_t Write(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
 
+	// Reads the ranges of a file concurrently, see RateLimitFileHandle::Prefetch.
+	void Prefetch(RateLimitFileHandle &handle, const vector<PrefetchRange> &ranges);
+
 	FileMetadata Stats(FileHandle &handle) override;
 	int64_t GetFileSize(FileHandle &handle) override;
 	timestamp_t GetLastModifiedTime(FileHandle &handle) override;
@@ -59,6 +238,10 @@ public:
 	string GetVersionTag(FileHandle &handle) override;
 
 	void Truncate(FileHandle &handle, int64_t new_size) override;
+	bool Trim(FileHandle &handle, idx_t offset_bytes, idx_t length_bytes) override;
+	void FileSync(FileHandle &handle) override;
+	// Charged as a WRITE of the source's size, since object stores move by copying server side.
+	void MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener = nullptr) override;
 
 	bool DirectoryExists(const string &directory, optional_ptr<FileOpener> opener = nullptr) override;
 	void RemoveDirectory(const string &directory, optional_ptr<FileOpener> opener = nullptr) override;
@@ -81,13 +264,12 @@ public:
 
 	bool CanHandleFile(const string &path) override;
 
+	// Charged as a STAT call, or as an OPEN call once OPEN has a config. Read-only files may be reopened from the
+	// handle pool, which isn't charged.
 	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags,
 	                                optional_ptr<FileOpener> opener = nullptr) override;
 
 	bool IsPipe(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
-	void MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener = nullptr) override;
-
-	void FileSync(FileHandle &handle) override;
 
 	void Seek(FileHandle &handle, idx_t location) override;
 	void Reset(FileHandle &handle) override;
@@ -98,6 +280,12 @@ public:
 
 	string GetName() const override;
 	string PathSeparator(const string &path) override;
+	string GetHomeDirectory() override;
+	string ExpandPath(const string &path) override;
+	bool IsManuallySet() override;
+
+	// Sub-system registration isn't forwarded: it's the virtual filesystem's, and the wrapper is one of its
+	// sub-systems rather than a container of them.
 
 protected:
 	unique_ptr<FileHandle> OpenFileExtended(const OpenFileInfo &file, FileOpenFlags flags,
@@ -108,14 +296,136 @@ protected:
 	                       optional_ptr<FileOpener> opener) override;
 	bool SupportsListFilesExtended() const override;
 
+	// Returns a lazily expanded list, see RateLimitMultiFileList; only the first page is charged up front.
+	unique_ptr<MultiFileList> GlobFilesExtended(const string &path, const FileGlobInput &input,
+	                                            optional_ptr<FileOpener> opener) override;
+	bool SupportsGlobExtended() const override;
+
 private:
-	[[nodiscard]] SemaphoreGuard AcquireConcurrencySlot(FileSystemOperation operation);
-	void ApplyRateLimit(FileSystemOperation operation, idx_t bytes = 1);
+	// Waits for a concurrency slot if max requests is set, and counts the operation as in flight.
+	[[nodiscard]] OperationSlot AcquireConcurrencySlot(FileSystemOperation operation);
+	// Acquires the READ concurrency slot of a read through the handle. With stream slots enabled, the read runs under
+	// the slot the handle keeps, taking one first if it holds none, and stream_lock, deferred on the handle's stream
+	// slot, stays locked until the read is done. A read racing with another one on the same handle takes its own slot.
+	[[nodiscard]] OperationSlot AcquireReadSlot(RateLimitFileHandle &handle,
+	                                            concurrency::unique_lock<concurrency::mutex> &stream_lock);
+	// Returns the trace of an operation's inner calls if it is sampled for tracing, and a disabled one otherwise.
+	OperationTrace GetOperationTrace(FileSystemOperation operation, const RateLimitConfig::RateLimitSnapshot &snapshot,
+	                                 Duration semaphore_wait);
+	// Checks at deadline whether a stream slot has been idle long enough to be given back, and checks again later if
+	// it hasn't.
+	static void ScheduleStreamSlotRelease(weak_ptr<StreamSlot> stream_slot, TimePoint deadline, Duration idle_timeout);
+	// Bytes a call was charged for, so that those it doesn't transfer can be given back, see RefundUntransferred.
+	struct ByteCharge {
+		FileSystemOperation operation = FileSystemOperation::NONE;
+		idx_t bytes = 0;
+		optional_ptr<RateLimiter> connection_limiter;
+		// Only compared against the operation's current limiter, since a config change may have replaced it.
+		const RateLimiter *rate_limiter = nullptr;
+		OperationCost cost;
+	};
+	// Charges the connection limit of the scope, the path rule limiter and then the filesystem-level limit of the
+	// operation, skipping whichever aren't set. If a later limit rejects the call, the earlier ones are refunded.
+	ByteCharge ApplyRateLimit(FileSystemOperation operation, idx_t bytes = 1,
+	                          optional_ptr<const RateLimitScope> scope = nullptr,
+	                          optional_ptr<RateLimiter> path_limiter = nullptr);
+	void ApplyFilesystemRateLimit(FileSystemOperation operation, idx_t bytes, RateLimitPriority priority,
+	                              ByteCharge &charge);
+	// Gives back what a READ or WRITE was charged for the bytes past the transferred ones, once the inner call came
+	// back short or failed, to the connection budget and to the operation's limiter unless it has been replaced. The
+	// call cost and the request and path limiter tokens stay charged, since the request was issued.
+	void RefundUntransferred(const ByteCharge &charge, idx_t transferred);
+	// Runs an inner READ or WRITE call in the slot, giving back the whole charge if it fails. Throttled calls are only
+	// retried if retry is set, which calls through the file pointer mustn't, since they may have moved it already.
+	template <class FUNC>
+	auto TrackTransfer(OperationSlot &slot, const ByteCharge &charge, bool retry, FUNC &&func) -> decltype(func()) {
+		try {
+			return retry ? slot.Track(func) : slot.TrackWithoutRetry(func);
+		} catch (...) {
+			RefundUntransferred(charge, 0);
+			throw;
+		}
+	}
+	// Issue a write to the inner filesystem under the WRITE limits, splitting it in split mode. With write-behind
+	// enabled, these run on the handle's flusher.
+	void WriteAt(RateLimitFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	int64_t WriteAtFilePointer(RateLimitFileHandle &handle, void *buffer, int64_t nr_bytes);
+	// Issues a positional read to the inner filesystem under the READ limits, splitting it in split mode.
+	void ReadAt(RateLimitFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Serves a positional read from cached blocks, fetching every run of missing blocks with one charged read.
+	void ReadThroughBlockCache(RateLimitFileHandle &handle, BlockCache &block_cache, void *buffer, idx_t nr_bytes,
+	                           idx_t location);
+	// Drops everything cached about the file's contents and metadata after a write through the handle.
+	void InvalidateReadState(RateLimitFileHandle &handle);
+	// Returns the metadata cache of the filesystem, nullptr if disabled.
+	shared_ptr<MetadataCache> GetMetadataCache();
+	// Drops the cached metadata, pooled handles and cached blocks of a path changed through the wrapper.
+	void InvalidateMetadata(const string &path);
+	// Drops what InvalidateMetadata does for a directory removed through the wrapper and every path under it.
+	void InvalidateDirectory(const string &directory);
+	// Returns the handle pool of the filesystem, nullptr if disabled.
+	shared_ptr<HandlePool> GetHandlePool();
+	// Returns the version tag a listing or the metadata cache reported for a file, empty if neither did.
+	string GetKnownVersionTag(const OpenFileInfo &file);
+	// Caches the metadata an open or a listing reported for a file, which exists as of now.
+	void CacheListedMetadata(const OpenFileInfo &info, const string &path);
+	// Charges calls against a path rule limiter, one token per call, in the rate limit mode of the operation.
+	void ApplyPathRateLimit(FileSystemOperation operation, RateLimiter &path_limiter, idx_t calls,
+	                        RateLimitPriority priority);
+	// Returns how many files a RemoveFiles call may remove per inner call, so that each sub-batch fits the DELETE
+	// limits of the filesystem and of the files' paths; 0 if unbounded.
+	idx_t GetRemoveBatchSize(const vector<SharedRateLimiter> &path_limiters);
+	// Removes one sub-batch of files, charging one DELETE call per file. path_limiters is empty or holds the path
+	// limiter of every file.
+	void RemoveFileBatch(const vector<string> &filenames, const vector<SharedRateLimiter> &path_limiters,
+	                     optional_ptr<FileOpener> opener);
+	// Charges the pages beyond the first of a listing that returned the given number of entries, and with a cost model
+	// its items. The listing has already happened, so the cost is booked without waiting and delays later LIST calls.
+	void ChargeListPages(idx_t entries, optional_ptr<RateLimiter> path_limiter);
+	// Books the item cost of listed entries without waiting, if LIST has a cost model.
+	void ChargeListItems(idx_t entries);
+	// Returns the limiter of the longest path rule matching the path for the operation, nullptr if none.
+	SharedRateLimiter ResolvePathLimiter(const string &path, FileSystemOperation operation);
 	FileHandle &GetInnerFileHandle(FileHandle &handle);
+	// Returns the chunk size a read or write of the given size must be split into under RateLimitMode::SPLIT, or 0 if
+	// it can be issued as a single inner call.
+	idx_t GetSplitChunkSize(FileSystemOperation operation, idx_t bytes);
+	// Issues one chunk of a split read or write in the given slot, charging it first.
+	using SplitChunkFunction = std::function<void(OperationSlot &slot, idx_t offset, idx_t bytes)>;
+	// Issues the chunks a positional read or write of total_bytes was split into, as many at once as
+	// GetMaxConcurrentTransfers allows, so a chunk's inner call overlaps the token wait of the next. One chunk at a
+	// time runs in the caller's slot, and concurrent ones in slots of their own. If a chunk fails, the remaining ones
+	// aren't issued and its exception is thrown once the running ones returned.
+	void IssueSplitChunks(FileSystemOperation operation, OperationSlot &slot, idx_t total_bytes, idx_t chunk_size,
+	                      const SplitChunkFunction &issue_chunk);
+	// Returns how many transfers of the operation a single call may issue at once: MAX_TRANSFER_THREADS, or the max
+	// requests if lower.
+	idx_t GetMaxConcurrentTransfers(FileSystemOperation operation);
+	// Returns the WRITE bytes a move of the source is charged: its size, from the metadata cache or looked up with a
+	// STAT call, and at least 1. Moves are charged 1 without looking up the size if WRITE has no byte limit.
+	idx_t GetMoveBytes(const string &source, optional_ptr<FileOpener> opener);
+	// Returns how many of the requested bytes lie within the file, which is what a positional read is charged.
+	idx_t GetChargeableReadBytes(RateLimitFileHandle &handle, int64_t nr_bytes, idx_t location);
+
+	// Returns the rate-limit state for an operation from this thread's cached snapshot of the filesystem config, which
+	// is only rebuilt when the config version changes. The reference is valid until the next lookup on this thread.
+	const RateLimitConfig::RateLimitSnapshot &GetOperationSnapshot(FileSystemOperation operation);
+	const RateLimitConfig::FilesystemSnapshot &GetFilesystemSnapshot();
+	// Returns whether the operation has a config or a path rule. Operations without any skip every snapshot and
+	// limiter lookup; a concurrent configuration change may be missed by calls already past the check.
+	bool IsConfigured(FileSystemOperation operation) const;
 
 	string filesystem_name;
 	unique_ptr<FileSystem> inner_fs;
 	shared_ptr<RateLimitConfig> config;
+	// Process-unique id which keys this filesystem in per-thread snapshot caches.
+	const idx_t filesystem_id;
+	// Id of the filesystem name interned in the config, which snapshots are built by.
+	idx_t config_filesystem_id;
+	// Counters reported by rate_limit_fs_stats(), shared with every filesystem of the same name.
+	shared_ptr<FilesystemStats> stats;
+	// Operations with a config or a path rule, maintained by the config.
+	shared_ptr<const atomic<FileSystemOperationMask>> configured_operations;
 };
 
 } // namespace duckdb
@@ -22,6 +22,134 @@ ScalarFunction GetRateLimitFsQuotaFunction();
 // Returns true on success.
 ScalarFunction GetRateLimitFsBurstFunction();
 
+// Scalar function: rate_limit_fs_request_quota(filesystem_name VARCHAR, operation VARCHAR, value BIGINT) -> BOOLEAN
+// Sets the calls per second for read or write operations on a specific filesystem, enforced together with the byte
+// quota, since object stores throttle on request count as well as bytes.
+// - operation: 'read' or 'write'
+// - value: The request quota in calls per second. 0 to disable request rate limiting for this operation.
+// Returns true on success.
+ScalarFunction GetRateLimitFsRequestQuotaFunction();
+
+// Scalar function: rate_limit_fs_shard_lease(filesystem_name VARCHAR, operation VARCHAR, value BIGINT) -> BOOLEAN
+// Shards the rate limiter of an operation on a specific filesystem over per-thread leases, so very high call rates
+// don't contend on the shared limiter state. The long-term rate is unchanged, but bursts may overshoot by up to one
+// lease per shard.
+// - value: Bytes (or calls) a shard leases at once, capped at the burst. 0 to disable sharding.
+// Returns true on success.
+ScalarFunction GetRateLimitFsShardLeaseFunction();
+
+// Scalar function: rate_limit_fs_partitions(filesystem_name VARCHAR, operation VARCHAR, count BIGINT) -> BOOLEAN
+// Splits the rate limiter of an operation on a specific filesystem into per NUMA node partitions, whose bandwidths
+// and bursts are rebalanced by use, so threads of different sockets don't contend on the limiter state.
+// - count: Number of partitions, usually the number of sockets. 0 or 1 to disable partitioning.
+// Returns true on success.
+ScalarFunction GetRateLimitFsPartitionsFunction();
+
+// Scalar function: rate_limit_fs_clock_resolution(filesystem_name VARCHAR, operation VARCHAR, resolution_us BIGINT)
+// -> BOOLEAN
+// Makes the rate limiters of an operation on a specific filesystem read a coarse clock, refreshed in the background,
+// instead of reading the system clock on every acquisition. The long-term rate is unchanged, but calls may be
+// admitted up to one resolution late.
+// - resolution_us: Refresh interval of the clock in microseconds, at most 100000. 0 for the default clock.
+// Returns true on success.
+ScalarFunction GetRateLimitFsClockResolutionFunction();
+
+// Scalar function: rate_limit_fs_max_wait(filesystem_name VARCHAR, operation VARCHAR, max_wait_ms BIGINT) -> BOOLEAN
+// Sets how long calls of an operation in 'bounded' mode may wait for each limiter; calls which would wait longer fail
+// right away without consuming tokens.
+// - max_wait_ms: The max wait in milliseconds. 0 to restore the default of 1 second.
+// Returns true on success.
+ScalarFunction GetRateLimitFsMaxWaitFunction();
+
+// Scalar function: rate_limit_fs_trace(filesystem_name VARCHAR, operation VARCHAR, sample_every BIGINT) -> BOOLEAN
+// Traces one in sample_every calls of an operation, recording the latency of their inner filesystem calls in
+// rate_limit_fs_stats() and logging each one at debug level.
+// - sample_every: 1 to trace every call. 0 to disable tracing.
+// Returns true on success.
+ScalarFunction GetRateLimitFsTraceFunction();
+
+// Scalar function: rate_limit_fs_cost(filesystem_name VARCHAR, operation VARCHAR, call_cost DOUBLE,
+//                                     byte_cost DOUBLE, item_cost DOUBLE) -> BOOLEAN
+// Charges an operation on a specific filesystem by backend cost instead of one token per byte (read, write) or call,
+// so its quota and burst are in cost units. A call costs call_cost, plus byte_cost per byte transferred and
+// item_cost per entry listed or directory level created; items are booked after the call without waiting.
+// - byte_cost: Only for 'read' and 'write'.
+// - item_cost: Only for 'list' and 'mkdir'.
+// Pass 0 as every cost to charge one token per byte or call again. Returns true on success.
+ScalarFunction GetRateLimitFsCostFunction();
+
+// Table function: rate_limit_fs_costs()
+// Returns every operation charged by a cost model, ordered by filesystem and operation.
+// Columns: filesystem VARCHAR, operation VARCHAR, call_cost DOUBLE, byte_cost DOUBLE, item_cost DOUBLE
+TableFunction GetRateLimitFsCostsFunction();
+
+// Scalar function: rate_limit_fs_quota_profile(filesystem_name VARCHAR, operation VARCHAR, start_time VARCHAR,
+//                                              end_time VARCHAR, bandwidth BIGINT, burst BIGINT) -> BOOLEAN
+// Replaces the quota and burst of an operation on a specific filesystem every day from start_time until end_time,
+// given as 'HH:MM' in UTC, e.g. during a nightly backup window. Windows may wrap around midnight but must not overlap.
+// Switching profiles keeps the limiter's accumulated debt.
+// - bandwidth, burst: Limits during the window. 0 for both removes the profile starting at start_time.
+// Returns true on success.
+ScalarFunction GetRateLimitFsQuotaProfileFunction();
+
+// Table function: rate_limit_fs_quota_profiles()
+// Returns all quota profiles, ordered by filesystem, operation and start time.
+// Columns: filesystem VARCHAR, operation VARCHAR, start_time VARCHAR, end_time VARCHAR, bandwidth BIGINT,
+//          burst BIGINT, active BOOLEAN
+TableFunction GetRateLimitFsQuotaProfilesFunction();
+
+// Scalar function: rate_limit_fs_read_ahead(filesystem_name VARCHAR, buffer_size BIGINT, window BIGINT) -> BOOLEAN
+// Coalesces small positional reads on a specific filesystem into buffer_size reads, each charged once, so scans
+// issuing many adjacent small reads need far fewer requests.
+// - buffer_size: Bytes fetched ahead per coalesced read. 0 to disable read-ahead.
+// - window: How many bytes past the end of the previous read a read may start to still be coalesced.
+// Returns true on success.
+ScalarFunction GetRateLimitFsReadAheadFunction();
+
+// Scalar function: rate_limit_fs_stream_slot(filesystem_name VARCHAR, idle_timeout_ms BIGINT) -> BOOLEAN
+// Lets handles of a specific filesystem keep their read concurrency slot between reads, so sequential streams take
+// the read max requests semaphore once rather than on every call. The number of handles holding a slot stays bounded
+// by max requests; a handle gives its slot back when closed or after idle_timeout_ms without a read.
+// - idle_timeout_ms: Milliseconds a handle may go without a read before its slot is released. 0 to disable.
+// Returns true on success.
+ScalarFunction GetRateLimitFsStreamSlotFunction();
+
+// Scalar function: rate_limit_fs_write_behind(filesystem_name VARCHAR, buffer_size BIGINT) -> BOOLEAN
+// Lets handles of a specific filesystem opened for writing accept writes into a buffer of buffer_size bytes, which a
+// shared flusher issues at the write rate, coalescing adjacent writes. Syncing or closing a handle, and every other
+// call on it, waits for its buffered writes first. Applies to handles opened afterwards.
+// - buffer_size: Bytes buffered per handle. 0 to write through.
+// Returns true on success.
+ScalarFunction GetRateLimitFsWriteBehindFunction();
+
+// Scalar function: rate_limit_fs_block_cache(filesystem_name VARCHAR, block_size BIGINT, capacity BIGINT) -> BOOLEAN
+// Caches blocks read from a specific filesystem in memory, keyed by path and version tag, so repeated reads of the
+// same data are served without being charged or reaching the wrapped filesystem. Writes through a handle drop the
+// file's blocks. Reconfiguring replaces the cache with an empty one; handles use the cache only if it was enabled
+// when they were opened.
+// - block_size: Bytes per cached block, and the granularity of reads issued on a miss.
+// - capacity: Memory budget in bytes, least recently used blocks are evicted first. 0 to disable the cache.
+// Returns true on success.
+ScalarFunction GetRateLimitFsBlockCacheFunction();
+
+// Scalar function: rate_limit_fs_metadata_cache(filesystem_name VARCHAR, ttl_ms BIGINT, max_entries BIGINT) -> BOOLEAN
+// Caches the existence, size, modification time, type and version tag of paths on a specific filesystem, so repeated
+// metadata lookups of the same files aren't charged as STAT calls. Entries come from metadata calls, opens and
+// listings that report metadata; writes, truncations, moves and removals through the wrapper drop them.
+// - ttl_ms: How long an entry is used after it was created. 0 to disable the cache.
+// - max_entries: Maximum number of cached paths.
+// Returns true on success.
+ScalarFunction GetRateLimitFsMetadataCacheFunction();
+
+// Scalar function: rate_limit_fs_handle_pool(filesystem_name VARCHAR, ttl_ms BIGINT, capacity BIGINT) -> BOOLEAN
+// Keeps the inner handles of closed read-only files of a specific filesystem open, so reopening one of those files
+// reuses its handle without another open call or OPEN charge. Writes, truncations, moves and removals through the
+// wrapper close the pooled handles of their path, as does a changed version tag.
+// - ttl_ms: How long a closed handle is kept. 0 to disable the pool.
+// - capacity: Maximum number of pooled handles.
+// Returns true on success.
+ScalarFunction GetRateLimitFsHandlePoolFunction();
+
 // Scalar function: rate_limit_fs_clear(filesystem_name VARCHAR, operation VARCHAR) -> BOOLEAN
 // Clears the rate limit configuration for an operation on a specific filesystem.
 // - filesystem_name: The filesystem name, or '*' to clear all filesystems.
@@ -31,9 +159,96 @@ ScalarFunction GetRateLimitFsClearFunction();
 
 // Table function: rate_limit_fs_configs()
 // Returns all configured rate limit settings.
-// Columns: filesystem VARCHAR, operation VARCHAR, quota BIGINT, mode VARCHAR, burst BIGINT
+// Columns: filesystem VARCHAR, operation VARCHAR, quota BIGINT, mode VARCHAR, burst BIGINT, max_requests BIGINT,
+// limiter_group VARCHAR, request_quota BIGINT, read_ahead_buffer BIGINT, read_ahead_window BIGINT, shard_lease BIGINT,
+// max_wait_ms BIGINT, stream_idle_timeout_ms BIGINT, write_behind_buffer BIGINT, trace_sample_every BIGINT
 TableFunction GetRateLimitFsConfigsFunction();
 
+// Scalar function: rate_limit_fs_group(group_name VARCHAR, bandwidth BIGINT, burst BIGINT, parent VARCHAR) -> BOOLEAN
+// Creates or updates a named limiter group shared by all operations assigned to it.
+// - group_name: The group name.
+// - bandwidth: The group bandwidth in bytes per second, 0 for no rate limiting.
+// - burst: The group burst, 0 for no burst limiting. 0 for both bandwidth and burst removes the group.
+// - parent: The parent group every acquisition must pass as well, or '' for a root group.
+// Returns true on success.
+ScalarFunction GetRateLimitFsGroupFunction();
+
+// Scalar function: rate_limit_fs_group_assign(filesystem_name VARCHAR, operation VARCHAR, group_name VARCHAR) ->
+// BOOLEAN Charges an operation on a specific filesystem against a limiter group, on top of its own limits.
+// - group_name: The group name, or '' to unassign the operation.
+// Returns true on success.
+ScalarFunction GetRateLimitFsGroupAssignFunction();
+
+// Table function: rate_limit_fs_groups()
+// Returns all limiter groups, ordered by name.
+// Columns: name VARCHAR, bandwidth BIGINT, burst BIGINT, parent VARCHAR
+TableFunction GetRateLimitFsGroupsFunction();
+
+// Scalar function: rate_limit_fs_path_group(prefix VARCHAR, operation VARCHAR, group_name VARCHAR) -> BOOLEAN
+// Charges every call of an operation on a path starting with the prefix, in any wrapped filesystem, against a limiter
+// group, one token per call. A path matches the rule with its longest prefix. Handles keep the rules they were
+// opened with.
+// - group_name: The group name, or '' to remove the rule.
+// Returns true on success.
+ScalarFunction GetRateLimitFsPathGroupFunction();
+
+// Scalar function: rate_limit_fs_shared_state(directory VARCHAR) -> BOOLEAN
+// Keeps the state of every rate limiter in a memory-mapped file under the directory, so all processes on the host
+// using the same directory share their limits. Existing limiters are rebuilt with the state found there.
+// - directory: A directory, ideally on tmpfs such as '/dev/shm', or '' to keep state in process memory.
+// Returns true on success.
+ScalarFunction GetRateLimitFsSharedStateFunction();
+
+// Table function: rate_limit_fs_path_groups()
+// Returns all path rules, ordered by prefix and operation.
+// Columns: prefix VARCHAR, operation VARCHAR, limiter_group VARCHAR
+TableFunction GetRateLimitFsPathGroupsFunction();
+
+// Table function: rate_limit_fs_block_caches()
+// Returns the state of every block cache, ordered by filesystem.
+// Columns: filesystem VARCHAR, block_size BIGINT, capacity BIGINT, memory_usage BIGINT, blocks BIGINT, hits BIGINT,
+// misses BIGINT
+TableFunction GetRateLimitFsBlockCachesFunction();
+
+// Table function: rate_limit_fs_metadata_caches()
+// Returns the state of every metadata cache, ordered by filesystem.
+// Columns: filesystem VARCHAR, ttl_ms BIGINT, max_entries BIGINT, entries BIGINT, hits BIGINT, misses BIGINT
+TableFunction GetRateLimitFsMetadataCachesFunction();
+
+// Table function: rate_limit_fs_handle_pools()
+// Returns the state of every handle pool, ordered by filesystem.
+// Columns: filesystem VARCHAR, ttl_ms BIGINT, capacity BIGINT, handles BIGINT, hits BIGINT, misses BIGINT
+TableFunction GetRateLimitFsHandlePoolsFunction();
+
+// Table function: rate_limit_fs_stats()
+// Returns admission and wait counters of every wrapped filesystem operation that has seen any activity, ordered by
+// filesystem and operation.
+// Columns: filesystem VARCHAR, operation VARCHAR, ops_admitted BIGINT, bytes_admitted BIGINT, rate_rejections BIGINT,
+// burst_rejections BIGINT, throttled_ops BIGINT, throttle_wait_ns BIGINT, semaphore_wait_ns BIGINT, in_flight BIGINT,
+// wait_histogram BIGINT[], semaphore_wait_histogram BIGINT[], traced_calls BIGINT, inner_latency_ns BIGINT,
+// inner_latency_histogram BIGINT[]
+TableFunction GetRateLimitFsStatsFunction();
+
+// Scalar function: rate_limit_fs_stats_reset() -> BOOLEAN
+// Zeroes all counters reported by rate_limit_fs_stats(), except in_flight.
+// Returns true on success.
+ScalarFunction GetRateLimitFsStatsResetFunction();
+
+// Table function: rate_limit_fs_burst_recommendations()
+// Returns the distribution of request sizes of every wrapped filesystem's read and write operations seen since the
+// stats were last reset, with the current burst and the burst admitting 99% of the requests, ordered by filesystem and
+// operation. Sizes are rounded up to a power of two.
+// Columns: filesystem VARCHAR, operation VARCHAR, requests BIGINT, p50_bytes BIGINT, p90_bytes BIGINT,
+// p99_bytes BIGINT, max_bytes BIGINT, burst BIGINT, recommended_burst BIGINT
+TableFunction GetRateLimitFsBurstRecommendationsFunction();
+
+// Scalar function: rate_limit_fs_auto_burst(filesystem_name VARCHAR, operation VARCHAR, percentile DOUBLE) -> BIGINT
+// Sets the burst of a read or write operation to admit percentile percent of the requests seen since the stats were
+// last reset, in the units of its cost model if it has one.
+// - percentile: Greater than 0 and at most 100.
+// Returns the burst set.
+ScalarFunction GetRateLimitFsAutoBurstFunction();
+
 // Table function: rate_limit_fs_list_filesystems()
 // Lists all registered filesystems in the virtual file system.
 // Columns: name VARCHAR
@@ -43,6 +258,28 @@ TableFunction GetRateLimitFsListFilesystemsFunction();
 // value: -1 for unlimited (default), or a positive integer for the concurrency cap.
 ScalarFunction GetRateLimitFsMaxRequestsFunction();
 
+// rate_limit_fs_adaptive_max_requests(filesystem_name, operation, min_value, max_value) -> BOOLEAN
+// Lets the concurrency cap adapt between min_value and max_value from the latency and throttling errors of the
+// wrapped filesystem. It starts at min_value; rate_limit_fs_max_requests() makes it static again.
+ScalarFunction GetRateLimitFsAdaptiveMaxRequestsFunction();
+
+// rate_limit_fs_throttle_backoff(filesystem_name, operation, min_ratio, recovery_ms, max_retries) -> BOOLEAN
+// Cuts the operation's quota on throttling errors of the wrapped filesystem, down to min_ratio of the configured one,
+// gives it back over recovery_ms steps, and retries throttled calls up to max_retries times with jitter.
+// recovery_ms: 0 disables the backoff.
+ScalarFunction GetRateLimitFsThrottleBackoffFunction();
+
+// Table function: rate_limit_fs_throttle_backoffs()
+// Returns the state of every throttle backoff, ordered by filesystem and operation.
+// Columns: filesystem VARCHAR, operation VARCHAR, min_ratio DOUBLE, recovery_ms BIGINT, max_retries BIGINT,
+// ratio DOUBLE, throttle_errors BIGINT, retries BIGINT
+TableFunction GetRateLimitFsThrottleBackoffsFunction();
+
+// Table function: rate_limit_fs_partition_quotas()
+// Returns the current split of every partitioned rate limiter, ordered by filesystem, operation and partition.
+// Columns: filesystem VARCHAR, operation VARCHAR, partition BIGINT, bandwidth BIGINT, burst BIGINT
+TableFunction GetRateLimitFsPartitionQuotasFunction();
+
 // Scalar function: rate_limit_fs_wrap(filesystem_name VARCHAR) -> BOOLEAN
 // Extracts the specified filesystem from the virtual filesystem registry,
 // wraps it with the rate limit filesystem, and registers the wrapped version.
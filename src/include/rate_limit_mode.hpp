@@ -12,7 +12,17 @@ enum class RateLimitMode : uint8_t {
 	// Wait until the rate limit allows the operation to proceed
 	BLOCKING,
 	// Fail immediately if the rate limit would be exceeded
-	NON_BLOCKING
+	NON_BLOCKING,
+	// Like BLOCKING, but reads and writes larger than the burst are split into burst-sized chunks, each waiting for its
+	// own tokens, instead of failing with insufficient capacity. Positional chunks are issued concurrently, those
+	// through the file pointer one after another
+	SPLIT,
+	// Like BLOCKING, but each acquirer books its slot up front and sleeps until exactly its start time, so waiters are
+	// admitted in FIFO order instead of racing each other once capacity is replenished
+	FAIR,
+	// Like BLOCKING while the wait fits the operation's max wait, and like NON_BLOCKING once it doesn't: requests whose
+	// wait would run past the deadline fail right away, without consuming tokens
+	BOUNDED
 };
 
 // Converts a string to RateLimitMode. Throws on invalid input.
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+namespace duckdb {
+
+// Priority class of a rate-limited request, configured per connection through the rate_limit_fs_priority setting.
+// Both classes share the same bandwidth, but batch requests may only use part of the burst, so interactive requests
+// always find headroom and get admitted ahead of queued batch requests.
+enum class RateLimitPriority : uint8_t {
+	// Latency-sensitive requests, which may use the full burst
+	INTERACTIVE,
+	// Throughput-oriented requests, which leave part of the burst to interactive ones
+	BATCH
+};
+
+// Converts a string to RateLimitPriority. Throws on invalid input.
+RateLimitPriority ParseRateLimitPriority(const string &priority_str);
+
+// Converts RateLimitPriority to string.
+string RateLimitPriorityToString(RateLimitPriority priority);
+
+} // namespace duckdb
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+#include "rate_limit_priority.hpp"
+#include "rate_limiter.hpp"
+
+namespace duckdb {
+
+// Forward declaration.
+class FileOpener;
+
+// Connection-scoped settings, read when a file is opened.
+constexpr const char *RATE_LIMIT_FS_PRIORITY_SETTING = "rate_limit_fs_priority";
+constexpr const char *RATE_LIMIT_FS_CONNECTION_BANDWIDTH_SETTING = "rate_limit_fs_connection_bandwidth";
+
+// Rate-limit state of the connection which opened a file, layered on top of the filesystem-level limits.
+struct RateLimitScope {
+	// Limits reads and writes of every file the connection opens together, nullptr if unlimited.
+	SharedRateLimiter connection_limiter;
+	RateLimitPriority priority = RateLimitPriority::INTERACTIVE;
+
+	// Resolves the scope from the settings of the connection behind the opener. Returns the default scope, with no
+	// connection limit and interactive priority, if the opener has no client context.
+	static RateLimitScope FromOpener(optional_ptr<FileOpener> opener, shared_ptr<BaseClock> clock);
+};
+
+// Per-connection state which owns the connection's limiter, so it lives as long as the connection does and is
+// shared by all of its open files.
+class RateLimitClientState : public ClientContextState {
+public:
+	static constexpr const char *CACHE_KEY = "rate_limit_fs_client_state";
+
+	// Returns the connection limiter for the given bandwidth, which is reused as long as the bandwidth is unchanged.
+	SharedRateLimiter GetConnectionLimiter(idx_t bandwidth, shared_ptr<BaseClock> clock);
+
+private:
+	concurrency::mutex lock;
+	idx_t bandwidth DUCKDB_GUARDED_BY(lock) = 0;
+	SharedRateLimiter limiter DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include <functional>
+
+#include "adaptive_concurrency_limiter.hpp"
+#include "base_clock.hpp"
+#include "counting_semaphore.hpp"
+#include "file_system_operation.hpp"
+#include "throttle_backoff.hpp"
+
+namespace duckdb {
+
+// Point-in-time totals of an OperationStats, summed over all shards.
+struct OperationStatsSnapshot {
+	// Number of buckets of every histogram. Bucket 0 counts durations below 1us, bucket i > 0 counts durations in
+	// [2^(i-1), 2^i) us, and the last bucket also counts everything above.
+	static constexpr idx_t WAIT_HISTOGRAM_BUCKETS = 24;
+	// Number of request size histogram buckets. Bucket 0 counts empty requests, bucket i > 0 counts sizes in
+	// (2^(i-2), 2^(i-1)] bytes, and the last bucket also counts everything above.
+	static constexpr idx_t SIZE_HISTOGRAM_BUCKETS = 48;
+	using WaitHistogram = array<uint64_t, WAIT_HISTOGRAM_BUCKETS>;
+
+	uint64_t ops_admitted = 0;
+	// Net of the bytes given back by calls which transferred fewer than they were admitted for.
+	uint64_t bytes_admitted = 0;
+	// Non-blocking requests rejected because the rate limit was exceeded.
+	uint64_t rate_rejections = 0;
+	// Requests rejected because they exceed the burst capacity.
+	uint64_t burst_rejections = 0;
+	// Admitted requests that had to wait for the rate limiter.
+	uint64_t throttled_ops = 0;
+	uint64_t throttle_wait_nanos = 0;
+	uint64_t semaphore_wait_nanos = 0;
+	// Operations currently inside the filesystem, holding a concurrency slot if max requests is set.
+	int64_t in_flight = 0;
+	// Distribution of rate limiter waits of requests charged against a rate limiter, including ones that didn't wait.
+	WaitHistogram wait_histogram {};
+	// Distribution of concurrency semaphore waits of operations which took a slot.
+	WaitHistogram semaphore_wait_histogram {};
+	// Inner filesystem calls timed by tracing, their total latency and its distribution.
+	uint64_t traced_calls = 0;
+	uint64_t inner_latency_nanos = 0;
+	WaitHistogram inner_latency_histogram {};
+	// Distribution of the bytes of READ and WRITE requests, as charged before split mode cuts them into chunks.
+	array<uint64_t, SIZE_HISTOGRAM_BUCKETS> request_size_histogram {};
+};
+
+// Counters for one (filesystem, operation). Updates go to a per-thread shard, each on its own cache line, so
+// instrumenting the I/O path doesn't add a shared contention point. Reads sum all shards and are only approximately
+// consistent while updates are in flight.
+class OperationStats {
+public:
+	static constexpr idx_t SHARD_COUNT = 16;
+
+	OperationStats();
+
+	OperationStats(const OperationStats &) = delete;
+	OperationStats &operator=(const OperationStats &) = delete;
+
+	void RecordAdmitted(idx_t bytes);
+	// Records admitted bytes a call didn't transfer, which are no longer counted as admitted.
+	void RecordRefunded(idx_t bytes);
+	void RecordRateRejection();
+	void RecordBurstRejection();
+	// Records the rate limiter wait of an admitted request.
+	void RecordThrottleWait(Duration wait);
+	void RecordSemaphoreWait(Duration wait);
+	// Records the latency of a traced inner call.
+	void RecordInnerLatency(Duration latency);
+	// Records the bytes of a READ or WRITE request.
+	void RecordRequestSize(idx_t bytes);
+	// Returns whether to trace the next operation of the calling thread, when one in sample_every is traced.
+	bool ShouldTrace(idx_t sample_every);
+	void IncrementInFlight();
+	void DecrementInFlight();
+
+	OperationStatsSnapshot GetSnapshot() const;
+
+	// Zeroes every counter except the in-flight gauge.
+	void Reset();
+
+	// Returns the histogram bucket of a duration.
+	static idx_t GetWaitBucket(Duration wait);
+	// Returns the end of the durations a histogram bucket counts; for the last bucket, where the ones above begin.
+	static Duration GetWaitBucketUpperBound(idx_t bucket);
+	// Returns the smallest bucket end at or above percentile percent of the durations counted by a histogram, zero
+	// if it is empty. The percentile is in (0, 100].
+	static Duration GetDurationPercentile(const OperationStatsSnapshot::WaitHistogram &histogram, double percentile);
+	// Returns the request size histogram bucket of a size, and the largest size a bucket counts; for the last bucket,
+	// the largest size below it.
+	static idx_t GetSizeBucket(idx_t bytes);
+	static idx_t GetSizeBucketUpperBound(idx_t bucket);
+	// Returns the smallest bucket upper bound at or above the size of percentile percent of the recorded requests, 0
+	// if none were recorded. The percentile is in (0, 100].
+	static idx_t GetRequestSizePercentile(const OperationStatsSnapshot &snapshot, double percentile);
+
+private:
+	struct alignas(64) Shard {
+		atomic<uint64_t> ops_admitted {0};
+		atomic<uint64_t> bytes_admitted {0};
+		atomic<uint64_t> rate_rejections {0};
+		atomic<uint64_t> burst_rejections {0};
+		atomic<uint64_t> throttled_ops {0};
+		atomic<uint64_t> throttle_wait_nanos {0};
+		atomic<uint64_t> semaphore_wait_nanos {0};
+		atomic<int64_t> in_flight {0};
+		array<atomic<uint64_t>, OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS> wait_histogram {};
+		array<atomic<uint64_t>, OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS> semaphore_wait_histogram {};
+		atomic<uint64_t> traced_calls {0};
+		atomic<uint64_t> inner_latency_nanos {0};
+		array<atomic<uint64_t>, OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS> inner_latency_histogram {};
+		array<atomic<uint64_t>, OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS> request_size_histogram {};
+		// Operations started in the shard, which picks the ones to trace. Not a stat, so never reset.
+		atomic<uint64_t> trace_counter {0};
+	};
+
+	// Returns the calling thread's shard.
+	Shard &GetShard();
+
+	array<Shard, SHARD_COUNT> shards;
+};
+
+// Counters for every operation of one filesystem, indexed by FileSystemOperation.
+struct FilesystemStats {
+	explicit FilesystemStats(string filesystem_name_p) : filesystem_name(std::move(filesystem_name_p)) {
+	}
+
+	OperationStats &Get(FileSystemOperation operation) {
+		return operations[static_cast<idx_t>(operation)];
+	}
+
+	const string filesystem_name;
+	array<OperationStats, FILE_SYSTEM_OPERATION_COUNT> operations;
+};
+
+// Tracing of the inner calls of one operation, disabled without a clock.
+struct OperationTrace {
+	shared_ptr<BaseClock> clock;
+	// How long the operation waited for its concurrency slot.
+	Duration semaphore_wait = Duration::zero();
+	// Called with the slot wait and the latency of every traced inner call, if set.
+	std::function<void(Duration semaphore_wait, Duration latency)> callback;
+};
+
+// Holds an operation's concurrency slot, and counts the operation as in flight until destroyed.
+class OperationSlot {
+public:
+	OperationSlot(SemaphoreGuard semaphore_guard_p, OperationStats &stats_p,
+	              shared_ptr<AdaptiveConcurrencyLimiter> adaptive_limiter_p = nullptr,
+	              shared_ptr<ThrottleBackoff> throttle_backoff_p = nullptr, OperationTrace trace_p = OperationTrace());
+	~OperationSlot();
+
+	OperationSlot(const OperationSlot &) = delete;
+	OperationSlot &operator=(const OperationSlot &) = delete;
+
+	// Runs a call to the inner filesystem. If the concurrency limit is adaptive, its latency and outcome are fed back
+	// to the limiter, and if the operation is traced its latency is recorded; rate limiter waits happen outside of it,
+	// so they don't count as backend latency. With a throttle backoff, throttling errors slow down the operation's rate
+	// limiter, and the call is retried as the backoff allows.
+	template <class FUNC>
+	auto Track(FUNC &&func) -> decltype(func()) {
+		return TrackBackoff(func, /*retry=*/true);
+	}
+
+	// Like Track, but a throttled call is never retried, for calls which may have delivered part of their result or
+	// taken part of their effect before failing, such as a listing or a page of one, a read or write through the file
+	// pointer, a move, or a delete, which once through would fail as not found when retried.
+	template <class FUNC>
+	auto TrackWithoutRetry(FUNC &&func) -> decltype(func()) {
+		return TrackBackoff(func, /*retry=*/false);
+	}
+
+private:
+	template <class FUNC>
+	auto TrackBackoff(FUNC &func, bool retry) -> decltype(func()) {
+		if (!throttle_backoff) {
+			return TrackAttempt(func);
+		}
+		for (idx_t attempt = 0;; ++attempt) {
+			try {
+				ThrottleBackoff::SuccessReporter reporter(*throttle_backoff);
+				return TrackAttempt(func);
+			} catch (const std::exception &ex) {
+				const bool throttled = throttle_backoff->OnFailure(ex.what());
+				if (!throttled || !retry || !throttle_backoff->WaitToRetry(attempt)) {
+					throw;
+				}
+			}
+		}
+	}
+
+	template <class FUNC>
+	auto TrackAttempt(FUNC &func) -> decltype(func()) {
+		if (trace.clock) {
+			TracedCall traced_call(*this);
+			return TrackAdaptive(func);
+		}
+		return TrackAdaptive(func);
+	}
+
+	// Records the latency of a traced inner call once it returns or throws.
+	class TracedCall {
+	public:
+		explicit TracedCall(OperationSlot &slot_p) : slot(slot_p), start(slot.trace.clock->Now()) {
+		}
+		~TracedCall() {
+			slot.RecordTrace(slot.trace.clock->Now() - start);
+		}
+
+	private:
+		OperationSlot &slot;
+		const TimePoint start;
+	};
+
+	template <class FUNC>
+	auto TrackAdaptive(FUNC &&func) -> decltype(func()) {
+		if (!adaptive_limiter) {
+			return func();
+		}
+		try {
+			AdaptiveConcurrencyLimiter::SuccessReporter reporter(*adaptive_limiter);
+			return func();
+		} catch (const std::exception &ex) {
+			adaptive_limiter->OnFailure(ex.what());
+			throw;
+		}
+	}
+
+	void RecordTrace(Duration latency);
+
+	SemaphoreGuard semaphore_guard;
+	OperationStats &stats;
+	shared_ptr<AdaptiveConcurrencyLimiter> adaptive_limiter;
+	shared_ptr<ThrottleBackoff> throttle_backoff;
+	OperationTrace trace;
+};
+
+} // namespace duckdb
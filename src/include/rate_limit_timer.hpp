@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Waiter queue which runs callbacks once their deadline has passed, so rate-limited callers can be woken up instead
+// of parking their own thread in SleepUntil.
+//
+// Deadlines are interpreted against the timer's clock. With the default clock a single background thread started
+// by Start() runs due callbacks; with a mock clock, callers drive the queue with RunDueTasks() after advancing time.
+// Callbacks run on the thread that drives the queue, so they must be short and must not block.
+class RateLimitTimer {
+public:
+	using Task = std::function<void()>;
+
+	explicit RateLimitTimer(shared_ptr<BaseClock> clock_p = nullptr);
+	~RateLimitTimer();
+
+	RateLimitTimer(const RateLimitTimer &) = delete;
+	RateLimitTimer &operator=(const RateLimitTimer &) = delete;
+
+	// Schedules a task to run at or after the given deadline.
+	void Schedule(TimePoint deadline, Task task);
+
+	// Runs every task whose deadline is due according to the clock, and returns how many were run.
+	idx_t RunDueTasks();
+
+	// Returns the number of tasks still waiting.
+	idx_t GetPendingCount() const;
+
+	// Returns the clock deadlines are interpreted against.
+	const shared_ptr<BaseClock> &GetClock() const;
+
+	// Starts the background thread, which sleeps until the earliest deadline. Only meaningful with a real clock. Cheap
+	// and lock-free if it's already running.
+	void Start();
+
+	// Stops and joins the background thread. Pending tasks are kept, and run by a later Start() or RunDueTasks().
+	void Stop();
+
+	// Returns the process-wide timer used for asynchronous acquisitions, backed by the default clock and started by the
+	// first call only.
+	static RateLimitTimer &GetDefault();
+
+private:
+	struct ScheduledTask {
+		TimePoint deadline;
+		// Breaks ties in scheduling order, so tasks with the same deadline run first in, first out.
+		idx_t sequence;
+		Task task;
+	};
+
+	struct LaterDeadline {
+		bool operator()(const ScheduledTask &lhs, const ScheduledTask &rhs) const {
+			if (lhs.deadline != rhs.deadline) {
+				return lhs.deadline > rhs.deadline;
+			}
+			return lhs.sequence > rhs.sequence;
+		}
+	};
+
+	// Pops every due task under the lock, so they can be run without holding it.
+	vector<Task> PopDueTasks(TimePoint now) DUCKDB_REQUIRES(lock);
+
+	void RunBackgroundThread();
+
+	shared_ptr<BaseClock> clock;
+	mutable concurrency::mutex lock;
+	std::condition_variable_any cv;
+	// Min-heap on deadline.
+	vector<ScheduledTask> tasks DUCKDB_GUARDED_BY(lock);
+	idx_t next_sequence DUCKDB_GUARDED_BY(lock);
+	// Only written under the lock, but read without it by Start().
+	std::atomic<bool> running;
+	unique_ptr<thread> background_thread;
+};
+
+} // namespace duckdb
@@ -1,17 +1,25 @@
 #pragma once
 
 #include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/array.hpp"
 #include "duckdb/common/atomic.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/mutex.hpp"
+#include "duckdb/common/optional_ptr.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
 
+#include <functional>
+#include <future>
 #include <optional>
 
 #include "base_clock.hpp"
+#include "mutex.hpp"
+#include "rate_limit_priority.hpp"
+#include "rate_limit_timer.hpp"
 
 namespace duckdb {
 
@@ -25,8 +33,15 @@ shared_ptr<BaseClock> CreateDefaultClock();
 // - bandwidth = 0: no rate limiting (requests pass immediately without timing)
 // - burst = 0: no burst limiting (any request size allowed)
 // - both = 0: error (nothing to limit)
+//
+// The emission interval is precomputed once as a fixed-point number of nanoseconds with EMISSION_FRACTION_BITS
+// fractional bits, so costing a request is a multiplication, and bandwidths above 1 GB/s, whose interval is a fraction
+// of a nanosecond, are still enforced exactly.
 class Quota {
 public:
+	// Fractional bits of the fixed-point emission interval.
+	static constexpr idx_t EMISSION_FRACTION_BITS = 32;
+
 	// Creates a quota with the specified bandwidth and burst.
 	// Throws InvalidInputException if both bandwidth and burst are 0.
 	Quota(idx_t bandwidth_p, idx_t burst_p);
@@ -43,29 +58,63 @@ public:
 	// Returns true if burst limiting is enabled (burst > 0).
 	bool HasBurstLimiting() const;
 
-	// Returns the emission interval (time between each byte).
+	// Returns the emission interval (time between each byte), rounded down to whole nanoseconds.
 	Duration GetEmissionInterval() const;
 
 	// Returns the delay tolerance (maximum time that can be "borrowed").
 	Duration GetDelayTolerance() const;
 
+	// Returns the time n bytes take at the configured bandwidth in nanoseconds, rounded down and saturated at an
+	// interval far beyond any realistic wait. 0 if rate limiting is disabled.
+	int64_t GetEmissionNanos(idx_t n) const;
+
+	// Returns the delay tolerance in nanoseconds, the maximum int64_t if rate limiting is disabled.
+	int64_t GetDelayToleranceNanos() const;
+
+	// Returns the fixed-point emission interval, 0 if rate limiting is disabled.
+	uint64_t GetEmissionIntervalFixed() const;
+
+	// Returns the time n bytes take at a fixed-point emission interval, see GetEmissionNanos.
+	static int64_t ScaleEmissionNanos(uint64_t emission_interval_fixed, idx_t n);
+
 private:
 	idx_t bandwidth;
 	idx_t burst;
+	// Nanoseconds per byte, scaled by 2^EMISSION_FRACTION_BITS and rounded up.
+	uint64_t emission_interval_fixed;
+	int64_t delay_tolerance_nanos;
 };
 
 // Internal state for the GCRA rate limiter.
 // Manages the Theoretical Arrival Time (TAT) which represents when the next cell (byte)
 // is expected to arrive according to the configured rate.
+//
+// The state is the limiter's backend: every acquisition is a read followed by a CAS on the TAT, so the limiter is
+// shared by everyone who shares the state. LocalRateLimiterState keeps it in process memory, other implementations
+// can keep it somewhere several processes see, as long as the operations are atomic and TATs are interpreted against
+// a clock every sharer agrees on.
 class RateLimiterState {
 public:
-	RateLimiterState();
+	virtual ~RateLimiterState() = default;
 
 	// Returns the current TAT as nanoseconds since epoch.
-	int64_t GetTatNanos() const;
+	virtual int64_t GetTatNanos() const = 0;
+
+	// Atomically compares and swaps the TAT value. Returns true if the swap succeeded; may fail spuriously, so callers
+	// retry in a loop.
+	virtual bool CompareExchangeTat(int64_t &expected, int64_t desired) = 0;
+};
+
+// State private to one limiter in this process.
+//
+// Aligned to a cache line of its own, so CAS traffic on the TAT doesn't also invalidate the quota and clock every
+// acquisition reads. The TAT publishes no other data, so every access is relaxed.
+class alignas(64) LocalRateLimiterState final : public RateLimiterState {
+public:
+	LocalRateLimiterState();
 
-	// Atomically compares and swaps the TAT value. Returns true if the swap succeeded.
-	bool CompareExchangeTat(int64_t &expected, int64_t desired);
+	int64_t GetTatNanos() const override;
+	bool CompareExchangeTat(int64_t &expected, int64_t desired) override;
 
 private:
 	atomic<int64_t> tat_nanos;
@@ -97,17 +146,87 @@ struct WaitInfo {
 // - Is lock-free for the common case (using atomic operations)
 //
 // See https://en.wikipedia.org/wiki/Generic_cell_rate_algorithm
-class RateLimiter {
+//
+// A rate limiter may have a parent, e.g. a host-wide budget shared by several filesystems. An acquisition then has
+// to pass every level of the chain: it is admitted only if all levels admit it, and if any level rejects it the
+// capacity already reserved on the levels below is given back, so a rejected request consumes nothing anywhere.
+//
+// With a shard lease, blocking and non-blocking acquisitions of up to shard_lease bytes are served from per-thread
+// shards: a shard draws shard_lease bytes from the chain in one acquisition and hands them out locally, without
+// touching the TAT or reading the clock. Leased bytes are already charged, so the long-term rate is unchanged, but a
+// burst may exceed the configured one by roughly LEASE_SHARD_COUNT * shard_lease bytes, and bytes left in a shard are
+// only spent once its threads acquire again. Fair acquisitions, refunds and charges always go to the chain. Bytes
+// leased more than LEASE_EXPIRY_NANOS ago are given back to the chain by the next lease of any shard, so a thread
+// going idle doesn't hold on to its lease, and all leased bytes are given back when the limiter is destroyed.
+//
+// A partitioned limiter splits its bandwidth over sub-limiters with a TAT of their own, one per NUMA node modulo the
+// partition count, so the threads of one socket never contend with another socket's on a cache line. Every acquisition,
+// refund and charge goes to the calling thread's partition. Each PARTITION_REBALANCE_NANOS, the bandwidth is split
+// again: partitions which used less than SATURATED_SHARE_RATIO of their share keep twice what they used, the rest is
+// split evenly among the others, and every partition keeps at least 1/MIN_SHARE_DIVISOR of an even split. The partition
+// bandwidths always add up to the configured one, so the aggregate rate stays exact. The burst is split by the same
+// shares, but requests are only rejected if they exceed the configured burst: an idle partition admits one request
+// beyond its share, like any GCRA level admits one beyond its tolerance, so partitions together admit at most the
+// configured burst plus one request each at once. FIFO order of fair acquisitions only holds within a partition.
+// Partitions share the limiter's parent and clock, and a partitioned limiter must not be the parent of another one.
+class RateLimiter : public enable_shared_from_this<RateLimiter> {
 public:
-	// Creates a rate limiter with the specified quota and optional clock implementation.
-	explicit RateLimiter(const Quota &quota_p, shared_ptr<BaseClock> clock_p = nullptr);
+	// Invoked with the outcome of an asynchronous acquisition.
+	using AcquireCallback = std::function<void(RateLimitResult)>;
+
+	// Batch requests are admitted only while at least 1/BATCH_TOLERANCE_DIVISOR of the delay tolerance is unused.
+	static constexpr int64_t BATCH_TOLERANCE_DIVISOR = 2;
 
-	// Creates a shared rate limiter with the specified quota and optional clock.
-	static shared_ptr<RateLimiter> Direct(const Quota &quota_p, shared_ptr<BaseClock> clock_p = nullptr);
+	// Number of shards leased bytes are spread over.
+	static constexpr idx_t LEASE_SHARD_COUNT = 16;
+
+	// Age after which the bytes left in a shard's lease are given back.
+	static constexpr int64_t LEASE_EXPIRY_NANOS = 10 * 1000 * 1000;
+
+	// Most partitions a limiter may be split into.
+	static constexpr idx_t MAX_PARTITIONS = 64;
+
+	// Interval between two splits of a partitioned limiter's bandwidth.
+	static constexpr int64_t PARTITION_REBALANCE_NANOS = 10 * 1000 * 1000;
+
+	// Fraction of its share a partition has to use to count as saturated.
+	static constexpr double SATURATED_SHARE_RATIO = 0.9;
+
+	// Every partition keeps at least 1/MIN_SHARE_DIVISOR of an even split, so it can ramp up without waiting.
+	static constexpr idx_t MIN_SHARE_DIVISOR = 8;
+
+	// Creates a rate limiter with the specified quota, optional clock implementation, optional parent, optional shard
+	// lease in bytes (0 for none), optional state (nullptr for a LocalRateLimiterState) and optional partition count
+	// (0 or 1 for none). The lease is capped at the effective burst of the chain, and applies to every partition.
+	// Partitions start from the state's debt, and leave theirs in it when the limiter is destroyed. Throws
+	// InvalidInputException for more than MAX_PARTITIONS partitions.
+	explicit RateLimiter(const Quota &quota_p, shared_ptr<BaseClock> clock_p = nullptr,
+	                     shared_ptr<RateLimiter> parent_p = nullptr, idx_t shard_lease_p = 0,
+	                     shared_ptr<RateLimiterState> state_p = nullptr, idx_t partition_count_p = 0);
+
+	// Creates a shared rate limiter with the specified quota, optional clock, optional parent, optional shard lease,
+	// optional state and optional partition count.
+	static shared_ptr<RateLimiter> Direct(const Quota &quota_p, shared_ptr<BaseClock> clock_p = nullptr,
+	                                      shared_ptr<RateLimiter> parent_p = nullptr, idx_t shard_lease_p = 0,
+	                                      shared_ptr<RateLimiterState> state_p = nullptr, idx_t partition_count_p = 0);
+
+	// Gives back all leased bytes not yet handed out.
+	~RateLimiter();
 
 	// Blocking mode: Waits until n bytes can be transmitted.
-	// Returns Allowed on success, InsufficientCapacity if n > burst (when burst limiting is enabled).
-	RateLimitResult UntilNReady(idx_t n);
+	// Returns Allowed on success, InsufficientCapacity if n > burst of any level (when burst limiting is enabled).
+	RateLimitResult UntilNReady(idx_t n, RateLimitPriority priority = RateLimitPriority::INTERACTIVE);
+
+	// Fair blocking mode: books the earliest free slot for n bytes on every level right away, then sleeps until that
+	// slot starts. Slots are handed out in the order acquirers arrive, so waits are FIFO and deterministic, and no
+	// waiter has to retry after waking up. Returns InsufficientCapacity if n > burst of any level.
+	RateLimitResult UntilNReadyFair(idx_t n, RateLimitPriority priority = RateLimitPriority::INTERACTIVE);
+
+	// Bounded blocking mode: waits until n bytes can be transmitted, as long as that happens no later than deadline.
+	// Returns std::nullopt once admitted. Otherwise nothing is consumed, and the WaitInfo tells when the request could
+	// have been admitted, with wait_duration == Duration::max() if n > burst of any level.
+	std::optional<WaitInfo> UntilNReadyBy(idx_t n, TimePoint deadline,
+	                                      RateLimitPriority priority = RateLimitPriority::INTERACTIVE);
 
 	// Non-blocking mode: Tries to acquire permission for n bytes without waiting.
 	//
@@ -117,38 +236,214 @@ public:
 	//   The wait_duration indicates how long to wait before the operation can proceed
 	// - WaitInfo with wait_duration == Duration::max(): Burst capacity is exceeded
 	//   This indicates the request size (n) exceeds the configured burst limit and cannot proceed
-	std::optional<WaitInfo> TryAcquireImmediate(idx_t n);
+	std::optional<WaitInfo> TryAcquireImmediate(idx_t n, RateLimitPriority priority = RateLimitPriority::INTERACTIVE);
+
+	// Gives back n bytes acquired earlier on every level of the chain, e.g. when the request was rejected further
+	// down the line and never issued, or transferred fewer bytes than it acquired. Bytes the limiter has earned back
+	// by the time of the refund aren't given back again.
+	void Refund(idx_t n);
+
+	// Books n bytes on every level of the chain without waiting and regardless of the burst, for costs which are only
+	// known once a request has completed. Later acquisitions wait for them, as if they had been acquired up front.
+	void Charge(idx_t n);
+
+	// Asynchronous blocking mode: invokes the callback once n bytes can be transmitted, without parking the calling
+	// thread. The callback runs inline if the request is admitted (or exceeds the burst) right away, otherwise on the
+	// timer's thread once enough capacity has been replenished. Callers able to yield, such as a DuckDB task holding
+	// an InterruptState, can return BLOCKED and reschedule themselves from the callback.
+	//
+	// Wait deadlines come from this limiter's clock, so the timer must use the same clock; nullptr selects
+	// RateLimitTimer::GetDefault(). The limiter must be owned by a shared_ptr.
+	void AcquireAsync(idx_t n, AcquireCallback callback, optional_ptr<RateLimitTimer> timer = nullptr);
+
+	// Returns a future which is fulfilled once n bytes can be transmitted, see AcquireAsync.
+	std::future<RateLimitResult> AcquireFuture(idx_t n, optional_ptr<RateLimitTimer> timer = nullptr);
+
+	// Replaces the quota in place, so every holder of the limiter, including in-flight operations, sees the new limits
+	// right away. The TAT is kept, with its debt beyond now rescaled from the old rate to the new one, so a retune
+	// neither forgives accumulated debt nor hands out a fresh burst. Acquisitions racing with the update may be
+	// judged against a mix of the old and new limits. The shard lease is capped at the new effective burst.
+	void SetQuota(const Quota &quota_p);
 
-	// Returns the configured quota.
-	const Quota &GetQuota() const;
+	// Returns the current quota.
+	Quota GetQuota() const;
 
 	// Returns the clock used by this rate limiter.
 	const shared_ptr<BaseClock> &GetClock() const;
 
+	// Returns the parent rate limiter, or nullptr for the root of a chain.
+	const shared_ptr<RateLimiter> &GetParent() const;
+
+	// Returns the smallest burst across this limiter and all its ancestors, or 0 if no level limits the burst.
+	idx_t GetEffectiveBurst() const;
+
+	// Returns the bytes a shard leases at once, 0 if acquisitions aren't sharded.
+	idx_t GetShardLease() const;
+
+	// Returns the TAT state.
+	const shared_ptr<RateLimiterState> &GetState() const;
+
+	// Returns the leased bytes not yet handed out, summed over all shards.
+	idx_t GetLeasedBytes() const;
+
+	// Gives back the bytes left in leases older than LEASE_EXPIRY_NANOS to the chain, and returns their number.
+	idx_t ReturnExpiredLeases();
+
+	// Returns the number of partitions, 0 if the limiter isn't partitioned.
+	idx_t GetPartitionCount() const;
+
+	// Returns the index of the calling thread's partition, 0 if the limiter isn't partitioned.
+	idx_t GetLocalPartitionIndex() const;
+
+	// Returns the current quota of a partition.
+	Quota GetPartitionQuota(idx_t index) const;
+
+	// Splits the bandwidth over the partitions again, from their use since the last split. Acquisitions do so every
+	// PARTITION_REBALANCE_NANOS.
+	void RebalancePartitions();
+
 private:
 	struct AcquireDecision {
 		bool allowed;
 		std::optional<WaitInfo> wait_info;
 	};
 
+	// Lock-free copy of the quota read by acquisitions, with the same accessors, updated in place by SetQuota.
+	class LiveQuota {
+	public:
+		explicit LiveQuota(const Quota &quota_p);
+
+		void Store(const Quota &quota_p);
+
+		// Stores a quota whose requests are checked against burst_p instead of its own burst.
+		void Store(const Quota &quota_p, idx_t burst_p);
+
+		bool HasRateLimiting() const {
+			return emission_interval_fixed.load(std::memory_order_relaxed) != 0;
+		}
+		bool HasBurstLimiting() const {
+			return GetBurst() != 0;
+		}
+		idx_t GetBurst() const {
+			return burst.load(std::memory_order_relaxed);
+		}
+		int64_t GetEmissionNanos(idx_t n) const {
+			return Quota::ScaleEmissionNanos(emission_interval_fixed.load(std::memory_order_relaxed), n);
+		}
+		int64_t GetDelayToleranceNanos() const {
+			return delay_tolerance_nanos.load(std::memory_order_relaxed);
+		}
+
+	private:
+		atomic<idx_t> burst;
+		atomic<uint64_t> emission_interval_fixed;
+		atomic<int64_t> delay_tolerance_nanos;
+	};
+
+	// Leased bytes of one shard, on a cache line of its own.
+	struct alignas(64) LeaseShard {
+		atomic<int64_t> tokens {0};
+		// Time of the shard's latest lease, in nanoseconds since epoch.
+		atomic<int64_t> leased_at_nanos {0};
+	};
+
+	// Sub-limiter of one partition, on a cache line of its own.
+	struct alignas(64) Partition {
+		shared_ptr<RateLimiter> limiter;
+		// Bytes requested from the partition since the last split.
+		atomic<idx_t> demand {0};
+	};
+
 	// Converts a TimePoint to nanoseconds since epoch.
 	static int64_t ToNanos(TimePoint tp);
 
 	// Converts nanoseconds since epoch to a TimePoint.
 	static TimePoint FromNanos(int64_t nanos);
 
+	// Returns the delay tolerance requests of the given priority may use, in nanoseconds.
+	int64_t GetToleranceNanos(RateLimitPriority priority) const;
+
 	// Tries to acquire rate limit at a specific time point.
-	AcquireDecision TryAcquire(TimePoint now, idx_t n);
+	AcquireDecision TryAcquire(TimePoint now, idx_t n, RateLimitPriority priority);
+
+	// Tries to acquire rate limit on every level of the chain at a specific time point, all or nothing.
+	AcquireDecision TryAcquireChain(TimePoint now, idx_t n, RateLimitPriority priority);
+
+	// Takes n bytes from the calling thread's shard, returning false if it holds fewer.
+	bool TryTakeLeased(idx_t n);
+
+	// Like TryAcquireChain, but leases a whole shard_lease for requests smaller than it and keeps the rest in the
+	// calling thread's shard. Falls back to acquiring just n bytes if the lease isn't available.
+	AcquireDecision TryAcquireLeasing(TimePoint now, idx_t n, RateLimitPriority priority);
+
+	// Gives back the bytes left in leases taken before the given time, in nanoseconds since epoch, and returns their
+	// number.
+	idx_t ReturnLeases(int64_t leased_before_nanos);
+
+	// Unconditionally books n bytes at the earliest time they can be admitted, and returns that time as nanoseconds
+	// since epoch.
+	int64_t Reserve(TimePoint now, idx_t n, RateLimitPriority priority);
+
+	// Gives back n bytes reserved by a successful TryAcquire on this level only, moving the TAT back no further than
+	// now.
+	void RefundLevel(idx_t n);
+
+	// Returns true if n exceeds the burst of any level of the chain.
+	bool ExceedsBurst(idx_t n) const;
+
+	// Like SetQuota, but requests are checked against burst_p instead of the quota's burst.
+	void SetQuota(const Quota &quota_p, idx_t burst_p);
+
+	// Returns true if any level of the chain limits the rate.
+	bool ChainHasRateLimiting() const;
+
+	// Returns the requested shard lease capped at the effective burst, 0 if that's too small to be worth leasing.
+	idx_t GetCappedShardLease() const;
+
+	// Returns the calling thread's partition with n bytes added to its demand, after splitting the bandwidth again if
+	// that's due. nullptr if the limiter isn't partitioned.
+	RateLimiter *GetLocalPartition(idx_t n);
+
+	// Splits the bandwidth from the partitions' use since the last split.
+	void RebalancePartitions(int64_t now_nanos) DUCKDB_REQUIRES(quota_lock);
+
+	// Sets the quota of every partition from the configured quota and the partition shares.
+	void ApplyPartitionShares() DUCKDB_REQUIRES(quota_lock);
+
+	// Moves the TAT of the limiter's own state to where the partitions' debts put it at the configured rate, so that a
+	// limiter rebuilt from the state starts from their debt.
+	void StorePartitionDebt(int64_t now_nanos) DUCKDB_REQUIRES(quota_lock);
 
-	Quota quota;
+	LiveQuota quota;
 	shared_ptr<BaseClock> clock;
-	unique_ptr<RateLimiterState> state;
+	shared_ptr<RateLimiter> parent;
+	shared_ptr<RateLimiterState> state;
+	// Shard lease as requested, before capping.
+	const idx_t requested_shard_lease;
+	atomic<idx_t> shard_lease;
+	// nullptr unless a shard lease was requested and the limiter isn't partitioned.
+	unique_ptr<array<LeaseShard, LEASE_SHARD_COUNT>> lease_shards;
+	// Empty unless the limiter is partitioned. Fixed at construction.
+	vector<Partition> partitions;
+	// Time of the next split of a partitioned limiter's bandwidth, in nanoseconds since epoch.
+	atomic<int64_t> next_rebalance_nanos;
+	// Serializes SetQuota and partition splits.
+	mutable concurrency::mutex quota_lock;
+	// The quota as configured, for GetQuota.
+	Quota configured_quota DUCKDB_GUARDED_BY(quota_lock);
+	// Fraction of the configured bandwidth each partition gets, adding up to 1.
+	vector<double> partition_shares DUCKDB_GUARDED_BY(quota_lock);
+	// Time of the latest split, in nanoseconds since epoch.
+	int64_t last_rebalance_nanos DUCKDB_GUARDED_BY(quota_lock);
 };
 
 // Shared rate limiter type for thread-safe access across multiple threads/operations.
 using SharedRateLimiter = shared_ptr<RateLimiter>;
 
-// Creates a shared rate limiter with the specified bandwidth, burst, and optional clock.
-SharedRateLimiter CreateRateLimiter(idx_t bandwidth_p, idx_t burst_p, shared_ptr<BaseClock> clock_p = nullptr);
+// Creates a shared rate limiter with the specified bandwidth, burst, optional clock, optional parent, optional shard
+// lease, optional state and optional partition count.
+SharedRateLimiter CreateRateLimiter(idx_t bandwidth_p, idx_t burst_p, shared_ptr<BaseClock> clock_p = nullptr,
+                                    SharedRateLimiter parent_p = nullptr, idx_t shard_lease_p = 0,
+                                    shared_ptr<RateLimiterState> state_p = nullptr, idx_t partition_count_p = 0);
 
 } // namespace duckdb
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include "rate_limiter.hpp"
+
+namespace duckdb {
+
+// Rate limiter state kept in a memory-mapped file, so every process on the host which maps the same file shares one
+// TAT, and a quota holds across all of them rather than per process.
+//
+// The file holds the TAT as a lock-free atomic, updated with the same CAS as LocalRateLimiterState; a new file starts
+// out zeroed, which is a full bucket. TATs are in nanoseconds of the default clock, which is the host-wide monotonic
+// clock, so sharers must use it (a mock clock only makes sense within one process). Sharers should also configure the
+// same quota, since each one interprets the shared TAT with its own emission interval.
+//
+// The monotonic clock starts over at boot, so a TAT left over from before a reboot would lie about the previous uptime
+// in the future. The file therefore also records the boot time, as the system clock minus the monotonic clock, and the
+// first mapping to see one more than BOOT_TIME_TOLERANCE off resets the TAT to a full bucket. A system clock step
+// beyond the tolerance resets it as well, which only forgives the current debt.
+//
+// Only supported on POSIX systems; construction throws NotImplementedException elsewhere.
+class SharedMemoryRateLimiterState final : public RateLimiterState {
+public:
+	// Maps the state file for the key in the directory, creating it if needed. Keys are mapped to file names
+	// deterministically, so every process using the same directory and key shares the state.
+	// Throws IOException if the file can't be created or mapped.
+	SharedMemoryRateLimiterState(const string &directory, const string &key);
+	~SharedMemoryRateLimiterState() override;
+
+	SharedMemoryRateLimiterState(const SharedMemoryRateLimiterState &) = delete;
+	SharedMemoryRateLimiterState &operator=(const SharedMemoryRateLimiterState &) = delete;
+
+	int64_t GetTatNanos() const override;
+	bool CompareExchangeTat(int64_t &expected, int64_t desired) override;
+
+	// Returns the path of the state file.
+	const string &GetPath() const;
+
+	// Returns the file name used for a key: the key with every character other than letters, digits, '-' and '_'
+	// replaced by '_', followed by a hash of the original key so distinct keys never collide.
+	static string GetFileName(const string &key);
+
+	// Size of a state file, one cache line.
+	static constexpr idx_t FILE_SIZE = 64;
+	// How far the boot time recorded in a file may be off the current one, in seconds, for its TAT to be kept. Covers
+	// the drift between the system and the monotonic clock.
+	static constexpr int64_t BOOT_TIME_TOLERANCE = 60;
+
+	// Layout of a state file.
+	struct Layout {
+		atomic<int64_t> tat_nanos;
+		// System clock seconds at which the monotonic clock read zero, 0 in a new file.
+		atomic<int64_t> boot_time;
+	};
+
+private:
+	string path;
+	void *mapping;
+	atomic<int64_t> *tat_nanos;
+};
+
+// Creates the shared state for a key, or returns nullptr if directory is empty.
+shared_ptr<RateLimiterState> CreateSharedMemoryRateLimiterState(const string &directory, const string &key);
+
+} // namespace duckdb
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <exception>
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/random_engine.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include "base_clock.hpp"
+#include "mutex.hpp"
+#include "rate_limiter.hpp"
+
+namespace duckdb {
+
+// Point-in-time state of a ThrottleBackoff.
+struct ThrottleBackoffStats {
+	double min_ratio = 0;
+	Duration recovery_interval {0};
+	idx_t max_retries = 0;
+	// Fraction of the configured quota currently in effect.
+	double ratio = 1;
+	uint64_t throttle_errors = 0;
+	uint64_t retries = 0;
+};
+
+// Closes the loop between the backend's throttling responses and an operation's rate limiter, so that it converges
+// on the backend's actual capacity instead of admitting requests at the static quota into a throttle storm.
+//
+// Each throttling error (see AdaptiveConcurrencyLimiter::IsThrottleError) cuts the limiter's quota by BACKOFF_RATIO,
+// down to min_ratio of the configured quota. Cuts apply at most once per DECREASE_COOLDOWN_DIVISOR-th of the recovery
+// interval, since requests admitted before a cut still fail against the old rate. After every recovery interval
+// without throttling errors, RECOVERY_STEP of the configured quota is given back. The failed call may also be retried
+// up to max_retries times, after a delay drawn uniformly from [0, RETRY_BASE_DELAY * 2^attempt], capped at the
+// recovery interval, so retries of concurrent calls don't arrive together. Retries hold on to the call's concurrency
+// slot and tokens. Thread-safe.
+class ThrottleBackoff {
+public:
+	static constexpr double BACKOFF_RATIO = 0.5;
+	static constexpr double RECOVERY_STEP = 0.1;
+	static constexpr int64_t DECREASE_COOLDOWN_DIVISOR = 4;
+	static constexpr Duration RETRY_BASE_DELAY = std::chrono::milliseconds(50);
+
+	// Throws InvalidInputException unless 0 < min_ratio <= 1 and recovery_interval is positive.
+	ThrottleBackoff(double min_ratio, Duration recovery_interval, idx_t max_retries, shared_ptr<BaseClock> clock);
+
+	ThrottleBackoff(const ThrottleBackoff &) = delete;
+	ThrottleBackoff &operator=(const ThrottleBackoff &) = delete;
+
+	// Makes the backoff scale the given limiter, whose configured quota and burst they are, and applies the current
+	// ratio to it right away. Called whenever the config rebuilds or retunes the limiter. A nullptr limiter detaches
+	// the backoff, so it no longer changes any limiter, e.g. once it's replaced or the operation only has a group.
+	void Attach(SharedRateLimiter limiter, idx_t quota, idx_t burst);
+
+	// Records a call which completed, giving back quota if a recovery interval passed since the last change.
+	void OnSuccess();
+
+	// Records a call which failed with the given error, cutting the quota if it's a throttling error. Returns whether
+	// it was one.
+	bool OnFailure(const string &error_message);
+
+	// Sleeps off the delay before retrying a throttled call which already made attempt retries, and returns true, or
+	// returns false right away once it used up max_retries.
+	bool WaitToRetry(idx_t attempt);
+
+	// Reports a call to the inner filesystem as a success unless it exits by exception.
+	class SuccessReporter {
+	public:
+		explicit SuccessReporter(ThrottleBackoff &backoff_p);
+		~SuccessReporter();
+
+	private:
+		ThrottleBackoff &backoff;
+		const int uncaught_exceptions;
+	};
+
+	ThrottleBackoffStats GetStats() const;
+
+private:
+	// Gives back RECOVERY_STEP for every recovery interval passed since the last change.
+	void Recover(TimePoint now) DUCKDB_REQUIRES(lock);
+	// Pushes the scaled quota to the attached limiter.
+	void Apply() DUCKDB_REQUIRES(lock);
+
+	const double min_ratio;
+	const Duration recovery_interval;
+	const idx_t max_retries;
+	const shared_ptr<BaseClock> clock;
+
+	mutable concurrency::mutex lock;
+	SharedRateLimiter limiter DUCKDB_GUARDED_BY(lock);
+	idx_t quota DUCKDB_GUARDED_BY(lock);
+	idx_t burst DUCKDB_GUARDED_BY(lock);
+	double ratio DUCKDB_GUARDED_BY(lock);
+	TimePoint last_change DUCKDB_GUARDED_BY(lock);
+	TimePoint last_decrease DUCKDB_GUARDED_BY(lock);
+	bool decreased DUCKDB_GUARDED_BY(lock);
+	RandomEngine random_engine DUCKDB_GUARDED_BY(lock);
+	// Skips taking the lock on every success while the full quota is in effect.
+	atomic<bool> backed_off;
+	atomic<uint64_t> throttle_errors;
+	atomic<uint64_t> retries;
+};
+
+} // namespace duckdb
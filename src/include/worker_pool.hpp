@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+#include "duckdb/common/deque.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "mutex.hpp"
+
+namespace duckdb {
+
+// Fixed set of worker threads, started on first use and kept for later calls, which help callers run a task
+// concurrently or run tasks in the background. With RunConcurrently, the caller always runs the task itself, so it
+// makes progress even while every worker is busy with other callers, and copies of the task no worker has picked up by
+// the time the caller's run returns are dropped.
+//
+// A worker that can't be started, e.g. because the process is out of threads, is simply missing: the pool keeps
+// running tasks on the workers it has, and callers run them themselves without any.
+class WorkerPool {
+public:
+	using Task = std::function<void()>;
+
+	explicit WorkerPool(idx_t thread_count_p);
+	// Stops and joins the workers, dropping submitted tasks no worker picked up. No RunConcurrently may be in flight.
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	// Runs the task on the calling thread, and offers up to count - 1 copies of it to the workers, then returns once
+	// every copy started has returned. The task must be safe to run concurrently, and to run fewer than count times,
+	// e.g. by taking work items from a shared counter until none are left. If any run throws, the first exception is
+	// thrown once the others have returned.
+	void RunConcurrently(idx_t count, const Task &task);
+
+	// Queues the task for the next idle worker, starting one if needed and the pool isn't full. Returns false without
+	// queueing it if the pool has no worker and can't start one, so the caller can run it itself. The task must not
+	// throw; an exception it throws anyway is dropped.
+	bool Submit(Task task);
+
+	// Returns the number of workers started so far.
+	idx_t GetStartedCount() const;
+
+private:
+	// One RunConcurrently call, on the caller's stack.
+	struct Batch {
+		const Task *task;
+		// Copies workers are running.
+		idx_t running = 0;
+		std::exception_ptr error;
+	};
+
+	// A copy offered by RunConcurrently, or a task of Submit without a batch.
+	struct PendingTask {
+		Batch *batch;
+		Task task;
+	};
+
+	// Starts workers until idle ones can pick up every pending task, or the pool is full.
+	void StartWorkers() DUCKDB_REQUIRES(lock);
+
+	void RunWorker();
+
+	const idx_t thread_count;
+	mutable concurrency::mutex lock;
+	// Signalled when tasks are queued or the pool stops.
+	std::condition_variable_any work_cv;
+	// Signalled when a batch's last running copy returns.
+	std::condition_variable_any done_cv;
+	// One entry per copy offered or task submitted and not yet picked up.
+	deque<PendingTask> pending DUCKDB_GUARDED_BY(lock);
+	// Workers running a task.
+	idx_t busy_count DUCKDB_GUARDED_BY(lock);
+	bool stopping DUCKDB_GUARDED_BY(lock);
+	vector<thread> workers DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
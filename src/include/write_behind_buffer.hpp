@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+#include "duckdb/common/deque.hpp"
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include "mutex.hpp"
+#include "worker_pool.hpp"
+
+namespace duckdb {
+
+// Bounded queue of writes which are accepted at memory speed and issued in order in the background, so a producer
+// only waits for a throttled backend once the buffer is full. A write continuing where the last queued one ends is
+// appended to it, so adjacent small writes reach the backend as one call.
+//
+// Writes are issued by a worker of a pool shared by every buffer, taken only while the buffer has queued writes, so
+// open handles don't hold a thread each. Without a worker, e.g. once the process is out of threads, writes are issued
+// by the producer right away. The flush function is where rate limiting happens. If it throws, the writes still queued
+// behind the failed one are dropped, and the error is thrown by the next Write or Drain.
+class WriteBehindBuffer {
+public:
+	// Issues one write of size bytes at location, or at the file pointer if location is invalid.
+	using FlushFunction = std::function<void(const_data_ptr_t data, idx_t size, optional_idx location)>;
+
+	// Workers of the pool buffers flush on by default. Buffers with queued writes beyond it wait for a free worker.
+	static constexpr idx_t MAX_FLUSHERS = 16;
+
+	// Flushes on the given pool, or on a process-wide one of MAX_FLUSHERS workers if nullptr.
+	WriteBehindBuffer(idx_t capacity_p, FlushFunction flush_p, optional_ptr<WorkerPool> flushers_p = nullptr);
+	// Waits for every queued write, dropping a flush error nobody is left to see.
+	~WriteBehindBuffer();
+
+	WriteBehindBuffer(const WriteBehindBuffer &) = delete;
+	WriteBehindBuffer &operator=(const WriteBehindBuffer &) = delete;
+
+	// Queues a copy of the bytes, waiting while they don't fit the capacity. A write larger than the capacity waits
+	// for the buffer to empty, and is then queued on its own.
+	void Write(const_data_ptr_t data, idx_t size, optional_idx location);
+
+	// Waits until every queued write has been issued.
+	void Drain();
+
+	// Returns the capacity in bytes.
+	idx_t GetCapacity() const;
+
+	// Returns the bytes queued or being flushed.
+	idx_t GetBufferedBytes() const;
+
+private:
+	struct PendingWrite {
+		optional_idx location;
+		vector<data_t> data;
+	};
+
+	// Throws and clears the error of a failed flush, if any.
+	void ThrowFlushError() DUCKDB_REQUIRES(lock);
+
+	// Hands the queued writes to a worker, or issues them right away without one.
+	void ScheduleFlush();
+
+	// Issues queued writes until none are left.
+	void FlushPending();
+
+	const idx_t capacity;
+	const FlushFunction flush;
+	WorkerPool &flushers;
+	mutable concurrency::mutex lock;
+	// Signalled whenever a flush completes.
+	std::condition_variable_any cv;
+	deque<PendingWrite> pending DUCKDB_GUARDED_BY(lock);
+	idx_t buffered_bytes DUCKDB_GUARDED_BY(lock);
+	// True while a write at the front of the queue is issued.
+	bool flushing DUCKDB_GUARDED_BY(lock);
+	// True from queueing a write to an empty buffer until FlushPending emptied it again.
+	bool scheduled DUCKDB_GUARDED_BY(lock);
+	std::exception_ptr flush_error DUCKDB_GUARDED_BY(lock);
+};
+
+} // namespace duckdb
@@ -0,0 +1,97 @@
+#include "metadata_cache.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include "default_clock.hpp"
+
+namespace duckdb {
+
+MetadataCache::MetadataCache(Duration ttl_p, idx_t max_entries_p, shared_ptr<BaseClock> clock_p)
+    : ttl(ttl_p), max_entries(max_entries_p), clock(clock_p ? std::move(clock_p) : CreateDefaultClock()), hits(0),
+      misses(0) {
+	if (ttl <= Duration::zero()) {
+		throw InvalidInputException("Metadata cache TTL must be positive");
+	}
+	if (max_entries == 0) {
+		throw InvalidInputException("Metadata cache max entries must be positive");
+	}
+}
+
+bool MetadataCache::Get(const string &path, const std::function<bool(const CachedMetadata &)> &lookup) {
+	const auto now = clock->Now();
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = entries.find(path);
+	if (it != entries.end() && it->second.expiry <= now) {
+		entries.erase(it);
+		it = entries.end();
+	}
+	if (it == entries.end() || !lookup(it->second.metadata)) {
+		++misses;
+		return false;
+	}
+	++hits;
+	return true;
+}
+
+void MetadataCache::Update(const string &path, const std::function<void(CachedMetadata &)> &update) {
+	const auto now = clock->Now();
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	auto it = entries.find(path);
+	if (it != entries.end() && it->second.expiry > now) {
+		update(it->second.metadata);
+		return;
+	}
+	if (it != entries.end()) {
+		entries.erase(it);
+	}
+	if (entries.size() >= max_entries) {
+		PurgeExpired(now);
+		if (entries.size() >= max_entries) {
+			return;
+		}
+	}
+	Entry entry;
+	entry.expiry = now + ttl;
+	update(entry.metadata);
+	entries.emplace(path, std::move(entry));
+}
+
+void MetadataCache::Erase(const string &path) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	entries.erase(path);
+}
+
+void MetadataCache::ErasePrefix(const string &prefix) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->first.compare(0, prefix.size(), prefix) == 0) {
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+MetadataCacheStats MetadataCache::GetStats() const {
+	MetadataCacheStats stats;
+	stats.ttl = ttl;
+	stats.max_entries = max_entries;
+
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	stats.entry_count = entries.size();
+	stats.hits = hits;
+	stats.misses = misses;
+	return stats;
+}
+
+void MetadataCache::PurgeExpired(TimePoint now) {
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->second.expiry <= now) {
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+} // namespace duckdb
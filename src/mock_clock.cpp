@@ -12,17 +12,19 @@ TimePoint MockClock::Now() const {
 }
 
 void MockClock::SleepFor(Duration duration_p) const {
-	current_time += duration_p;
+	auto time_point = current_time.load();
+	while (!current_time.compare_exchange_weak(time_point, time_point + duration_p)) {
+	}
 }
 
 void MockClock::SleepUntil(TimePoint time_point) const {
-	if (time_point > current_time) {
-		current_time = time_point;
+	auto current = current_time.load();
+	while (time_point > current && !current_time.compare_exchange_weak(current, time_point)) {
 	}
 }
 
 void MockClock::Advance(Duration duration_p) {
-	current_time += duration_p;
+	SleepFor(duration_p);
 }
 
 void MockClock::SetTime(TimePoint time_point) {
@@ -0,0 +1,59 @@
+#include "operation_cost.hpp"
+
+#include "duckdb/common/limits.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Converts a non-negative number of tokens to idx_t, rounding up and saturating.
+idx_t RoundUpTokens(double tokens) {
+	const auto rounded = std::ceil(tokens);
+	if (rounded >= static_cast<double>(NumericLimits<idx_t>::Maximum())) {
+		return NumericLimits<idx_t>::Maximum();
+	}
+	return rounded > 0 ? static_cast<idx_t>(rounded) : 0;
+}
+
+// Returns how many units of the given cost fit into the budget, the maximum idx_t if units are free.
+idx_t GetMaxUnits(double budget, double unit_cost) {
+	if (unit_cost <= 0) {
+		return NumericLimits<idx_t>::Maximum();
+	}
+	const auto units = std::floor(budget / unit_cost);
+	if (units >= static_cast<double>(NumericLimits<idx_t>::Maximum())) {
+		return NumericLimits<idx_t>::Maximum();
+	}
+	return units > 0 ? static_cast<idx_t>(units) : 0;
+}
+
+} // namespace
+
+idx_t OperationCost::GetTokens(idx_t calls, idx_t bytes, idx_t items) const {
+	return RoundUpTokens(static_cast<double>(calls) * call_cost + static_cast<double>(bytes) * byte_cost +
+	                     static_cast<double>(items) * item_cost);
+}
+
+idx_t OperationCost::GetMaxBytes(idx_t tokens) const {
+	const auto budget = static_cast<double>(tokens) - call_cost;
+	if (budget < 0) {
+		return 0;
+	}
+	return GetMaxUnits(budget, byte_cost);
+}
+
+idx_t OperationCost::GetMaxCalls(idx_t tokens) const {
+	return GetMaxUnits(static_cast<double>(tokens), call_cost);
+}
+
+bool IsByteOperation(FileSystemOperation operation) {
+	return operation == FileSystemOperation::READ || operation == FileSystemOperation::WRITE;
+}
+
+bool IsItemOperation(FileSystemOperation operation) {
+	return operation == FileSystemOperation::LIST || operation == FileSystemOperation::MKDIR;
+}
+
+} // namespace duckdb
@@ -0,0 +1,82 @@
+#include "path_limiter_trie.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+bool PathLimiterTrie::Node::ChildBefore(const std::pair<char, unique_ptr<Node>> &child, char key) {
+	return child.first < key;
+}
+
+const PathLimiterTrie::Node *PathLimiterTrie::Node::FindChild(char c) const {
+	auto it = std::lower_bound(children.begin(), children.end(), c, ChildBefore);
+	if (it == children.end() || it->first != c) {
+		return nullptr;
+	}
+	return it->second.get();
+}
+
+PathLimiterTrie::Node &PathLimiterTrie::Node::GetOrCreateChild(char c) {
+	auto it = std::lower_bound(children.begin(), children.end(), c, ChildBefore);
+	if (it == children.end() || it->first != c) {
+		it = children.emplace(it, c, make_uniq<Node>());
+	}
+	return *it->second;
+}
+
+PathLimiterTrie::PathLimiterTrie() : rule_count(0) {
+}
+
+PathLimiterTrie::~PathLimiterTrie() = default;
+
+void PathLimiterTrie::Insert(const string &prefix, FileSystemOperation operation, SharedRateLimiter rate_limiter) {
+	auto *node = &root;
+	for (const auto c : prefix) {
+		node = &node->GetOrCreateChild(c);
+	}
+	auto &slot = node->rate_limiters[static_cast<idx_t>(operation)];
+	if (!slot) {
+		++rule_count;
+	}
+	slot = std::move(rate_limiter);
+}
+
+SharedRateLimiter PathLimiterTrie::Match(const string &path, FileSystemOperation operation) const {
+	const auto op_idx = static_cast<idx_t>(operation);
+	const auto *node = &root;
+	const SharedRateLimiter *match = &root.rate_limiters[op_idx];
+	for (const auto c : path) {
+		node = node->FindChild(c);
+		if (!node) {
+			break;
+		}
+		if (node->rate_limiters[op_idx]) {
+			match = &node->rate_limiters[op_idx];
+		}
+	}
+	return *match;
+}
+
+PathLimiters PathLimiterTrie::MatchAll(const string &path) const {
+	PathLimiters result = root.rate_limiters;
+	const auto *node = &root;
+	for (const auto c : path) {
+		node = node->FindChild(c);
+		if (!node) {
+			break;
+		}
+		for (idx_t op_idx = 0; op_idx < FILE_SYSTEM_OPERATION_COUNT; ++op_idx) {
+			if (node->rate_limiters[op_idx]) {
+				result[op_idx] = node->rate_limiters[op_idx];
+			}
+		}
+	}
+	return result;
+}
+
+bool PathLimiterTrie::IsEmpty() const {
+	return rule_count == 0;
+}
+
+} // namespace duckdb
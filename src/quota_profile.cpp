@@ -0,0 +1,53 @@
+#include "quota_profile.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Returns the time since the start of the current day of the system clock, in UTC.
+Duration GetTimeSinceMidnight() {
+	const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+	const auto nanos = std::chrono::duration_cast<Duration>(since_epoch).count();
+	constexpr int64_t NANOS_PER_DAY = static_cast<int64_t>(MINUTES_PER_DAY) * 60 * 1000 * 1000 * 1000;
+	return Duration(((nanos % NANOS_PER_DAY) + NANOS_PER_DAY) % NANOS_PER_DAY);
+}
+
+bool IsDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+idx_t ParseTimeOfDay(const string &time_str) {
+	if (time_str.size() != 5 || !IsDigit(time_str[0]) || !IsDigit(time_str[1]) || time_str[2] != ':' ||
+	    !IsDigit(time_str[3]) || !IsDigit(time_str[4])) {
+		throw InvalidInputException("Invalid time of day '%s'. Use 'HH:MM'", time_str);
+	}
+	const idx_t hours = static_cast<idx_t>((time_str[0] - '0') * 10 + (time_str[1] - '0'));
+	const idx_t minutes = static_cast<idx_t>((time_str[3] - '0') * 10 + (time_str[4] - '0'));
+	if (hours >= 24 || minutes >= 60) {
+		throw InvalidInputException("Invalid time of day '%s'. Use 'HH:MM' between '00:00' and '23:59'", time_str);
+	}
+	return hours * 60 + minutes;
+}
+
+string TimeOfDayToString(idx_t minute) {
+	D_ASSERT(minute < MINUTES_PER_DAY);
+	return StringUtil::Format("%02llu:%02llu", static_cast<unsigned long long>(minute / 60),
+	                          static_cast<unsigned long long>(minute % 60));
+}
+
+idx_t GetCurrentMinuteOfDay() {
+	return static_cast<idx_t>(std::chrono::duration_cast<std::chrono::minutes>(GetTimeSinceMidnight()).count());
+}
+
+Duration GetTimeUntilNextMinute() {
+	const auto since_midnight = GetTimeSinceMidnight();
+	const auto into_minute = since_midnight - std::chrono::duration_cast<std::chrono::minutes>(since_midnight);
+	return std::chrono::minutes(1) - into_minute;
+}
+
+} // namespace duckdb
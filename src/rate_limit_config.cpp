@@ -1,15 +1,82 @@
 #include "rate_limit_config.hpp"
 
+#include "duckdb/common/algorithm.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 
+#include <cmath>
+
+#include "coarse_clock.hpp"
+#include "rate_limit_timer.hpp"
+#include "shared_memory_rate_limiter_state.hpp"
+
 namespace duckdb {
 
-RateLimitConfig::RateLimitConfig() = default;
+namespace {
+
+// Returns the index of the profile whose window contains the minute of day, invalid if there is none.
+optional_idx FindActiveProfile(const vector<QuotaProfile> &schedule, idx_t minute) {
+	for (idx_t idx = 0; idx < schedule.size(); ++idx) {
+		if (schedule[idx].Contains(minute)) {
+			return optional_idx(idx);
+		}
+	}
+	return optional_idx();
+}
+
+bool IsSameProfile(const optional_idx &lhs, const optional_idx &rhs) {
+	if (!lhs.IsValid() || !rhs.IsValid()) {
+		return lhs.IsValid() == rhs.IsValid();
+	}
+	return lhs.GetIndex() == rhs.GetIndex();
+}
+
+unique_ptr<OperationConfig> CreateConfig(const string &filesystem_name, FileSystemOperation operation) {
+	auto config = make_uniq<OperationConfig>();
+	config->filesystem_name = filesystem_name;
+	config->operation = operation;
+	return config;
+}
+
+// Drops a config, retiring its handle pool so that the idle handles it holds are closed right away, rather than once
+// the last snapshot referencing the pool is gone.
+void ResetConfig(unique_ptr<OperationConfig> &config) {
+	if (config && config->handle_pool) {
+		config->handle_pool->Retire();
+	}
+	if (config && config->throttle_backoff) {
+		config->throttle_backoff->Attach(nullptr, 0, 0);
+	}
+	config.reset();
+}
+
+// Points the operation's throttle backoff at its rate limiter, as long as the limiter is the operation's own rather
+// than its group's.
+void AttachThrottleBackoff(OperationConfig &config) {
+	if (!config.throttle_backoff) {
+		return;
+	}
+	const bool own_limiter = config.rate_limiter && config.rate_limiter->GetState() == config.rate_limiter_state;
+	config.throttle_backoff->Attach(own_limiter ? config.rate_limiter : nullptr, config.GetEffectiveQuota(),
+	                                config.GetEffectiveBurst());
+}
+
+} // namespace
 
-RateLimitConfig::~RateLimitConfig() = default;
+RateLimitConfig::RateLimitConfig()
+    : path_limiters_version(0), schedule_minute(GetCurrentMinuteOfDay()), schedule_ticker_running(false),
+      schedule_handle(make_shared_ptr<ScheduleHandle>()), version(0) {
+	concurrency::lock_guard<concurrency::mutex> guard(schedule_handle->lock);
+	schedule_handle->config = this;
+}
+
+RateLimitConfig::~RateLimitConfig() {
+	// Waits for a running tick, and stops pending ones from calling into the destroyed config.
+	concurrency::lock_guard<concurrency::mutex> guard(schedule_handle->lock);
+	schedule_handle->config = nullptr;
+}
 
 string RateLimitConfig::GetObjectType() {
 	return OBJECT_TYPE;
@@ -21,29 +88,27 @@ string RateLimitConfig::ObjectType() {
 
 void RateLimitConfig::SetQuota(const string &filesystem_name, FileSystemOperation operation, idx_t value,
                                RateLimitMode mode) {
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
 		if (value == 0) {
 			return;
 		}
-		OperationConfig config;
-		config.filesystem_name = filesystem_name;
-		config.operation = operation;
-		config.quota = value;
-		config.mode = mode;
-		it = configs.emplace(key, config).first;
+		slot = CreateConfig(filesystem_name, operation);
+		slot->quota = value;
+		slot->mode = mode;
 	} else {
-		it->second.quota = value;
-		it->second.mode = mode;
-		if (it->second.IsEmpty()) {
-			configs.erase(it);
+		slot->quota = value;
+		slot->mode = mode;
+		if (slot->IsEmpty()) {
+			slot.reset();
+			BumpVersion();
 			return;
 		}
 	}
 
-	UpdateRateLimiter(it->second);
+	ReconfigureRateLimiter(*slot);
+	BumpVersion();
 }
 
 void RateLimitConfig::SetBurst(const string &filesystem_name, FileSystemOperation operation, idx_t value) {
@@ -52,29 +117,418 @@ void RateLimitConfig::SetBurst(const string &filesystem_name, FileSystemOperatio
 		                            FileSystemOperationToString(operation));
 	}
 
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
 		if (value == 0) {
 			return;
 		}
-		OperationConfig config;
-		config.filesystem_name = filesystem_name;
-		config.operation = operation;
-		config.quota = 0;
-		config.mode = RateLimitMode::BLOCKING;
-		config.burst = value;
-		it = configs.emplace(key, config).first;
+		slot = CreateConfig(filesystem_name, operation);
+		slot->quota = 0;
+		slot->mode = RateLimitMode::BLOCKING;
+		slot->burst = value;
+	} else {
+		slot->burst = value;
+		if (slot->IsEmpty()) {
+			slot.reset();
+			BumpVersion();
+			return;
+		}
+	}
+
+	ReconfigureRateLimiter(*slot);
+	BumpVersion();
+}
+
+void RateLimitConfig::SetRequestQuota(const string &filesystem_name, FileSystemOperation operation, idx_t value) {
+	if (operation != FileSystemOperation::READ && operation != FileSystemOperation::WRITE) {
+		throw InvalidInputException("Request quota can only be set for READ or WRITE operations, not '%s'; the quota "
+		                            "of other operations already counts calls",
+		                            FileSystemOperationToString(operation));
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (value == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+		slot->mode = RateLimitMode::BLOCKING;
+		slot->request_quota = value;
+	} else {
+		slot->request_quota = value;
+		if (slot->IsEmpty()) {
+			slot.reset();
+			BumpVersion();
+			return;
+		}
+		if (slot->mode == RateLimitMode::NONE) {
+			slot->mode = RateLimitMode::BLOCKING;
+		}
+	}
+
+	ReconfigureRequestRateLimiter(*slot);
+	BumpVersion();
+}
+
+void RateLimitConfig::SetReadAhead(const string &filesystem_name, idx_t buffer_size, idx_t window) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::READ);
+	if (!slot) {
+		if (buffer_size == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::READ);
+	}
+	slot->read_ahead_buffer_size = buffer_size;
+	slot->read_ahead_window = buffer_size == 0 ? 0 : window;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetStreamSlot(const string &filesystem_name, Duration idle_timeout) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::READ);
+	if (!slot) {
+		if (idle_timeout == Duration::zero()) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::READ);
+	}
+	slot->stream_idle_timeout = idle_timeout;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetWriteBehind(const string &filesystem_name, idx_t buffer_size) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::WRITE);
+	if (!slot) {
+		if (buffer_size == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::WRITE);
+	}
+	slot->write_behind_buffer_size = buffer_size;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetTracing(const string &filesystem_name, FileSystemOperation operation, idx_t sample_every) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (sample_every == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->trace_sample_every = sample_every;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetShardLease(const string &filesystem_name, FileSystemOperation operation, idx_t value) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (value == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->shard_lease = value;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	} else {
+		UpdateRateLimiter(*slot);
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetPartitions(const string &filesystem_name, FileSystemOperation operation, idx_t count) {
+	if (count > RateLimiter::MAX_PARTITIONS) {
+		throw InvalidInputException("Partition count must be at most %llu, got %llu", RateLimiter::MAX_PARTITIONS,
+		                            count);
+	}
+	// A single partition is the unpartitioned limiter with extra steps.
+	const idx_t partitions = count > 1 ? count : 0;
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (partitions == 0) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->partitions = partitions;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	} else {
+		UpdateRateLimiter(*slot);
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetClockResolution(const string &filesystem_name, FileSystemOperation operation,
+                                         Duration resolution) {
+	if (resolution < Duration::zero() || resolution > CoarseClock::MAX_RESOLUTION) {
+		const auto max_ms = std::chrono::duration_cast<std::chrono::milliseconds>(CoarseClock::MAX_RESOLUTION).count();
+		throw InvalidInputException("Clock resolution must be between 0 and %lld ms", static_cast<long long>(max_ms));
+	}
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (resolution == Duration::zero()) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->clock_resolution = resolution;
+	if (slot->IsEmpty()) {
+		slot.reset();
 	} else {
-		it->second.burst = value;
-		if (it->second.IsEmpty()) {
-			configs.erase(it);
+		UpdateRateLimiter(*slot);
+		UpdateRequestRateLimiter(*slot);
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetMaxWait(const string &filesystem_name, FileSystemOperation operation, Duration max_wait) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (max_wait == Duration::zero()) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->max_wait = max_wait;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetBlockCache(const string &filesystem_name, idx_t block_size, idx_t capacity) {
+	// Validates before taking the lock.
+	auto block_cache = capacity == 0 ? nullptr : make_shared_ptr<BlockCache>(block_size, capacity);
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::READ);
+	if (!slot) {
+		if (!block_cache) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::READ);
+	}
+	slot->block_cache = std::move(block_cache);
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetMetadataCache(const string &filesystem_name, Duration ttl, idx_t max_entries) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto metadata_cache = ttl == Duration::zero() ? nullptr : make_shared_ptr<MetadataCache>(ttl, max_entries, clock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::STAT);
+	if (!slot) {
+		if (!metadata_cache) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::STAT);
+	}
+	slot->metadata_cache = std::move(metadata_cache);
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetHandlePool(const string &filesystem_name, Duration ttl, idx_t capacity) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto handle_pool = ttl == Duration::zero() ? nullptr : make_shared_ptr<HandlePool>(ttl, capacity, clock);
+	auto &slot = GetConfigSlot(filesystem_name, FileSystemOperation::OPEN);
+	if (!slot) {
+		if (!handle_pool) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, FileSystemOperation::OPEN);
+	}
+	if (slot->handle_pool) {
+		slot->handle_pool->Retire();
+	}
+	slot->handle_pool = std::move(handle_pool);
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetCost(const string &filesystem_name, FileSystemOperation operation, const OperationCost &cost) {
+	if (!(cost.call_cost >= 0 && cost.byte_cost >= 0 && cost.item_cost >= 0) ||
+	    !std::isfinite(cost.call_cost + cost.byte_cost + cost.item_cost)) {
+		throw InvalidInputException("Costs must be non-negative and finite");
+	}
+	if (cost.byte_cost != 0 && !IsByteOperation(operation)) {
+		throw InvalidInputException("Byte cost can only be set for READ or WRITE operations, not '%s'",
+		                            FileSystemOperationToString(operation));
+	}
+	if (cost.item_cost != 0 && !IsItemOperation(operation)) {
+		throw InvalidInputException("Item cost can only be set for LIST or MKDIR operations, not '%s'",
+		                            FileSystemOperationToString(operation));
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (!cost.IsSet()) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->cost = cost;
+	if (slot->IsEmpty()) {
+		slot.reset();
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetQuotaProfile(const string &filesystem_name, FileSystemOperation operation,
+                                      idx_t start_minute, idx_t end_minute, idx_t bandwidth, idx_t burst) {
+	D_ASSERT(start_minute < MINUTES_PER_DAY && end_minute < MINUTES_PER_DAY);
+	if (start_minute == end_minute) {
+		throw InvalidInputException("Quota profile window from '%s' to '%s' is empty", TimeOfDayToString(start_minute),
+		                            TimeOfDayToString(end_minute));
+	}
+	if (burst != 0 && operation != FileSystemOperation::READ && operation != FileSystemOperation::WRITE) {
+		throw InvalidInputException("Burst limit can only be set for READ or WRITE operations, not '%s'",
+		                            FileSystemOperationToString(operation));
+	}
+
+	QuotaProfile profile;
+	profile.start_minute = start_minute;
+	profile.end_minute = end_minute;
+	profile.bandwidth = bandwidth;
+	profile.burst = burst;
+	const bool remove = bandwidth == 0 && burst == 0;
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (remove) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+		slot->mode = RateLimitMode::BLOCKING;
+	}
+	auto &config = *slot;
+	auto &schedule = config.schedule;
+	if (!remove) {
+		for (const auto &other : schedule) {
+			// Two windows on a circle overlap if and only if one contains the start of the other.
+			if (other.start_minute != start_minute &&
+			    (other.Contains(start_minute) || profile.Contains(other.start_minute))) {
+				throw InvalidInputException("Quota profile from '%s' to '%s' overlaps the profile from '%s' to '%s'",
+				                            TimeOfDayToString(start_minute), TimeOfDayToString(end_minute),
+				                            TimeOfDayToString(other.start_minute),
+				                            TimeOfDayToString(other.end_minute));
+			}
+		}
+	}
+
+	schedule.erase(std::remove_if(schedule.begin(), schedule.end(),
+	                              [&](const QuotaProfile &other) { return other.start_minute == start_minute; }),
+	               schedule.end());
+	if (!remove) {
+		auto position = std::find_if(schedule.begin(), schedule.end(),
+		                             [&](const QuotaProfile &other) { return other.start_minute > start_minute; });
+		schedule.insert(position, profile);
+	}
+	if (config.IsEmpty()) {
+		slot.reset();
+		BumpVersion();
+		return;
+	}
+	if (config.mode == RateLimitMode::NONE) {
+		config.mode = RateLimitMode::BLOCKING;
+	}
+
+	if (!clock) {
+		schedule_minute = GetCurrentMinuteOfDay();
+	}
+	config.active_profile = FindActiveProfile(schedule, schedule_minute);
+	ReconfigureRateLimiter(config);
+	StartScheduleTicker();
+	BumpVersion();
+}
+
+idx_t RateLimitConfig::ApplyQuotaProfiles(idx_t minute) {
+	D_ASSERT(minute < MINUTES_PER_DAY);
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	return ApplyQuotaProfilesLocked(minute);
+}
+
+idx_t RateLimitConfig::ApplyQuotaProfilesLocked(idx_t minute) {
+	schedule_minute = minute;
+	idx_t changed = 0;
+	ForEachConfig([&](OperationConfig &config) {
+		if (config.schedule.empty()) {
+			return;
+		}
+		auto active_profile = FindActiveProfile(config.schedule, minute);
+		if (IsSameProfile(active_profile, config.active_profile)) {
 			return;
 		}
+		config.active_profile = active_profile;
+		ReconfigureRateLimiter(config);
+		++changed;
+	});
+	if (changed != 0) {
+		BumpVersion();
+	}
+	return changed;
+}
+
+void RateLimitConfig::StartScheduleTicker() {
+	// Profiles follow the system clock, which only ticks along with the default clock.
+	if (schedule_ticker_running || clock) {
+		return;
 	}
+	schedule_ticker_running = true;
+	ScheduleTick(schedule_handle);
+}
+
+void RateLimitConfig::ScheduleTick(shared_ptr<ScheduleHandle> handle) {
+	auto &timer = RateLimitTimer::GetDefault();
+	timer.Schedule(timer.GetClock()->Now() + GetTimeUntilNextMinute(), [handle]() {
+		concurrency::lock_guard<concurrency::mutex> guard(handle->lock);
+		if (handle->config) {
+			handle->config->OnScheduleTick();
+		}
+	});
+}
 
-	UpdateRateLimiter(it->second);
+void RateLimitConfig::OnScheduleTick() {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	bool has_schedule = false;
+	ForEachConfig([&](const OperationConfig &config) { has_schedule |= !config.schedule.empty(); });
+	if (!has_schedule || clock) {
+		schedule_ticker_running = false;
+		return;
+	}
+	ApplyQuotaProfilesLocked(GetCurrentMinuteOfDay());
+	ScheduleTick(schedule_handle);
 }
 
 void RateLimitConfig::SetMaxRequests(const string &filesystem_name, FileSystemOperation operation, int64_t value) {
@@ -85,116 +539,413 @@ void RateLimitConfig::SetMaxRequests(const string &filesystem_name, FileSystemOp
 		throw InvalidInputException("Max requests value cannot be 0 (would block all requests)");
 	}
 
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
 		if (value == CountingSemaphore::UNLIMITED) {
 			return;
 		}
-		OperationConfig config;
-		config.filesystem_name = filesystem_name;
-		config.operation = operation;
-		config.max_requests = value;
-		config.semaphore = make_shared_ptr<CountingSemaphore>(value);
-		it = configs.emplace(key, config).first;
+		slot = CreateConfig(filesystem_name, operation);
+		slot->max_requests = value;
+		slot->semaphore = make_shared_ptr<CountingSemaphore>(value);
 	} else {
-		it->second.max_requests = value;
-		if (it->second.IsEmpty()) {
-			configs.erase(it);
+		slot->max_requests = value;
+		if (slot->IsEmpty()) {
+			slot.reset();
+			BumpVersion();
 			return;
 		}
+		if (slot->adaptive_limiter) {
+			// Operations still in flight keep feeding the old limiter, so don't share its semaphore.
+			slot->adaptive_limiter = nullptr;
+			slot->semaphore = nullptr;
+		}
 		if (value == CountingSemaphore::UNLIMITED) {
-			it->second.semaphore = nullptr;
-		} else if (it->second.semaphore) {
-			it->second.semaphore->SetMax(value);
+			slot->semaphore = nullptr;
+		} else if (slot->semaphore) {
+			slot->semaphore->SetMax(value);
 		} else {
-			it->second.semaphore = make_shared_ptr<CountingSemaphore>(value);
+			slot->semaphore = make_shared_ptr<CountingSemaphore>(value);
 		}
 	}
+	BumpVersion();
 }
 
-const OperationConfig *RateLimitConfig::GetConfig(const string &filesystem_name, FileSystemOperation operation) const {
-	ConfigKey key {filesystem_name, operation};
+void RateLimitConfig::SetAdaptiveMaxRequests(const string &filesystem_name, FileSystemOperation operation,
+                                             int64_t min_value, int64_t max_value) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto adaptive_limiter = make_shared_ptr<AdaptiveConcurrencyLimiter>(min_value, max_value, clock);
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	slot->max_requests = max_value;
+	slot->semaphore = adaptive_limiter->GetSemaphore();
+	slot->adaptive_limiter = std::move(adaptive_limiter);
+	BumpVersion();
+}
+
+void RateLimitConfig::SetThrottleBackoff(const string &filesystem_name, FileSystemOperation operation,
+                                         double min_ratio, Duration recovery_interval, idx_t max_retries) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	// Built before touching the config, so invalid parameters leave it unchanged.
+	shared_ptr<ThrottleBackoff> throttle_backoff;
+	if (recovery_interval != Duration::zero()) {
+		throttle_backoff = make_shared_ptr<ThrottleBackoff>(min_ratio, recovery_interval, max_retries, clock);
+	}
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (!throttle_backoff) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+	}
+	if (slot->throttle_backoff) {
+		// Operations still in flight may keep reporting to the old backoff, which must no longer touch the limiter.
+		slot->throttle_backoff->Attach(nullptr, 0, 0);
+	}
+	slot->throttle_backoff = std::move(throttle_backoff);
+	if (slot->IsEmpty()) {
+		slot.reset();
+	} else if (slot->rate_limiter) {
+		// Restores the full quota, or lets the new backoff scale it.
+		ReconfigureRateLimiter(*slot);
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetGroup(const string &group_name, idx_t bandwidth, idx_t burst, const string &parent_name) {
+	if (group_name.empty()) {
+		throw InvalidInputException("Limiter group name cannot be empty");
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto it = groups.find(group_name);
+	if (bandwidth == 0 && burst == 0) {
+		if (it == groups.end()) {
+			return;
+		}
+		for (const auto &pair : groups) {
+			if (pair.second.parent_name == group_name) {
+				throw InvalidInputException("Cannot remove limiter group '%s': it is the parent of group '%s'",
+				                            group_name, pair.first);
+			}
+		}
+		ForEachConfig([&](const OperationConfig &config) {
+			if (config.group_name == group_name) {
+				throw InvalidInputException("Cannot remove limiter group '%s': operation '%s' of filesystem '%s' is "
+				                            "assigned to it",
+				                            group_name, FileSystemOperationToString(config.operation),
+				                            config.filesystem_name);
+			}
+		});
+		for (const auto &pair : path_groups) {
+			if (pair.second == group_name) {
+				throw InvalidInputException("Cannot remove limiter group '%s': operation '%s' on path prefix '%s' is "
+				                            "assigned to it",
+				                            group_name, FileSystemOperationToString(pair.first.second),
+				                            pair.first.first);
+			}
+		}
+		groups.erase(it);
+		BumpVersion();
+		return;
+	}
+
+	if (!parent_name.empty()) {
+		if (groups.find(parent_name) == groups.end()) {
+			throw InvalidInputException("Parent limiter group '%s' does not exist", parent_name);
+		}
+		for (auto ancestor = parent_name; !ancestor.empty(); ancestor = groups.at(ancestor).parent_name) {
+			if (ancestor == group_name) {
+				throw InvalidInputException("Setting parent of limiter group '%s' to '%s' would create a cycle",
+				                            group_name, parent_name);
+			}
+		}
+	}
+
+	if (it == groups.end()) {
+		LimiterGroupConfig group;
+		group.name = group_name;
+		it = groups.emplace(group_name, group).first;
+	}
+	auto &group = it->second;
+	group.bandwidth = bandwidth;
+	group.burst = burst;
+	if (group.rate_limiter && group.parent_name == parent_name) {
+		// Everything below keeps pointing at the same limiter, so there is nothing to rebuild.
+		group.rate_limiter->SetQuota(Quota(bandwidth, burst));
+	} else {
+		group.parent_name = parent_name;
+		RebuildGroup(group);
+	}
+	BumpVersion();
+}
+
+void RateLimitConfig::SetPathGroup(const string &prefix, FileSystemOperation operation, const string &group_name) {
+	if (prefix.empty()) {
+		throw InvalidInputException("Path prefix cannot be empty");
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto key = std::make_pair(prefix, operation);
+	if (group_name.empty()) {
+		if (path_groups.erase(key) > 0) {
+			BumpVersion();
+		}
+		return;
+	}
+	if (groups.find(group_name) == groups.end()) {
+		throw InvalidInputException("Limiter group '%s' does not exist", group_name);
+	}
+	path_groups[key] = group_name;
+	BumpVersion();
+}
+
+vector<PathGroupConfig> RateLimitConfig::GetAllPathGroups() const {
+	vector<PathGroupConfig> result;
+
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	result.reserve(path_groups.size());
+	for (const auto &pair : path_groups) {
+		result.push_back(PathGroupConfig {pair.first.first, pair.first.second, pair.second});
+	}
+	return result;
+}
+
+shared_ptr<const PathLimiterTrie> RateLimitConfig::GetPathLimiters() {
+	if (path_groups.empty()) {
 		return nullptr;
 	}
-	return &it->second;
+	const auto current_version = version.load(std::memory_order_relaxed);
+	if (path_limiters && path_limiters_version == current_version) {
+		return path_limiters;
+	}
+	// Groups rebuild their rate limiters on every change, which bumps the version, so the trie is rebuilt as well.
+	auto trie = make_shared_ptr<PathLimiterTrie>();
+	for (const auto &pair : path_groups) {
+		trie->Insert(pair.first.first, pair.first.second, GetGroupRateLimiter(pair.second));
+	}
+	path_limiters = std::move(trie);
+	path_limiters_version = current_version;
+	return path_limiters;
+}
+
+void RateLimitConfig::SetGroupAssignment(const string &filesystem_name, FileSystemOperation operation,
+                                         const string &group_name) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	if (!group_name.empty() && groups.find(group_name) == groups.end()) {
+		throw InvalidInputException("Limiter group '%s' does not exist", group_name);
+	}
+
+	auto &slot = GetConfigSlot(filesystem_name, operation);
+	if (!slot) {
+		if (group_name.empty()) {
+			return;
+		}
+		slot = CreateConfig(filesystem_name, operation);
+		slot->mode = RateLimitMode::BLOCKING;
+		slot->group_name = group_name;
+	} else {
+		slot->group_name = group_name;
+		if (slot->IsEmpty()) {
+			slot.reset();
+			BumpVersion();
+			return;
+		}
+		// Configs created by max requests alone have no mode yet.
+		if (slot->mode == RateLimitMode::NONE) {
+			slot->mode = RateLimitMode::BLOCKING;
+		}
+	}
+
+	UpdateRateLimiter(*slot);
+	BumpVersion();
+}
+
+vector<LimiterGroupConfig> RateLimitConfig::GetAllGroups() const {
+	vector<LimiterGroupConfig> result;
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	result.reserve(groups.size());
+	for (const auto &pair : groups) {
+		result.push_back(pair.second);
+	}
+	return result;
+}
+
+const OperationConfig *RateLimitConfig::GetConfig(const string &filesystem_name, FileSystemOperation operation) const {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	return FindConfig(filesystem_name, operation);
 }
 
 SharedRateLimiter RateLimitConfig::GetOrCreateRateLimiter(const string &filesystem_name,
                                                           FileSystemOperation operation) {
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto config = FindConfig(filesystem_name, operation);
+	if (!config) {
 		return nullptr;
 	}
 
-	if (!it->second.rate_limiter) {
-		UpdateRateLimiter(it->second);
+	if (!config->rate_limiter) {
+		UpdateRateLimiter(*config);
 	}
-	return it->second.rate_limiter;
+	return config->rate_limiter;
 }
 
 shared_ptr<CountingSemaphore> RateLimitConfig::GetOrCreateSemaphore(const string &filesystem_name,
                                                                     FileSystemOperation operation) {
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto config = FindConfig(filesystem_name, operation);
+	if (!config) {
 		return nullptr;
 	}
 
-	if (it->second.max_requests == CountingSemaphore::UNLIMITED) {
+	if (config->max_requests == CountingSemaphore::UNLIMITED) {
 		return nullptr;
 	}
 
-	if (!it->second.semaphore) {
-		it->second.semaphore = make_shared_ptr<CountingSemaphore>(it->second.max_requests);
+	if (!config->semaphore) {
+		config->semaphore = make_shared_ptr<CountingSemaphore>(config->max_requests);
 	}
-	return it->second.semaphore;
+	return config->semaphore;
 }
 
 RateLimitConfig::RateLimitSnapshot RateLimitConfig::GetRateLimitSnapshot(const string &filesystem_name,
                                                                          FileSystemOperation operation) {
 	RateLimitSnapshot snapshot;
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	auto it = configs.find(key);
-	if (it == configs.end()) {
+	auto config = FindConfig(filesystem_name, operation);
+	if (!config) {
 		return snapshot;
 	}
 
-	auto &op_config = it->second;
+	FillSnapshot(*config, snapshot);
+	return snapshot;
+}
+
+idx_t RateLimitConfig::InternFilesystem(const string &filesystem_name) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	return InternFilesystemLocked(filesystem_name);
+}
+
+idx_t RateLimitConfig::InternFilesystemLocked(const string &filesystem_name) {
+	auto it = filesystem_ids.find(filesystem_name);
+	if (it != filesystem_ids.end()) {
+		return it->second;
+	}
+	const auto filesystem_id = filesystems.size();
+	filesystems.push_back(make_uniq<FilesystemConfigs>(filesystem_name));
+	filesystem_ids.emplace(filesystem_name, filesystem_id);
+	return filesystem_id;
+}
+
+unique_ptr<OperationConfig> &RateLimitConfig::GetConfigSlot(const string &filesystem_name,
+                                                            FileSystemOperation operation) {
+	return filesystems[InternFilesystemLocked(filesystem_name)]->Get(operation);
+}
+
+OperationConfig *RateLimitConfig::FindConfig(const string &filesystem_name, FileSystemOperation operation) const {
+	auto it = filesystem_ids.find(filesystem_name);
+	if (it == filesystem_ids.end()) {
+		return nullptr;
+	}
+	return filesystems[it->second]->Get(operation).get();
+}
+
+shared_ptr<const RateLimitConfig::FilesystemSnapshot> RateLimitConfig::GetFilesystemSnapshot(idx_t filesystem_id) {
+	auto snapshot = make_shared_ptr<FilesystemSnapshot>();
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	D_ASSERT(filesystem_id < filesystems.size());
+	// Read under the lock, since writers only bump the version while holding it.
+	snapshot->version = version.load(std::memory_order_relaxed);
+	auto &operations = filesystems[filesystem_id]->operations;
+	for (idx_t idx = 0; idx < FILE_SYSTEM_OPERATION_COUNT; ++idx) {
+		if (operations[idx]) {
+			FillSnapshot(*operations[idx], snapshot->operations[idx]);
+		}
+	}
+	snapshot->path_limiters = GetPathLimiters();
+	return std::move(snapshot);
+}
+
+uint64_t RateLimitConfig::GetVersion() const {
+	return version.load(std::memory_order_acquire);
+}
+
+void RateLimitConfig::FillSnapshot(OperationConfig &op_config, RateLimitSnapshot &snapshot) {
 	snapshot.mode = op_config.mode;
+	snapshot.read_ahead_buffer_size = op_config.read_ahead_buffer_size;
+	snapshot.read_ahead_window = op_config.read_ahead_window;
+	snapshot.stream_idle_timeout = op_config.stream_idle_timeout;
+	snapshot.write_behind_buffer_size = op_config.write_behind_buffer_size;
+	snapshot.block_cache = op_config.block_cache;
+	snapshot.metadata_cache = op_config.metadata_cache;
+	snapshot.handle_pool = op_config.handle_pool;
+	snapshot.cost = op_config.cost;
+	snapshot.max_wait = op_config.max_wait != Duration::zero() ? op_config.max_wait : OperationConfig::DEFAULT_MAX_WAIT;
+	snapshot.trace_sample_every = op_config.trace_sample_every;
+	if (op_config.trace_sample_every > 0) {
+		snapshot.trace_clock = clock ? clock : CreateDefaultClock();
+	}
 
-	// Ensure rate limiter exists if quota/burst are set.
-	if (op_config.quota > 0 || op_config.burst > 0) {
+	// Ensure rate limiter exists if quota/burst/group are set.
+	if (op_config.GetEffectiveQuota() > 0 || op_config.GetEffectiveBurst() > 0 || !op_config.group_name.empty()) {
 		if (!op_config.rate_limiter) {
 			UpdateRateLimiter(op_config);
 		}
 		snapshot.rate_limiter = op_config.rate_limiter;
 	}
+	snapshot.request_rate_limiter = op_config.request_rate_limiter;
 
 	if (op_config.max_requests != CountingSemaphore::UNLIMITED) {
 		D_ASSERT(op_config.semaphore);
 		snapshot.semaphore = op_config.semaphore;
+		snapshot.adaptive_limiter = op_config.adaptive_limiter;
 	}
+	snapshot.throttle_backoff = op_config.throttle_backoff;
+}
 
-	return snapshot;
+FileSystemOperationMask RateLimitConfig::ComputeConfiguredOperations(const FilesystemConfigs &filesystem) const {
+	FileSystemOperationMask result = 0;
+	for (idx_t idx = 0; idx < FILE_SYSTEM_OPERATION_COUNT; ++idx) {
+		if (filesystem.operations[idx]) {
+			result |= GetOperationBit(static_cast<FileSystemOperation>(idx));
+		}
+	}
+	// Path rules apply to every filesystem.
+	for (const auto &pair : path_groups) {
+		result |= GetOperationBit(pair.first.second);
+	}
+	return result;
+}
+
+void RateLimitConfig::BumpVersion() {
+	for (auto &filesystem : filesystems) {
+		if (filesystem->configured_operations) {
+			filesystem->configured_operations->store(ComputeConfiguredOperations(*filesystem),
+			                                         std::memory_order_relaxed);
+		}
+	}
+	version.fetch_add(1, std::memory_order_release);
+}
+
+shared_ptr<const atomic<FileSystemOperationMask>> RateLimitConfig::GetConfiguredOperations(idx_t filesystem_id) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	D_ASSERT(filesystem_id < filesystems.size());
+	auto &filesystem = *filesystems[filesystem_id];
+	if (!filesystem.configured_operations) {
+		filesystem.configured_operations =
+		    make_shared_ptr<atomic<FileSystemOperationMask>>(ComputeConfiguredOperations(filesystem));
+	}
+	return filesystem.configured_operations;
 }
 
 vector<OperationConfig> RateLimitConfig::GetAllConfigs() const {
 	vector<OperationConfig> result;
-	result.reserve(configs.size());
 
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	for (const auto &pair : configs) {
-		result.push_back(pair.second);
-	}
+	ForEachConfig([&](const OperationConfig &config) { result.push_back(config); });
 	return result;
 }
 
@@ -202,45 +953,123 @@ vector<OperationConfig> RateLimitConfig::GetConfigsForFilesystem(const string &f
 	vector<OperationConfig> result;
 
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	for (const auto &pair : configs) {
-		if (pair.first.filesystem_name == filesystem_name) {
-			result.push_back(pair.second);
+	auto it = filesystem_ids.find(filesystem_name);
+	if (it == filesystem_ids.end()) {
+		return result;
+	}
+	for (const auto &config : filesystems[it->second]->operations) {
+		if (config) {
+			result.push_back(*config);
 		}
 	}
 	return result;
 }
 
 void RateLimitConfig::ClearConfig(const string &filesystem_name, FileSystemOperation operation) {
-	ConfigKey key {filesystem_name, operation};
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	configs.erase(key);
+	auto it = filesystem_ids.find(filesystem_name);
+	if (it != filesystem_ids.end()) {
+		ResetConfig(filesystems[it->second]->Get(operation));
+	}
+	BumpVersion();
 }
 
 void RateLimitConfig::ClearFilesystem(const string &filesystem_name) {
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	for (auto it = configs.begin(); it != configs.end();) {
-		if (it->first.filesystem_name == filesystem_name) {
-			it = configs.erase(it);
-		} else {
-			++it;
+	auto it = filesystem_ids.find(filesystem_name);
+	if (it != filesystem_ids.end()) {
+		for (auto &config : filesystems[it->second]->operations) {
+			ResetConfig(config);
 		}
 	}
+	BumpVersion();
 }
 
 void RateLimitConfig::ClearAll() {
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
-	configs.clear();
+	// Filesystems stay interned, since wrapped filesystems keep looking their configs up by id.
+	for (auto &filesystem : filesystems) {
+		for (auto &config : filesystem->operations) {
+			ResetConfig(config);
+		}
+	}
+	path_groups.clear();
+	groups.clear();
+	BumpVersion();
+}
+
+shared_ptr<FilesystemStats> RateLimitConfig::GetOrCreateStats(const string &filesystem_name) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto &entry = stats[filesystem_name];
+	if (!entry) {
+		entry = make_shared_ptr<FilesystemStats>(filesystem_name);
+	}
+	return entry;
+}
+
+vector<shared_ptr<FilesystemStats>> RateLimitConfig::GetAllStats() const {
+	vector<shared_ptr<FilesystemStats>> result;
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	result.reserve(stats.size());
+	for (const auto &pair : stats) {
+		result.push_back(pair.second);
+	}
+	return result;
+}
+
+idx_t RateLimitConfig::RecommendBurst(const string &filesystem_name, FileSystemOperation operation, double percentile) {
+	if (operation != FileSystemOperation::READ && operation != FileSystemOperation::WRITE) {
+		throw InvalidInputException("Burst can only be recommended for READ or WRITE operations, not '%s'",
+		                            FileSystemOperationToString(operation));
+	}
+	if (!(percentile > 0 && percentile <= 100)) {
+		throw InvalidInputException("Percentile must be greater than 0 and at most 100, got %f", percentile);
+	}
+	const auto snapshot = GetOrCreateStats(filesystem_name)->Get(operation).GetSnapshot();
+	const auto bytes = OperationStats::GetRequestSizePercentile(snapshot, percentile);
+	if (bytes == 0) {
+		return 0;
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	auto config = FindConfig(filesystem_name, operation);
+	if (!config || !config->cost.IsSet()) {
+		return bytes;
+	}
+	return config->cost.GetTokens(1, bytes, 0);
+}
+
+idx_t RateLimitConfig::AutoTuneBurst(const string &filesystem_name, FileSystemOperation operation, double percentile) {
+	const auto burst = RecommendBurst(filesystem_name, operation, percentile);
+	if (burst == 0) {
+		throw InvalidInputException("No %s requests seen on '%s' to tune the burst from",
+		                            FileSystemOperationToString(operation), filesystem_name);
+	}
+	SetBurst(filesystem_name, operation, burst);
+	return burst;
+}
+
+void RateLimitConfig::ResetStats() {
+	for (auto &filesystem_stats : GetAllStats()) {
+		for (auto &operation_stats : filesystem_stats->operations) {
+			operation_stats.Reset();
+		}
+	}
 }
 
 shared_ptr<RateLimitConfig> RateLimitConfig::GetOrCreate(ClientContext &context) {
-	auto &cache = ObjectCache::GetObjectCache(context);
+	return GetOrCreate(DatabaseInstance::GetDatabase(context));
+}
+
+shared_ptr<RateLimitConfig> RateLimitConfig::GetOrCreate(DatabaseInstance &db) {
+	auto &cache = db.GetObjectCache();
 	auto config = cache.GetOrCreate<RateLimitConfig>(CACHE_KEY);
 
 	// Set the database instance for logging
 	{
 		concurrency::lock_guard<concurrency::mutex> guard(config->config_lock);
 		if (config->db_instance.expired()) {
-			auto &db = DatabaseInstance::GetDatabase(context);
 			config->db_instance = db.shared_from_this();
 		}
 	}
@@ -266,21 +1095,189 @@ void RateLimitConfig::SetClock(shared_ptr<BaseClock> clock_p) {
 	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
 	clock = std::move(clock_p);
 
-	// Update all existing rate limiters to use the new clock
-	for (auto &pair : configs) {
-		UpdateRateLimiter(pair.second);
+	// Update all existing rate limiters to use the new clock.
+	RebuildRateLimiters();
+	if (!clock) {
+		ApplyQuotaProfilesLocked(GetCurrentMinuteOfDay());
+		StartScheduleTicker();
+	}
+	ForEachConfig([&](OperationConfig &config) {
+		// Entries expire against the clock, so they can't be carried over to another one.
+		auto &metadata_cache = config.metadata_cache;
+		if (metadata_cache) {
+			const auto stats = metadata_cache->GetStats();
+			metadata_cache = make_shared_ptr<MetadataCache>(stats.ttl, stats.max_entries, clock);
+		}
+		auto &handle_pool = config.handle_pool;
+		if (handle_pool) {
+			const auto stats = handle_pool->GetStats();
+			handle_pool->Retire();
+			handle_pool = make_shared_ptr<HandlePool>(stats.ttl, stats.capacity, clock);
+		}
+		auto &throttle_backoff = config.throttle_backoff;
+		if (throttle_backoff) {
+			const auto stats = throttle_backoff->GetStats();
+			throttle_backoff->Attach(nullptr, 0, 0);
+			throttle_backoff = make_shared_ptr<ThrottleBackoff>(stats.min_ratio, stats.recovery_interval,
+			                                                    stats.max_retries, clock);
+			AttachThrottleBackoff(config);
+		}
+	});
+	BumpVersion();
+}
+
+void RateLimitConfig::SetSharedStateDirectory(const string &directory) {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	const auto previous_directory = shared_state_directory;
+	shared_state_directory = directory;
+	try {
+		RebuildRateLimiters();
+	} catch (...) {
+		// The directory is unusable; go back to the previous states, which could all be created before.
+		shared_state_directory = previous_directory;
+		RebuildRateLimiters();
+		throw;
+	}
+	BumpVersion();
+}
+
+string RateLimitConfig::GetSharedStateDirectory() const {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	return shared_state_directory;
+}
+
+void RateLimitConfig::RebuildRateLimiters() {
+	// The states hold TATs of the previous clock or state directory, which can't be carried over.
+	for (auto &pair : groups) {
+		pair.second.rate_limiter_state = nullptr;
+	}
+	ForEachConfig([](OperationConfig &config) {
+		config.rate_limiter_state = nullptr;
+		config.request_rate_limiter_state = nullptr;
+	});
+	// Rebuilding the root groups also rebuilds every group below them and every operation assigned to one.
+	for (auto &pair : groups) {
+		if (pair.second.parent_name.empty()) {
+			RebuildGroup(pair.second);
+		}
+	}
+	ForEachConfig([&](OperationConfig &config) {
+		if (config.group_name.empty()) {
+			UpdateRateLimiter(config);
+		}
+		UpdateRequestRateLimiter(config);
+	});
+}
+
+shared_ptr<BaseClock> RateLimitConfig::GetClock() const {
+	concurrency::lock_guard<concurrency::mutex> guard(config_lock);
+	return clock;
+}
+
+shared_ptr<RateLimiterState> RateLimitConfig::GetOrCreateState(shared_ptr<RateLimiterState> &slot,
+                                                               const string &key) {
+	if (!slot) {
+		slot = CreateSharedMemoryRateLimiterState(shared_state_directory, key);
+		if (!slot) {
+			slot = make_shared_ptr<LocalRateLimiterState>();
+		}
+	}
+	return slot;
+}
+
+shared_ptr<BaseClock> RateLimitConfig::GetLimiterClock(const OperationConfig &config) const {
+	if (clock || config.clock_resolution == Duration::zero()) {
+		return clock;
 	}
+	return GetCoarseClock(config.clock_resolution);
 }
 
 void RateLimitConfig::UpdateRateLimiter(OperationConfig &config) {
 	D_ASSERT(!config.IsEmpty());
 
-	if (config.quota == 0 && config.burst == 0) {
-		config.rate_limiter = nullptr;
+	auto group_rate_limiter = GetGroupRateLimiter(config.group_name);
+	const auto quota = config.GetEffectiveQuota();
+	const auto burst = config.GetEffectiveBurst();
+	if (quota == 0 && burst == 0) {
+		// Without limits of its own, the operation is charged against its group directly.
+		config.rate_limiter = std::move(group_rate_limiter);
+		AttachThrottleBackoff(config);
+		return;
+	}
+
+	auto state = GetOrCreateState(
+	    config.rate_limiter_state,
+	    StringUtil::Format("fs:%s:%s", config.filesystem_name, FileSystemOperationToString(config.operation)));
+	// Partitions would take the TAT traffic off a state other processes share, and with it the shared limit.
+	const auto partitions = shared_state_directory.empty() ? config.partitions : 0;
+	config.rate_limiter = CreateRateLimiter(quota, burst, GetLimiterClock(config), std::move(group_rate_limiter),
+	                                        config.shard_lease, std::move(state), partitions);
+	AttachThrottleBackoff(config);
+}
+
+void RateLimitConfig::ReconfigureRateLimiter(OperationConfig &config) {
+	const auto quota = config.GetEffectiveQuota();
+	const auto burst = config.GetEffectiveBurst();
+	auto &limiter = config.rate_limiter;
+	// Only a limiter of the operation's own can be changed; one shared with its group is replaced instead.
+	if ((quota == 0 && burst == 0) || !limiter || limiter->GetState() != config.rate_limiter_state) {
+		UpdateRateLimiter(config);
+		return;
+	}
+	if (config.throttle_backoff) {
+		// Applies the quota scaled by the current backoff instead.
+		AttachThrottleBackoff(config);
+		return;
+	}
+	limiter->SetQuota(Quota(quota, burst));
+}
+
+void RateLimitConfig::ReconfigureRequestRateLimiter(OperationConfig &config) {
+	if (config.request_quota == 0 || !config.request_rate_limiter) {
+		UpdateRequestRateLimiter(config);
+		return;
+	}
+	config.request_rate_limiter->SetQuota(Quota(config.request_quota, /*burst=*/0));
+}
+
+void RateLimitConfig::UpdateRequestRateLimiter(OperationConfig &config) {
+	if (config.request_quota == 0) {
+		config.request_rate_limiter = nullptr;
+		config.request_rate_limiter_state = nullptr;
 		return;
 	}
+	auto state = GetOrCreateState(
+	    config.request_rate_limiter_state,
+	    StringUtil::Format("fs:%s:%s:requests", config.filesystem_name, FileSystemOperationToString(config.operation)));
+	// No burst, so calls are spaced evenly at the configured rate.
+	config.request_rate_limiter = CreateRateLimiter(config.request_quota, /*burst=*/0, GetLimiterClock(config),
+	                                                /*parent_p=*/nullptr, /*shard_lease_p=*/0, std::move(state));
+}
+
+void RateLimitConfig::RebuildGroup(LimiterGroupConfig &group) {
+	auto state = GetOrCreateState(group.rate_limiter_state, "group:" + group.name);
+	group.rate_limiter = CreateRateLimiter(group.bandwidth, group.burst, clock, GetGroupRateLimiter(group.parent_name),
+	                                       /*shard_lease_p=*/0, std::move(state));
+
+	for (auto &pair : groups) {
+		if (pair.second.parent_name == group.name) {
+			RebuildGroup(pair.second);
+		}
+	}
+	ForEachConfig([&](OperationConfig &config) {
+		if (config.group_name == group.name) {
+			UpdateRateLimiter(config);
+		}
+	});
+}
 
-	config.rate_limiter = CreateRateLimiter(config.quota, config.burst, clock);
+SharedRateLimiter RateLimitConfig::GetGroupRateLimiter(const string &group_name) const {
+	if (group_name.empty()) {
+		return nullptr;
+	}
+	auto it = groups.find(group_name);
+	D_ASSERT(it != groups.end());
+	return it->second.rate_limiter;
 }
 
 } // namespace duckdb
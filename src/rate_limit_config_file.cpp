@@ -0,0 +1,193 @@
+#include "rate_limit_config_file.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include "rate_limit_config.hpp"
+
+namespace duckdb {
+
+namespace {
+
+RateLimitConfigFileKey ParseKey(const string &key, idx_t line) {
+	const auto lower = StringUtil::Lower(key);
+	if (lower == "quota") {
+		return RateLimitConfigFileKey::QUOTA;
+	}
+	if (lower == "burst") {
+		return RateLimitConfigFileKey::BURST;
+	}
+	if (lower == "request_quota") {
+		return RateLimitConfigFileKey::REQUEST_QUOTA;
+	}
+	if (lower == "max_requests") {
+		return RateLimitConfigFileKey::MAX_REQUESTS;
+	}
+	if (lower == "max_wait_ms") {
+		return RateLimitConfigFileKey::MAX_WAIT_MS;
+	}
+	throw InvalidInputException("Rate limit config file line %llu: unknown key, valid keys are: quota, burst, "
+	                            "request_quota, max_requests, max_wait_ms",
+	                            static_cast<unsigned long long>(line));
+}
+
+idx_t ParseValue(const string &value, idx_t line) {
+	if (value.empty()) {
+		throw InvalidInputException("Rate limit config file line %llu: missing value",
+		                            static_cast<unsigned long long>(line));
+	}
+	idx_t result = 0;
+	for (auto c : value) {
+		if (c < '0' || c > '9') {
+			throw InvalidInputException("Rate limit config file line %llu: expected a non-negative integer value",
+			                            static_cast<unsigned long long>(line));
+		}
+		const idx_t digit = static_cast<idx_t>(c - '0');
+		if (result > (NumericLimits<idx_t>::Maximum() - digit) / 10) {
+			throw InvalidInputException("Rate limit config file line %llu: value is out of range",
+			                            static_cast<unsigned long long>(line));
+		}
+		result = result * 10 + digit;
+	}
+	return result;
+}
+
+void CheckRange(idx_t value, int64_t max_value, idx_t line) {
+	if (value > static_cast<idx_t>(max_value)) {
+		throw InvalidInputException("Rate limit config file line %llu: value is out of range",
+		                            static_cast<unsigned long long>(line));
+	}
+}
+
+// Parses "<operation>.<key> = <value> [mode]" of a section.
+RateLimitConfigFileSetting ParseSetting(const string &filesystem_name, const string &name, const string &value,
+                                        idx_t line) {
+	const auto dot = name.find('.');
+	if (dot == string::npos) {
+		throw InvalidInputException("Rate limit config file line %llu: expected '<operation>.<key>'",
+		                            static_cast<unsigned long long>(line));
+	}
+	RateLimitConfigFileSetting setting;
+	setting.filesystem_name = filesystem_name;
+	try {
+		setting.operation = ParseFileSystemOperation(name.substr(0, dot));
+	} catch (const InvalidInputException &) {
+		throw InvalidInputException("Rate limit config file line %llu: unknown operation, valid operations are: %s",
+		                            static_cast<unsigned long long>(line), GetValidOperationsString());
+	}
+	setting.key = ParseKey(name.substr(dot + 1), line);
+	setting.line = line;
+
+	auto number = value;
+	const auto space = value.find_first_of(" \t");
+	if (space != string::npos) {
+		if (setting.key != RateLimitConfigFileKey::QUOTA) {
+			throw InvalidInputException("Rate limit config file line %llu: only a quota takes a mode",
+			                            static_cast<unsigned long long>(line));
+		}
+		number = value.substr(0, space);
+		auto mode = value.substr(space + 1);
+		StringUtil::Trim(mode);
+		try {
+			setting.mode = ParseRateLimitMode(mode);
+		} catch (const InvalidInputException &) {
+			throw InvalidInputException("Rate limit config file line %llu: unknown mode, valid modes are: blocking, "
+			                            "non_blocking, split, fair, bounded",
+			                            static_cast<unsigned long long>(line));
+		}
+	}
+	setting.value = ParseValue(number, line);
+	// Max requests and max wait are converted to signed types.
+	switch (setting.key) {
+	case RateLimitConfigFileKey::MAX_REQUESTS:
+		CheckRange(setting.value, NumericLimits<int64_t>::Maximum(), line);
+		break;
+	case RateLimitConfigFileKey::MAX_WAIT_MS: {
+		const auto max_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Duration::max()).count();
+		CheckRange(setting.value, max_ms, line);
+		break;
+	}
+	default:
+		break;
+	}
+	return setting;
+}
+
+} // namespace
+
+RateLimitConfigFile ParseRateLimitConfigFile(const string &content) {
+	RateLimitConfigFile file;
+	// Empty before the first section, where only wrap is allowed.
+	string section;
+	bool in_section = false;
+	idx_t line_number = 0;
+	for (auto line : StringUtil::Split(content, '\n')) {
+		++line_number;
+		StringUtil::Trim(line);
+		if (line.empty() || line[0] == '#' || line[0] == ';') {
+			continue;
+		}
+		if (line[0] == '[') {
+			if (line.back() != ']' || line.size() < 3) {
+				throw InvalidInputException("Rate limit config file line %llu: expected '[<filesystem>]'",
+				                            static_cast<unsigned long long>(line_number));
+			}
+			section = line.substr(1, line.size() - 2);
+			StringUtil::Trim(section);
+			in_section = true;
+			continue;
+		}
+		const auto equals = line.find('=');
+		if (equals == string::npos) {
+			throw InvalidInputException("Rate limit config file line %llu: expected '<key> = <value>'",
+			                            static_cast<unsigned long long>(line_number));
+		}
+		auto name = line.substr(0, equals);
+		auto value = line.substr(equals + 1);
+		StringUtil::Trim(name);
+		StringUtil::Trim(value);
+		if (!in_section) {
+			if (StringUtil::Lower(name) != "wrap") {
+				throw InvalidInputException("Rate limit config file line %llu: settings must be inside a [filesystem] "
+				                            "section, only 'wrap' may come before the first one",
+				                            static_cast<unsigned long long>(line_number));
+			}
+			for (auto fs_name : StringUtil::Split(value, ',')) {
+				StringUtil::Trim(fs_name);
+				if (!fs_name.empty()) {
+					file.wrap.push_back(std::move(fs_name));
+				}
+			}
+			continue;
+		}
+		file.settings.push_back(ParseSetting(section, name, value, line_number));
+	}
+	return file;
+}
+
+void ApplyRateLimitConfigFile(const RateLimitConfigFile &file, RateLimitConfig &config) {
+	for (const auto &setting : file.settings) {
+		const auto &fs_name = setting.filesystem_name;
+		switch (setting.key) {
+		case RateLimitConfigFileKey::QUOTA:
+			config.SetQuota(fs_name, setting.operation, setting.value, setting.mode);
+			break;
+		case RateLimitConfigFileKey::BURST:
+			config.SetBurst(fs_name, setting.operation, setting.value);
+			break;
+		case RateLimitConfigFileKey::REQUEST_QUOTA:
+			config.SetRequestQuota(fs_name, setting.operation, setting.value);
+			break;
+		case RateLimitConfigFileKey::MAX_REQUESTS:
+			config.SetMaxRequests(fs_name, setting.operation, static_cast<int64_t>(setting.value));
+			break;
+		case RateLimitConfigFileKey::MAX_WAIT_MS:
+			config.SetMaxWait(fs_name, setting.operation,
+			                  std::chrono::milliseconds(static_cast<int64_t>(setting.value)));
+			break;
+		}
+	}
+}
+
+} // namespace duckdb
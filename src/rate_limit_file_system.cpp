@@ -1,53 +1,541 @@
 #include "rate_limit_file_system.hpp"
 
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
 #include "duckdb/common/multi_file/multi_file_list.hpp"
 #include "duckdb/common/local_file_system.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/logging/logger.hpp"
 
+#include "no_destructor.hpp"
+#include "rate_limit_timer.hpp"
+#include "worker_pool.hpp"
+
 namespace duckdb {
 
+namespace {
+
+// Source of RateLimitFileSystem ids. Ids are never reused, so a cache entry cannot be mistaken for a filesystem
+// allocated at the address of a destroyed one.
+atomic<idx_t> next_filesystem_id {0};
+
+// Returns the workers every prefetch and split positional transfer shares, so they don't start threads of their own.
+WorkerPool &GetTransferPool() {
+	// Never destroyed, like the default timer, so transfers of threads still running at exit don't race with it.
+	static NoDestructor<WorkerPool> pool(RateLimitFileSystem::MAX_TRANSFER_THREADS - 1);
+	return *pool;
+}
+
+// Number of filesystems whose snapshots a single thread keeps cached.
+constexpr idx_t SNAPSHOT_CACHE_SIZE = 8;
+
+struct SnapshotCacheEntry {
+	idx_t filesystem_id = DConstants::INVALID_INDEX;
+	shared_ptr<const RateLimitConfig::FilesystemSnapshot> snapshot;
+};
+
+// Per-thread cache of filesystem snapshots, so steady-state I/O never touches the config lock and never shares a
+// reference count across threads.
+struct SnapshotCache {
+	array<SnapshotCacheEntry, SNAPSHOT_CACHE_SIZE> entries;
+	idx_t next_victim = 0;
+};
+
+SnapshotCache &GetThreadSnapshotCache() {
+	thread_local SnapshotCache cache;
+	return cache;
+}
+
+// Copies the metadata object store listings attach to their entries (e.g. S3 glob results) into a cache entry.
+void MergeExtendedInfo(const OpenFileInfo &info, CachedMetadata &metadata) {
+	if (!info.extended_info) {
+		return;
+	}
+	const auto &options = info.extended_info->options;
+	auto entry = options.find("file_size");
+	if (entry != options.end() && !entry->second.IsNull()) {
+		metadata.file_size = entry->second.GetValue<int64_t>();
+	}
+	entry = options.find("last_modified");
+	if (entry != options.end() && !entry->second.IsNull()) {
+		metadata.has_last_modified = true;
+		metadata.last_modified = entry->second.GetValue<timestamp_t>();
+	}
+	entry = options.find("etag");
+	if (entry != options.end() && !entry->second.IsNull()) {
+		metadata.has_version_tag = true;
+		metadata.version_tag = entry->second.ToString();
+	}
+}
+
+// Returns the tokens the rate limiter of an operation charges for a request: bytes are the size of one READ or WRITE
+// call, and the number of calls for every other operation.
+idx_t GetRequestTokens(const OperationCost &cost, FileSystemOperation operation, idx_t bytes) {
+	if (!cost.IsSet()) {
+		return bytes;
+	}
+	return IsByteOperation(operation) ? cost.GetTokens(1, bytes, 0) : cost.GetTokens(bytes, 0, 0);
+}
+
+// Returns the directory levels a recursive create of the path may create, skipping a URL scheme like "s3:".
+idx_t CountDirectoryLevels(const string &path) {
+	idx_t levels = 0;
+	idx_t start = 0;
+	while (start <= path.size()) {
+		auto end = path.find('/', start);
+		if (end == string::npos) {
+			end = path.size();
+		}
+		if (end > start && !(start == 0 && path[end - 1] == ':')) {
+			++levels;
+		}
+		start = end + 1;
+	}
+	return levels;
+}
+
+} // namespace
+
 // ==========================================================================
 // RateLimitFileHandle
 // ==========================================================================
 
 RateLimitFileHandle::RateLimitFileHandle(RateLimitFileSystem &fs, unique_ptr<FileHandle> inner_handle_p,
                                          const string &path, FileOpenFlags flags)
-    : FileHandle(fs, path, flags), inner_handle(std::move(inner_handle_p)) {
+    : FileHandle(fs, path, flags), inner_handle(std::move(inner_handle_p)), cached_file_size(UNKNOWN_FILE_SIZE),
+      read_buffer_start(0), read_buffer_size(0), last_read_end(0), has_prefetched_ranges(false),
+      stream_slot(make_shared_ptr<StreamSlot>()), block_cache_enabled(false), pool_owner(0) {
 }
 
 RateLimitFileHandle::~RateLimitFileHandle() {
+	// The background flush writes through the inner handle, so it has to finish first.
+	write_behind.reset();
+	// Handles are often destroyed without being closed first.
+	if (handle_pool && inner_handle) {
+		ReturnToPool();
+	}
 }
 
 void RateLimitFileHandle::Close() {
-	if (inner_handle) {
+	if (write_behind) {
+		// Queued writes are issued before the file is closed. Moved out first, so a failed flush isn't thrown twice.
+		auto draining = std::move(write_behind);
+		draining->Drain();
+	}
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(stream_slot->lock);
+		stream_slot->Release();
+	}
+	if (handle_pool && inner_handle) {
+		ReturnToPool();
+	} else if (inner_handle) {
 		inner_handle->Close();
 	}
 }
 
+idx_t RateLimitFileHandle::GetProgress() {
+	return inner_handle->GetProgress();
+}
+
+FileCompressionType RateLimitFileHandle::GetFileCompressionType() {
+	return inner_handle->GetFileCompressionType();
+}
+
 FileHandle &RateLimitFileHandle::GetInnerHandle() {
 	return *inner_handle;
 }
 
+int64_t RateLimitFileHandle::GetCachedFileSize() const {
+	return cached_file_size.load(std::memory_order_relaxed);
+}
+
+void RateLimitFileHandle::SetCachedFileSize(int64_t file_size) {
+	cached_file_size.store(file_size, std::memory_order_relaxed);
+}
+
+void RateLimitFileHandle::InvalidateCachedFileSize() {
+	cached_file_size.store(UNKNOWN_FILE_SIZE, std::memory_order_relaxed);
+}
+
+const RateLimitScope &RateLimitFileHandle::GetScope() const {
+	return scope;
+}
+
+void RateLimitFileHandle::SetScope(RateLimitScope scope_p) {
+	scope = std::move(scope_p);
+}
+
+optional_ptr<RateLimiter> RateLimitFileHandle::GetPathLimiter(FileSystemOperation operation) const {
+	return path_limiters[static_cast<idx_t>(operation)].get();
+}
+
+void RateLimitFileHandle::SetPathLimiters(PathLimiters path_limiters_p) {
+	path_limiters = std::move(path_limiters_p);
+}
+
+bool RateLimitFileHandle::RecordRead(idx_t nr_bytes, idx_t location, idx_t window) {
+	concurrency::lock_guard<concurrency::mutex> guard(read_buffer_lock);
+	const bool sequential = location >= last_read_end && location - last_read_end <= window;
+	last_read_end = location + nr_bytes;
+	return sequential;
+}
+
+bool RateLimitFileHandle::ReadFromBuffer(void *buffer, idx_t nr_bytes, idx_t location) {
+	concurrency::lock_guard<concurrency::mutex> guard(read_buffer_lock);
+	if (!read_buffer || location < read_buffer_start || location + nr_bytes > read_buffer_start + read_buffer_size) {
+		return false;
+	}
+	memcpy(buffer, read_buffer.get() + (location - read_buffer_start), nr_bytes);
+	return true;
+}
+
+void RateLimitFileHandle::SetReadBuffer(unsafe_unique_array<data_t> data, idx_t size, idx_t location) {
+	concurrency::lock_guard<concurrency::mutex> guard(read_buffer_lock);
+	read_buffer = std::move(data);
+	read_buffer_start = location;
+	read_buffer_size = size;
+}
+
+void RateLimitFileHandle::InvalidateReadBuffer() {
+	concurrency::lock_guard<concurrency::mutex> guard(read_buffer_lock);
+	read_buffer.reset();
+	read_buffer_size = 0;
+}
+
+void RateLimitFileHandle::Prefetch(const vector<PrefetchRange> &ranges) {
+	file_system.Cast<RateLimitFileSystem>().Prefetch(*this, ranges);
+}
+
+bool RateLimitFileHandle::ReadFromPrefetched(void *buffer, idx_t nr_bytes, idx_t location) {
+	if (!has_prefetched_ranges.load(std::memory_order_acquire)) {
+		return false;
+	}
+	concurrency::lock_guard<concurrency::mutex> guard(prefetch_lock);
+	// The range starting at or before the location is the only one which can hold the read.
+	auto it = prefetched_ranges.upper_bound(location);
+	if (it == prefetched_ranges.begin()) {
+		return false;
+	}
+	--it;
+	if (location + nr_bytes > it->first + it->second.size) {
+		return false;
+	}
+	memcpy(buffer, it->second.data.get() + (location - it->first), nr_bytes);
+	return true;
+}
+
+void RateLimitFileHandle::SetPrefetchedRanges(map<idx_t, PrefetchedRange> ranges) {
+	concurrency::lock_guard<concurrency::mutex> guard(prefetch_lock);
+	prefetched_ranges = std::move(ranges);
+	has_prefetched_ranges.store(!prefetched_ranges.empty(), std::memory_order_release);
+}
+
+void RateLimitFileHandle::InvalidatePrefetchedRanges() {
+	concurrency::lock_guard<concurrency::mutex> guard(prefetch_lock);
+	prefetched_ranges.clear();
+	has_prefetched_ranges.store(false, std::memory_order_release);
+}
+
+const shared_ptr<StreamSlot> &RateLimitFileHandle::GetStreamSlot() const {
+	return stream_slot;
+}
+
+bool RateLimitFileHandle::IsBlockCacheEnabled() const {
+	return block_cache_enabled;
+}
+
+const string &RateLimitFileHandle::GetCacheVersionTag() const {
+	return cache_version_tag;
+}
+
+void RateLimitFileHandle::EnableBlockCache(string version_tag) {
+	block_cache_enabled = true;
+	cache_version_tag = std::move(version_tag);
+}
+
+optional_ptr<WriteBehindBuffer> RateLimitFileHandle::GetWriteBehind() const {
+	return write_behind.get();
+}
+
+void RateLimitFileHandle::EnableWriteBehind(unique_ptr<WriteBehindBuffer> write_behind_p) {
+	write_behind = std::move(write_behind_p);
+}
+
+void RateLimitFileHandle::EnableHandlePool(shared_ptr<HandlePool> handle_pool_p, idx_t owner, string version_tag) {
+	handle_pool = std::move(handle_pool_p);
+	pool_owner = owner;
+	pool_version_tag = std::move(version_tag);
+}
+
+void RateLimitFileHandle::ReturnToPool() {
+	PooledHandle pooled;
+	pooled.handle = std::move(inner_handle);
+	pooled.version_tag = std::move(pool_version_tag);
+	pooled.file_size = cached_file_size.load(std::memory_order_relaxed);
+	auto pool = std::move(handle_pool);
+	pool->Put(pool_owner, GetPath(), GetFlags(), std::move(pooled));
+}
+
+void RateLimitFileHandle::DrainWriteBehind() {
+	if (write_behind) {
+		write_behind->Drain();
+	}
+}
+
+// ==========================================================================
+// RateLimitMultiFileList
+// ==========================================================================
+
+RateLimitMultiFileList::RateLimitMultiFileList(RateLimitFileSystem &fs_p, const string &pattern,
+                                               FileGlobInput glob_input_p, unique_ptr<MultiFileList> inner_list_p,
+                                               SharedRateLimiter path_limiter_p)
+    : MultiFileList(vector<OpenFileInfo> {OpenFileInfo(pattern)}, std::move(glob_input_p)), fs(fs_p),
+      path_limiter(std::move(path_limiter_p)), inner_list(std::move(inner_list_p)), exhausted(false) {
+	inner_list->InitializeScan(scan_data);
+}
+
+vector<OpenFileInfo> RateLimitMultiFileList::GetAllFiles() {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	ExpandTo(NumericLimits<idx_t>::Maximum());
+	return files;
+}
+
+FileExpandResult RateLimitMultiFileList::GetExpandResult() {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	ExpandTo(1);
+	if (files.empty()) {
+		return FileExpandResult::NO_FILES;
+	}
+	return files.size() == 1 ? FileExpandResult::SINGLE_FILE : FileExpandResult::MULTIPLE_FILES;
+}
+
+idx_t RateLimitMultiFileList::GetTotalFileCount() {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	ExpandTo(NumericLimits<idx_t>::Maximum());
+	return files.size();
+}
+
+OpenFileInfo RateLimitMultiFileList::GetFile(idx_t i) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	ExpandTo(i);
+	return i < files.size() ? files[i] : OpenFileInfo();
+}
+
+void RateLimitMultiFileList::ExpandTo(idx_t count) {
+	while (!exhausted && files.size() <= count) {
+		FetchPage();
+	}
+}
+
+void RateLimitMultiFileList::FetchPage() {
+	const idx_t page_start = files.size();
+	{
+		auto concurrency_guard = fs.AcquireConcurrencySlot(FileSystemOperation::LIST);
+		// A page that already appended entries would be scanned again from where the failure left the scan state.
+		concurrency_guard.TrackWithoutRetry([&] {
+			OpenFileInfo file;
+			while (files.size() - page_start < RateLimitFileSystem::LIST_PAGE_SIZE &&
+			       inner_list->Scan(scan_data, file)) {
+				files.push_back(file);
+			}
+		});
+	}
+	const idx_t fetched = files.size() - page_start;
+	if (fetched < RateLimitFileSystem::LIST_PAGE_SIZE) {
+		exhausted = true;
+		// Nothing is pulled from the inner list anymore, release what it holds.
+		inner_list.reset();
+	}
+	for (idx_t idx = page_start; idx < files.size(); ++idx) {
+		fs.CacheListedMetadata(files[idx], files[idx].path);
+	}
+	// The rate limit waits outside of the concurrency slot, like every other call. A listing ending on a page boundary
+	// isn't charged for the empty page after it.
+	if (page_start > 0 && fetched > 0) {
+		fs.ApplyRateLimit(FileSystemOperation::LIST, 1, nullptr, path_limiter.get());
+	}
+	fs.ChargeListItems(fetched);
+}
+
 // ==========================================================================
 // RateLimitFileSystem
 // ==========================================================================
 
 RateLimitFileSystem::RateLimitFileSystem(unique_ptr<FileSystem> inner_fs_p, shared_ptr<RateLimitConfig> config_p)
     : filesystem_name(StringUtil::Format("RateLimitFileSystem - %s", inner_fs_p->GetName())),
-      inner_fs(std::move(inner_fs_p)), config(std::move(config_p)) {
+      inner_fs(std::move(inner_fs_p)), config(std::move(config_p)),
+      filesystem_id(next_filesystem_id.fetch_add(1, std::memory_order_relaxed)) {
 	if (!config) {
 		throw InvalidInputException("RateLimitFileSystem requires a non-null RateLimitConfig");
 	}
+	config_filesystem_id = config->InternFilesystem(filesystem_name);
+	stats = config->GetOrCreateStats(filesystem_name);
+	configured_operations = config->GetConfiguredOperations(config_filesystem_id);
 }
 
 RateLimitFileSystem::~RateLimitFileSystem() {
+	// Pooled handles were opened by the inner filesystem, so they can't outlive it.
+	auto handle_pool = GetHandlePool();
+	if (handle_pool) {
+		handle_pool->EraseOwner(filesystem_id);
+	}
+}
+
+const RateLimitConfig::FilesystemSnapshot &RateLimitFileSystem::GetFilesystemSnapshot() {
+	const auto version = config->GetVersion();
+	auto &cache = GetThreadSnapshotCache();
+	for (auto &entry : cache.entries) {
+		if (entry.filesystem_id != filesystem_id) {
+			continue;
+		}
+		if (entry.snapshot->version != version) {
+			entry.snapshot = config->GetFilesystemSnapshot(config_filesystem_id);
+		}
+		return *entry.snapshot;
+	}
+
+	auto &victim = cache.entries[cache.next_victim];
+	cache.next_victim = (cache.next_victim + 1) % SNAPSHOT_CACHE_SIZE;
+	victim.filesystem_id = filesystem_id;
+	victim.snapshot = config->GetFilesystemSnapshot(config_filesystem_id);
+	return *victim.snapshot;
+}
+
+const RateLimitConfig::RateLimitSnapshot &RateLimitFileSystem::GetOperationSnapshot(FileSystemOperation operation) {
+	return GetFilesystemSnapshot().Get(operation);
+}
+
+bool RateLimitFileSystem::IsConfigured(FileSystemOperation operation) const {
+	return (configured_operations->load(std::memory_order_relaxed) & GetOperationBit(operation)) != 0;
+}
+
+SharedRateLimiter RateLimitFileSystem::ResolvePathLimiter(const string &path, FileSystemOperation operation) {
+	if (!IsConfigured(operation)) {
+		return nullptr;
+	}
+	const auto &path_limiters = GetFilesystemSnapshot().path_limiters;
+	if (!path_limiters) {
+		return nullptr;
+	}
+	return path_limiters->Match(path, operation);
+}
+
+RateLimitFileSystem::ByteCharge RateLimitFileSystem::ApplyRateLimit(FileSystemOperation operation, idx_t bytes,
+                                                                    optional_ptr<const RateLimitScope> scope,
+                                                                    optional_ptr<RateLimiter> path_limiter) {
+	ByteCharge charge;
+	charge.operation = operation;
+	charge.bytes = bytes;
+	if (!scope && !path_limiter) {
+		ApplyFilesystemRateLimit(operation, bytes, RateLimitPriority::INTERACTIVE, charge);
+		return charge;
+	}
+
+	const auto priority = scope ? scope->priority : RateLimitPriority::INTERACTIVE;
+	// The connection budget only ever waits, it's the connection's own pacing rather than a shared resource.
+	const auto connection_limiter = scope ? scope->connection_limiter.get() : nullptr;
+	if (connection_limiter) {
+		connection_limiter->UntilNReady(bytes);
+		charge.connection_limiter = connection_limiter;
+	}
+	bool path_charged = false;
+	try {
+		if (path_limiter) {
+			ApplyPathRateLimit(operation, *path_limiter, 1, priority);
+			path_charged = true;
+		}
+		ApplyFilesystemRateLimit(operation, bytes, priority, charge);
+	} catch (...) {
+		// Rejected requests are never issued, so they shouldn't count against the connection or the path.
+		if (path_charged) {
+			path_limiter->Refund(1);
+		}
+		if (connection_limiter) {
+			connection_limiter->Refund(bytes);
+		}
+		throw;
+	}
+	return charge;
+}
+
+void RateLimitFileSystem::RefundUntransferred(const ByteCharge &charge, idx_t transferred) {
+	if (transferred >= charge.bytes) {
+		return;
+	}
+	const auto untransferred = charge.bytes - transferred;
+	stats->Get(charge.operation).RecordRefunded(untransferred);
+	if (charge.connection_limiter) {
+		charge.connection_limiter->Refund(untransferred);
+	}
+	if (!charge.rate_limiter) {
+		return;
+	}
+	// A limiter the config replaced since doesn't carry the charge over, so there's nothing to give back.
+	const auto &rate_limiter = GetOperationSnapshot(charge.operation).rate_limiter;
+	if (rate_limiter.get() != charge.rate_limiter) {
+		return;
+	}
+	const auto charged = GetRequestTokens(charge.cost, charge.operation, charge.bytes);
+	rate_limiter->Refund(charged - GetRequestTokens(charge.cost, charge.operation, transferred));
+}
+
+void RateLimitFileSystem::ApplyPathRateLimit(FileSystemOperation operation, RateLimiter &path_limiter, idx_t calls,
+                                             RateLimitPriority priority) {
+	const auto &snapshot = GetOperationSnapshot(operation);
+	const auto mode = snapshot.mode;
+	if (mode == RateLimitMode::BOUNDED) {
+		const auto deadline = path_limiter.GetClock()->Now() + snapshot.max_wait;
+		auto result = path_limiter.UntilNReadyBy(calls, deadline, priority);
+		if (!result.has_value()) {
+			return;
+		}
+		if (result->wait_duration == Duration::max()) {
+			stats->Get(operation).RecordBurstRejection();
+			throw IOException("%llu calls exceed the path limit burst capacity for operation '%s'", calls,
+			                  FileSystemOperationToString(operation));
+		}
+		stats->Get(operation).RecordRateRejection();
+		throw IOException("Path rate limit exceeded for operation '%s': would wait more than %lld ms",
+		                  FileSystemOperationToString(operation),
+		                  std::chrono::duration_cast<std::chrono::milliseconds>(snapshot.max_wait).count());
+	}
+	if (mode == RateLimitMode::NON_BLOCKING) {
+		auto result = path_limiter.TryAcquireImmediate(calls, priority);
+		if (!result.has_value()) {
+			return;
+		}
+		stats->Get(operation).RecordRateRejection();
+		if (result->wait_duration == Duration::max()) {
+			throw IOException("%llu calls exceed the path limit burst capacity for operation '%s'", calls,
+			                  FileSystemOperationToString(operation));
+		}
+		throw IOException("Path rate limit exceeded for operation '%s': would need to wait %lld ms",
+		                  FileSystemOperationToString(operation),
+		                  std::chrono::duration_cast<std::chrono::milliseconds>(result->wait_duration).count());
+	}
+
+	// Calls aren't split, so split mode, like an unconfigured operation, waits as in blocking mode.
+	auto wait_result = mode == RateLimitMode::FAIR ? path_limiter.UntilNReadyFair(calls, priority)
+	                                               : path_limiter.UntilNReady(calls, priority);
+	if (wait_result == RateLimitResult::InsufficientCapacity) {
+		stats->Get(operation).RecordBurstRejection();
+		throw IOException("%llu calls exceed the path limit burst capacity for operation '%s'", calls,
+		                  FileSystemOperationToString(operation));
+	}
 }
 
-void RateLimitFileSystem::ApplyRateLimit(FileSystemOperation operation, idx_t bytes) {
-	auto snapshot = config->GetRateLimitSnapshot(filesystem_name, operation);
-	if (!snapshot.rate_limiter) {
+void RateLimitFileSystem::ApplyFilesystemRateLimit(FileSystemOperation operation, idx_t bytes,
+                                                   RateLimitPriority priority, ByteCharge &charge) {
+	auto &operation_stats = stats->Get(operation);
+	if (!IsConfigured(operation)) {
+		operation_stats.RecordAdmitted(bytes);
+		return;
+	}
+	const auto &snapshot = GetOperationSnapshot(operation);
+	if (!snapshot.rate_limiter && !snapshot.request_rate_limiter) {
+		operation_stats.RecordAdmitted(bytes);
 		return;
 	}
 
@@ -56,30 +544,117 @@ void RateLimitFileSystem::ApplyRateLimit(FileSystemOperation operation, idx_t by
 		                        FileSystemOperationToString(operation));
 	}
 
+	// The request rate limiter charges one token per call, the rate limiter one per byte or by the cost model. A call
+	// has to pass both: the request token is taken first, and given back if the byte limiter rejects the call.
+	const auto &request_rate_limiter = snapshot.request_rate_limiter;
+	const auto tokens = GetRequestTokens(snapshot.cost, operation, bytes);
+	// Only read by the caller once the call is admitted, since a rejection throws.
+	charge.rate_limiter = snapshot.rate_limiter.get();
+	charge.cost = snapshot.cost;
+
 	// Non-blocking mode: check if we can acquire immediately, throw if not
 	if (snapshot.mode == RateLimitMode::NON_BLOCKING) {
-		auto result = snapshot.rate_limiter->TryAcquireImmediate(bytes);
+		if (request_rate_limiter) {
+			auto result = request_rate_limiter->TryAcquireImmediate(1, priority);
+			if (result.has_value()) {
+				operation_stats.RecordRateRejection();
+				throw IOException("Request rate limit exceeded for operation '%s': would need to wait %lld ms",
+				                  FileSystemOperationToString(operation),
+				                  std::chrono::duration_cast<std::chrono::milliseconds>(result->wait_duration).count());
+			}
+		}
+
+		auto result = snapshot.rate_limiter ? snapshot.rate_limiter->TryAcquireImmediate(tokens, priority)
+		                                    : std::optional<WaitInfo>();
 		// Allowed immediately
 		if (!result.has_value()) {
+			operation_stats.RecordAdmitted(bytes);
+			operation_stats.RecordThrottleWait(Duration::zero());
 			return;
 		}
+		if (request_rate_limiter) {
+			request_rate_limiter->Refund(1);
+		}
 
 		// Check if burst capacity is exceeded
 		if (result->wait_duration == Duration::max()) {
+			operation_stats.RecordBurstRejection();
 			throw IOException("Request size %llu exceeds burst capacity for operation '%s'", bytes,
 			                  FileSystemOperationToString(operation));
 		}
 
 		// Rate limit exceeded, throw immediately
+		operation_stats.RecordRateRejection();
 		throw IOException("Rate limit exceeded for operation '%s': would need to wait %lld ms",
 		                  FileSystemOperationToString(operation),
 		                  std::chrono::duration_cast<std::chrono::milliseconds>(result->wait_duration).count());
 	}
 
-	// Blocking mode: wait until ready
-	D_ASSERT(snapshot.mode == RateLimitMode::BLOCKING);
-	auto wait_result = snapshot.rate_limiter->UntilNReady(bytes);
+	// Bounded mode: wait as in blocking mode, but only up to the max wait, measured from the start of the call so that
+	// it covers both limiters. A call which can't make the deadline fails right away rather than after waiting.
+	if (snapshot.mode == RateLimitMode::BOUNDED) {
+		const auto &clock =
+		    snapshot.rate_limiter ? snapshot.rate_limiter->GetClock() : request_rate_limiter->GetClock();
+		const auto wait_start = clock->Now();
+		const auto deadline = wait_start + snapshot.max_wait;
+		const auto max_wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(snapshot.max_wait).count();
+		if (request_rate_limiter) {
+			auto result = request_rate_limiter->UntilNReadyBy(1, deadline, priority);
+			if (result.has_value()) {
+				operation_stats.RecordRateRejection();
+				throw IOException("Request rate limit exceeded for operation '%s': would wait more than %lld ms",
+				                  FileSystemOperationToString(operation), max_wait_ms);
+			}
+		}
+
+		auto result = snapshot.rate_limiter ? snapshot.rate_limiter->UntilNReadyBy(tokens, deadline, priority)
+		                                    : std::optional<WaitInfo>();
+		if (!result.has_value()) {
+			operation_stats.RecordAdmitted(bytes);
+			operation_stats.RecordThrottleWait(clock->Now() - wait_start);
+			return;
+		}
+		if (request_rate_limiter) {
+			request_rate_limiter->Refund(1);
+		}
+		if (result->wait_duration == Duration::max()) {
+			operation_stats.RecordBurstRejection();
+			throw IOException("Request size %llu exceeds burst capacity for operation '%s'", bytes,
+			                  FileSystemOperationToString(operation));
+		}
+		operation_stats.RecordRateRejection();
+		throw IOException("Rate limit exceeded for operation '%s': would wait more than %lld ms",
+		                  FileSystemOperationToString(operation), max_wait_ms);
+	}
+
+	// Blocking, split and fair mode: wait until ready. Split mode callers have already cut the request into
+	// burst-sized chunks, so capacity can only be insufficient if the burst shrank concurrently.
+	D_ASSERT(snapshot.mode == RateLimitMode::BLOCKING || snapshot.mode == RateLimitMode::SPLIT ||
+	         snapshot.mode == RateLimitMode::FAIR);
+	auto wait_until_ready = [&](RateLimiter &rate_limiter, idx_t n) {
+		return snapshot.mode == RateLimitMode::FAIR ? rate_limiter.UntilNReadyFair(n, priority)
+		                                            : rate_limiter.UntilNReady(n, priority);
+	};
+	const auto &clock = snapshot.rate_limiter ? snapshot.rate_limiter->GetClock() : request_rate_limiter->GetClock();
+	const auto wait_start = clock->Now();
+	if (request_rate_limiter) {
+		// Without a burst, a single token always fits.
+		auto request_wait_result = wait_until_ready(*request_rate_limiter, 1);
+		D_ASSERT(request_wait_result == RateLimitResult::Allowed);
+		(void)request_wait_result;
+	}
+	auto wait_result =
+	    snapshot.rate_limiter ? wait_until_ready(*snapshot.rate_limiter, tokens) : RateLimitResult::Allowed;
+	if (wait_result == RateLimitResult::Allowed) {
+		operation_stats.RecordAdmitted(bytes);
+		operation_stats.RecordThrottleWait(clock->Now() - wait_start);
+		return;
+	}
 	if (wait_result == RateLimitResult::InsufficientCapacity) {
+		if (request_rate_limiter) {
+			request_rate_limiter->Refund(1);
+		}
+		operation_stats.RecordBurstRejection();
 		throw IOException("Request size %llu exceeds burst capacity for operation '%s'", bytes,
 		                  FileSystemOperationToString(operation));
 	}
@@ -90,12 +665,190 @@ FileHandle &RateLimitFileSystem::GetInnerFileHandle(FileHandle &handle) {
 	return rate_limit_handle.GetInnerHandle();
 }
 
-SemaphoreGuard RateLimitFileSystem::AcquireConcurrencySlot(FileSystemOperation operation) {
-	auto semaphore = config->GetOrCreateSemaphore(filesystem_name, operation);
+idx_t RateLimitFileSystem::GetChargeableReadBytes(RateLimitFileHandle &handle, int64_t nr_bytes, idx_t location) {
+	const auto requested = static_cast<idx_t>(nr_bytes);
+	auto file_size = handle.GetCachedFileSize();
+	// Refetch when the read runs past the cached size as well, since the file may have grown through another handle.
+	if (file_size == RateLimitFileHandle::UNKNOWN_FILE_SIZE || location + requested > static_cast<idx_t>(file_size)) {
+		file_size = inner_fs->GetFileSize(handle.GetInnerHandle());
+		handle.SetCachedFileSize(file_size);
+	}
+	const auto size = static_cast<idx_t>(file_size);
+	if (location >= size) {
+		return 0;
+	}
+	return MinValue<idx_t>(requested, size - location);
+}
+
+idx_t RateLimitFileSystem::GetSplitChunkSize(FileSystemOperation operation, idx_t bytes) {
+	if (!IsConfigured(operation)) {
+		return 0;
+	}
+	const auto &snapshot = GetOperationSnapshot(operation);
+	if (snapshot.mode != RateLimitMode::SPLIT || !snapshot.rate_limiter) {
+		return 0;
+	}
+	// Chunks have to fit the tightest burst along the limiter group chain.
+	const auto burst = snapshot.rate_limiter->GetEffectiveBurst();
+	if (burst == 0) {
+		return 0;
+	}
+	// With a cost model, every chunk also pays the call cost. If not even that fits, the call is left to be rejected.
+	const auto chunk_size = snapshot.cost.IsSet() ? snapshot.cost.GetMaxBytes(burst) : burst;
+	if (chunk_size == 0 || bytes <= chunk_size) {
+		return 0;
+	}
+	return chunk_size;
+}
+
+void RateLimitFileSystem::IssueSplitChunks(FileSystemOperation operation, OperationSlot &slot, idx_t total_bytes,
+                                           idx_t chunk_size, const SplitChunkFunction &issue_chunk) {
+	const idx_t chunk_count = (total_bytes + chunk_size - 1) / chunk_size;
+	atomic<idx_t> next_chunk {0};
+	atomic<bool> slot_taken {false};
+	auto run_chunks = [&](OperationSlot &runner_slot) {
+		for (idx_t idx = next_chunk.fetch_add(1); idx < chunk_count; idx = next_chunk.fetch_add(1)) {
+			const idx_t offset = idx * chunk_size;
+			try {
+				issue_chunk(runner_slot, offset, MinValue<idx_t>(chunk_size, total_bytes - offset));
+			} catch (...) {
+				// The call fails as a whole, so don't issue the remaining chunks.
+				next_chunk.store(chunk_count);
+				throw;
+			}
+		}
+	};
+	const auto runner_count = MinValue<idx_t>(chunk_count, GetMaxConcurrentTransfers(operation));
+	GetTransferPool().RunConcurrently(runner_count, [&]() {
+		if (next_chunk.load() >= chunk_count) {
+			return;
+		}
+		bool expected = false;
+		if (slot_taken.compare_exchange_strong(expected, true)) {
+			run_chunks(slot);
+			return;
+		}
+		auto runner_slot = AcquireConcurrencySlot(operation);
+		run_chunks(runner_slot);
+	});
+}
+
+idx_t RateLimitFileSystem::GetMaxConcurrentTransfers(FileSystemOperation operation) {
+	// More transfers than concurrency slots would only queue on the semaphore.
+	idx_t count = MAX_TRANSFER_THREADS;
+	if (IsConfigured(operation)) {
+		const auto &semaphore = GetOperationSnapshot(operation).semaphore;
+		if (semaphore && semaphore->GetMax() > 0) {
+			count = MinValue<idx_t>(count, static_cast<idx_t>(semaphore->GetMax()));
+		}
+	}
+	return count;
+}
+
+OperationSlot RateLimitFileSystem::AcquireConcurrencySlot(FileSystemOperation operation) {
+	auto &operation_stats = stats->Get(operation);
+	if (!IsConfigured(operation)) {
+		return OperationSlot(SemaphoreGuard(), operation_stats);
+	}
+	const auto &snapshot = GetOperationSnapshot(operation);
+	const auto &semaphore = snapshot.semaphore;
 	if (!semaphore) {
-		return SemaphoreGuard();
+		return OperationSlot(SemaphoreGuard(), operation_stats, nullptr, snapshot.throttle_backoff,
+		                     GetOperationTrace(operation, snapshot, Duration::zero()));
 	}
-	return semaphore->AcquireGuard();
+	// The semaphore blocks in real time whatever the configured clock, so measure the wait with the steady clock.
+	const auto wait_start = std::chrono::steady_clock::now();
+	// Share ownership, since the snapshot may be replaced on this thread before the slot is released.
+	SemaphoreGuard guard(semaphore);
+	const Duration semaphore_wait = std::chrono::steady_clock::now() - wait_start;
+	operation_stats.RecordSemaphoreWait(semaphore_wait);
+	return OperationSlot(std::move(guard), operation_stats, snapshot.adaptive_limiter, snapshot.throttle_backoff,
+	                     GetOperationTrace(operation, snapshot, semaphore_wait));
+}
+
+OperationSlot RateLimitFileSystem::AcquireReadSlot(RateLimitFileHandle &handle,
+                                                   concurrency::unique_lock<concurrency::mutex> &stream_lock) {
+	if (!IsConfigured(FileSystemOperation::READ)) {
+		return AcquireConcurrencySlot(FileSystemOperation::READ);
+	}
+	const auto &snapshot = GetOperationSnapshot(FileSystemOperation::READ);
+	if (snapshot.stream_idle_timeout == Duration::zero() || !snapshot.semaphore || !stream_lock.try_lock()) {
+		return AcquireConcurrencySlot(FileSystemOperation::READ);
+	}
+
+	auto &operation_stats = stats->Get(FileSystemOperation::READ);
+	auto &stream_slot = *handle.GetStreamSlot();
+	// Slots of a semaphore replaced by a max requests change no longer bound anything.
+	if (stream_slot.semaphore != snapshot.semaphore) {
+		stream_slot.Release();
+	}
+	const auto &timer_clock = RateLimitTimer::GetDefault().GetClock();
+	stream_slot.idle_timeout = snapshot.stream_idle_timeout;
+	Duration semaphore_wait = Duration::zero();
+	if (!stream_slot.semaphore) {
+		const auto wait_start = std::chrono::steady_clock::now();
+		stream_slot.guard = SemaphoreGuard(snapshot.semaphore);
+		stream_slot.semaphore = snapshot.semaphore;
+		semaphore_wait = std::chrono::steady_clock::now() - wait_start;
+		operation_stats.RecordSemaphoreWait(semaphore_wait);
+		ScheduleStreamSlotRelease(handle.GetStreamSlot(), timer_clock->Now() + stream_slot.idle_timeout,
+		                          stream_slot.idle_timeout);
+	}
+	stream_slot.last_used = timer_clock->Now();
+	return OperationSlot(SemaphoreGuard(), operation_stats, snapshot.adaptive_limiter, snapshot.throttle_backoff,
+	                     GetOperationTrace(FileSystemOperation::READ, snapshot, semaphore_wait));
+}
+
+OperationTrace RateLimitFileSystem::GetOperationTrace(FileSystemOperation operation,
+                                                      const RateLimitConfig::RateLimitSnapshot &snapshot,
+                                                      Duration semaphore_wait) {
+	if (!snapshot.trace_clock || !stats->Get(operation).ShouldTrace(snapshot.trace_sample_every)) {
+		return OperationTrace();
+	}
+	OperationTrace trace;
+	trace.clock = snapshot.trace_clock;
+	trace.semaphore_wait = semaphore_wait;
+	trace.callback = [this, operation](Duration slot_wait, Duration latency) {
+		auto db = config->GetDatabaseInstance();
+		if (!db) {
+			return;
+		}
+		using std::chrono::microseconds;
+		const auto message = StringUtil::Format(
+		    "Traced %s call on %s: %lld us waiting for a concurrency slot, %lld us in the wrapped filesystem.",
+		    FileSystemOperationToString(operation), GetName(),
+		    static_cast<long long>(std::chrono::duration_cast<microseconds>(slot_wait).count()),
+		    static_cast<long long>(std::chrono::duration_cast<microseconds>(latency).count()));
+		DUCKDB_LOG_DEBUG(*db, message);
+	};
+	return trace;
+}
+
+void RateLimitFileSystem::ScheduleStreamSlotRelease(weak_ptr<StreamSlot> stream_slot, TimePoint deadline,
+                                                    Duration idle_timeout) {
+	auto &timer = RateLimitTimer::GetDefault();
+	timer.Schedule(deadline, [stream_slot, idle_timeout]() {
+		auto slot = stream_slot.lock();
+		if (!slot) {
+			return;
+		}
+		const auto now = RateLimitTimer::GetDefault().GetClock()->Now();
+		// Timer tasks mustn't block, so a slot busy with a read is checked again one idle timeout later.
+		concurrency::unique_lock<concurrency::mutex> guard(slot->lock, std::try_to_lock);
+		if (!guard.owns_lock()) {
+			ScheduleStreamSlotRelease(stream_slot, now + idle_timeout, idle_timeout);
+			return;
+		}
+		if (!slot->semaphore) {
+			return;
+		}
+		const auto idle_until = slot->last_used + slot->idle_timeout;
+		if (now >= idle_until) {
+			slot->Release();
+			return;
+		}
+		ScheduleStreamSlotRelease(stream_slot, idle_until, slot->idle_timeout);
+	});
 }
 
 // ==========================================================================
@@ -109,153 +862,975 @@ unique_ptr<FileHandle> RateLimitFileSystem::OpenFile(const string &path, FileOpe
 
 unique_ptr<FileHandle> RateLimitFileSystem::OpenFileExtended(const OpenFileInfo &file, FileOpenFlags flags,
                                                              optional_ptr<FileOpener> opener) {
-	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	auto inner_handle = inner_fs->OpenFile(file, flags, opener);
-	if (!inner_handle) {
-		return nullptr;
+	const auto open_operation =
+	    IsConfigured(FileSystemOperation::OPEN) ? FileSystemOperation::OPEN : FileSystemOperation::STAT;
+	auto handle_pool = HandlePool::CanPool(flags) ? GetHandlePool() : nullptr;
+	PooledHandle pooled;
+	if (handle_pool) {
+		pooled = handle_pool->Take(filesystem_id, file.path, flags, GetKnownVersionTag(file));
+	}
+	const bool reused = pooled.handle != nullptr;
+	unique_ptr<FileHandle> inner_handle;
+	if (reused) {
+		inner_handle = std::move(pooled.handle);
+		inner_fs->Reset(*inner_handle);
+	} else {
+		auto concurrency_guard = AcquireConcurrencySlot(open_operation);
+		auto path_limiter = ResolvePathLimiter(file.path, open_operation);
+		ApplyRateLimit(open_operation, 1, nullptr, path_limiter.get());
+		inner_handle = concurrency_guard.Track([&] { return inner_fs->OpenFile(file, flags, opener); });
+		if (!inner_handle) {
+			return nullptr;
+		}
+	}
+	auto handle = make_uniq<RateLimitFileHandle>(*this, std::move(inner_handle), file.path, flags);
+	if (reused && pooled.file_size != RateLimitFileHandle::UNKNOWN_FILE_SIZE) {
+		handle->SetCachedFileSize(pooled.file_size);
 	}
-	return make_uniq<RateLimitFileHandle>(*this, std::move(inner_handle), file.path, flags);
+	handle->SetScope(RateLimitScope::FromOpener(opener, config->GetClock()));
+	if (configured_operations->load(std::memory_order_relaxed) == 0) {
+		return std::move(handle);
+	}
+	const auto &path_limiters = GetFilesystemSnapshot().path_limiters;
+	if (path_limiters) {
+		handle->SetPathLimiters(path_limiters->MatchAll(file.path));
+	}
+	if (flags.OpenForWriting()) {
+		InvalidateMetadata(file.path);
+	} else {
+		CacheListedMetadata(file, file.path);
+	}
+	const bool block_cache_enabled = flags.OpenForReading() && IsConfigured(FileSystemOperation::READ) &&
+	                                 GetOperationSnapshot(FileSystemOperation::READ).block_cache;
+	if (block_cache_enabled || handle_pool) {
+		// Taken once per handle, so cached reads don't need a metadata call each time. A reused handle keeps the tag
+		// it was pooled with, which the pool checked against the known one.
+		auto version_tag = reused ? pooled.version_tag : inner_fs->GetVersionTag(handle->GetInnerHandle());
+		if (block_cache_enabled) {
+			handle->EnableBlockCache(version_tag);
+		}
+		if (handle_pool) {
+			handle->EnableHandlePool(std::move(handle_pool), filesystem_id, std::move(version_tag));
+		}
+	}
+	if (flags.OpenForWriting() && IsConfigured(FileSystemOperation::WRITE)) {
+		const auto buffer_size = GetOperationSnapshot(FileSystemOperation::WRITE).write_behind_buffer_size;
+		if (buffer_size > 0) {
+			auto &rate_limit_handle = *handle;
+			handle->EnableWriteBehind(make_uniq<WriteBehindBuffer>(
+			    buffer_size, [this, &rate_limit_handle](const_data_ptr_t data, idx_t size, optional_idx location) {
+				    auto *buffer = const_cast<data_ptr_t>(data);
+				    if (location.IsValid()) {
+					    WriteAt(rate_limit_handle, buffer, static_cast<int64_t>(size), location.GetIndex());
+					    return;
+				    }
+				    const auto written = WriteAtFilePointer(rate_limit_handle, buffer, static_cast<int64_t>(size));
+				    if (static_cast<idx_t>(written) < size) {
+					    throw IOException("Write-behind flush to '%s' wrote %lld of %llu bytes",
+					                      rate_limit_handle.GetPath(), static_cast<long long>(written),
+					                      static_cast<unsigned long long>(size));
+				    }
+			    }));
+		}
+	}
+	return std::move(handle);
 }
 
 void RateLimitFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::READ);
-	auto &inner_handle = GetInnerFileHandle(handle);
-	auto file_size = inner_fs->GetFileSize(inner_handle);
-	const idx_t actual_bytes = MinValue<idx_t>(static_cast<idx_t>(nr_bytes), static_cast<idx_t>(file_size) - location);
-	ApplyRateLimit(FileSystemOperation::READ, actual_bytes);
-	inner_fs->Read(inner_handle, buffer, nr_bytes, location);
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	rate_limit_handle.DrainWriteBehind();
+	// Prefetched bytes were charged when they were fetched.
+	if (rate_limit_handle.ReadFromPrefetched(buffer, static_cast<idx_t>(nr_bytes), location)) {
+		return;
+	}
+	if (!IsConfigured(FileSystemOperation::READ)) {
+		ReadAt(rate_limit_handle, buffer, nr_bytes, location);
+		return;
+	}
+	// Copied, since the snapshot reference doesn't survive the limiter lookups of the reads below.
+	const auto &snapshot = GetOperationSnapshot(FileSystemOperation::READ);
+	const idx_t buffer_size = snapshot.read_ahead_buffer_size;
+	const idx_t window = snapshot.read_ahead_window;
+	const auto block_cache = snapshot.block_cache;
+	const auto read_bytes = static_cast<idx_t>(nr_bytes);
+	// Cached blocks already coalesce reads, so read-ahead only applies without the cache.
+	if (block_cache && rate_limit_handle.IsBlockCacheEnabled()) {
+		ReadThroughBlockCache(rate_limit_handle, *block_cache, buffer, read_bytes, location);
+		return;
+	}
+	if (buffer_size == 0) {
+		ReadAt(rate_limit_handle, buffer, nr_bytes, location);
+		return;
+	}
+	const bool sequential = rate_limit_handle.RecordRead(read_bytes, location, window);
+	if (read_bytes >= buffer_size) {
+		ReadAt(rate_limit_handle, buffer, nr_bytes, location);
+		return;
+	}
+
+	// Buffered bytes were charged when they were fetched.
+	if (rate_limit_handle.ReadFromBuffer(buffer, read_bytes, location)) {
+		return;
+	}
+	if (!sequential) {
+		ReadAt(rate_limit_handle, buffer, nr_bytes, location);
+		return;
+	}
+
+	// Fetch from the read that missed rather than from an aligned offset below it, so a sequential scan never fetches
+	// bytes it already has buffered.
+	const idx_t fetch_start = location;
+	const idx_t fetch_bytes = GetChargeableReadBytes(rate_limit_handle, static_cast<int64_t>(buffer_size), fetch_start);
+	if (fetch_start + fetch_bytes < location + read_bytes) {
+		// The read runs past the end of the file, leave it to the inner filesystem to report.
+		ReadAt(rate_limit_handle, buffer, nr_bytes, location);
+		return;
+	}
+	auto data = make_unsafe_uniq_array<data_t>(fetch_bytes);
+	ReadAt(rate_limit_handle, data.get(), static_cast<int64_t>(fetch_bytes), fetch_start);
+	memcpy(buffer, data.get() + (location - fetch_start), read_bytes);
+	rate_limit_handle.SetReadBuffer(std::move(data), fetch_bytes, fetch_start);
+}
+
+void RateLimitFileSystem::ReadThroughBlockCache(RateLimitFileHandle &handle, BlockCache &block_cache, void *buffer,
+                                                idx_t nr_bytes, idx_t location) {
+	if (nr_bytes == 0 ||
+	    GetChargeableReadBytes(handle, static_cast<int64_t>(nr_bytes), location) < nr_bytes) {
+		// Leave reads running past the end of the file to the inner filesystem to report.
+		ReadAt(handle, buffer, static_cast<int64_t>(nr_bytes), location);
+		return;
+	}
+	const auto file_size = static_cast<idx_t>(handle.GetCachedFileSize());
+	const idx_t block_size = block_cache.GetBlockSize();
+	const idx_t first_block = location / block_size;
+	const idx_t block_count = (location + nr_bytes - 1) / block_size - first_block + 1;
+
+	BlockCacheKey key {handle.GetPath(), handle.GetCacheVersionTag(), 0};
+	vector<shared_ptr<const CachedBlock>> blocks(block_count);
+	for (idx_t idx = 0; idx < block_count; ++idx) {
+		key.block_index = first_block + idx;
+		blocks[idx] = block_cache.Get(key);
+	}
+
+	for (idx_t run_begin = 0; run_begin < block_count;) {
+		if (blocks[run_begin]) {
+			++run_begin;
+			continue;
+		}
+		idx_t run_end = run_begin + 1;
+		while (run_end < block_count && !blocks[run_end]) {
+			++run_end;
+		}
+		// Only misses reach the inner filesystem and its limits.
+		const idx_t fetch_start = (first_block + run_begin) * block_size;
+		const idx_t fetch_end = MinValue<idx_t>((first_block + run_end) * block_size, file_size);
+		auto data = make_unsafe_uniq_array<data_t>(fetch_end - fetch_start);
+		ReadAt(handle, data.get(), static_cast<int64_t>(fetch_end - fetch_start), fetch_start);
+		for (idx_t idx = run_begin; idx < run_end; ++idx) {
+			const idx_t block_start = (first_block + idx) * block_size;
+			auto block = make_shared_ptr<CachedBlock>();
+			block->size = MinValue<idx_t>(block_size, fetch_end - block_start);
+			block->data = make_unsafe_uniq_array<data_t>(block->size);
+			memcpy(block->data.get(), data.get() + (block_start - fetch_start), block->size);
+			key.block_index = first_block + idx;
+			block_cache.Put(key, block);
+			blocks[idx] = std::move(block);
+		}
+		run_begin = run_end;
+	}
+
+	auto *out = static_cast<data_ptr_t>(buffer);
+	for (idx_t idx = 0; idx < block_count; ++idx) {
+		const idx_t block_start = (first_block + idx) * block_size;
+		const idx_t copy_start = MaxValue<idx_t>(block_start, location);
+		const idx_t copy_end = MinValue<idx_t>(block_start + blocks[idx]->size, location + nr_bytes);
+		memcpy(out + (copy_start - location), blocks[idx]->data.get() + (copy_start - block_start),
+		       copy_end - copy_start);
+	}
+}
+
+void RateLimitFileSystem::InvalidateReadState(RateLimitFileHandle &handle) {
+	handle.InvalidateCachedFileSize();
+	handle.InvalidateReadBuffer();
+	handle.InvalidatePrefetchedRanges();
+	InvalidateMetadata(handle.GetPath());
+}
+
+shared_ptr<MetadataCache> RateLimitFileSystem::GetMetadataCache() {
+	if (!IsConfigured(FileSystemOperation::STAT)) {
+		return nullptr;
+	}
+	return GetOperationSnapshot(FileSystemOperation::STAT).metadata_cache;
+}
+
+void RateLimitFileSystem::InvalidateMetadata(const string &path) {
+	auto metadata_cache = GetMetadataCache();
+	if (metadata_cache) {
+		metadata_cache->Erase(path);
+	}
+	auto handle_pool = GetHandlePool();
+	if (handle_pool) {
+		handle_pool->Erase(path);
+	}
+	// Whatever the flags of the changing handle, since blocks are cached by the handles that read the path.
+	if (IsConfigured(FileSystemOperation::READ)) {
+		const auto &block_cache = GetOperationSnapshot(FileSystemOperation::READ).block_cache;
+		if (block_cache) {
+			block_cache->ErasePath(path);
+		}
+	}
+}
+
+void RateLimitFileSystem::InvalidateDirectory(const string &directory) {
+	InvalidateMetadata(directory);
+	const auto separator = inner_fs->PathSeparator(directory);
+	const auto prefix = StringUtil::EndsWith(directory, separator) ? directory : directory + separator;
+	auto metadata_cache = GetMetadataCache();
+	if (metadata_cache) {
+		metadata_cache->ErasePrefix(prefix);
+	}
+	// Without a known version tag, a pooled handle of a file under a recreated directory would be reused.
+	auto handle_pool = GetHandlePool();
+	if (handle_pool) {
+		handle_pool->ErasePrefix(prefix);
+	}
+}
+
+shared_ptr<HandlePool> RateLimitFileSystem::GetHandlePool() {
+	if (!IsConfigured(FileSystemOperation::OPEN)) {
+		return nullptr;
+	}
+	return GetOperationSnapshot(FileSystemOperation::OPEN).handle_pool;
+}
+
+string RateLimitFileSystem::GetKnownVersionTag(const OpenFileInfo &file) {
+	CachedMetadata listed;
+	MergeExtendedInfo(file, listed);
+	if (listed.has_version_tag) {
+		return listed.version_tag;
+	}
+	string version_tag;
+	auto metadata_cache = GetMetadataCache();
+	if (metadata_cache) {
+		metadata_cache->Get(file.path, [&](const CachedMetadata &metadata) {
+			if (!metadata.has_version_tag) {
+				return false;
+			}
+			version_tag = metadata.version_tag;
+			return true;
+		});
+	}
+	return version_tag;
+}
+
+void RateLimitFileSystem::CacheListedMetadata(const OpenFileInfo &info, const string &path) {
+	auto metadata_cache = GetMetadataCache();
+	if (!metadata_cache) {
+		return;
+	}
+	metadata_cache->Update(path, [&](CachedMetadata &metadata) {
+		metadata.has_exists = true;
+		metadata.exists = true;
+		MergeExtendedInfo(info, metadata);
+	});
+}
+
+void RateLimitFileSystem::ReadAt(RateLimitFileHandle &rate_limit_handle, void *buffer, int64_t nr_bytes,
+                                 idx_t location) {
+	concurrency::unique_lock<concurrency::mutex> stream_lock(rate_limit_handle.GetStreamSlot()->lock, std::defer_lock);
+	auto concurrency_guard = AcquireReadSlot(rate_limit_handle, stream_lock);
+	auto &inner_handle = rate_limit_handle.GetInnerHandle();
+	const idx_t actual_bytes = GetChargeableReadBytes(rate_limit_handle, nr_bytes, location);
+	stats->Get(FileSystemOperation::READ).RecordRequestSize(actual_bytes);
+	const idx_t chunk_size = GetSplitChunkSize(FileSystemOperation::READ, actual_bytes);
+	if (chunk_size == 0) {
+		const auto charge = ApplyRateLimit(FileSystemOperation::READ, actual_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::READ));
+		TrackTransfer(concurrency_guard, charge, /*retry=*/true,
+		              [&] { inner_fs->Read(inner_handle, buffer, nr_bytes, location); });
+		return;
+	}
+
+	auto *data = static_cast<data_ptr_t>(buffer);
+	IssueSplitChunks(FileSystemOperation::READ, concurrency_guard, static_cast<idx_t>(nr_bytes), chunk_size,
+	                 [&](OperationSlot &slot, idx_t offset, idx_t cur_bytes) {
+		                 // Only charge the part of the chunk which lies within the file.
+		                 const idx_t cur_charge =
+		                     offset < actual_bytes ? MinValue<idx_t>(cur_bytes, actual_bytes - offset) : 0;
+		                 const auto charge =
+		                     ApplyRateLimit(FileSystemOperation::READ, cur_charge, &rate_limit_handle.GetScope(),
+		                                    rate_limit_handle.GetPathLimiter(FileSystemOperation::READ));
+		                 TrackTransfer(slot, charge, /*retry=*/true, [&] {
+			                 inner_fs->Read(inner_handle, data + offset, static_cast<int64_t>(cur_bytes),
+			                                location + offset);
+		                 });
+	                 });
+}
+
+void RateLimitFileSystem::Prefetch(RateLimitFileHandle &handle, const vector<PrefetchRange> &ranges) {
+	handle.DrainWriteBehind();
+	// Clamped to the file up front, so no read runs past its end.
+	vector<PrefetchRange> reads;
+	for (const auto &range : ranges) {
+		const auto length = GetChargeableReadBytes(handle, static_cast<int64_t>(range.length), range.offset);
+		if (length > 0) {
+			reads.push_back(PrefetchRange {range.offset, length});
+		}
+	}
+
+	const idx_t reader_count = MinValue<idx_t>(reads.size(), GetMaxConcurrentTransfers(FileSystemOperation::READ));
+
+	// Every read is charged as it's issued, like a positional read, so the first ranges don't wait for the tokens of
+	// the whole prefetch and split mode still applies to ranges larger than the burst.
+	vector<unsafe_unique_array<data_t>> buffers(reads.size());
+	atomic<idx_t> next_read {0};
+	concurrency::mutex error_lock;
+	std::exception_ptr error;
+	auto run_reads = [&]() {
+		for (idx_t idx = next_read.fetch_add(1); idx < reads.size(); idx = next_read.fetch_add(1)) {
+			try {
+				buffers[idx] = make_unsafe_uniq_array<data_t>(reads[idx].length);
+				ReadAt(handle, buffers[idx].get(), static_cast<int64_t>(reads[idx].length), reads[idx].offset);
+			} catch (...) {
+				concurrency::lock_guard<concurrency::mutex> guard(error_lock);
+				if (!error) {
+					error = std::current_exception();
+				}
+				// The prefetch fails as a whole, so don't issue the remaining reads.
+				next_read.store(reads.size());
+				return;
+			}
+		}
+	};
+	// The calling thread reads as well, so the prefetch completes even while other prefetches keep every worker busy.
+	GetTransferPool().RunConcurrently(reader_count, run_reads);
+	if (error) {
+		std::rethrow_exception(error);
+	}
+
+	map<idx_t, PrefetchedRange> prefetched;
+	for (idx_t idx = 0; idx < reads.size(); ++idx) {
+		prefetched[reads[idx].offset] = PrefetchedRange {std::move(buffers[idx]), reads[idx].length};
+	}
+	handle.SetPrefetchedRanges(std::move(prefetched));
 }
 
 // TODO: Consider how multipart upload interacts with concurrency limits.
 // A single Write at the filesystem level may fan out into multiple HTTP PUT requests
 // for large payloads, which means the actual TCP connection count could exceed the limit.
 void RateLimitFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	auto write_behind = rate_limit_handle.GetWriteBehind();
+	if (write_behind) {
+		write_behind->Write(static_cast<const_data_ptr_t>(buffer), static_cast<idx_t>(nr_bytes), location);
+		return;
+	}
+	WriteAt(rate_limit_handle, buffer, nr_bytes, location);
+}
+
+void RateLimitFileSystem::WriteAt(RateLimitFileHandle &rate_limit_handle, void *buffer, int64_t nr_bytes,
+                                  idx_t location) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::WRITE);
-	ApplyRateLimit(FileSystemOperation::WRITE, static_cast<idx_t>(nr_bytes));
-	inner_fs->Write(GetInnerFileHandle(handle), buffer, nr_bytes, location);
+	auto &inner_handle = rate_limit_handle.GetInnerHandle();
+	const auto total_bytes = static_cast<idx_t>(nr_bytes);
+	stats->Get(FileSystemOperation::WRITE).RecordRequestSize(total_bytes);
+	const idx_t chunk_size = GetSplitChunkSize(FileSystemOperation::WRITE, total_bytes);
+	if (chunk_size == 0) {
+		const auto charge = ApplyRateLimit(FileSystemOperation::WRITE, total_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+		TrackTransfer(concurrency_guard, charge, /*retry=*/true,
+		              [&] { inner_fs->Write(inner_handle, buffer, nr_bytes, location); });
+		InvalidateReadState(rate_limit_handle);
+		return;
+	}
+
+	auto *data = static_cast<data_ptr_t>(buffer);
+	IssueSplitChunks(FileSystemOperation::WRITE, concurrency_guard, total_bytes, chunk_size,
+	                 [&](OperationSlot &slot, idx_t offset, idx_t cur_bytes) {
+		                 const auto charge =
+		                     ApplyRateLimit(FileSystemOperation::WRITE, cur_bytes, &rate_limit_handle.GetScope(),
+		                                    rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+		                 TrackTransfer(slot, charge, /*retry=*/true, [&] {
+			                 inner_fs->Write(inner_handle, data + offset, static_cast<int64_t>(cur_bytes),
+			                                 location + offset);
+		                 });
+	                 });
+	InvalidateReadState(rate_limit_handle);
 }
 
 int64_t RateLimitFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
-	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::READ);
-	ApplyRateLimit(FileSystemOperation::READ, static_cast<idx_t>(nr_bytes));
-	return inner_fs->Read(GetInnerFileHandle(handle), buffer, nr_bytes);
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	rate_limit_handle.DrainWriteBehind();
+	concurrency::unique_lock<concurrency::mutex> stream_lock(rate_limit_handle.GetStreamSlot()->lock, std::defer_lock);
+	auto concurrency_guard = AcquireReadSlot(rate_limit_handle, stream_lock);
+	auto &inner_handle = rate_limit_handle.GetInnerHandle();
+	const auto total_bytes = static_cast<idx_t>(nr_bytes);
+	stats->Get(FileSystemOperation::READ).RecordRequestSize(total_bytes);
+	const idx_t chunk_size = GetSplitChunkSize(FileSystemOperation::READ, total_bytes);
+	if (chunk_size == 0) {
+		const auto charge = ApplyRateLimit(FileSystemOperation::READ, total_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::READ));
+		const auto bytes_read = TrackTransfer(concurrency_guard, charge, /*retry=*/false,
+		                                      [&] { return inner_fs->Read(inner_handle, buffer, nr_bytes); });
+		// Streaming reads come back short at the end of the file.
+		RefundUntransferred(charge, static_cast<idx_t>(bytes_read));
+		return bytes_read;
+	}
+
+	auto *data = static_cast<data_ptr_t>(buffer);
+	idx_t offset = 0;
+	while (offset < total_bytes) {
+		const idx_t cur_bytes = MinValue<idx_t>(chunk_size, total_bytes - offset);
+		const auto charge = ApplyRateLimit(FileSystemOperation::READ, cur_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::READ));
+		const auto bytes_read = TrackTransfer(concurrency_guard, charge, /*retry=*/false, [&] {
+			return inner_fs->Read(inner_handle, data + offset, static_cast<int64_t>(cur_bytes));
+		});
+		RefundUntransferred(charge, static_cast<idx_t>(bytes_read));
+		offset += static_cast<idx_t>(bytes_read);
+		// A short read means end of file, stop instead of paying for chunks that won't return data.
+		if (static_cast<idx_t>(bytes_read) < cur_bytes) {
+			break;
+		}
+	}
+	return static_cast<int64_t>(offset);
 }
 
 int64_t RateLimitFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	auto write_behind = rate_limit_handle.GetWriteBehind();
+	if (write_behind) {
+		// Reported as written in full; a short write is raised as an error by a later call instead.
+		write_behind->Write(static_cast<const_data_ptr_t>(buffer), static_cast<idx_t>(nr_bytes), optional_idx());
+		return nr_bytes;
+	}
+	return WriteAtFilePointer(rate_limit_handle, buffer, nr_bytes);
+}
+
+int64_t RateLimitFileSystem::WriteAtFilePointer(RateLimitFileHandle &rate_limit_handle, void *buffer,
+                                                int64_t nr_bytes) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::WRITE);
-	ApplyRateLimit(FileSystemOperation::WRITE, static_cast<idx_t>(nr_bytes));
-	return inner_fs->Write(GetInnerFileHandle(handle), buffer, nr_bytes);
+	auto &inner_handle = rate_limit_handle.GetInnerHandle();
+	const auto total_bytes = static_cast<idx_t>(nr_bytes);
+	stats->Get(FileSystemOperation::WRITE).RecordRequestSize(total_bytes);
+	const idx_t chunk_size = GetSplitChunkSize(FileSystemOperation::WRITE, total_bytes);
+	if (chunk_size == 0) {
+		const auto charge = ApplyRateLimit(FileSystemOperation::WRITE, total_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+		auto bytes_written = TrackTransfer(concurrency_guard, charge, /*retry=*/false,
+		                                   [&] { return inner_fs->Write(inner_handle, buffer, nr_bytes); });
+		RefundUntransferred(charge, static_cast<idx_t>(bytes_written));
+		InvalidateReadState(rate_limit_handle);
+		return bytes_written;
+	}
+
+	auto *data = static_cast<data_ptr_t>(buffer);
+	idx_t offset = 0;
+	while (offset < total_bytes) {
+		const idx_t cur_bytes = MinValue<idx_t>(chunk_size, total_bytes - offset);
+		const auto charge = ApplyRateLimit(FileSystemOperation::WRITE, cur_bytes, &rate_limit_handle.GetScope(),
+		                                   rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+		const auto bytes_written = TrackTransfer(concurrency_guard, charge, /*retry=*/false, [&] {
+			return inner_fs->Write(inner_handle, data + offset, static_cast<int64_t>(cur_bytes));
+		});
+		RefundUntransferred(charge, static_cast<idx_t>(bytes_written));
+		offset += static_cast<idx_t>(bytes_written);
+		if (static_cast<idx_t>(bytes_written) < cur_bytes) {
+			break;
+		}
+	}
+	InvalidateReadState(rate_limit_handle);
+	return static_cast<int64_t>(offset);
 }
 
 FileMetadata RateLimitFileSystem::Stats(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
+	auto metadata_cache = GetMetadataCache();
+	FileMetadata result;
+	if (metadata_cache && metadata_cache->Get(handle.GetPath(), [&](const CachedMetadata &metadata) {
+		    if (metadata.file_size < 0 || !metadata.has_last_modified || !metadata.has_file_type ||
+		        !metadata.has_version_tag) {
+			    return false;
+		    }
+		    result.file_size = metadata.file_size;
+		    result.last_modification_time = metadata.last_modified;
+		    result.file_type = metadata.file_type;
+		    result.version_tag = metadata.version_tag;
+		    return true;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->Stats(GetInnerFileHandle(handle));
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr,
+	               handle.Cast<RateLimitFileHandle>().GetPathLimiter(FileSystemOperation::STAT));
+	result = concurrency_guard.Track([&] { return inner_fs->Stats(GetInnerFileHandle(handle)); });
+	if (metadata_cache) {
+		metadata_cache->Update(handle.GetPath(), [&](CachedMetadata &metadata) {
+			metadata.file_size = result.file_size;
+			metadata.has_last_modified = true;
+			metadata.last_modified = result.last_modification_time;
+			metadata.has_file_type = true;
+			metadata.file_type = result.file_type;
+			metadata.has_version_tag = true;
+			metadata.version_tag = result.version_tag;
+		});
+	}
+	return result;
 }
 
 int64_t RateLimitFileSystem::GetFileSize(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
+	auto metadata_cache = GetMetadataCache();
+	int64_t result = -1;
+	if (metadata_cache && metadata_cache->Get(handle.GetPath(), [&](const CachedMetadata &metadata) {
+		    result = metadata.file_size;
+		    return result >= 0;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->GetFileSize(GetInnerFileHandle(handle));
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr,
+	               handle.Cast<RateLimitFileHandle>().GetPathLimiter(FileSystemOperation::STAT));
+	result = concurrency_guard.Track([&] { return inner_fs->GetFileSize(GetInnerFileHandle(handle)); });
+	if (metadata_cache) {
+		metadata_cache->Update(handle.GetPath(), [&](CachedMetadata &metadata) { metadata.file_size = result; });
+	}
+	return result;
 }
 
 timestamp_t RateLimitFileSystem::GetLastModifiedTime(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
+	auto metadata_cache = GetMetadataCache();
+	timestamp_t result;
+	if (metadata_cache && metadata_cache->Get(handle.GetPath(), [&](const CachedMetadata &metadata) {
+		    result = metadata.last_modified;
+		    return metadata.has_last_modified;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->GetLastModifiedTime(GetInnerFileHandle(handle));
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr,
+	               handle.Cast<RateLimitFileHandle>().GetPathLimiter(FileSystemOperation::STAT));
+	result = concurrency_guard.Track([&] { return inner_fs->GetLastModifiedTime(GetInnerFileHandle(handle)); });
+	if (metadata_cache) {
+		metadata_cache->Update(handle.GetPath(), [&](CachedMetadata &metadata) {
+			metadata.has_last_modified = true;
+			metadata.last_modified = result;
+		});
+	}
+	return result;
 }
 
 FileType RateLimitFileSystem::GetFileType(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
+	auto metadata_cache = GetMetadataCache();
+	FileType result = FileType::FILE_TYPE_INVALID;
+	if (metadata_cache && metadata_cache->Get(handle.GetPath(), [&](const CachedMetadata &metadata) {
+		    result = metadata.file_type;
+		    return metadata.has_file_type;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->GetFileType(GetInnerFileHandle(handle));
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr,
+	               handle.Cast<RateLimitFileHandle>().GetPathLimiter(FileSystemOperation::STAT));
+	result = concurrency_guard.Track([&] { return inner_fs->GetFileType(GetInnerFileHandle(handle)); });
+	if (metadata_cache) {
+		metadata_cache->Update(handle.GetPath(), [&](CachedMetadata &metadata) {
+			metadata.has_file_type = true;
+			metadata.file_type = result;
+		});
+	}
+	return result;
 }
 
 string RateLimitFileSystem::GetVersionTag(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
+	auto metadata_cache = GetMetadataCache();
+	string result;
+	if (metadata_cache && metadata_cache->Get(handle.GetPath(), [&](const CachedMetadata &metadata) {
+		    result = metadata.version_tag;
+		    return metadata.has_version_tag;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->GetVersionTag(GetInnerFileHandle(handle));
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr,
+	               handle.Cast<RateLimitFileHandle>().GetPathLimiter(FileSystemOperation::STAT));
+	result = concurrency_guard.Track([&] { return inner_fs->GetVersionTag(GetInnerFileHandle(handle)); });
+	if (metadata_cache) {
+		metadata_cache->Update(handle.GetPath(), [&](CachedMetadata &metadata) {
+			metadata.has_version_tag = true;
+			metadata.version_tag = result;
+		});
+	}
+	return result;
 }
 
 void RateLimitFileSystem::Truncate(FileHandle &handle, int64_t new_size) {
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	rate_limit_handle.DrainWriteBehind();
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::WRITE);
-	ApplyRateLimit(FileSystemOperation::WRITE);
-	inner_fs->Truncate(GetInnerFileHandle(handle), new_size);
+	ApplyRateLimit(FileSystemOperation::WRITE, 1, nullptr,
+	               rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+	concurrency_guard.Track([&] { inner_fs->Truncate(rate_limit_handle.GetInnerHandle(), new_size); });
+	InvalidateReadState(rate_limit_handle);
 }
 
 bool RateLimitFileSystem::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->DirectoryExists(directory, opener);
+	auto path_limiter = ResolvePathLimiter(directory, FileSystemOperation::STAT);
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr, path_limiter.get());
+	return concurrency_guard.Track([&] { return inner_fs->DirectoryExists(directory, opener); });
 }
 
 void RateLimitFileSystem::RemoveDirectory(const string &directory, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::DELETE);
-	ApplyRateLimit(FileSystemOperation::DELETE);
-	inner_fs->RemoveDirectory(directory, opener);
+	auto path_limiter = ResolvePathLimiter(directory, FileSystemOperation::DELETE);
+	ApplyRateLimit(FileSystemOperation::DELETE, 1, nullptr, path_limiter.get());
+	concurrency_guard.TrackWithoutRetry([&] { inner_fs->RemoveDirectory(directory, opener); });
+	InvalidateDirectory(directory);
+}
+
+bool RateLimitFileSystem::Trim(FileHandle &handle, idx_t offset_bytes, idx_t length_bytes) {
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	rate_limit_handle.DrainWriteBehind();
+	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::WRITE);
+	ApplyRateLimit(FileSystemOperation::WRITE, 1, nullptr,
+	               rate_limit_handle.GetPathLimiter(FileSystemOperation::WRITE));
+	const auto result = concurrency_guard.Track(
+	    [&] { return inner_fs->Trim(rate_limit_handle.GetInnerHandle(), offset_bytes, length_bytes); });
+	InvalidateReadState(rate_limit_handle);
+	return result;
+}
+
+void RateLimitFileSystem::FileSync(FileHandle &handle) {
+	auto &rate_limit_handle = handle.Cast<RateLimitFileHandle>();
+	rate_limit_handle.DrainWriteBehind();
+	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::SYNC);
+	ApplyRateLimit(FileSystemOperation::SYNC, 1, nullptr, rate_limit_handle.GetPathLimiter(FileSystemOperation::SYNC));
+	concurrency_guard.Track([&] { inner_fs->FileSync(rate_limit_handle.GetInnerHandle()); });
+}
+
+idx_t RateLimitFileSystem::GetMoveBytes(const string &source, optional_ptr<FileOpener> opener) {
+	// Only a byte limit needs the size, which a cost model without a byte cost isn't.
+	if (!IsConfigured(FileSystemOperation::WRITE)) {
+		return 1;
+	}
+	const auto &snapshot = GetOperationSnapshot(FileSystemOperation::WRITE);
+	if (!snapshot.rate_limiter || (snapshot.cost.IsSet() && snapshot.cost.byte_cost == 0)) {
+		return 1;
+	}
+	int64_t file_size = 0;
+	auto metadata_cache = GetMetadataCache();
+	if (metadata_cache && metadata_cache->Get(source, [&](const CachedMetadata &metadata) {
+		    file_size = metadata.file_size;
+		    return metadata.file_size >= 0;
+	    })) {
+		return MaxValue<idx_t>(static_cast<idx_t>(file_size), 1);
+	}
+	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
+	auto path_limiter = ResolvePathLimiter(source, FileSystemOperation::STAT);
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr, path_limiter.get());
+	concurrency_guard.Track([&] {
+		auto source_handle = inner_fs->OpenFile(
+		    source, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS, opener);
+		// A missing source is left for the move itself to report.
+		if (source_handle) {
+			file_size = inner_fs->GetFileSize(*source_handle);
+		}
+	});
+	return MaxValue<idx_t>(static_cast<idx_t>(file_size), 1);
 }
 
 void RateLimitFileSystem::MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener) {
-	inner_fs->MoveFile(source, target, opener);
+	// Looked up first, so the STAT call doesn't hold a WRITE slot.
+	const auto bytes = GetMoveBytes(source, opener);
+	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::WRITE);
+	auto path_limiter = ResolvePathLimiter(target, FileSystemOperation::WRITE);
+	SharedRateLimiter rate_limiter;
+	OperationCost cost;
+	if (IsConfigured(FileSystemOperation::WRITE)) {
+		const auto &snapshot = GetOperationSnapshot(FileSystemOperation::WRITE);
+		rate_limiter = snapshot.rate_limiter;
+		cost = snapshot.cost;
+	}
+	// A move can't be split like a write; one larger than the burst is admitted as a full burst, and the rest is booked
+	// without waiting, so the writes after it pay for the copy.
+	const auto burst = rate_limiter ? rate_limiter->GetEffectiveBurst() : 0;
+	const auto max_bytes = cost.IsSet() ? cost.GetMaxBytes(burst) : burst;
+	const auto admitted_bytes = burst == 0 ? bytes : MinValue<idx_t>(bytes, max_bytes);
+	ApplyRateLimit(FileSystemOperation::WRITE, admitted_bytes, nullptr, path_limiter.get());
+	if (bytes > admitted_bytes) {
+		rate_limiter->Charge(GetRequestTokens(cost, FileSystemOperation::WRITE, bytes) -
+		                     GetRequestTokens(cost, FileSystemOperation::WRITE, admitted_bytes));
+	}
+	concurrency_guard.TrackWithoutRetry([&] { inner_fs->MoveFile(source, target, opener); });
+	InvalidateMetadata(source);
+	InvalidateMetadata(target);
 }
 
 bool RateLimitFileSystem::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
+	auto metadata_cache = GetMetadataCache();
+	bool result = false;
+	if (metadata_cache && metadata_cache->Get(filename, [&](const CachedMetadata &metadata) {
+		    result = metadata.exists;
+		    return metadata.has_exists;
+	    })) {
+		return result;
+	}
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::STAT);
-	ApplyRateLimit(FileSystemOperation::STAT);
-	return inner_fs->FileExists(filename, opener);
+	auto path_limiter = ResolvePathLimiter(filename, FileSystemOperation::STAT);
+	ApplyRateLimit(FileSystemOperation::STAT, 1, nullptr, path_limiter.get());
+	result = concurrency_guard.Track([&] { return inner_fs->FileExists(filename, opener); });
+	if (metadata_cache) {
+		// Files that don't exist are cached too, since lookups of optional files (e.g. a WAL) are common.
+		metadata_cache->Update(filename, [&](CachedMetadata &metadata) {
+			metadata.has_exists = true;
+			metadata.exists = result;
+		});
+	}
+	return result;
 }
 
 void RateLimitFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::DELETE);
-	ApplyRateLimit(FileSystemOperation::DELETE);
-	inner_fs->RemoveFile(filename, opener);
+	auto path_limiter = ResolvePathLimiter(filename, FileSystemOperation::DELETE);
+	ApplyRateLimit(FileSystemOperation::DELETE, 1, nullptr, path_limiter.get());
+	concurrency_guard.TrackWithoutRetry([&] { inner_fs->RemoveFile(filename, opener); });
+	InvalidateMetadata(filename);
 }
 
 bool RateLimitFileSystem::TryRemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::DELETE);
-	ApplyRateLimit(FileSystemOperation::DELETE);
-	return inner_fs->TryRemoveFile(filename, opener);
+	auto path_limiter = ResolvePathLimiter(filename, FileSystemOperation::DELETE);
+	ApplyRateLimit(FileSystemOperation::DELETE, 1, nullptr, path_limiter.get());
+	auto result = concurrency_guard.TrackWithoutRetry([&] { return inner_fs->TryRemoveFile(filename, opener); });
+	InvalidateMetadata(filename);
+	return result;
 }
 
 void RateLimitFileSystem::RemoveFiles(const vector<string> &filenames, optional_ptr<FileOpener> opener) {
+	// Every file counts as one DELETE call, against the filesystem limit and against its path's limiter.
+	vector<SharedRateLimiter> path_limiters;
+	if (IsConfigured(FileSystemOperation::DELETE) && GetFilesystemSnapshot().path_limiters) {
+		path_limiters.reserve(filenames.size());
+		for (const auto &filename : filenames) {
+			path_limiters.push_back(ResolvePathLimiter(filename, FileSystemOperation::DELETE));
+		}
+	}
+
+	const idx_t batch_size = GetRemoveBatchSize(path_limiters);
+	if (batch_size == 0 || filenames.size() <= batch_size) {
+		RemoveFileBatch(filenames, path_limiters, opener);
+		return;
+	}
+	// Issue each sub-batch as soon as its tokens are available, rather than waiting for the cost of all of them.
+	for (idx_t offset = 0; offset < filenames.size(); offset += batch_size) {
+		const idx_t end = MinValue<idx_t>(offset + batch_size, filenames.size());
+		vector<string> batch(filenames.begin() + offset, filenames.begin() + end);
+		vector<SharedRateLimiter> batch_path_limiters;
+		if (!path_limiters.empty()) {
+			batch_path_limiters.assign(path_limiters.begin() + offset, path_limiters.begin() + end);
+		}
+		RemoveFileBatch(batch, batch_path_limiters, opener);
+	}
+}
+
+idx_t RateLimitFileSystem::GetRemoveBatchSize(const vector<SharedRateLimiter> &path_limiters) {
+	idx_t batch_size = 0;
+	auto limit_batch = [&](const RateLimiter &rate_limiter, const OperationCost &cost) {
+		// A batch has to fit the burst; without one, it's capped at a second of the rate so deletes trickle out.
+		auto limit = rate_limiter.GetEffectiveBurst();
+		if (limit == 0) {
+			limit = rate_limiter.GetQuota().GetBandwidth();
+		}
+		if (limit > 0 && cost.IsSet()) {
+			// Free calls leave the batch unbounded; a single call costing more than the burst is rejected on its own.
+			limit = cost.GetMaxCalls(limit);
+			if (limit == NumericLimits<idx_t>::Maximum()) {
+				return;
+			}
+			limit = MaxValue<idx_t>(limit, 1);
+		}
+		if (limit > 0 && (batch_size == 0 || limit < batch_size)) {
+			batch_size = limit;
+		}
+	};
+	if (IsConfigured(FileSystemOperation::DELETE)) {
+		const auto &snapshot = GetOperationSnapshot(FileSystemOperation::DELETE);
+		if (snapshot.rate_limiter) {
+			limit_batch(*snapshot.rate_limiter, snapshot.cost);
+		}
+	}
+	// Path rules always charge one token per call.
+	for (const auto &path_limiter : path_limiters) {
+		if (path_limiter) {
+			limit_batch(*path_limiter, OperationCost());
+		}
+	}
+	return batch_size;
+}
+
+void RateLimitFileSystem::RemoveFileBatch(const vector<string> &filenames,
+                                          const vector<SharedRateLimiter> &path_limiters,
+                                          optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::DELETE);
-	ApplyRateLimit(FileSystemOperation::DELETE);
-	inner_fs->RemoveFiles(filenames, opener);
+	vector<std::pair<SharedRateLimiter, idx_t>> path_calls;
+	for (const auto &path_limiter : path_limiters) {
+		if (!path_limiter) {
+			continue;
+		}
+		// Files of a batch usually share a handful of prefixes, so a linear search is cheapest.
+		bool found = false;
+		for (auto &entry : path_calls) {
+			if (entry.first == path_limiter) {
+				++entry.second;
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			path_calls.emplace_back(path_limiter, 1);
+		}
+	}
+	idx_t charged = 0;
+	try {
+		for (; charged < path_calls.size(); ++charged) {
+			ApplyPathRateLimit(FileSystemOperation::DELETE, *path_calls[charged].first, path_calls[charged].second,
+			                   RateLimitPriority::INTERACTIVE);
+		}
+		ApplyRateLimit(FileSystemOperation::DELETE, filenames.size());
+	} catch (...) {
+		for (idx_t idx = 0; idx < charged; ++idx) {
+			path_calls[idx].first->Refund(path_calls[idx].second);
+		}
+		throw;
+	}
+	concurrency_guard.TrackWithoutRetry([&] { inner_fs->RemoveFiles(filenames, opener); });
+	for (const auto &filename : filenames) {
+		InvalidateMetadata(filename);
+	}
+}
+
+void RateLimitFileSystem::ChargeListPages(idx_t entries, optional_ptr<RateLimiter> path_limiter) {
+	// The first page was charged up front.
+	const idx_t extra_pages = entries <= LIST_PAGE_SIZE ? 0 : (entries - 1) / LIST_PAGE_SIZE;
+	if (IsConfigured(FileSystemOperation::LIST)) {
+		const auto &snapshot = GetOperationSnapshot(FileSystemOperation::LIST);
+		// With a cost model, every extra page costs a call and every entry an item.
+		const auto tokens = snapshot.cost.IsSet() ? snapshot.cost.GetTokens(extra_pages, 0, entries) : extra_pages;
+		if (snapshot.rate_limiter && tokens > 0) {
+			snapshot.rate_limiter->Charge(tokens);
+		}
+	}
+	if (path_limiter && extra_pages > 0) {
+		path_limiter->Charge(extra_pages);
+	}
+}
+
+void RateLimitFileSystem::ChargeListItems(idx_t entries) {
+	if (entries == 0 || !IsConfigured(FileSystemOperation::LIST)) {
+		return;
+	}
+	const auto &snapshot = GetOperationSnapshot(FileSystemOperation::LIST);
+	const auto tokens = snapshot.cost.GetTokens(0, 0, entries);
+	if (snapshot.rate_limiter && tokens > 0) {
+		snapshot.rate_limiter->Charge(tokens);
+	}
 }
 
 vector<OpenFileInfo> RateLimitFileSystem::Glob(const string &path, FileOpener *opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::LIST);
-	ApplyRateLimit(FileSystemOperation::LIST);
-	auto result = inner_fs->Glob(path, FileGlobOptions::ALLOW_EMPTY, opener);
-	return result->GetAllFiles();
+	auto path_limiter = ResolvePathLimiter(path, FileSystemOperation::LIST);
+	ApplyRateLimit(FileSystemOperation::LIST, 1, nullptr, path_limiter.get());
+	auto result = concurrency_guard.Track([&] { return inner_fs->Glob(path, FileGlobOptions::ALLOW_EMPTY, opener); });
+	auto files = result->GetAllFiles();
+	ChargeListPages(files.size(), path_limiter.get());
+	for (const auto &file : files) {
+		CacheListedMetadata(file, file.path);
+	}
+	return files;
+}
+
+unique_ptr<MultiFileList> RateLimitFileSystem::GlobFilesExtended(const string &path, const FileGlobInput &input,
+                                                                 optional_ptr<FileOpener> opener) {
+	auto path_limiter = ResolvePathLimiter(path, FileSystemOperation::LIST);
+	unique_ptr<MultiFileList> inner_list;
+	{
+		auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::LIST);
+		ApplyRateLimit(FileSystemOperation::LIST, 1, nullptr, path_limiter.get());
+		inner_list = concurrency_guard.Track([&] { return inner_fs->Glob(path, input, opener); });
+	}
+	return make_uniq<RateLimitMultiFileList>(*this, path, input, std::move(inner_list), std::move(path_limiter));
 }
 
 bool RateLimitFileSystem::ListFiles(const string &directory, const std::function<void(const string &, bool)> &callback,
                                     FileOpener *opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::LIST);
-	ApplyRateLimit(FileSystemOperation::LIST);
-	return inner_fs->ListFiles(directory, callback, opener);
+	auto path_limiter = ResolvePathLimiter(directory, FileSystemOperation::LIST);
+	ApplyRateLimit(FileSystemOperation::LIST, 1, nullptr, path_limiter.get());
+	idx_t entries = 0;
+	// Entries already passed to the callback can't be taken back, so a throttled listing isn't retried.
+	auto result = concurrency_guard.TrackWithoutRetry([&] {
+		return inner_fs->ListFiles(
+		    directory,
+		    [&](const string &path, bool is_directory) {
+			    ++entries;
+			    callback(path, is_directory);
+		    },
+		    opener);
+	});
+	ChargeListPages(entries, path_limiter.get());
+	return result;
 }
 
 bool RateLimitFileSystem::ListFilesExtended(const string &directory,
                                             const std::function<void(OpenFileInfo &info)> &callback,
                                             optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::LIST);
-	ApplyRateLimit(FileSystemOperation::LIST);
-	return inner_fs->ListFiles(directory, callback, opener);
+	auto path_limiter = ResolvePathLimiter(directory, FileSystemOperation::LIST);
+	ApplyRateLimit(FileSystemOperation::LIST, 1, nullptr, path_limiter.get());
+	idx_t entries = 0;
+	auto result = concurrency_guard.TrackWithoutRetry([&] {
+		return inner_fs->ListFiles(
+		    directory,
+		    [&](OpenFileInfo &info) {
+			    ++entries;
+			    if (info.extended_info) {
+				    // Entries are usually named relative to the directory, but some filesystems list full paths.
+				    const auto path = StringUtil::StartsWith(info.path, directory) ? info.path
+				                                                                  : JoinPath(directory, info.path);
+				    CacheListedMetadata(info, path);
+			    }
+			    callback(info);
+		    },
+		    opener);
+	});
+	ChargeListPages(entries, path_limiter.get());
+	return result;
 }
 
 void RateLimitFileSystem::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::MKDIR);
-	ApplyRateLimit(FileSystemOperation::MKDIR);
-	inner_fs->CreateDirectory(directory, opener);
+	auto path_limiter = ResolvePathLimiter(directory, FileSystemOperation::MKDIR);
+	ApplyRateLimit(FileSystemOperation::MKDIR, 1, nullptr, path_limiter.get());
+	concurrency_guard.Track([&] { inner_fs->CreateDirectory(directory, opener); });
 }
 
 void RateLimitFileSystem::CreateDirectoriesRecursive(const string &path, optional_ptr<FileOpener> opener) {
 	auto concurrency_guard = AcquireConcurrencySlot(FileSystemOperation::MKDIR);
-	ApplyRateLimit(FileSystemOperation::MKDIR);
-	inner_fs->CreateDirectoriesRecursive(path, opener);
+	auto path_limiter = ResolvePathLimiter(path, FileSystemOperation::MKDIR);
+	ApplyRateLimit(FileSystemOperation::MKDIR, 1, nullptr, path_limiter.get());
+	concurrency_guard.Track([&] { inner_fs->CreateDirectoriesRecursive(path, opener); });
+	// Which levels already existed isn't known, so with a cost model every level of the path is booked as an item.
+	if (IsConfigured(FileSystemOperation::MKDIR)) {
+		const auto &snapshot = GetOperationSnapshot(FileSystemOperation::MKDIR);
+		const auto tokens = snapshot.cost.GetTokens(0, 0, CountDirectoryLevels(path));
+		if (snapshot.rate_limiter && tokens > 0) {
+			snapshot.rate_limiter->Charge(tokens);
+		}
+	}
 }
 
 // ==========================================================================
@@ -270,19 +1845,22 @@ bool RateLimitFileSystem::SupportsListFilesExtended() const {
 	return true;
 }
 
-void RateLimitFileSystem::FileSync(FileHandle &handle) {
-	inner_fs->FileSync(GetInnerFileHandle(handle));
+bool RateLimitFileSystem::SupportsGlobExtended() const {
+	return true;
 }
 
 void RateLimitFileSystem::Seek(FileHandle &handle, idx_t location) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
 	inner_fs->Seek(GetInnerFileHandle(handle), location);
 }
 
 void RateLimitFileSystem::Reset(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
 	inner_fs->Reset(GetInnerFileHandle(handle));
 }
 
 idx_t RateLimitFileSystem::SeekPosition(FileHandle &handle) {
+	handle.Cast<RateLimitFileHandle>().DrainWriteBehind();
 	return inner_fs->SeekPosition(GetInnerFileHandle(handle));
 }
 
@@ -310,4 +1888,16 @@ string RateLimitFileSystem::PathSeparator(const string &path) {
 	return inner_fs->PathSeparator(path);
 }
 
+string RateLimitFileSystem::GetHomeDirectory() {
+	return inner_fs->GetHomeDirectory();
+}
+
+string RateLimitFileSystem::ExpandPath(const string &path) {
+	return inner_fs->ExpandPath(path);
+}
+
+bool RateLimitFileSystem::IsManuallySet() {
+	return inner_fs->IsManuallySet();
+}
+
 } // namespace duckdb
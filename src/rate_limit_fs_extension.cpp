@@ -2,30 +2,157 @@
 
 #include "rate_limit_fs_extension.hpp"
 
+#include <cstdlib>
+
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/opener_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/function/table_function.hpp"
+#include "duckdb/logging/logger.hpp"
+#include "duckdb/main/config.hpp"
 #include "fake_filesystem.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_config_file.hpp"
+#include "rate_limit_file_system.hpp"
 #include "rate_limit_functions.hpp"
+#include "rate_limit_priority.hpp"
+#include "rate_limit_scope.hpp"
 
 namespace duckdb {
 
 namespace {
+
+void ValidatePrioritySetting(ClientContext &context, SetScope scope, Value &parameter) {
+	ParseRateLimitPriority(parameter.ToString());
+}
+
+void ValidateConnectionBandwidthSetting(ClientContext &context, SetScope scope, Value &parameter) {
+	const auto bandwidth = parameter.GetValue<int64_t>();
+	if (bandwidth < 0) {
+		throw InvalidInputException("Connection bandwidth must be non-negative, got %lld", bandwidth);
+	}
+}
+
+// Applies a config file read through the given filesystem, then wraps the filesystems it names. Filesystems which
+// aren't registered, or are already wrapped, are skipped: those registered by an extension loaded afterwards are
+// wrapped once the file is applied again.
+void LoadConfigFile(DatabaseInstance &db, FileSystem &fs, const string &path) {
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	const auto file_size = fs.GetFileSize(*handle);
+	string content(static_cast<size_t>(file_size), '\0');
+	fs.Read(*handle, &content[0], file_size, /*location=*/0);
+	const auto file = ParseRateLimitConfigFile(content);
+
+	auto config = RateLimitConfig::GetOrCreate(db);
+	ApplyRateLimitConfigFile(file, *config);
+
+	auto &vfs = db.GetFileSystem().Cast<OpenerFileSystem>().GetFileSystem();
+	for (const auto &fs_name : file.wrap) {
+		auto extracted_fs = vfs.ExtractSubSystem(fs_name);
+		if (!extracted_fs) {
+			DUCKDB_LOG_DEBUG(db, StringUtil::Format("Filesystem %s from %s is not registered, not wrapping it.",
+			                                        fs_name, path));
+			continue;
+		}
+		auto wrapped_fs = make_uniq<RateLimitFileSystem>(std::move(extracted_fs), config);
+		DUCKDB_LOG_DEBUG(db, StringUtil::Format("Wrap filesystem %s with rate limit filesystem (registered as %s).",
+		                                        fs_name, wrapped_fs->GetName()));
+		vfs.RegisterSubSystem(std::move(wrapped_fs));
+	}
+}
+
+void ApplyConfigFileSetting(ClientContext &context, SetScope scope, Value &parameter) {
+	const auto path = parameter.ToString();
+	if (path.empty()) {
+		return;
+	}
+	if (!DBConfig::GetConfig(context).options.enable_external_access) {
+		throw PermissionException("Setting %s is disabled through configuration (enable_external_access is false)",
+		                          RATE_LIMIT_FS_CONFIG_FILE_SETTING);
+	}
+	// Through the session's filesystem, so allowed_directories applies like to any other file it reads.
+	LoadConfigFile(DatabaseInstance::GetDatabase(context), FileSystem::GetFileSystem(context), path);
+}
+
+// Returns the config file given as a database setting at startup, or else by the environment, empty if none.
+string GetStartupConfigFile(DatabaseInstance &db) {
+	Value value;
+	if (db.TryGetCurrentSetting(RATE_LIMIT_FS_CONFIG_FILE_SETTING, value) && !value.IsNull()) {
+		auto path = value.ToString();
+		if (!path.empty()) {
+			return path;
+		}
+	}
+	const char *env_path = std::getenv(RATE_LIMIT_FS_CONFIG_FILE_ENV);
+	return env_path ? string(env_path) : string();
+}
+
 void LoadInternal(ExtensionLoader &loader) {
 	// Register rate limit configuration functions
 	loader.RegisterFunction(GetRateLimitFsQuotaFunction());
 	loader.RegisterFunction(GetRateLimitFsBurstFunction());
+	loader.RegisterFunction(GetRateLimitFsRequestQuotaFunction());
+	loader.RegisterFunction(GetRateLimitFsShardLeaseFunction());
+	loader.RegisterFunction(GetRateLimitFsPartitionsFunction());
+	loader.RegisterFunction(GetRateLimitFsClockResolutionFunction());
+	loader.RegisterFunction(GetRateLimitFsMaxWaitFunction());
+	loader.RegisterFunction(GetRateLimitFsTraceFunction());
+	loader.RegisterFunction(GetRateLimitFsCostFunction());
+	loader.RegisterFunction(GetRateLimitFsCostsFunction());
+	loader.RegisterFunction(GetRateLimitFsQuotaProfileFunction());
+	loader.RegisterFunction(GetRateLimitFsQuotaProfilesFunction());
+	loader.RegisterFunction(GetRateLimitFsReadAheadFunction());
+	loader.RegisterFunction(GetRateLimitFsStreamSlotFunction());
+	loader.RegisterFunction(GetRateLimitFsWriteBehindFunction());
+	loader.RegisterFunction(GetRateLimitFsBlockCacheFunction());
+	loader.RegisterFunction(GetRateLimitFsMetadataCacheFunction());
+	loader.RegisterFunction(GetRateLimitFsHandlePoolFunction());
 	loader.RegisterFunction(GetRateLimitFsMaxRequestsFunction());
+	loader.RegisterFunction(GetRateLimitFsAdaptiveMaxRequestsFunction());
+	loader.RegisterFunction(GetRateLimitFsThrottleBackoffFunction());
 	loader.RegisterFunction(GetRateLimitFsClearFunction());
 	loader.RegisterFunction(GetRateLimitFsConfigsFunction());
+	loader.RegisterFunction(GetRateLimitFsGroupFunction());
+	loader.RegisterFunction(GetRateLimitFsGroupAssignFunction());
+	loader.RegisterFunction(GetRateLimitFsGroupsFunction());
+	loader.RegisterFunction(GetRateLimitFsPathGroupFunction());
+	loader.RegisterFunction(GetRateLimitFsPathGroupsFunction());
+	loader.RegisterFunction(GetRateLimitFsSharedStateFunction());
+	loader.RegisterFunction(GetRateLimitFsBlockCachesFunction());
+	loader.RegisterFunction(GetRateLimitFsMetadataCachesFunction());
+	loader.RegisterFunction(GetRateLimitFsHandlePoolsFunction());
+	loader.RegisterFunction(GetRateLimitFsThrottleBackoffsFunction());
+	loader.RegisterFunction(GetRateLimitFsPartitionQuotasFunction());
+	loader.RegisterFunction(GetRateLimitFsStatsFunction());
+	loader.RegisterFunction(GetRateLimitFsStatsResetFunction());
+	loader.RegisterFunction(GetRateLimitFsBurstRecommendationsFunction());
+	loader.RegisterFunction(GetRateLimitFsAutoBurstFunction());
 
 	// Register filesystem management functions
 	loader.RegisterFunction(GetRateLimitFsListFilesystemsFunction());
 	loader.RegisterFunction(GetRateLimitFsWrapFunction());
 
+	// Register connection-scoped settings, read whenever a wrapped filesystem opens a file
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(RATE_LIMIT_FS_PRIORITY_SETTING,
+	                          "Priority of the connection's reads and writes on rate-limited filesystems: "
+	                          "'interactive' or 'batch'",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value("interactive"), ValidatePrioritySetting);
+	config.AddExtensionOption(RATE_LIMIT_FS_CONNECTION_BANDWIDTH_SETTING,
+	                          "Bytes per second the connection may read and write across all rate-limited "
+	                          "filesystems, on top of the filesystem limits (0 for unlimited)",
+	                          LogicalType {LogicalTypeId::BIGINT}, Value::BIGINT(0),
+	                          ValidateConnectionBandwidthSetting);
+
+	// Register the database-wide config file setting
+	config.AddExtensionOption(RATE_LIMIT_FS_CONFIG_FILE_SETTING,
+	                          "Path of a rate limit config file, applied when the extension is loaded and whenever "
+	                          "the setting is changed",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value(""), ApplyConfigFileSetting);
+
 	// TODO(hjiang): Register a fake filesystem at extension load for testing purpose. This is not ideal since
 	// additional necessary instance is shipped in the extension. Local filesystem is not viable because it's not
 	// registered in virtual filesystem. A better approach is find another filesystem not in httpfs extension.
@@ -34,6 +161,13 @@ void LoadInternal(ExtensionLoader &loader) {
 	auto &vfs = opener_fs.GetFileSystem();
 	vfs.RegisterSubSystem(make_uniq<RateLimitFsFakeFileSystem>());
 
+	// Apply the declarative config last, so its limits are in force before the first query and it can wrap every
+	// filesystem registered so far
+	const auto config_file = GetStartupConfigFile(db);
+	if (!config_file.empty()) {
+		LoadConfigFile(db, db.GetFileSystem(), config_file);
+	}
+
 	// Add extension description.
 	loader.SetDescription("Extension to enforce configurable quotas and burst limits per operation.");
 }
@@ -86,77 +86,1561 @@ void RateLimitFsBurstFunction(DataChunk &args, ExpressionState &state, Vector &r
 	result.SetValue(0, Value::BOOLEAN(true));
 }
 
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_request_quota(filesystem_name, operation, value)
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsRequestQuotaFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto value = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (value < 0) {
+		throw InvalidInputException("Request quota value must be non-negative, got %lld", value);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetRequestQuota(fs_str, op_enum, static_cast<idx_t>(value));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_shard_lease(filesystem_name, operation, value)
+// Pass 0 as value to disable sharding.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsShardLeaseFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto value = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (value < 0) {
+		throw InvalidInputException("Shard lease value must be non-negative, got %lld", value);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetShardLease(fs_str, op_enum, static_cast<idx_t>(value));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_partitions(filesystem_name, operation, count)
+// Pass 0 as count to disable partitioning.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsPartitionsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto count = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (count < 0) {
+		throw InvalidInputException("Partition count must be non-negative, got %lld", count);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetPartitions(fs_str, op_enum, static_cast<idx_t>(count));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_clock_resolution(filesystem_name, operation, resolution_us)
+// Pass 0 as resolution_us to go back to the default clock.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsClockResolutionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto resolution_us = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (resolution_us < 0) {
+		throw InvalidInputException("Clock resolution must be non-negative, got %lld", resolution_us);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetClockResolution(fs_str, op_enum, std::chrono::microseconds(resolution_us));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_max_wait(filesystem_name, operation, max_wait_ms)
+// Pass 0 to restore the default max wait.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsMaxWaitFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto max_wait_ms = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (max_wait_ms < 0) {
+		throw InvalidInputException("Max wait must be non-negative, got %lld ms", max_wait_ms);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetMaxWait(fs_str, op_enum, std::chrono::milliseconds(max_wait_ms));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_trace(filesystem_name, operation, sample_every)
+// Pass 0 as sample_every to disable tracing.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsTraceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto sample_every = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (sample_every < 0) {
+		throw InvalidInputException("Trace sample rate must be non-negative, got %lld", sample_every);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetTracing(fs_str, op_enum, static_cast<idx_t>(sample_every));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_cost(filesystem_name, operation, call_cost, byte_cost, item_cost)
+// Pass 0 as every cost to remove the cost model.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsCostFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	OperationCost cost;
+	cost.call_cost = args.data[2].GetValue(0).GetValue<double>();
+	cost.byte_cost = args.data[3].GetValue(0).GetValue<double>();
+	cost.item_cost = args.data[4].GetValue(0).GetValue<double>();
+
+	ValidateFilesystemExists(context, fs_str);
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetCost(fs_str, op_enum, cost);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_quota_profile(filesystem_name, operation, start_time, end_time, bandwidth, burst)
+// Pass 0 as bandwidth and burst to remove the profile starting at start_time.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsQuotaProfileFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto start_str = args.data[2].GetValue(0).ToString();
+	auto end_str = args.data[3].GetValue(0).ToString();
+	auto bandwidth = args.data[4].GetValue(0).GetValue<int64_t>();
+	auto burst = args.data[5].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (bandwidth < 0) {
+		throw InvalidInputException("Quota profile bandwidth must be non-negative, got %lld", bandwidth);
+	}
+	if (burst < 0) {
+		throw InvalidInputException("Quota profile burst must be non-negative, got %lld", burst);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+	auto start_minute = ParseTimeOfDay(start_str);
+	auto end_minute = ParseTimeOfDay(end_str);
+
+	config->SetQuotaProfile(fs_str, op_enum, start_minute, end_minute, static_cast<idx_t>(bandwidth),
+	                        static_cast<idx_t>(burst));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_read_ahead(filesystem_name, buffer_size, window)
+// Pass 0 as buffer_size to disable read-ahead.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsReadAheadFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto buffer_size = args.data[1].GetValue(0).GetValue<int64_t>();
+	auto window = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (buffer_size < 0) {
+		throw InvalidInputException("Read-ahead buffer size must be non-negative, got %lld", buffer_size);
+	}
+	if (window < 0) {
+		throw InvalidInputException("Read-ahead window must be non-negative, got %lld", window);
+	}
+
+	config->SetReadAhead(fs_str, static_cast<idx_t>(buffer_size), static_cast<idx_t>(window));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_stream_slot(filesystem_name, idle_timeout_ms)
+// Pass 0 as idle_timeout_ms to disable stream slots.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsStreamSlotFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto idle_timeout_ms = args.data[1].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (idle_timeout_ms < 0) {
+		throw InvalidInputException("Stream slot idle timeout must be non-negative, got %lld ms", idle_timeout_ms);
+	}
+
+	config->SetStreamSlot(fs_str, std::chrono::milliseconds(idle_timeout_ms));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_write_behind(filesystem_name, buffer_size)
+// Pass 0 as buffer_size to write through.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsWriteBehindFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto buffer_size = args.data[1].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (buffer_size < 0) {
+		throw InvalidInputException("Write-behind buffer size must be non-negative, got %lld", buffer_size);
+	}
+
+	config->SetWriteBehind(fs_str, static_cast<idx_t>(buffer_size));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_block_cache(filesystem_name, block_size, capacity)
+// Pass 0 as capacity to disable the block cache.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsBlockCacheFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto block_size = args.data[1].GetValue(0).GetValue<int64_t>();
+	auto capacity = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (block_size < 0) {
+		throw InvalidInputException("Block cache block size must be non-negative, got %lld", block_size);
+	}
+	if (capacity < 0) {
+		throw InvalidInputException("Block cache capacity must be non-negative, got %lld", capacity);
+	}
+
+	config->SetBlockCache(fs_str, static_cast<idx_t>(block_size), static_cast<idx_t>(capacity));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_metadata_cache(filesystem_name, ttl_ms, max_entries)
+// Pass 0 as ttl_ms to disable the metadata cache.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsMetadataCacheFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto ttl_ms = args.data[1].GetValue(0).GetValue<int64_t>();
+	auto max_entries = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (ttl_ms < 0) {
+		throw InvalidInputException("Metadata cache TTL must be non-negative, got %lld", ttl_ms);
+	}
+	if (max_entries < 0) {
+		throw InvalidInputException("Metadata cache max entries must be non-negative, got %lld", max_entries);
+	}
+
+	config->SetMetadataCache(fs_str, std::chrono::milliseconds(ttl_ms), static_cast<idx_t>(max_entries));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_handle_pool(filesystem_name, ttl_ms, capacity)
+// Pass 0 as ttl_ms to disable the handle pool.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsHandlePoolFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto ttl_ms = args.data[1].GetValue(0).GetValue<int64_t>();
+	auto capacity = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (ttl_ms < 0) {
+		throw InvalidInputException("Handle pool TTL must be non-negative, got %lld", ttl_ms);
+	}
+	if (capacity < 0) {
+		throw InvalidInputException("Handle pool capacity must be non-negative, got %lld", capacity);
+	}
+
+	config->SetHandlePool(fs_str, std::chrono::milliseconds(ttl_ms), static_cast<idx_t>(capacity));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
 //===--------------------------------------------------------------------===//
 // rate_limit_fs_clear(filesystem_name, operation)
 // Pass '*' as operation to clear all configs for a filesystem.
 // Pass '*' as filesystem_name to clear all configs.
 //===--------------------------------------------------------------------===//
 
-void RateLimitFsClearFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.size() == 1);
-	auto &context = state.GetContext();
-	auto config = RateLimitConfig::GetOrCreate(context);
+void RateLimitFsClearFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+
+	if (fs_str == "*") {
+		config->ClearAll();
+		result.SetValue(0, Value::BOOLEAN(true));
+		return;
+	}
+
+	if (op_str == "*") {
+		config->ClearFilesystem(fs_str);
+		result.SetValue(0, Value::BOOLEAN(true));
+		return;
+	}
+
+	auto op_enum = ParseFileSystemOperation(op_str);
+	config->ClearConfig(fs_str, op_enum);
+
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_max_requests(filesystem_name, operation, value)
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsMaxRequestsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto value = args.data[2].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetMaxRequests(fs_str, op_enum, value);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_adaptive_max_requests(filesystem_name, operation, min_value, max_value)
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsAdaptiveMaxRequestsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto min_value = args.data[2].GetValue(0).GetValue<int64_t>();
+	auto max_value = args.data[3].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetAdaptiveMaxRequests(fs_str, op_enum, min_value, max_value);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_throttle_backoff(filesystem_name, operation, min_ratio, recovery_ms, max_retries)
+// Pass 0 as recovery_ms to disable the backoff.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsThrottleBackoffFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto min_ratio = args.data[2].GetValue(0).GetValue<double>();
+	auto recovery_ms = args.data[3].GetValue(0).GetValue<int64_t>();
+	auto max_retries = args.data[4].GetValue(0).GetValue<int64_t>();
+
+	ValidateFilesystemExists(context, fs_str);
+	if (recovery_ms < 0) {
+		throw InvalidInputException("Throttle backoff recovery interval must be non-negative, got %lld ms",
+		                            recovery_ms);
+	}
+	if (max_retries < 0) {
+		throw InvalidInputException("Throttle backoff max retries must be non-negative, got %lld", max_retries);
+	}
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetThrottleBackoff(fs_str, op_enum, min_ratio, std::chrono::milliseconds(recovery_ms),
+	                           static_cast<idx_t>(max_retries));
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_group(group_name, bandwidth, burst, parent)
+// Pass '' as parent for a root group, and 0 for both bandwidth and burst to remove the group.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsGroupFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto group_str = args.data[0].GetValue(0).ToString();
+	auto bandwidth = args.data[1].GetValue(0).GetValue<int64_t>();
+	auto burst = args.data[2].GetValue(0).GetValue<int64_t>();
+	auto parent_str = args.data[3].GetValue(0).ToString();
+
+	if (bandwidth < 0) {
+		throw InvalidInputException("Bandwidth value must be non-negative, got %lld", bandwidth);
+	}
+	if (burst < 0) {
+		throw InvalidInputException("Burst value must be non-negative, got %lld", burst);
+	}
+
+	config->SetGroup(group_str, static_cast<idx_t>(bandwidth), static_cast<idx_t>(burst), parent_str);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_group_assign(filesystem_name, operation, group_name)
+// Pass '' as group_name to unassign the operation.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsGroupAssignFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto group_str = args.data[2].GetValue(0).ToString();
+
+	ValidateFilesystemExists(context, fs_str);
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetGroupAssignment(fs_str, op_enum, group_str);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_path_group(prefix, operation, group_name)
+// Pass '' as group_name to remove the rule.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsPathGroupFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto prefix_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto group_str = args.data[2].GetValue(0).ToString();
+
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	config->SetPathGroup(prefix_str, op_enum, group_str);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_shared_state(directory)
+// Pass '' as directory to keep limiter state in process memory.
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsSharedStateFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto directory_str = args.data[0].GetValue(0).ToString();
+
+	config->SetSharedStateDirectory(directory_str);
+	result.SetValue(0, Value::BOOLEAN(true));
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_configs() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitConfigsData : public GlobalTableFunctionState {
+	vector<OperationConfig> configs;
+	idx_t current_idx;
+
+	RateLimitConfigsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitConfigsBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(15);
+	names.reserve(15);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("quota");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("mode");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("burst");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("max_requests");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("limiter_group");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("request_quota");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("read_ahead_buffer");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("read_ahead_window");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("shard_lease");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("max_wait_ms");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("stream_idle_timeout_ms");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("write_behind_buffer");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("trace_sample_every");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitConfigsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitConfigsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		result->configs = config->GetAllConfigs();
+	}
+	return std::move(result);
+}
+
+void RateLimitConfigsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitConfigsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.configs.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &config = state.configs[state.current_idx];
+
+		output.SetValue(0, count, Value(config.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(config.operation)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(config.quota)));
+		output.SetValue(3, count, Value(RateLimitModeToString(config.mode)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(config.burst)));
+		// An adaptive limit reports its current value.
+		const auto max_requests = config.adaptive_limiter ? config.adaptive_limiter->GetLimit() : config.max_requests;
+		output.SetValue(5, count, Value::BIGINT(max_requests));
+		output.SetValue(6, count, config.group_name.empty() ? Value() : Value(config.group_name));
+		output.SetValue(7, count, Value::BIGINT(static_cast<int64_t>(config.request_quota)));
+		output.SetValue(8, count, Value::BIGINT(static_cast<int64_t>(config.read_ahead_buffer_size)));
+		output.SetValue(9, count, Value::BIGINT(static_cast<int64_t>(config.read_ahead_window)));
+		output.SetValue(10, count, Value::BIGINT(static_cast<int64_t>(config.shard_lease)));
+		using std::chrono::milliseconds;
+		output.SetValue(11, count, Value::BIGINT(std::chrono::duration_cast<milliseconds>(config.max_wait).count()));
+		output.SetValue(12, count,
+		                Value::BIGINT(std::chrono::duration_cast<milliseconds>(config.stream_idle_timeout).count()));
+		output.SetValue(13, count, Value::BIGINT(static_cast<int64_t>(config.write_behind_buffer_size)));
+		output.SetValue(14, count, Value::BIGINT(static_cast<int64_t>(config.trace_sample_every)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_groups() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitGroupsData : public GlobalTableFunctionState {
+	vector<LimiterGroupConfig> groups;
+	idx_t current_idx;
+
+	RateLimitGroupsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitGroupsBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(4);
+	names.reserve(4);
+
+	names.emplace_back("name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("bandwidth");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("burst");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("parent");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitGroupsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitGroupsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		result->groups = config->GetAllGroups();
+		std::sort(result->groups.begin(), result->groups.end(),
+		          [](const LimiterGroupConfig &lhs, const LimiterGroupConfig &rhs) { return lhs.name < rhs.name; });
+	}
+	return std::move(result);
+}
+
+void RateLimitGroupsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitGroupsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.groups.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &group = state.groups[state.current_idx];
+
+		output.SetValue(0, count, Value(group.name));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(group.bandwidth)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(group.burst)));
+		output.SetValue(3, count, group.parent_name.empty() ? Value() : Value(group.parent_name));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_path_groups() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitPathGroupsData : public GlobalTableFunctionState {
+	vector<PathGroupConfig> path_groups;
+	idx_t current_idx;
+
+	RateLimitPathGroupsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitPathGroupsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(3);
+	names.reserve(3);
+
+	names.emplace_back("prefix");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("limiter_group");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitPathGroupsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitPathGroupsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		result->path_groups = config->GetAllPathGroups();
+	}
+	return std::move(result);
+}
+
+void RateLimitPathGroupsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitPathGroupsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.path_groups.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &path_group = state.path_groups[state.current_idx];
+
+		output.SetValue(0, count, Value(path_group.prefix));
+		output.SetValue(1, count, Value(FileSystemOperationToString(path_group.operation)));
+		output.SetValue(2, count, Value(path_group.group_name));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_quota_profiles() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitQuotaProfileRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	QuotaProfile profile;
+	bool active;
+};
+
+struct RateLimitQuotaProfilesData : public GlobalTableFunctionState {
+	vector<RateLimitQuotaProfileRow> rows;
+	idx_t current_idx;
+
+	RateLimitQuotaProfilesData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitQuotaProfilesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(7);
+	names.reserve(7);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("start_time");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("end_time");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("bandwidth");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("burst");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("active");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitQuotaProfilesInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitQuotaProfilesData>();
+	auto config = RateLimitConfig::Get(context);
+	if (!config) {
+		return std::move(result);
+	}
+	for (auto &op_config : config->GetAllConfigs()) {
+		for (idx_t idx = 0; idx < op_config.schedule.size(); ++idx) {
+			const bool active = op_config.active_profile.IsValid() && op_config.active_profile.GetIndex() == idx;
+			result->rows.push_back(RateLimitQuotaProfileRow {op_config.filesystem_name, op_config.operation,
+			                                                 op_config.schedule[idx], active});
+		}
+	}
+	std::sort(result->rows.begin(), result->rows.end(),
+	          [](const RateLimitQuotaProfileRow &lhs, const RateLimitQuotaProfileRow &rhs) {
+		          if (lhs.filesystem_name != rhs.filesystem_name) {
+			          return lhs.filesystem_name < rhs.filesystem_name;
+		          }
+		          if (lhs.operation != rhs.operation) {
+			          return lhs.operation < rhs.operation;
+		          }
+		          return lhs.profile.start_minute < rhs.profile.start_minute;
+	          });
+	return std::move(result);
+}
+
+void RateLimitQuotaProfilesFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitQuotaProfilesData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value(TimeOfDayToString(row.profile.start_minute)));
+		output.SetValue(3, count, Value(TimeOfDayToString(row.profile.end_minute)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.profile.bandwidth)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.profile.burst)));
+		output.SetValue(6, count, Value::BOOLEAN(row.active));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_costs() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitCostRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	OperationCost cost;
+};
+
+struct RateLimitCostsData : public GlobalTableFunctionState {
+	vector<RateLimitCostRow> rows;
+	idx_t current_idx;
+
+	RateLimitCostsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitCostsBind(ClientContext &context, TableFunctionBindInput &input,
+                                            vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(5);
+	names.reserve(5);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("call_cost");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	names.emplace_back("byte_cost");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	names.emplace_back("item_cost");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitCostsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitCostsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (!config) {
+		return std::move(result);
+	}
+	for (auto &op_config : config->GetAllConfigs()) {
+		if (op_config.cost.IsSet()) {
+			result->rows.push_back(RateLimitCostRow {op_config.filesystem_name, op_config.operation, op_config.cost});
+		}
+	}
+	std::sort(result->rows.begin(), result->rows.end(), [](const RateLimitCostRow &lhs, const RateLimitCostRow &rhs) {
+		if (lhs.filesystem_name != rhs.filesystem_name) {
+			return lhs.filesystem_name < rhs.filesystem_name;
+		}
+		return lhs.operation < rhs.operation;
+	});
+	return std::move(result);
+}
+
+void RateLimitCostsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitCostsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value::DOUBLE(row.cost.call_cost));
+		output.SetValue(3, count, Value::DOUBLE(row.cost.byte_cost));
+		output.SetValue(4, count, Value::DOUBLE(row.cost.item_cost));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_block_caches() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitBlockCacheRow {
+	string filesystem_name;
+	BlockCacheStats stats;
+};
+
+struct RateLimitBlockCachesData : public GlobalTableFunctionState {
+	vector<RateLimitBlockCacheRow> rows;
+	idx_t current_idx;
+
+	RateLimitBlockCachesData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitBlockCachesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(7);
+	names.reserve(7);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("block_size");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("capacity");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("memory_usage");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("blocks");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("misses");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitBlockCachesInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitBlockCachesData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		for (const auto &op_config : config->GetAllConfigs()) {
+			if (op_config.block_cache) {
+				result->rows.push_back(RateLimitBlockCacheRow {op_config.filesystem_name,
+				                                               op_config.block_cache->GetStats()});
+			}
+		}
+	}
+	return std::move(result);
+}
+
+void RateLimitBlockCachesFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitBlockCachesData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(row.stats.block_size)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.stats.capacity)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.stats.memory_usage)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.stats.block_count)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.stats.hits)));
+		output.SetValue(6, count, Value::BIGINT(static_cast<int64_t>(row.stats.misses)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_metadata_caches() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitMetadataCacheRow {
+	string filesystem_name;
+	MetadataCacheStats stats;
+};
+
+struct RateLimitMetadataCachesData : public GlobalTableFunctionState {
+	vector<RateLimitMetadataCacheRow> rows;
+	idx_t current_idx;
+
+	RateLimitMetadataCachesData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitMetadataCachesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(6);
+	names.reserve(6);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("ttl_ms");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("max_entries");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("entries");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("misses");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitMetadataCachesInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitMetadataCachesData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		for (const auto &op_config : config->GetAllConfigs()) {
+			if (op_config.metadata_cache) {
+				result->rows.push_back(RateLimitMetadataCacheRow {op_config.filesystem_name,
+				                                                  op_config.metadata_cache->GetStats()});
+			}
+		}
+	}
+	return std::move(result);
+}
+
+void RateLimitMetadataCachesFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitMetadataCachesData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+		const auto ttl_ms = std::chrono::duration_cast<std::chrono::milliseconds>(row.stats.ttl).count();
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(ttl_ms)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.stats.max_entries)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.stats.entry_count)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.stats.hits)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.stats.misses)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_handle_pools() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitHandlePoolRow {
+	string filesystem_name;
+	HandlePoolStats stats;
+};
+
+struct RateLimitHandlePoolsData : public GlobalTableFunctionState {
+	vector<RateLimitHandlePoolRow> rows;
+	idx_t current_idx;
+
+	RateLimitHandlePoolsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitHandlePoolsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(6);
+	names.reserve(6);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("ttl_ms");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("capacity");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("handles");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("misses");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitHandlePoolsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitHandlePoolsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		for (const auto &op_config : config->GetAllConfigs()) {
+			if (op_config.handle_pool) {
+				result->rows.push_back(
+				    RateLimitHandlePoolRow {op_config.filesystem_name, op_config.handle_pool->GetStats()});
+			}
+		}
+	}
+	return std::move(result);
+}
+
+void RateLimitHandlePoolsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitHandlePoolsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+		const auto ttl_ms = std::chrono::duration_cast<std::chrono::milliseconds>(row.stats.ttl).count();
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(ttl_ms)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.stats.capacity)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.stats.handle_count)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.stats.hits)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.stats.misses)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_throttle_backoffs() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitThrottleBackoffRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	ThrottleBackoffStats stats;
+};
+
+struct RateLimitThrottleBackoffsData : public GlobalTableFunctionState {
+	vector<RateLimitThrottleBackoffRow> rows;
+	idx_t current_idx;
+
+	RateLimitThrottleBackoffsData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitThrottleBackoffsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(8);
+	names.reserve(8);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("min_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	names.emplace_back("recovery_ms");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("max_retries");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	names.emplace_back("throttle_errors");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("retries");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitThrottleBackoffsInit(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitThrottleBackoffsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		for (const auto &op_config : config->GetAllConfigs()) {
+			if (op_config.throttle_backoff) {
+				result->rows.push_back(RateLimitThrottleBackoffRow {op_config.filesystem_name, op_config.operation,
+				                                                    op_config.throttle_backoff->GetStats()});
+			}
+		}
+	}
+	return std::move(result);
+}
+
+void RateLimitThrottleBackoffsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitThrottleBackoffsData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+		const auto recovery_ms =
+		    std::chrono::duration_cast<std::chrono::milliseconds>(row.stats.recovery_interval).count();
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value::DOUBLE(row.stats.min_ratio));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(recovery_ms)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.stats.max_retries)));
+		output.SetValue(5, count, Value::DOUBLE(row.stats.ratio));
+		output.SetValue(6, count, Value::BIGINT(static_cast<int64_t>(row.stats.throttle_errors)));
+		output.SetValue(7, count, Value::BIGINT(static_cast<int64_t>(row.stats.retries)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_partition_quotas() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitPartitionQuotaRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	idx_t partition;
+	idx_t bandwidth;
+	idx_t burst;
+};
+
+struct RateLimitPartitionQuotasData : public GlobalTableFunctionState {
+	vector<RateLimitPartitionQuotaRow> rows;
+	idx_t current_idx;
+
+	RateLimitPartitionQuotasData() : current_idx(0) {
+	}
+};
+
+unique_ptr<FunctionData> RateLimitPartitionQuotasBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(5);
+	names.reserve(5);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("partition");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("bandwidth");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	names.emplace_back("burst");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> RateLimitPartitionQuotasInit(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitPartitionQuotasData>();
+	auto config = RateLimitConfig::Get(context);
+	if (config) {
+		for (const auto &op_config : config->GetAllConfigs()) {
+			const auto &limiter = op_config.rate_limiter;
+			if (!limiter) {
+				continue;
+			}
+			for (idx_t idx = 0; idx < limiter->GetPartitionCount(); ++idx) {
+				const auto quota = limiter->GetPartitionQuota(idx);
+				result->rows.push_back(RateLimitPartitionQuotaRow {op_config.filesystem_name, op_config.operation, idx,
+				                                                   quota.GetBandwidth(), quota.GetBurst()});
+			}
+		}
+	}
+	return std::move(result);
+}
+
+void RateLimitPartitionQuotasFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitPartitionQuotasData>();
+
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.partition)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.bandwidth)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.burst)));
+
+		state.current_idx++;
+		count++;
+	}
+
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_stats() - Table Function
+//===--------------------------------------------------------------------===//
+
+struct RateLimitStatsRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	OperationStatsSnapshot snapshot;
+};
 
-	auto fs_str = args.data[0].GetValue(0).ToString();
-	auto op_str = args.data[1].GetValue(0).ToString();
+struct RateLimitStatsData : public GlobalTableFunctionState {
+	vector<RateLimitStatsRow> rows;
+	idx_t current_idx;
 
-	if (fs_str == "*") {
-		config->ClearAll();
-		result.SetValue(0, Value::BOOLEAN(true));
-		return;
+	RateLimitStatsData() : current_idx(0) {
 	}
+};
 
-	if (op_str == "*") {
-		config->ClearFilesystem(fs_str);
-		result.SetValue(0, Value::BOOLEAN(true));
-		return;
+Value HistogramToValue(const array<uint64_t, OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS> &histogram) {
+	vector<Value> buckets;
+	buckets.reserve(histogram.size());
+	for (auto bucket : histogram) {
+		buckets.push_back(Value::BIGINT(static_cast<int64_t>(bucket)));
 	}
+	return Value::LIST(LogicalType {LogicalTypeId::BIGINT}, std::move(buckets));
+}
 
-	auto op_enum = ParseFileSystemOperation(op_str);
-	config->ClearConfig(fs_str, op_enum);
+bool HasActivity(const OperationStatsSnapshot &snapshot) {
+	return snapshot.ops_admitted > 0 || snapshot.rate_rejections > 0 || snapshot.burst_rejections > 0 ||
+	       snapshot.in_flight != 0 || snapshot.traced_calls > 0;
+}
 
-	result.SetValue(0, Value::BOOLEAN(true));
+unique_ptr<FunctionData> RateLimitStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                            vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(15);
+	names.reserve(15);
+
+	names.emplace_back("filesystem");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	for (const auto *counter_name : {"ops_admitted", "bytes_admitted", "rate_rejections", "burst_rejections",
+	                                 "throttled_ops", "throttle_wait_ns", "semaphore_wait_ns", "in_flight"}) {
+		names.emplace_back(counter_name);
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
+
+	names.emplace_back("wait_histogram");
+	return_types.emplace_back(LogicalType::LIST(LogicalType {LogicalTypeId::BIGINT}));
+
+	names.emplace_back("semaphore_wait_histogram");
+	return_types.emplace_back(LogicalType::LIST(LogicalType {LogicalTypeId::BIGINT}));
+
+	for (const auto *counter_name : {"traced_calls", "inner_latency_ns"}) {
+		names.emplace_back(counter_name);
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
+
+	names.emplace_back("inner_latency_histogram");
+	return_types.emplace_back(LogicalType::LIST(LogicalType {LogicalTypeId::BIGINT}));
+
+	return nullptr;
 }
 
-//===--------------------------------------------------------------------===//
-// rate_limit_fs_max_requests(filesystem_name, operation, value)
-//===--------------------------------------------------------------------===//
+unique_ptr<GlobalTableFunctionState> RateLimitStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RateLimitStatsData>();
+	auto config = RateLimitConfig::Get(context);
+	if (!config) {
+		return std::move(result);
+	}
+	for (const auto &filesystem_stats : config->GetAllStats()) {
+		for (idx_t idx = 0; idx < FILE_SYSTEM_OPERATION_COUNT; ++idx) {
+			auto snapshot = filesystem_stats->operations[idx].GetSnapshot();
+			if (!HasActivity(snapshot)) {
+				continue;
+			}
+			result->rows.push_back(RateLimitStatsRow {filesystem_stats->filesystem_name,
+			                                          static_cast<FileSystemOperation>(idx), snapshot});
+		}
+	}
+	std::sort(result->rows.begin(), result->rows.end(), [](const RateLimitStatsRow &lhs, const RateLimitStatsRow &rhs) {
+		if (lhs.filesystem_name != rhs.filesystem_name) {
+			return lhs.filesystem_name < rhs.filesystem_name;
+		}
+		return lhs.operation < rhs.operation;
+	});
+	return std::move(result);
+}
 
-void RateLimitFsMaxRequestsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.size() == 1);
-	auto &context = state.GetContext();
-	auto config = RateLimitConfig::GetOrCreate(context);
+void RateLimitStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<RateLimitStatsData>();
 
-	auto fs_str = args.data[0].GetValue(0).ToString();
-	auto op_str = args.data[1].GetValue(0).ToString();
-	auto value = args.data[2].GetValue(0).GetValue<int64_t>();
+	idx_t count = 0;
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+		auto &snapshot = row.snapshot;
+
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(snapshot.ops_admitted)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(snapshot.bytes_admitted)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(snapshot.rate_rejections)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(snapshot.burst_rejections)));
+		output.SetValue(6, count, Value::BIGINT(static_cast<int64_t>(snapshot.throttled_ops)));
+		output.SetValue(7, count, Value::BIGINT(static_cast<int64_t>(snapshot.throttle_wait_nanos)));
+		output.SetValue(8, count, Value::BIGINT(static_cast<int64_t>(snapshot.semaphore_wait_nanos)));
+		output.SetValue(9, count, Value::BIGINT(snapshot.in_flight));
+		output.SetValue(10, count, HistogramToValue(snapshot.wait_histogram));
+		output.SetValue(11, count, HistogramToValue(snapshot.semaphore_wait_histogram));
+		output.SetValue(12, count, Value::BIGINT(static_cast<int64_t>(snapshot.traced_calls)));
+		output.SetValue(13, count, Value::BIGINT(static_cast<int64_t>(snapshot.inner_latency_nanos)));
+		output.SetValue(14, count, HistogramToValue(snapshot.inner_latency_histogram));
 
-	ValidateFilesystemExists(context, fs_str);
-	auto op_enum = ParseFileSystemOperation(op_str);
+		state.current_idx++;
+		count++;
+	}
 
-	config->SetMaxRequests(fs_str, op_enum, value);
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_stats_reset()
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsStatsResetFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto config = RateLimitConfig::Get(state.GetContext());
+	if (config) {
+		config->ResetStats();
+	}
 	result.SetValue(0, Value::BOOLEAN(true));
 }
 
 //===--------------------------------------------------------------------===//
-// rate_limit_fs_configs() - Table Function
+// rate_limit_fs_burst_recommendations() - Table Function
 //===--------------------------------------------------------------------===//
 
-struct RateLimitConfigsData : public GlobalTableFunctionState {
-	vector<OperationConfig> configs;
+// Percentile the recommended burst of rate_limit_fs_burst_recommendations() admits.
+constexpr double RECOMMENDED_BURST_PERCENTILE = 99;
+
+struct BurstRecommendationRow {
+	string filesystem_name;
+	FileSystemOperation operation;
+	uint64_t requests;
+	idx_t p50_bytes;
+	idx_t p90_bytes;
+	idx_t p99_bytes;
+	idx_t max_bytes;
+	idx_t burst;
+	idx_t recommended_burst;
+};
+
+struct BurstRecommendationsData : public GlobalTableFunctionState {
+	vector<BurstRecommendationRow> rows;
 	idx_t current_idx;
 
-	RateLimitConfigsData() : current_idx(0) {
+	BurstRecommendationsData() : current_idx(0) {
 	}
 };
 
-unique_ptr<FunctionData> RateLimitConfigsBind(ClientContext &context, TableFunctionBindInput &input,
-                                              vector<LogicalType> &return_types, vector<string> &names) {
+unique_ptr<FunctionData> BurstRecommendationsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
 	D_ASSERT(return_types.empty());
 	D_ASSERT(names.empty());
 
-	return_types.reserve(6);
-	names.reserve(6);
+	return_types.reserve(9);
+	names.reserve(9);
 
 	names.emplace_back("filesystem");
 	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
@@ -164,43 +1648,74 @@ unique_ptr<FunctionData> RateLimitConfigsBind(ClientContext &context, TableFunct
 	names.emplace_back("operation");
 	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
 
-	names.emplace_back("quota");
-	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
-
-	names.emplace_back("mode");
-	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
-
-	names.emplace_back("burst");
-	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
-
-	names.emplace_back("max_requests");
-	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	for (const auto *column_name :
+	     {"requests", "p50_bytes", "p90_bytes", "p99_bytes", "max_bytes", "burst", "recommended_burst"}) {
+		names.emplace_back(column_name);
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
 
 	return nullptr;
 }
 
-unique_ptr<GlobalTableFunctionState> RateLimitConfigsInit(ClientContext &context, TableFunctionInitInput &input) {
-	auto result = make_uniq<RateLimitConfigsData>();
+unique_ptr<GlobalTableFunctionState> BurstRecommendationsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<BurstRecommendationsData>();
 	auto config = RateLimitConfig::Get(context);
-	if (config) {
-		result->configs = config->GetAllConfigs();
+	if (!config) {
+		return std::move(result);
+	}
+	const auto configs = config->GetAllConfigs();
+	for (const auto &filesystem_stats : config->GetAllStats()) {
+		for (auto operation : {FileSystemOperation::READ, FileSystemOperation::WRITE}) {
+			const auto snapshot = filesystem_stats->Get(operation).GetSnapshot();
+			uint64_t requests = 0;
+			for (auto count : snapshot.request_size_histogram) {
+				requests += count;
+			}
+			if (requests == 0) {
+				continue;
+			}
+			BurstRecommendationRow row {filesystem_stats->filesystem_name, operation, requests};
+			row.p50_bytes = OperationStats::GetRequestSizePercentile(snapshot, 50);
+			row.p90_bytes = OperationStats::GetRequestSizePercentile(snapshot, 90);
+			row.p99_bytes = OperationStats::GetRequestSizePercentile(snapshot, 99);
+			row.max_bytes = OperationStats::GetRequestSizePercentile(snapshot, 100);
+			row.burst = 0;
+			for (const auto &op_config : configs) {
+				if (op_config.filesystem_name == row.filesystem_name && op_config.operation == operation) {
+					row.burst = op_config.GetEffectiveBurst();
+				}
+			}
+			row.recommended_burst =
+			    config->RecommendBurst(row.filesystem_name, operation, RECOMMENDED_BURST_PERCENTILE);
+			result->rows.push_back(std::move(row));
+		}
 	}
+	std::sort(result->rows.begin(), result->rows.end(),
+	          [](const BurstRecommendationRow &lhs, const BurstRecommendationRow &rhs) {
+		          if (lhs.filesystem_name != rhs.filesystem_name) {
+			          return lhs.filesystem_name < rhs.filesystem_name;
+		          }
+		          return lhs.operation < rhs.operation;
+	          });
 	return std::move(result);
 }
 
-void RateLimitConfigsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
-	auto &state = data.global_state->Cast<RateLimitConfigsData>();
+void BurstRecommendationsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<BurstRecommendationsData>();
 
 	idx_t count = 0;
-	while (state.current_idx < state.configs.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &config = state.configs[state.current_idx];
-
-		output.SetValue(0, count, Value(config.filesystem_name));
-		output.SetValue(1, count, Value(FileSystemOperationToString(config.operation)));
-		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(config.quota)));
-		output.SetValue(3, count, Value(RateLimitModeToString(config.mode)));
-		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(config.burst)));
-		output.SetValue(5, count, Value::BIGINT(config.max_requests));
+	while (state.current_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.current_idx];
+
+		output.SetValue(0, count, Value(row.filesystem_name));
+		output.SetValue(1, count, Value(FileSystemOperationToString(row.operation)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.requests)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.p50_bytes)));
+		output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(row.p90_bytes)));
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.p99_bytes)));
+		output.SetValue(6, count, Value::BIGINT(static_cast<int64_t>(row.max_bytes)));
+		output.SetValue(7, count, Value::BIGINT(static_cast<int64_t>(row.burst)));
+		output.SetValue(8, count, Value::BIGINT(static_cast<int64_t>(row.recommended_burst)));
 
 		state.current_idx++;
 		count++;
@@ -209,6 +1724,26 @@ void RateLimitConfigsFunction(ClientContext &context, TableFunctionInput &data,
 	output.SetCardinality(count);
 }
 
+//===--------------------------------------------------------------------===//
+// rate_limit_fs_auto_burst(filesystem_name, operation, percentile)
+//===--------------------------------------------------------------------===//
+
+void RateLimitFsAutoBurstFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.size() == 1);
+	auto &context = state.GetContext();
+	auto config = RateLimitConfig::GetOrCreate(context);
+
+	auto fs_str = args.data[0].GetValue(0).ToString();
+	auto op_str = args.data[1].GetValue(0).ToString();
+	auto percentile = args.data[2].GetValue(0).GetValue<double>();
+
+	ValidateFilesystemExists(context, fs_str);
+	auto op_enum = ParseFileSystemOperation(op_str);
+
+	const auto burst = config->AutoTuneBurst(fs_str, op_enum, percentile);
+	result.SetValue(0, Value::BIGINT(static_cast<int64_t>(burst)));
+}
+
 //===--------------------------------------------------------------------===//
 // rate_limit_fs_list_filesystems() - Table Function
 //===--------------------------------------------------------------------===//
@@ -305,6 +1840,113 @@ ScalarFunction GetRateLimitFsBurstFunction() {
 	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsBurstFunction);
 }
 
+ScalarFunction GetRateLimitFsRequestQuotaFunction() {
+	return ScalarFunction("rate_limit_fs_request_quota",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*value=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsRequestQuotaFunction);
+}
+
+ScalarFunction GetRateLimitFsShardLeaseFunction() {
+	return ScalarFunction("rate_limit_fs_shard_lease",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*value=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsShardLeaseFunction);
+}
+
+ScalarFunction GetRateLimitFsClockResolutionFunction() {
+	return ScalarFunction("rate_limit_fs_clock_resolution",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*resolution_us=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsClockResolutionFunction);
+}
+
+ScalarFunction GetRateLimitFsMaxWaitFunction() {
+	return ScalarFunction("rate_limit_fs_max_wait",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*max_wait_ms=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsMaxWaitFunction);
+}
+
+ScalarFunction GetRateLimitFsTraceFunction() {
+	return ScalarFunction("rate_limit_fs_trace",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*sample_every=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsTraceFunction);
+}
+
+ScalarFunction GetRateLimitFsCostFunction() {
+	return ScalarFunction("rate_limit_fs_cost",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*call_cost=*/LogicalType {LogicalTypeId::DOUBLE},
+	                       /*byte_cost=*/LogicalType {LogicalTypeId::DOUBLE},
+	                       /*item_cost=*/LogicalType {LogicalTypeId::DOUBLE}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsCostFunction);
+}
+
+ScalarFunction GetRateLimitFsQuotaProfileFunction() {
+	return ScalarFunction("rate_limit_fs_quota_profile",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*start_time=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*end_time=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*bandwidth=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*burst=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsQuotaProfileFunction);
+}
+
+ScalarFunction GetRateLimitFsReadAheadFunction() {
+	return ScalarFunction("rate_limit_fs_read_ahead",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*buffer_size=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*window=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsReadAheadFunction);
+}
+
+ScalarFunction GetRateLimitFsStreamSlotFunction() {
+	return ScalarFunction("rate_limit_fs_stream_slot",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*idle_timeout_ms=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsStreamSlotFunction);
+}
+
+ScalarFunction GetRateLimitFsWriteBehindFunction() {
+	return ScalarFunction("rate_limit_fs_write_behind",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*buffer_size=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsWriteBehindFunction);
+}
+
+ScalarFunction GetRateLimitFsBlockCacheFunction() {
+	return ScalarFunction("rate_limit_fs_block_cache",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*block_size=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*capacity=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsBlockCacheFunction);
+}
+
+ScalarFunction GetRateLimitFsMetadataCacheFunction() {
+	return ScalarFunction("rate_limit_fs_metadata_cache",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*ttl_ms=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*max_entries=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsMetadataCacheFunction);
+}
+
+ScalarFunction GetRateLimitFsHandlePoolFunction() {
+	return ScalarFunction("rate_limit_fs_handle_pool",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*ttl_ms=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*capacity=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsHandlePoolFunction);
+}
+
 ScalarFunction GetRateLimitFsClearFunction() {
 	return ScalarFunction("rate_limit_fs_clear",
 	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
@@ -312,6 +1954,139 @@ ScalarFunction GetRateLimitFsClearFunction() {
 	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsClearFunction);
 }
 
+ScalarFunction GetRateLimitFsAdaptiveMaxRequestsFunction() {
+	return ScalarFunction("rate_limit_fs_adaptive_max_requests",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*min_value=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*max_value=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsAdaptiveMaxRequestsFunction);
+}
+
+ScalarFunction GetRateLimitFsPartitionsFunction() {
+	return ScalarFunction("rate_limit_fs_partitions",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*count=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsPartitionsFunction);
+}
+
+ScalarFunction GetRateLimitFsThrottleBackoffFunction() {
+	return ScalarFunction("rate_limit_fs_throttle_backoff",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*min_ratio=*/LogicalType {LogicalTypeId::DOUBLE},
+	                       /*recovery_ms=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*max_retries=*/LogicalType {LogicalTypeId::BIGINT}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsThrottleBackoffFunction);
+}
+
+ScalarFunction GetRateLimitFsGroupFunction() {
+	return ScalarFunction("rate_limit_fs_group",
+	                      {/*group_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*bandwidth=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*burst=*/LogicalType {LogicalTypeId::BIGINT},
+	                       /*parent=*/LogicalType {LogicalTypeId::VARCHAR}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsGroupFunction);
+}
+
+ScalarFunction GetRateLimitFsGroupAssignFunction() {
+	return ScalarFunction("rate_limit_fs_group_assign",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*group_name=*/LogicalType {LogicalTypeId::VARCHAR}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsGroupAssignFunction);
+}
+
+TableFunction GetRateLimitFsGroupsFunction() {
+	TableFunction func("rate_limit_fs_groups", {}, RateLimitGroupsFunction, RateLimitGroupsBind, RateLimitGroupsInit);
+	return func;
+}
+
+ScalarFunction GetRateLimitFsPathGroupFunction() {
+	return ScalarFunction("rate_limit_fs_path_group",
+	                      {/*prefix=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*group_name=*/LogicalType {LogicalTypeId::VARCHAR}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsPathGroupFunction);
+}
+
+ScalarFunction GetRateLimitFsSharedStateFunction() {
+	return ScalarFunction("rate_limit_fs_shared_state", {/*directory=*/LogicalType {LogicalTypeId::VARCHAR}},
+	                      LogicalType {LogicalTypeId::BOOLEAN}, RateLimitFsSharedStateFunction);
+}
+
+TableFunction GetRateLimitFsPathGroupsFunction() {
+	TableFunction func("rate_limit_fs_path_groups", {}, RateLimitPathGroupsFunction, RateLimitPathGroupsBind,
+	                   RateLimitPathGroupsInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsCostsFunction() {
+	TableFunction func("rate_limit_fs_costs", {}, RateLimitCostsFunction, RateLimitCostsBind, RateLimitCostsInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsQuotaProfilesFunction() {
+	TableFunction func("rate_limit_fs_quota_profiles", {}, RateLimitQuotaProfilesFunction, RateLimitQuotaProfilesBind,
+	                   RateLimitQuotaProfilesInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsBlockCachesFunction() {
+	TableFunction func("rate_limit_fs_block_caches", {}, RateLimitBlockCachesFunction, RateLimitBlockCachesBind,
+	                   RateLimitBlockCachesInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsMetadataCachesFunction() {
+	TableFunction func("rate_limit_fs_metadata_caches", {}, RateLimitMetadataCachesFunction,
+	                   RateLimitMetadataCachesBind, RateLimitMetadataCachesInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsHandlePoolsFunction() {
+	TableFunction func("rate_limit_fs_handle_pools", {}, RateLimitHandlePoolsFunction, RateLimitHandlePoolsBind,
+	                   RateLimitHandlePoolsInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsThrottleBackoffsFunction() {
+	TableFunction func("rate_limit_fs_throttle_backoffs", {}, RateLimitThrottleBackoffsFunction,
+	                   RateLimitThrottleBackoffsBind, RateLimitThrottleBackoffsInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsPartitionQuotasFunction() {
+	TableFunction func("rate_limit_fs_partition_quotas", {}, RateLimitPartitionQuotasFunction,
+	                   RateLimitPartitionQuotasBind, RateLimitPartitionQuotasInit);
+	return func;
+}
+
+TableFunction GetRateLimitFsBurstRecommendationsFunction() {
+	TableFunction func("rate_limit_fs_burst_recommendations", {}, BurstRecommendationsFunction,
+	                   BurstRecommendationsBind, BurstRecommendationsInit);
+	return func;
+}
+
+ScalarFunction GetRateLimitFsAutoBurstFunction() {
+	return ScalarFunction("rate_limit_fs_auto_burst",
+	                      {/*filesystem_name=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*operation=*/LogicalType {LogicalTypeId::VARCHAR},
+	                       /*percentile=*/LogicalType {LogicalTypeId::DOUBLE}},
+	                      LogicalType {LogicalTypeId::BIGINT}, RateLimitFsAutoBurstFunction);
+}
+
+TableFunction GetRateLimitFsStatsFunction() {
+	TableFunction func("rate_limit_fs_stats", {}, RateLimitStatsFunction, RateLimitStatsBind, RateLimitStatsInit);
+	return func;
+}
+
+ScalarFunction GetRateLimitFsStatsResetFunction() {
+	return ScalarFunction("rate_limit_fs_stats_reset", {}, LogicalType {LogicalTypeId::BOOLEAN},
+	                      RateLimitFsStatsResetFunction);
+}
+
 TableFunction GetRateLimitFsConfigsFunction() {
 	TableFunction func("rate_limit_fs_configs", {}, RateLimitConfigsFunction, RateLimitConfigsBind,
 	                   RateLimitConfigsInit);
@@ -14,8 +14,18 @@ RateLimitMode ParseRateLimitMode(const string &mode_str) {
 	if (mode_lower == "non_blocking" || mode_lower == "non-blocking" || mode_lower == "nonblocking") {
 		return RateLimitMode::NON_BLOCKING;
 	}
+	if (mode_lower == "split") {
+		return RateLimitMode::SPLIT;
+	}
+	if (mode_lower == "fair") {
+		return RateLimitMode::FAIR;
+	}
+	if (mode_lower == "bounded") {
+		return RateLimitMode::BOUNDED;
+	}
 
-	throw InvalidInputException("Invalid rate limit mode '%s'. Use 'blocking' or 'non_blocking'", mode_str);
+	throw InvalidInputException(
+	    "Invalid rate limit mode '%s'. Use 'blocking', 'non_blocking', 'split', 'fair' or 'bounded'", mode_str);
 }
 
 string RateLimitModeToString(RateLimitMode mode) {
@@ -26,6 +36,12 @@ string RateLimitModeToString(RateLimitMode mode) {
 		return "blocking";
 	case RateLimitMode::NON_BLOCKING:
 		return "non_blocking";
+	case RateLimitMode::SPLIT:
+		return "split";
+	case RateLimitMode::FAIR:
+		return "fair";
+	case RateLimitMode::BOUNDED:
+		return "bounded";
 	default:
 		throw InternalException("Unknown RateLimitMode value");
 	}
@@ -0,0 +1,32 @@
+#include "rate_limit_priority.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+RateLimitPriority ParseRateLimitPriority(const string &priority_str) {
+	auto priority_lower = StringUtil::Lower(priority_str);
+
+	if (priority_lower == "interactive") {
+		return RateLimitPriority::INTERACTIVE;
+	}
+	if (priority_lower == "batch") {
+		return RateLimitPriority::BATCH;
+	}
+
+	throw InvalidInputException("Invalid rate limit priority '%s'. Use 'interactive' or 'batch'", priority_str);
+}
+
+string RateLimitPriorityToString(RateLimitPriority priority) {
+	switch (priority) {
+	case RateLimitPriority::INTERACTIVE:
+		return "interactive";
+	case RateLimitPriority::BATCH:
+		return "batch";
+	default:
+		throw InternalException("Unknown RateLimitPriority value");
+	}
+}
+
+} // namespace duckdb
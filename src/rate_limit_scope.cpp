@@ -0,0 +1,43 @@
+#include "rate_limit_scope.hpp"
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+RateLimitScope RateLimitScope::FromOpener(optional_ptr<FileOpener> opener, shared_ptr<BaseClock> clock) {
+	RateLimitScope scope;
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(opener, RATE_LIMIT_FS_PRIORITY_SETTING, value) && !value.IsNull()) {
+		scope.priority = ParseRateLimitPriority(value.ToString());
+	}
+
+	auto context = FileOpener::TryGetClientContext(opener);
+	if (!context) {
+		return scope;
+	}
+	if (!FileOpener::TryGetCurrentSetting(opener, RATE_LIMIT_FS_CONNECTION_BANDWIDTH_SETTING, value) ||
+	    value.IsNull()) {
+		return scope;
+	}
+	const auto bandwidth = value.GetValue<int64_t>();
+	if (bandwidth <= 0) {
+		return scope;
+	}
+	auto state = context->registered_state->GetOrCreate<RateLimitClientState>(RateLimitClientState::CACHE_KEY);
+	scope.connection_limiter = state->GetConnectionLimiter(static_cast<idx_t>(bandwidth), std::move(clock));
+	return scope;
+}
+
+SharedRateLimiter RateLimitClientState::GetConnectionLimiter(idx_t bandwidth_p, shared_ptr<BaseClock> clock) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	if (!limiter || bandwidth != bandwidth_p) {
+		// Rate only, so requests of any size pass and the connection is paced to its average bandwidth.
+		limiter = CreateRateLimiter(bandwidth_p, /*burst_p=*/0, std::move(clock));
+		bandwidth = bandwidth_p;
+	}
+	return limiter;
+}
+
+} // namespace duckdb
@@ -0,0 +1,237 @@
+#include "rate_limit_stats.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Source of shard indices; threads are spread over shards round-robin in the order they first record something.
+atomic<idx_t> next_shard_index {0};
+
+idx_t GetThreadShardIndex() {
+	thread_local idx_t shard_index =
+	    next_shard_index.fetch_add(1, std::memory_order_relaxed) % OperationStats::SHARD_COUNT;
+	return shard_index;
+}
+
+uint64_t ToNanos(Duration duration) {
+	const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	return nanos > 0 ? static_cast<uint64_t>(nanos) : 0;
+}
+
+} // namespace
+
+OperationStats::OperationStats() = default;
+
+OperationStats::Shard &OperationStats::GetShard() {
+	return shards[GetThreadShardIndex()];
+}
+
+void OperationStats::RecordAdmitted(idx_t bytes) {
+	auto &shard = GetShard();
+	shard.ops_admitted.fetch_add(1, std::memory_order_relaxed);
+	shard.bytes_admitted.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordRefunded(idx_t bytes) {
+	// Refunds come from the thread the bytes were admitted on, so the shard doesn't go below zero.
+	GetShard().bytes_admitted.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordRateRejection() {
+	GetShard().rate_rejections.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordBurstRejection() {
+	GetShard().burst_rejections.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordThrottleWait(Duration wait) {
+	auto &shard = GetShard();
+	const auto wait_nanos = ToNanos(wait);
+	if (wait_nanos > 0) {
+		shard.throttled_ops.fetch_add(1, std::memory_order_relaxed);
+		shard.throttle_wait_nanos.fetch_add(wait_nanos, std::memory_order_relaxed);
+	}
+	shard.wait_histogram[GetWaitBucket(wait)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordSemaphoreWait(Duration wait) {
+	auto &shard = GetShard();
+	shard.semaphore_wait_nanos.fetch_add(ToNanos(wait), std::memory_order_relaxed);
+	shard.semaphore_wait_histogram[GetWaitBucket(wait)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordInnerLatency(Duration latency) {
+	auto &shard = GetShard();
+	shard.traced_calls.fetch_add(1, std::memory_order_relaxed);
+	shard.inner_latency_nanos.fetch_add(ToNanos(latency), std::memory_order_relaxed);
+	shard.inner_latency_histogram[GetWaitBucket(latency)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::RecordRequestSize(idx_t bytes) {
+	GetShard().request_size_histogram[GetSizeBucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool OperationStats::ShouldTrace(idx_t sample_every) {
+	// Per shard, so sampling doesn't add a shared counter either; shards see similar traffic, so it evens out.
+	return GetShard().trace_counter.fetch_add(1, std::memory_order_relaxed) % sample_every == 0;
+}
+
+void OperationStats::IncrementInFlight() {
+	GetShard().in_flight.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::DecrementInFlight() {
+	// Usually the same shard as the increment, but only the sum over shards is meaningful anyway.
+	GetShard().in_flight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+OperationStatsSnapshot OperationStats::GetSnapshot() const {
+	OperationStatsSnapshot snapshot;
+	for (const auto &shard : shards) {
+		snapshot.ops_admitted += shard.ops_admitted.load(std::memory_order_relaxed);
+		snapshot.bytes_admitted += shard.bytes_admitted.load(std::memory_order_relaxed);
+		snapshot.rate_rejections += shard.rate_rejections.load(std::memory_order_relaxed);
+		snapshot.burst_rejections += shard.burst_rejections.load(std::memory_order_relaxed);
+		snapshot.throttled_ops += shard.throttled_ops.load(std::memory_order_relaxed);
+		snapshot.throttle_wait_nanos += shard.throttle_wait_nanos.load(std::memory_order_relaxed);
+		snapshot.semaphore_wait_nanos += shard.semaphore_wait_nanos.load(std::memory_order_relaxed);
+		snapshot.in_flight += shard.in_flight.load(std::memory_order_relaxed);
+		snapshot.traced_calls += shard.traced_calls.load(std::memory_order_relaxed);
+		snapshot.inner_latency_nanos += shard.inner_latency_nanos.load(std::memory_order_relaxed);
+		for (idx_t idx = 0; idx < OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS; ++idx) {
+			snapshot.wait_histogram[idx] += shard.wait_histogram[idx].load(std::memory_order_relaxed);
+			snapshot.semaphore_wait_histogram[idx] +=
+			    shard.semaphore_wait_histogram[idx].load(std::memory_order_relaxed);
+			snapshot.inner_latency_histogram[idx] += shard.inner_latency_histogram[idx].load(std::memory_order_relaxed);
+		}
+		for (idx_t idx = 0; idx < OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS; ++idx) {
+			snapshot.request_size_histogram[idx] += shard.request_size_histogram[idx].load(std::memory_order_relaxed);
+		}
+	}
+	return snapshot;
+}
+
+void OperationStats::Reset() {
+	for (auto &shard : shards) {
+		shard.ops_admitted.store(0, std::memory_order_relaxed);
+		shard.bytes_admitted.store(0, std::memory_order_relaxed);
+		shard.rate_rejections.store(0, std::memory_order_relaxed);
+		shard.burst_rejections.store(0, std::memory_order_relaxed);
+		shard.throttled_ops.store(0, std::memory_order_relaxed);
+		shard.throttle_wait_nanos.store(0, std::memory_order_relaxed);
+		shard.semaphore_wait_nanos.store(0, std::memory_order_relaxed);
+		shard.traced_calls.store(0, std::memory_order_relaxed);
+		shard.inner_latency_nanos.store(0, std::memory_order_relaxed);
+		for (idx_t idx = 0; idx < OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS; ++idx) {
+			shard.wait_histogram[idx].store(0, std::memory_order_relaxed);
+			shard.semaphore_wait_histogram[idx].store(0, std::memory_order_relaxed);
+			shard.inner_latency_histogram[idx].store(0, std::memory_order_relaxed);
+		}
+		for (auto &bucket : shard.request_size_histogram) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+idx_t OperationStats::GetWaitBucket(Duration wait) {
+	const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+	idx_t bucket = 0;
+	for (auto remaining = micros; remaining > 0 && bucket + 1 < OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS;
+	     remaining >>= 1) {
+		++bucket;
+	}
+	return bucket;
+}
+
+Duration OperationStats::GetWaitBucketUpperBound(idx_t bucket) {
+	return std::chrono::microseconds(int64_t(1) << bucket);
+}
+
+Duration OperationStats::GetDurationPercentile(const OperationStatsSnapshot::WaitHistogram &histogram,
+                                              double percentile) {
+	uint64_t total = 0;
+	for (auto count : histogram) {
+		total += count;
+	}
+	if (total == 0) {
+		return Duration::zero();
+	}
+	const auto target = static_cast<uint64_t>(std::ceil(static_cast<double>(total) * percentile / 100.0));
+	uint64_t covered = 0;
+	for (idx_t bucket = 0; bucket < OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS; ++bucket) {
+		covered += histogram[bucket];
+		if (covered >= target) {
+			return GetWaitBucketUpperBound(bucket);
+		}
+	}
+	return GetWaitBucketUpperBound(OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS - 1);
+}
+
+idx_t OperationStats::GetSizeBucket(idx_t bytes) {
+	if (bytes == 0) {
+		return 0;
+	}
+	// One more than the number of bits of bytes - 1, i.e. of the smallest power of two at or above bytes.
+	idx_t bucket = 1;
+	for (auto remaining = bytes - 1; remaining > 0 && bucket + 1 < OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS;
+	     remaining >>= 1) {
+		++bucket;
+	}
+	return bucket;
+}
+
+idx_t OperationStats::GetSizeBucketUpperBound(idx_t bucket) {
+	if (bucket == 0) {
+		return 0;
+	}
+	return idx_t(1) << (bucket - 1);
+}
+
+idx_t OperationStats::GetRequestSizePercentile(const OperationStatsSnapshot &snapshot, double percentile) {
+	uint64_t total = 0;
+	for (auto count : snapshot.request_size_histogram) {
+		total += count;
+	}
+	if (total == 0) {
+		return 0;
+	}
+	// Requests at or below the percentile, rounded up so that a percentile of 100 covers every request.
+	const auto target = static_cast<uint64_t>(std::ceil(static_cast<double>(total) * percentile / 100.0));
+	uint64_t covered = 0;
+	for (idx_t bucket = 0; bucket < OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS; ++bucket) {
+		covered += snapshot.request_size_histogram[bucket];
+		if (covered >= target) {
+			return GetSizeBucketUpperBound(bucket);
+		}
+	}
+	return GetSizeBucketUpperBound(OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS - 1);
+}
+
+OperationSlot::OperationSlot(SemaphoreGuard semaphore_guard_p, OperationStats &stats_p,
+                             shared_ptr<AdaptiveConcurrencyLimiter> adaptive_limiter_p,
+                             shared_ptr<ThrottleBackoff> throttle_backoff_p, OperationTrace trace_p)
+    : semaphore_guard(std::move(semaphore_guard_p)), stats(stats_p), adaptive_limiter(std::move(adaptive_limiter_p)),
+      throttle_backoff(std::move(throttle_backoff_p)), trace(std::move(trace_p)) {
+	stats.IncrementInFlight();
+}
+
+OperationSlot::~OperationSlot() {
+	stats.DecrementInFlight();
+}
+
+void OperationSlot::RecordTrace(Duration latency) {
+	stats.RecordInnerLatency(latency);
+	if (!trace.callback) {
+		return;
+	}
+	// Runs when the call returns or throws, and failing to report it must not fail the call.
+	try {
+		trace.callback(trace.semaphore_wait, latency);
+	} catch (...) {
+	}
+}
+
+} // namespace duckdb
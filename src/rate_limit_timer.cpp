@@ -0,0 +1,123 @@
+#include "rate_limit_timer.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/helper.hpp"
+
+#include "default_clock.hpp"
+#include "no_destructor.hpp"
+
+namespace duckdb {
+
+namespace {
+
+RateLimitTimer &StartDefaultTimer() {
+	// Never destroyed, so callbacks scheduled by threads still running at exit don't race with its destruction.
+	static NoDestructor<RateLimitTimer> timer;
+	timer->Start();
+	return *timer;
+}
+
+} // namespace
+
+RateLimitTimer::RateLimitTimer(shared_ptr<BaseClock> clock_p)
+    : clock(clock_p ? std::move(clock_p) : CreateDefaultClock()), next_sequence(0), running(false) {
+}
+
+RateLimitTimer::~RateLimitTimer() {
+	Stop();
+}
+
+void RateLimitTimer::Schedule(TimePoint deadline, Task task) {
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		tasks.push_back(ScheduledTask {deadline, next_sequence++, std::move(task)});
+		std::push_heap(tasks.begin(), tasks.end(), LaterDeadline());
+	}
+	// The new task may be due earlier than the one the background thread is sleeping for.
+	cv.notify_one();
+}
+
+idx_t RateLimitTimer::RunDueTasks() {
+	vector<Task> due;
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		due = PopDueTasks(clock->Now());
+	}
+	for (auto &task : due) {
+		task();
+	}
+	return due.size();
+}
+
+idx_t RateLimitTimer::GetPendingCount() const {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	return tasks.size();
+}
+
+const shared_ptr<BaseClock> &RateLimitTimer::GetClock() const {
+	return clock;
+}
+
+void RateLimitTimer::Start() {
+	if (running) {
+		return;
+	}
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	if (running) {
+		return;
+	}
+	running = true;
+	background_thread = make_uniq<thread>([this]() { RunBackgroundThread(); });
+}
+
+void RateLimitTimer::Stop() {
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		if (!running) {
+			return;
+		}
+		running = false;
+	}
+	cv.notify_all();
+	background_thread->join();
+	background_thread.reset();
+}
+
+RateLimitTimer &RateLimitTimer::GetDefault() {
+	// Every streaming read looks the timer up, so only the first call takes the timer lock to start it.
+	static auto &timer = StartDefaultTimer();
+	return timer;
+}
+
+vector<RateLimitTimer::Task> RateLimitTimer::PopDueTasks(TimePoint now) {
+	vector<Task> due;
+	while (!tasks.empty() && tasks.front().deadline <= now) {
+		std::pop_heap(tasks.begin(), tasks.end(), LaterDeadline());
+		due.push_back(std::move(tasks.back().task));
+		tasks.pop_back();
+	}
+	return due;
+}
+
+void RateLimitTimer::RunBackgroundThread() {
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (running) {
+		auto due = PopDueTasks(clock->Now());
+		if (!due.empty()) {
+			// Run without the lock, since tasks usually schedule themselves again.
+			guard.unlock();
+			for (auto &task : due) {
+				task();
+			}
+			guard.lock();
+			continue;
+		}
+		if (tasks.empty()) {
+			cv.wait(guard);
+		} else {
+			cv.wait_until(guard, tasks.front().deadline);
+		}
+	}
+}
+
+} // namespace duckdb
@@ -24,18 +24,102 @@ function try_acquire_immediately(N):
 
 #include "rate_limiter.hpp"
 
+#include "duckdb/common/limits.hpp"
+
 #include "default_clock.hpp"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace duckdb {
 
+namespace {
+
+constexpr uint64_t NANOS_PER_SECOND = 1000000000;
+
+// Cap of a single emission cost, about 73 years: large enough to never matter, small enough that adding it to a TAT
+// can't overflow.
+constexpr int64_t MAX_EMISSION_NANOS = NumericLimits<int64_t>::Maximum() / 4;
+
+// Source of lease shard indices; threads are spread over shards round-robin in the order they first acquire.
+atomic<idx_t> next_lease_shard_index {0};
+
+idx_t GetThreadLeaseShardIndex() {
+	thread_local idx_t shard_index =
+	    next_lease_shard_index.fetch_add(1, std::memory_order_relaxed) % RateLimiter::LEASE_SHARD_COUNT;
+	return shard_index;
+}
+
+// Calls between two lookups of the calling thread's NUMA node, which only changes when the scheduler migrates it.
+constexpr idx_t NUMA_NODE_REFRESH_CALLS = 1024;
+
+// Returns the NUMA node the calling thread last ran on. Without a way to tell, threads are spread round-robin like
+// lease shards, which still keeps each partition's TAT to a subset of the threads.
+idx_t GetThreadNumaNode() {
+	thread_local idx_t node = GetThreadLeaseShardIndex();
+#if defined(__linux__) && defined(SYS_getcpu)
+	thread_local idx_t calls = 0;
+	if (calls++ % NUMA_NODE_REFRESH_CALLS == 0) {
+		unsigned cpu = 0;
+		unsigned numa_node = 0;
+		if (syscall(SYS_getcpu, &cpu, &numa_node, nullptr) == 0) {
+			node = numa_node;
+		}
+	}
+#endif
+	return node;
+}
+
+// Splits a bandwidth or burst by shares adding up to 1, into parts adding up to it exactly. Every part of a non-zero
+// amount is at least 1, since a part of 0 wouldn't limit at all, so amounts below the partition count overshoot.
+vector<idx_t> SplitByShares(idx_t amount, const vector<double> &shares) {
+	vector<idx_t> parts(shares.size(), 0);
+	if (amount == 0) {
+		return parts;
+	}
+	idx_t assigned = 0;
+	idx_t largest = 0;
+	for (idx_t idx = 0; idx < shares.size(); ++idx) {
+		parts[idx] = MaxValue<idx_t>(static_cast<idx_t>(static_cast<double>(amount) * shares[idx]), 1);
+		assigned += parts[idx];
+		if (shares[idx] > shares[largest]) {
+			largest = idx;
+		}
+	}
+	// Rounding leftovers go to the largest part, and the minimum of 1 of the others is taken from it.
+	if (assigned < amount) {
+		parts[largest] += amount - assigned;
+	} else if (assigned > amount) {
+		parts[largest] -= MinValue<idx_t>(assigned - amount, parts[largest] - 1);
+	}
+	return parts;
+}
+
+} // namespace
+
 //===--------------------------------------------------------------------===//
 // Quota
 //===--------------------------------------------------------------------===//
 
-Quota::Quota(idx_t bandwidth_p, idx_t burst_p) : bandwidth(bandwidth_p), burst(burst_p) {
+Quota::Quota(idx_t bandwidth_p, idx_t burst_p)
+    : bandwidth(bandwidth_p), burst(burst_p), emission_interval_fixed(0),
+      delay_tolerance_nanos(NumericLimits<int64_t>::Maximum()) {
 	if (bandwidth_p == 0 && burst_p == 0) {
 		throw InvalidInputException("at least one of bandwidth or burst must be greater than 0");
 	}
+	if (bandwidth == 0) {
+		// No rate limiting - infinite tolerance
+		return;
+	}
+	// Time per byte = 1 second / bandwidth, rounded up so the rate is never exceeded.
+	constexpr uint64_t SCALED_SECOND = NANOS_PER_SECOND << EMISSION_FRACTION_BITS;
+	emission_interval_fixed = SCALED_SECOND / bandwidth + (SCALED_SECOND % bandwidth != 0 ? 1 : 0);
+	// Delay tolerance = burst * emission_interval
+	// For burst=0 (rate-only), use emission_interval (allows 1 op immediately)
+	const idx_t effective_burst = (burst == 0) ? 1 : burst;
+	delay_tolerance_nanos = GetEmissionNanos(effective_burst);
 }
 
 idx_t Quota::GetBandwidth() const {
@@ -55,70 +139,166 @@ bool Quota::HasBurstLimiting() const {
 }
 
 Duration Quota::GetEmissionInterval() const {
-	if (bandwidth == 0) {
-		return Duration::zero();
-	}
-	// Time per byte = 1 second / bandwidth
-	return std::chrono::duration_cast<Duration>(std::chrono::seconds(1)) / bandwidth;
+	return Duration(static_cast<int64_t>(emission_interval_fixed >> EMISSION_FRACTION_BITS));
 }
 
 Duration Quota::GetDelayTolerance() const {
 	if (bandwidth == 0) {
-		// No rate limiting - infinite tolerance
 		return Duration::max();
 	}
-	// Delay tolerance = burst * emission_interval
-	// For burst=0 (rate-only), use emission_interval (allows 1 op immediately)
-	const auto emission_interval = GetEmissionInterval();
-	const idx_t effective_burst = (burst == 0) ? 1 : burst;
-	return emission_interval * effective_burst;
+	return Duration(delay_tolerance_nanos);
+}
+
+int64_t Quota::GetEmissionNanos(idx_t n) const {
+	return ScaleEmissionNanos(emission_interval_fixed, n);
+}
+
+int64_t Quota::ScaleEmissionNanos(uint64_t emission_interval_fixed, idx_t n) {
+	// (n * emission_interval_fixed) >> EMISSION_FRACTION_BITS from 32-bit halves, since there's no portable 128-bit
+	// multiplication. Cross terms are shifted by exactly the fraction bits, so they contribute in full.
+	const uint64_t n_high = n >> 32;
+	const uint64_t n_low = n & 0xFFFFFFFF;
+	const uint64_t interval_high = emission_interval_fixed >> 32;
+	const uint64_t interval_low = emission_interval_fixed & 0xFFFFFFFF;
+	if (n_high != 0 && interval_high != 0) {
+		return MAX_EMISSION_NANOS;
+	}
+	const uint64_t nanos =
+	    n_high * interval_low + n_low * interval_high + ((n_low * interval_low) >> EMISSION_FRACTION_BITS);
+	// Each term is below 2^64, and if the cross terms are below the cap the sum can't wrap either.
+	constexpr auto CAP = static_cast<uint64_t>(MAX_EMISSION_NANOS);
+	if (n_high * interval_low > CAP || n_low * interval_high > CAP || nanos > CAP) {
+		return MAX_EMISSION_NANOS;
+	}
+	return static_cast<int64_t>(nanos);
+}
+
+int64_t Quota::GetDelayToleranceNanos() const {
+	return delay_tolerance_nanos;
+}
+
+uint64_t Quota::GetEmissionIntervalFixed() const {
+	return emission_interval_fixed;
 }
 
 //===--------------------------------------------------------------------===//
-// RateLimiterState
+// LocalRateLimiterState
 //===--------------------------------------------------------------------===//
 
-RateLimiterState::RateLimiterState() : tat_nanos(0) {
+LocalRateLimiterState::LocalRateLimiterState() : tat_nanos(0) {
 }
 
-int64_t RateLimiterState::GetTatNanos() const {
-	return tat_nanos.load(std::memory_order_seq_cst);
+int64_t LocalRateLimiterState::GetTatNanos() const {
+	return tat_nanos.load(std::memory_order_relaxed);
 }
 
-bool RateLimiterState::CompareExchangeTat(int64_t &expected, int64_t desired) {
-	return tat_nanos.compare_exchange_strong(expected, desired, std::memory_order_seq_cst, std::memory_order_seq_cst);
+bool LocalRateLimiterState::CompareExchangeTat(int64_t &expected, int64_t desired) {
+	return tat_nanos.compare_exchange_weak(expected, desired, std::memory_order_relaxed, std::memory_order_relaxed);
+}
+
+//===--------------------------------------------------------------------===//
+// RateLimiter::LiveQuota
+//===--------------------------------------------------------------------===//
+
+RateLimiter::LiveQuota::LiveQuota(const Quota &quota_p) {
+	Store(quota_p);
+}
+
+void RateLimiter::LiveQuota::Store(const Quota &quota_p) {
+	Store(quota_p, quota_p.GetBurst());
+}
+
+void RateLimiter::LiveQuota::Store(const Quota &quota_p, idx_t burst_p) {
+	burst.store(burst_p, std::memory_order_relaxed);
+	emission_interval_fixed.store(quota_p.GetEmissionIntervalFixed(), std::memory_order_relaxed);
+	delay_tolerance_nanos.store(quota_p.GetDelayToleranceNanos(), std::memory_order_relaxed);
 }
 
 //===--------------------------------------------------------------------===//
 // RateLimiter
 //===--------------------------------------------------------------------===//
 
-RateLimiter::RateLimiter(const Quota &quota_p, shared_ptr<BaseClock> clock_p)
-    : quota(quota_p), clock(clock_p ? clock_p : CreateDefaultClock()), state(make_uniq<RateLimiterState>()) {
+RateLimiter::RateLimiter(const Quota &quota_p, shared_ptr<BaseClock> clock_p, shared_ptr<RateLimiter> parent_p,
+                         idx_t shard_lease_p, shared_ptr<RateLimiterState> state_p, idx_t partition_count_p)
+    : quota(quota_p), clock(clock_p ? clock_p : CreateDefaultClock()), parent(std::move(parent_p)),
+      state(state_p ? std::move(state_p) : make_shared_ptr<LocalRateLimiterState>()),
+      requested_shard_lease(shard_lease_p), shard_lease(0), next_rebalance_nanos(0), configured_quota(quota_p),
+      last_rebalance_nanos(0) {
+	if (partition_count_p > MAX_PARTITIONS) {
+		throw InvalidInputException("A rate limiter can be split into at most %llu partitions, got %llu",
+		                            MAX_PARTITIONS, partition_count_p);
+	}
+	shard_lease.store(GetCappedShardLease(), std::memory_order_relaxed);
+	if (partition_count_p <= 1) {
+		if (requested_shard_lease > 1) {
+			lease_shards = make_uniq<array<LeaseShard, LEASE_SHARD_COUNT>>();
+		}
+		return;
+	}
+
+	concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+	partitions = vector<Partition>(partition_count_p);
+	partition_shares.assign(partition_count_p, 1.0 / static_cast<double>(partition_count_p));
+	const auto bandwidths = SplitByShares(quota_p.GetBandwidth(), partition_shares);
+	const auto bursts = SplitByShares(quota_p.GetBurst(), partition_shares);
+	// A partition's share of the debt takes as long to pay off at its share of the rate, so every partition starts
+	// from the same TAT.
+	const auto tat_nanos = state->GetTatNanos();
+	for (idx_t idx = 0; idx < partition_count_p; ++idx) {
+		auto partition_state = make_shared_ptr<LocalRateLimiterState>();
+		auto expected_tat = partition_state->GetTatNanos();
+		while (!partition_state->CompareExchangeTat(expected_tat, tat_nanos)) {
+		}
+		const Quota partition_quota(bandwidths[idx], bursts[idx]);
+		partitions[idx].limiter = make_shared_ptr<RateLimiter>(partition_quota, clock, parent, shard_lease_p,
+		                                                       std::move(partition_state));
+		partitions[idx].limiter->SetQuota(partition_quota, quota_p.GetBurst());
+	}
+	last_rebalance_nanos = ToNanos(clock->Now());
+	next_rebalance_nanos.store(last_rebalance_nanos + PARTITION_REBALANCE_NANOS, std::memory_order_relaxed);
 }
 
-shared_ptr<RateLimiter> RateLimiter::Direct(const Quota &quota_p, shared_ptr<BaseClock> clock_p) {
-	return make_shared_ptr<RateLimiter>(quota_p, clock_p);
+shared_ptr<RateLimiter> RateLimiter::Direct(const Quota &quota_p, shared_ptr<BaseClock> clock_p,
+                                            shared_ptr<RateLimiter> parent_p, idx_t shard_lease_p,
+                                            shared_ptr<RateLimiterState> state_p, idx_t partition_count_p) {
+	return make_shared_ptr<RateLimiter>(quota_p, clock_p, std::move(parent_p), shard_lease_p, std::move(state_p),
+	                                    partition_count_p);
 }
 
-RateLimitResult RateLimiter::UntilNReady(idx_t n) {
+RateLimiter::~RateLimiter() {
+	// Other processes may share the state, and other limiters the parents.
+	ReturnLeases(NumericLimits<int64_t>::Maximum());
+	if (!partitions.empty()) {
+		concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+		StorePartitionDebt(ToNanos(clock->Now()));
+	}
+}
+
+RateLimitResult RateLimiter::UntilNReady(idx_t n, RateLimitPriority priority) {
+	if (auto partition = GetLocalPartition(n)) {
+		return partition->UntilNReady(n, priority);
+	}
 	if (n == 0) {
 		return RateLimitResult::Allowed;
 	}
 
 	// Check burst limit only if burst limiting is enabled
-	if (quota.HasBurstLimiting() && n > quota.GetBurst()) {
+	if (ExceedsBurst(n)) {
 		return RateLimitResult::InsufficientCapacity;
 	}
 
 	// If no rate limiting, always allowed immediately
-	if (!quota.HasRateLimiting()) {
+	if (!ChainHasRateLimiting()) {
+		return RateLimitResult::Allowed;
+	}
+
+	if (TryTakeLeased(n)) {
 		return RateLimitResult::Allowed;
 	}
 
 	while (true) {
 		auto now = clock->Now();
-		auto decision = TryAcquire(now, n);
+		auto decision = TryAcquireLeasing(now, n, priority);
 
 		if (decision.allowed) {
 			return RateLimitResult::Allowed;
@@ -131,24 +311,100 @@ RateLimitResult RateLimiter::UntilNReady(idx_t n) {
 	}
 }
 
-std::optional<WaitInfo> RateLimiter::TryAcquireImmediate(idx_t n) {
+std::optional<WaitInfo> RateLimiter::UntilNReadyBy(idx_t n, TimePoint deadline, RateLimitPriority priority) {
+	if (auto partition = GetLocalPartition(n)) {
+		return partition->UntilNReadyBy(n, deadline, priority);
+	}
+	if (n == 0) {
+		return std::nullopt;
+	}
+
+	if (ExceedsBurst(n)) {
+		return WaitInfo {TimePoint::max(), Duration::max()};
+	}
+
+	if (!ChainHasRateLimiting()) {
+		return std::nullopt;
+	}
+
+	if (TryTakeLeased(n)) {
+		return std::nullopt;
+	}
+
+	while (true) {
+		auto now = clock->Now();
+		auto decision = TryAcquireLeasing(now, n, priority);
+
+		if (decision.allowed) {
+			return std::nullopt;
+		}
+
+		// Checked before every wait, since other acquirers may take the capacity replenished during the last one.
+		if (decision.wait_info) {
+			if (decision.wait_info->ready_at > deadline) {
+				return decision.wait_info;
+			}
+			clock->SleepUntil(decision.wait_info->ready_at);
+		}
+	}
+}
+
+RateLimitResult RateLimiter::UntilNReadyFair(idx_t n, RateLimitPriority priority) {
+	if (auto partition = GetLocalPartition(n)) {
+		return partition->UntilNReadyFair(n, priority);
+	}
+	if (n == 0) {
+		return RateLimitResult::Allowed;
+	}
+
+	if (ExceedsBurst(n)) {
+		return RateLimitResult::InsufficientCapacity;
+	}
+
+	if (!ChainHasRateLimiting()) {
+		return RateLimitResult::Allowed;
+	}
+
+	// Book every level first, then wait once for the latest start, so the request never holds a slot on one level
+	// while queueing on another.
+	const auto now = clock->Now();
+	int64_t start_nanos = ToNanos(now);
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasRateLimiting()) {
+			start_nanos = MaxValue<int64_t>(start_nanos, level->Reserve(now, n, priority));
+		}
+	}
+	if (start_nanos > ToNanos(now)) {
+		clock->SleepUntil(FromNanos(start_nanos));
+	}
+	return RateLimitResult::Allowed;
+}
+
+std::optional<WaitInfo> RateLimiter::TryAcquireImmediate(idx_t n, RateLimitPriority priority) {
+	if (auto partition = GetLocalPartition(n)) {
+		return partition->TryAcquireImmediate(n, priority);
+	}
 	if (n == 0) {
 		return std::nullopt;
 	}
 
 	// Check burst limit only if burst limiting is enabled
-	if (quota.HasBurstLimiting() && n > quota.GetBurst()) {
+	if (ExceedsBurst(n)) {
 		// Return max wait to indicate insufficient capacity
 		return WaitInfo {TimePoint::max(), Duration::max()};
 	}
 
 	// If no rate limiting, always allowed immediately
-	if (!quota.HasRateLimiting()) {
+	if (!ChainHasRateLimiting()) {
+		return std::nullopt;
+	}
+
+	if (TryTakeLeased(n)) {
 		return std::nullopt;
 	}
 
 	auto now = clock->Now();
-	auto decision = TryAcquire(now, n);
+	auto decision = TryAcquireLeasing(now, n, priority);
 
 	if (decision.allowed) {
 		return std::nullopt;
@@ -156,14 +412,221 @@ std::optional<WaitInfo> RateLimiter::TryAcquireImmediate(idx_t n) {
 	return decision.wait_info;
 }
 
-const Quota &RateLimiter::GetQuota() const {
-	return quota;
+void RateLimiter::AcquireAsync(idx_t n, AcquireCallback callback, optional_ptr<RateLimitTimer> timer) {
+	// Retries stay with the partition of the thread which started the acquisition.
+	if (auto partition = GetLocalPartition(n)) {
+		partition->AcquireAsync(n, std::move(callback), timer);
+		return;
+	}
+	auto wait_info = TryAcquireImmediate(n);
+	if (!wait_info.has_value()) {
+		callback(RateLimitResult::Allowed);
+		return;
+	}
+	if (wait_info->wait_duration == Duration::max()) {
+		callback(RateLimitResult::InsufficientCapacity);
+		return;
+	}
+
+	// Retry at the earliest time the request could be admitted. Another caller may take the capacity first, in which
+	// case the retry schedules itself again.
+	auto &target_timer = timer ? *timer : RateLimitTimer::GetDefault();
+	auto self = shared_from_this();
+	const auto ready_at = wait_info->ready_at;
+	target_timer.Schedule(ready_at, [self, n, callback, &target_timer, ready_at]() {
+		// The timer's clock may be ahead of a coarse limiter clock, which must not see a time before the deadline.
+		self->clock->Observe(ready_at);
+		self->AcquireAsync(n, callback, &target_timer);
+	});
+}
+
+std::future<RateLimitResult> RateLimiter::AcquireFuture(idx_t n, optional_ptr<RateLimitTimer> timer) {
+	auto promise = make_shared_ptr<std::promise<RateLimitResult>>();
+	auto future = promise->get_future();
+	AcquireAsync(
+	    n, [promise](RateLimitResult result) { promise->set_value(result); }, timer);
+	return future;
+}
+
+void RateLimiter::Refund(idx_t n) {
+	if (auto partition = GetLocalPartition(0)) {
+		partition->Refund(n);
+		return;
+	}
+	if (n == 0) {
+		return;
+	}
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasRateLimiting()) {
+			level->RefundLevel(n);
+		}
+	}
+}
+
+void RateLimiter::Charge(idx_t n) {
+	if (auto partition = GetLocalPartition(n)) {
+		partition->Charge(n);
+		return;
+	}
+	if (n == 0) {
+		return;
+	}
+	const auto now = clock->Now();
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasRateLimiting()) {
+			level->Reserve(now, n, RateLimitPriority::INTERACTIVE);
+		}
+	}
+}
+
+void RateLimiter::SetQuota(const Quota &quota_p) {
+	SetQuota(quota_p, quota_p.GetBurst());
+}
+
+void RateLimiter::SetQuota(const Quota &quota_p, idx_t burst_p) {
+	concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+	const auto old_interval = static_cast<double>(configured_quota.GetEmissionIntervalFixed());
+	const auto new_interval = static_cast<double>(quota_p.GetEmissionIntervalFixed());
+	configured_quota = quota_p;
+	quota.Store(quota_p, burst_p);
+	shard_lease.store(GetCappedShardLease(), std::memory_order_relaxed);
+	if (!partitions.empty()) {
+		// Partitions rescale their own debt.
+		ApplyPartitionShares();
+		return;
+	}
+
+	// Without a rate before or after, the TAT carries no debt worth keeping.
+	if (old_interval == 0 || new_interval == 0 || old_interval == new_interval) {
+		return;
+	}
+	// The debt is the time the owed bytes take at the old rate; they take new / old times as long at the new rate.
+	const int64_t now_nanos = ToNanos(clock->Now());
+	int64_t current_tat = state->GetTatNanos();
+	while (current_tat > now_nanos) {
+		const auto debt_nanos = static_cast<double>(current_tat - now_nanos) * new_interval / old_interval;
+		const auto new_tat = now_nanos + static_cast<int64_t>(MinValue<double>(debt_nanos, MAX_EMISSION_NANOS));
+		if (state->CompareExchangeTat(current_tat, new_tat)) {
+			break;
+		}
+	}
+}
+
+Quota RateLimiter::GetQuota() const {
+	concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+	return configured_quota;
 }
 
 const shared_ptr<BaseClock> &RateLimiter::GetClock() const {
 	return clock;
 }
 
+const shared_ptr<RateLimiter> &RateLimiter::GetParent() const {
+	return parent;
+}
+
+idx_t RateLimiter::GetEffectiveBurst() const {
+	idx_t burst = 0;
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasBurstLimiting() && (burst == 0 || level->quota.GetBurst() < burst)) {
+			burst = level->quota.GetBurst();
+		}
+	}
+	return burst;
+}
+
+idx_t RateLimiter::GetShardLease() const {
+	return shard_lease.load(std::memory_order_relaxed);
+}
+
+const shared_ptr<RateLimiterState> &RateLimiter::GetState() const {
+	return state;
+}
+
+idx_t RateLimiter::GetCappedShardLease() const {
+	// A lease larger than the burst could never be admitted.
+	auto lease = requested_shard_lease;
+	const auto effective_burst = GetEffectiveBurst();
+	if (effective_burst != 0 && lease > effective_burst) {
+		lease = effective_burst;
+	}
+	// Leasing a single byte at a time saves nothing.
+	return lease > 1 ? lease : 0;
+}
+
+idx_t RateLimiter::GetLeasedBytes() const {
+	if (!partitions.empty()) {
+		idx_t leased = 0;
+		for (const auto &partition : partitions) {
+			leased += partition.limiter->GetLeasedBytes();
+		}
+		return leased;
+	}
+	if (!lease_shards) {
+		return 0;
+	}
+	int64_t leased = 0;
+	for (const auto &shard : *lease_shards) {
+		leased += shard.tokens.load(std::memory_order_relaxed);
+	}
+	return static_cast<idx_t>(leased);
+}
+
+idx_t RateLimiter::ReturnExpiredLeases() {
+	if (!partitions.empty()) {
+		idx_t returned = 0;
+		for (auto &partition : partitions) {
+			returned += partition.limiter->ReturnExpiredLeases();
+		}
+		return returned;
+	}
+	if (!lease_shards) {
+		return 0;
+	}
+	return ReturnLeases(ToNanos(clock->Now()) - LEASE_EXPIRY_NANOS);
+}
+
+idx_t RateLimiter::GetPartitionCount() const {
+	return partitions.size();
+}
+
+idx_t RateLimiter::GetLocalPartitionIndex() const {
+	return partitions.empty() ? 0 : GetThreadNumaNode() % partitions.size();
+}
+
+Quota RateLimiter::GetPartitionQuota(idx_t index) const {
+	D_ASSERT(index < partitions.size());
+	return partitions[index].limiter->GetQuota();
+}
+
+void RateLimiter::RebalancePartitions() {
+	if (partitions.empty()) {
+		return;
+	}
+	const auto now_nanos = ToNanos(clock->Now());
+	concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+	next_rebalance_nanos.store(now_nanos + PARTITION_REBALANCE_NANOS, std::memory_order_relaxed);
+	RebalancePartitions(now_nanos);
+}
+
+bool RateLimiter::ExceedsBurst(idx_t n) const {
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasBurstLimiting() && n > level->quota.GetBurst()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RateLimiter::ChainHasRateLimiting() const {
+	for (auto level = this; level; level = level->parent.get()) {
+		if (level->quota.HasRateLimiting()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 int64_t RateLimiter::ToNanos(TimePoint tp) {
 	return std::chrono::duration_cast<Duration>(tp.time_since_epoch()).count();
 }
@@ -172,14 +635,19 @@ TimePoint RateLimiter::FromNanos(int64_t nanos) {
 	return TimePoint(Duration(nanos));
 }
 
-RateLimiter::AcquireDecision RateLimiter::TryAcquire(TimePoint now, idx_t n) {
-	auto emission_interval = quota.GetEmissionInterval();
-	auto delay_tolerance = quota.GetDelayTolerance();
+int64_t RateLimiter::GetToleranceNanos(RateLimitPriority priority) const {
+	const int64_t tolerance_nanos = quota.GetDelayToleranceNanos();
+	if (priority == RateLimitPriority::BATCH) {
+		return tolerance_nanos / BATCH_TOLERANCE_DIVISOR;
+	}
+	return tolerance_nanos;
+}
 
+RateLimiter::AcquireDecision RateLimiter::TryAcquire(TimePoint now, idx_t n, RateLimitPriority priority) {
 	const int64_t now_nanos = ToNanos(now);
 
-	const int64_t increment_nanos = std::chrono::duration_cast<Duration>(emission_interval * n).count();
-	const int64_t tolerance_nanos = std::chrono::duration_cast<Duration>(delay_tolerance).count();
+	const int64_t increment_nanos = quota.GetEmissionNanos(n);
+	const int64_t tolerance_nanos = GetToleranceNanos(priority);
 
 	int64_t current_tat = state->GetTatNanos();
 	while (true) {
@@ -199,13 +667,215 @@ RateLimiter::AcquireDecision RateLimiter::TryAcquire(TimePoint now, idx_t n) {
 	}
 }
 
+RateLimiter::AcquireDecision RateLimiter::TryAcquireChain(TimePoint now, idx_t n, RateLimitPriority priority) {
+	for (auto level = this; level; level = level->parent.get()) {
+		if (!level->quota.HasRateLimiting()) {
+			continue;
+		}
+		auto decision = level->TryAcquire(now, n, priority);
+		if (decision.allowed) {
+			continue;
+		}
+		// Give back what the levels below already reserved, so the request is admitted by all levels or none.
+		for (auto reserved = this; reserved != level; reserved = reserved->parent.get()) {
+			if (reserved->quota.HasRateLimiting()) {
+				reserved->RefundLevel(n);
+			}
+		}
+		return decision;
+	}
+	return AcquireDecision {true, std::nullopt};
+}
+
+bool RateLimiter::TryTakeLeased(idx_t n) {
+	if (!lease_shards || n > shard_lease.load(std::memory_order_relaxed)) {
+		return false;
+	}
+	auto &tokens = (*lease_shards)[GetThreadLeaseShardIndex()].tokens;
+	const auto needed = static_cast<int64_t>(n);
+	auto current = tokens.load(std::memory_order_relaxed);
+	while (current >= needed) {
+		if (tokens.compare_exchange_weak(current, current - needed, std::memory_order_relaxed,
+		                                 std::memory_order_relaxed)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+RateLimiter::AcquireDecision RateLimiter::TryAcquireLeasing(TimePoint now, idx_t n, RateLimitPriority priority) {
+	const auto lease = shard_lease.load(std::memory_order_relaxed);
+	if (n < lease) {
+		auto decision = TryAcquireChain(now, lease, priority);
+		if (decision.allowed) {
+			const auto now_nanos = ToNanos(now);
+			auto &shard = (*lease_shards)[GetThreadLeaseShardIndex()];
+			shard.leased_at_nanos.store(now_nanos, std::memory_order_relaxed);
+			shard.tokens.fetch_add(static_cast<int64_t>(lease - n), std::memory_order_relaxed);
+			// Leasing is rare enough to sweep the other shards for leases of threads which went idle.
+			ReturnLeases(now_nanos - LEASE_EXPIRY_NANOS);
+			return decision;
+		}
+	}
+	return TryAcquireChain(now, n, priority);
+}
+
+idx_t RateLimiter::ReturnLeases(int64_t leased_before_nanos) {
+	if (!lease_shards) {
+		return 0;
+	}
+	int64_t returned = 0;
+	for (auto &shard : *lease_shards) {
+		if (shard.tokens.load(std::memory_order_relaxed) <= 0 ||
+		    shard.leased_at_nanos.load(std::memory_order_relaxed) >= leased_before_nanos) {
+			continue;
+		}
+		// Racing with a lease of the shard's thread at worst gives back bytes leased just now, which is harmless.
+		returned += shard.tokens.exchange(0, std::memory_order_relaxed);
+	}
+	Refund(static_cast<idx_t>(returned));
+	return static_cast<idx_t>(returned);
+}
+
+RateLimiter *RateLimiter::GetLocalPartition(idx_t n) {
+	if (partitions.empty()) {
+		return nullptr;
+	}
+	auto &partition = partitions[GetThreadNumaNode() % partitions.size()];
+	if (n != 0) {
+		partition.demand.fetch_add(n, std::memory_order_relaxed);
+	}
+	// Read by every acquisition but written once per interval, so the cache line stays shared.
+	const auto now_nanos = ToNanos(clock->Now());
+	auto due_nanos = next_rebalance_nanos.load(std::memory_order_relaxed);
+	if (now_nanos >= due_nanos && next_rebalance_nanos.compare_exchange_strong(
+	                                  due_nanos, now_nanos + PARTITION_REBALANCE_NANOS, std::memory_order_relaxed)) {
+		concurrency::lock_guard<concurrency::mutex> guard(quota_lock);
+		RebalancePartitions(now_nanos);
+	}
+	return partition.limiter.get();
+}
+
+void RateLimiter::RebalancePartitions(int64_t now_nanos) {
+	const auto elapsed_nanos = now_nanos - last_rebalance_nanos;
+	const auto bandwidth = configured_quota.GetBandwidth();
+	if (elapsed_nanos <= 0) {
+		return;
+	}
+	last_rebalance_nanos = now_nanos;
+	const auto count = partitions.size();
+	vector<idx_t> demands(count, 0);
+	for (idx_t idx = 0; idx < count; ++idx) {
+		demands[idx] = partitions[idx].demand.exchange(0, std::memory_order_relaxed);
+	}
+	// Without a rate there's nothing to split.
+	if (bandwidth == 0) {
+		return;
+	}
+
+	// Bytes the configured bandwidth admits over the elapsed time.
+	const auto capacity = static_cast<double>(bandwidth) * static_cast<double>(elapsed_nanos) / NANOS_PER_SECOND;
+	const auto min_share = 1.0 / static_cast<double>(count * MIN_SHARE_DIVISOR);
+	vector<double> shares(count, 0);
+	vector<bool> saturated(count, false);
+	double unsaturated_total = 0;
+	idx_t saturated_count = 0;
+	for (idx_t idx = 0; idx < count; ++idx) {
+		const auto used = static_cast<double>(demands[idx]) / capacity;
+		if (used >= SATURATED_SHARE_RATIO * partition_shares[idx]) {
+			saturated[idx] = true;
+			++saturated_count;
+			continue;
+		}
+		// Twice its use leaves room to grow until the next split, which then counts it as saturated.
+		shares[idx] = MaxValue(min_share, MinValue(partition_shares[idx], 2 * used));
+		unsaturated_total += shares[idx];
+	}
+	if (saturated_count > 0) {
+		const auto unused_share = (1 - unsaturated_total) / static_cast<double>(saturated_count);
+		const auto saturated_share = MaxValue(min_share, unused_share);
+		for (idx_t idx = 0; idx < count; ++idx) {
+			if (saturated[idx]) {
+				shares[idx] = saturated_share;
+			}
+		}
+	}
+	// Without saturated partitions, the unused bandwidth is spread in proportion to the shares.
+	double total = 0;
+	for (const auto share : shares) {
+		total += share;
+	}
+	for (auto &share : shares) {
+		share /= total;
+	}
+	partition_shares = std::move(shares);
+	ApplyPartitionShares();
+	StorePartitionDebt(now_nanos);
+}
+
+void RateLimiter::ApplyPartitionShares() {
+	const auto bandwidths = SplitByShares(configured_quota.GetBandwidth(), partition_shares);
+	const auto bursts = SplitByShares(configured_quota.GetBurst(), partition_shares);
+	for (idx_t idx = 0; idx < partitions.size(); ++idx) {
+		partitions[idx].limiter->SetQuota(Quota(bandwidths[idx], bursts[idx]), configured_quota.GetBurst());
+	}
+}
+
+void RateLimiter::StorePartitionDebt(int64_t now_nanos) {
+	// Every partition owes its debt at its share of the rate, so at the full rate the debts add up weighted by share.
+	double debt_nanos = 0;
+	for (idx_t idx = 0; idx < partitions.size(); ++idx) {
+		const auto partition_debt = partitions[idx].limiter->state->GetTatNanos() - now_nanos;
+		if (partition_debt > 0) {
+			debt_nanos += partition_shares[idx] * static_cast<double>(partition_debt);
+		}
+	}
+	const auto new_tat = now_nanos + static_cast<int64_t>(MinValue<double>(debt_nanos, MAX_EMISSION_NANOS));
+	auto current_tat = state->GetTatNanos();
+	while (!state->CompareExchangeTat(current_tat, new_tat)) {
+	}
+}
+
+int64_t RateLimiter::Reserve(TimePoint now, idx_t n, RateLimitPriority priority) {
+	const int64_t now_nanos = ToNanos(now);
+	const int64_t increment_nanos = quota.GetEmissionNanos(n);
+	const int64_t tolerance_nanos = GetToleranceNanos(priority);
+
+	int64_t current_tat = state->GetTatNanos();
+	while (true) {
+		// Same new TAT as an admission at the start time would produce, since the start is never after the TAT.
+		int64_t new_tat = std::max(current_tat, now_nanos) + increment_nanos;
+		if (state->CompareExchangeTat(current_tat, new_tat)) {
+			return std::max(now_nanos, current_tat - tolerance_nanos);
+		}
+	}
+}
+
+void RateLimiter::RefundLevel(idx_t n) {
+	// A reservation moved the TAT from max(tat, now) forward by n emission intervals. Moving it back by the same
+	// amount is exact even under concurrent reservations. A refund after the call may come once part of that time has
+	// passed; the TAT then stops at now, which already means a full bucket, instead of drifting into the past.
+	const int64_t now_nanos = ToNanos(clock->Now());
+	const int64_t refund_nanos = quota.GetEmissionNanos(n);
+	int64_t current_tat = state->GetTatNanos();
+	while (current_tat > now_nanos) {
+		const auto new_tat = MaxValue(current_tat - refund_nanos, now_nanos);
+		if (state->CompareExchangeTat(current_tat, new_tat)) {
+			return;
+		}
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Helper function
 //===--------------------------------------------------------------------===//
 
-SharedRateLimiter CreateRateLimiter(idx_t bandwidth_p, idx_t burst_p, shared_ptr<BaseClock> clock_p) {
+SharedRateLimiter CreateRateLimiter(idx_t bandwidth_p, idx_t burst_p, shared_ptr<BaseClock> clock_p,
+                                    SharedRateLimiter parent_p, idx_t shard_lease_p,
+                                    shared_ptr<RateLimiterState> state_p, idx_t partition_count_p) {
 	Quota quota(bandwidth_p, burst_p);
-	return RateLimiter::Direct(quota, clock_p);
+	return RateLimiter::Direct(quota, clock_p, std::move(parent_p), shard_lease_p, std::move(state_p),
+	                           partition_count_p);
 }
 
 } // namespace duckdb
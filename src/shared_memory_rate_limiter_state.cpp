@@ -0,0 +1,122 @@
+#include "shared_memory_rate_limiter_state.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+
+namespace {
+
+static_assert(atomic<int64_t>::is_always_lock_free, "shared state requires an address-free atomic");
+static_assert(sizeof(SharedMemoryRateLimiterState::Layout) <= SharedMemoryRateLimiterState::FILE_SIZE,
+              "state must fit the file");
+
+// Returns the system clock seconds at which the monotonic clock read zero, which changes with every boot.
+int64_t GetBootTime() {
+	const auto system_now = std::chrono::system_clock::now().time_since_epoch();
+	const auto monotonic_now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::seconds>(system_now - monotonic_now).count();
+}
+
+// FNV-1a, which unlike std::hash is the same in every process and build.
+uint64_t HashKey(const string &key) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (const auto c : key) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+} // namespace
+
+SharedMemoryRateLimiterState::SharedMemoryRateLimiterState(const string &directory, const string &key)
+    : path(StringUtil::Format("%s/%s", directory, GetFileName(key))), mapping(nullptr), tat_nanos(nullptr) {
+#ifdef _WIN32
+	throw NotImplementedException("Shared rate limiter state is not supported on Windows");
+#else
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		throw IOException("Failed to open shared rate limiter state \"%s\": %s", path, strerror(errno));
+	}
+	// Extending a new file zero-fills it; other processes may race to do the same, which is harmless.
+	if (::ftruncate(fd, static_cast<off_t>(FILE_SIZE)) != 0) {
+		const auto error = errno;
+		::close(fd);
+		throw IOException("Failed to size shared rate limiter state \"%s\": %s", path, strerror(error));
+	}
+	mapping = ::mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	const auto error = errno;
+	// The mapping stays valid without the descriptor.
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		throw IOException("Failed to map shared rate limiter state \"%s\": %s", path, strerror(error));
+	}
+	auto &layout = *static_cast<Layout *>(mapping);
+	tat_nanos = &layout.tat_nanos;
+
+	// Only the mapping which records the new boot time resets the TAT, so one that already shares the state on this
+	// boot never loses its reservations to a later one.
+	const auto boot_time = GetBootTime();
+	auto recorded_boot_time = layout.boot_time.load(std::memory_order_relaxed);
+	while (std::abs(recorded_boot_time - boot_time) > BOOT_TIME_TOLERANCE) {
+		if (layout.boot_time.compare_exchange_weak(recorded_boot_time, boot_time, std::memory_order_relaxed)) {
+			tat_nanos->store(0, std::memory_order_relaxed);
+			break;
+		}
+	}
+#endif
+}
+
+SharedMemoryRateLimiterState::~SharedMemoryRateLimiterState() {
+#ifndef _WIN32
+	if (mapping) {
+		::munmap(mapping, FILE_SIZE);
+	}
+#endif
+}
+
+int64_t SharedMemoryRateLimiterState::GetTatNanos() const {
+	return tat_nanos->load(std::memory_order_relaxed);
+}
+
+bool SharedMemoryRateLimiterState::CompareExchangeTat(int64_t &expected, int64_t desired) {
+	return tat_nanos->compare_exchange_weak(expected, desired, std::memory_order_relaxed, std::memory_order_relaxed);
+}
+
+const string &SharedMemoryRateLimiterState::GetPath() const {
+	return path;
+}
+
+string SharedMemoryRateLimiterState::GetFileName(const string &key) {
+	string file_name;
+	file_name.reserve(key.size() + 24);
+	for (const auto c : key) {
+		const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+		                  c == '_';
+		file_name.push_back(keep ? c : '_');
+	}
+	return StringUtil::Format("%s-%016llx.tat", file_name, static_cast<unsigned long long>(HashKey(key)));
+}
+
+shared_ptr<RateLimiterState> CreateSharedMemoryRateLimiterState(const string &directory, const string &key) {
+	if (directory.empty()) {
+		return nullptr;
+	}
+	return make_shared_ptr<SharedMemoryRateLimiterState>(directory, key);
+}
+
+} // namespace duckdb
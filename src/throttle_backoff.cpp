@@ -0,0 +1,127 @@
+#include "throttle_backoff.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/exception.hpp"
+
+#include "adaptive_concurrency_limiter.hpp"
+#include "default_clock.hpp"
+
+namespace duckdb {
+
+ThrottleBackoff::ThrottleBackoff(double min_ratio_p, Duration recovery_interval_p, idx_t max_retries_p,
+                                 shared_ptr<BaseClock> clock_p)
+    : min_ratio(min_ratio_p), recovery_interval(recovery_interval_p), max_retries(max_retries_p),
+      clock(clock_p ? std::move(clock_p) : CreateDefaultClock()), limiter(nullptr), quota(0), burst(0), ratio(1),
+      last_change(), last_decrease(), decreased(false), backed_off(false), throttle_errors(0), retries(0) {
+	if (!(min_ratio > 0 && min_ratio <= 1)) {
+		throw InvalidInputException("Throttle backoff minimum ratio must be in (0, 1], got %f", min_ratio);
+	}
+	if (recovery_interval <= Duration::zero()) {
+		throw InvalidInputException("Throttle backoff recovery interval must be positive");
+	}
+}
+
+void ThrottleBackoff::Attach(SharedRateLimiter limiter_p, idx_t quota_p, idx_t burst_p) {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	limiter = std::move(limiter_p);
+	quota = quota_p;
+	burst = burst_p;
+	Apply();
+}
+
+void ThrottleBackoff::OnSuccess() {
+	if (!backed_off.load(std::memory_order_relaxed)) {
+		return;
+	}
+	const auto now = clock->Now();
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	Recover(now);
+}
+
+bool ThrottleBackoff::OnFailure(const string &error_message) {
+	if (!AdaptiveConcurrencyLimiter::IsThrottleError(error_message)) {
+		// Other errors, e.g. a missing file, say nothing about backend load.
+		OnSuccess();
+		return false;
+	}
+	++throttle_errors;
+	const auto now = clock->Now();
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	// Recovery only starts once a whole interval passed without throttling errors.
+	last_change = now;
+	const auto cooldown = recovery_interval / DECREASE_COOLDOWN_DIVISOR;
+	if (decreased && now - last_decrease < cooldown) {
+		return true;
+	}
+	ratio = MaxValue(ratio * BACKOFF_RATIO, min_ratio);
+	last_decrease = now;
+	decreased = true;
+	backed_off = ratio < 1;
+	Apply();
+	return true;
+}
+
+bool ThrottleBackoff::WaitToRetry(idx_t attempt) {
+	if (attempt >= max_retries) {
+		return false;
+	}
+	// Doubled per attempt, stopping before the shift overflows.
+	auto max_delay = recovery_interval;
+	if (attempt < 32) {
+		max_delay = MinValue(RETRY_BASE_DELAY * (int64_t(1) << attempt), recovery_interval);
+	}
+	Duration delay;
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		const auto jitter = random_engine.NextRandom() * static_cast<double>(max_delay.count());
+		delay = Duration(static_cast<Duration::rep>(jitter));
+	}
+	++retries;
+	clock->SleepFor(delay);
+	return true;
+}
+
+ThrottleBackoffStats ThrottleBackoff::GetStats() const {
+	ThrottleBackoffStats stats;
+	stats.min_ratio = min_ratio;
+	stats.recovery_interval = recovery_interval;
+	stats.max_retries = max_retries;
+	stats.throttle_errors = throttle_errors.load();
+	stats.retries = retries.load();
+
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	stats.ratio = ratio;
+	return stats;
+}
+
+void ThrottleBackoff::Recover(TimePoint now) {
+	if (ratio >= 1 || now - last_change < recovery_interval) {
+		return;
+	}
+	const auto intervals = (now - last_change) / recovery_interval;
+	ratio = MinValue(ratio + RECOVERY_STEP * static_cast<double>(intervals), 1.0);
+	last_change += recovery_interval * intervals;
+	backed_off = ratio < 1;
+	Apply();
+}
+
+void ThrottleBackoff::Apply() {
+	if (!limiter) {
+		return;
+	}
+	// Without a quota there is no rate to scale, but the burst still has to be kept up to date.
+	const auto scaled = static_cast<idx_t>(static_cast<double>(quota) * ratio);
+	limiter->SetQuota(Quota(quota == 0 ? 0 : MaxValue<idx_t>(scaled, 1), burst));
+}
+
+ThrottleBackoff::SuccessReporter::SuccessReporter(ThrottleBackoff &backoff_p)
+    : backoff(backoff_p), uncaught_exceptions(std::uncaught_exceptions()) {
+}
+
+ThrottleBackoff::SuccessReporter::~SuccessReporter() {
+	if (std::uncaught_exceptions() == uncaught_exceptions) {
+		backoff.OnSuccess();
+	}
+}
+
+} // namespace duckdb
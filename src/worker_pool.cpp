@@ -0,0 +1,146 @@
+#include "worker_pool.hpp"
+
+#include <system_error>
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+WorkerPool::WorkerPool(idx_t thread_count_p) : thread_count(thread_count_p), busy_count(0), stopping(false) {
+	// Reserved up front, so starting a worker can only fail in the thread constructor.
+	workers.reserve(thread_count);
+}
+
+WorkerPool::~WorkerPool() {
+	vector<thread> stopped;
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		stopping = true;
+		stopped = std::move(workers);
+	}
+	work_cv.notify_all();
+	for (auto &worker : stopped) {
+		worker.join();
+	}
+}
+
+void WorkerPool::RunConcurrently(idx_t count, const Task &task) {
+	Batch batch {&task};
+	if (count > 1 && thread_count > 0) {
+		{
+			concurrency::lock_guard<concurrency::mutex> guard(lock);
+			for (idx_t idx = 1; idx < count; ++idx) {
+				pending.push_back(PendingTask {&batch, nullptr});
+			}
+			StartWorkers();
+		}
+		work_cv.notify_all();
+	}
+
+	std::exception_ptr error;
+	try {
+		task();
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	{
+		concurrency::unique_lock<concurrency::mutex> guard(lock);
+		// Copies still queued would only find nothing left to do, and must not outlive the batch.
+		pending.erase(std::remove_if(pending.begin(), pending.end(),
+		                             [&](const PendingTask &pending_task) { return pending_task.batch == &batch; }),
+		              pending.end());
+		while (batch.running > 0) {
+			done_cv.wait(guard);
+		}
+		if (!error) {
+			error = batch.error;
+		}
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+bool WorkerPool::Submit(Task task) {
+	{
+		concurrency::lock_guard<concurrency::mutex> guard(lock);
+		pending.push_back(PendingTask {nullptr, std::move(task)});
+		StartWorkers();
+		if (workers.empty()) {
+			// No worker could take it, so it's still the last entry.
+			pending.pop_back();
+			return false;
+		}
+	}
+	work_cv.notify_all();
+	return true;
+}
+
+idx_t WorkerPool::GetStartedCount() const {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	return workers.size();
+}
+
+void WorkerPool::StartWorkers() {
+	const auto wanted = MinValue<idx_t>(thread_count, busy_count + pending.size());
+	while (workers.size() < wanted) {
+		try {
+			workers.emplace_back([this]() { RunWorker(); });
+		} catch (const std::system_error &) {
+			// Callers run their tasks themselves, so fewer workers only means less concurrency.
+			return;
+		}
+	}
+}
+
+void WorkerPool::RunWorker() {
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (true) {
+		while (!stopping && pending.empty()) {
+			work_cv.wait(guard);
+		}
+		if (stopping) {
+			return;
+		}
+		auto pending_task = std::move(pending.front());
+		pending.pop_front();
+		++busy_count;
+		if (!pending_task.batch) {
+			guard.unlock();
+			try {
+				pending_task.task();
+			} catch (...) {
+				// Nobody is left to see it, and it mustn't take the worker down.
+			}
+			// Destroyed without the lock, since it may own the last reference to its captures.
+			pending_task.task = nullptr;
+			guard.lock();
+			--busy_count;
+			continue;
+		}
+
+		auto &batch = *pending_task.batch;
+		++batch.running;
+		guard.unlock();
+
+		std::exception_ptr error;
+		try {
+			(*batch.task)();
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		guard.lock();
+		--busy_count;
+		if (error && !batch.error) {
+			batch.error = error;
+		}
+		if (--batch.running == 0) {
+			done_cv.notify_all();
+		}
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,142 @@
+#include "write_behind_buffer.hpp"
+
+#include "duckdb/common/helper.hpp"
+
+#include "no_destructor.hpp"
+
+namespace duckdb {
+
+namespace {
+
+WorkerPool &GetDefaultFlushers() {
+	// Never destroyed, like the default timer, so buffers of threads still running at exit don't race with it.
+	static NoDestructor<WorkerPool> flushers(WriteBehindBuffer::MAX_FLUSHERS);
+	return *flushers;
+}
+
+} // namespace
+
+WriteBehindBuffer::WriteBehindBuffer(idx_t capacity_p, FlushFunction flush_p, optional_ptr<WorkerPool> flushers_p)
+    : capacity(capacity_p), flush(std::move(flush_p)), flushers(flushers_p ? *flushers_p : GetDefaultFlushers()),
+      buffered_bytes(0), flushing(false), scheduled(false) {
+}
+
+WriteBehindBuffer::~WriteBehindBuffer() {
+	// The flush task refers to the buffer until it emptied the queue.
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (scheduled) {
+		cv.wait(guard);
+	}
+}
+
+void WriteBehindBuffer::Write(const_data_ptr_t data, idx_t size, optional_idx location) {
+	if (size == 0) {
+		return;
+	}
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	ThrowFlushError();
+	while (buffered_bytes > 0 && buffered_bytes + size > capacity) {
+		cv.wait(guard);
+		ThrowFlushError();
+	}
+
+	// The front write stays queued while it is being flushed, and must not change under the flusher.
+	const bool can_append = !pending.empty() && !(flushing && pending.size() == 1);
+	if (can_append) {
+		auto &last = pending.back();
+		// Writes at the file pointer always continue the previous one.
+		bool adjacent = !last.location.IsValid() && !location.IsValid();
+		if (last.location.IsValid() && location.IsValid()) {
+			adjacent = last.location.GetIndex() + last.data.size() == location.GetIndex();
+		}
+		if (adjacent && last.data.size() + size <= capacity) {
+			last.data.insert(last.data.end(), data, data + size);
+			buffered_bytes += size;
+			return;
+		}
+	}
+	PendingWrite write;
+	write.location = location;
+	write.data.assign(data, data + size);
+	pending.push_back(std::move(write));
+	buffered_bytes += size;
+	if (scheduled) {
+		return;
+	}
+	scheduled = true;
+	guard.unlock();
+	ScheduleFlush();
+}
+
+void WriteBehindBuffer::Drain() {
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (scheduled) {
+		cv.wait(guard);
+	}
+	ThrowFlushError();
+}
+
+idx_t WriteBehindBuffer::GetCapacity() const {
+	return capacity;
+}
+
+idx_t WriteBehindBuffer::GetBufferedBytes() const {
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	return buffered_bytes;
+}
+
+void WriteBehindBuffer::ThrowFlushError() {
+	if (!flush_error) {
+		return;
+	}
+	auto error = std::move(flush_error);
+	flush_error = nullptr;
+	std::rethrow_exception(error);
+}
+
+void WriteBehindBuffer::ScheduleFlush() {
+	if (flushers.Submit([this]() { FlushPending(); })) {
+		return;
+	}
+	// Issued by the producer instead, which then sees a failure right away.
+	FlushPending();
+	concurrency::lock_guard<concurrency::mutex> guard(lock);
+	ThrowFlushError();
+}
+
+void WriteBehindBuffer::FlushPending() {
+	concurrency::unique_lock<concurrency::mutex> guard(lock);
+	while (!pending.empty()) {
+		// Taken off the queue only once issued, so that writes queued meanwhile aren't appended to it.
+		flushing = true;
+		auto &write = pending.front();
+		const auto data = write.data.data();
+		const auto size = write.data.size();
+		const auto location = write.location;
+		guard.unlock();
+		std::exception_ptr error;
+		try {
+			flush(data, size, location);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		guard.lock();
+
+		pending.pop_front();
+		buffered_bytes -= size;
+		flushing = false;
+		if (error) {
+			// Writes behind a failed one would leave a hole in the file, so they are dropped rather than issued.
+			for (auto &dropped : pending) {
+				buffered_bytes -= dropped.data.size();
+			}
+			pending.clear();
+			flush_error = std::move(error);
+		}
+		cv.notify_all();
+	}
+	scheduled = false;
+	cv.notify_all();
+}
+
+} // namespace duckdb
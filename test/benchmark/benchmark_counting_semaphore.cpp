@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_util.hpp"
+#include "counting_semaphore.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Every thread takes and returns a slot of a shared semaphore with more slots than threads, so nobody parks and
+// this measures the lock-free fast path under contention.
+void BM_CountingSemaphoreAcquireRelease(benchmark::State &state) {
+	static CountingSemaphore semaphore(/*max_count=*/1024);
+	for (auto _ : state) {
+		semaphore.Acquire();
+		semaphore.Release();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// The unlimited semaphore every operation without max_requests goes through.
+void BM_CountingSemaphoreUnlimited(benchmark::State &state) {
+	static CountingSemaphore semaphore;
+	for (auto _ : state) {
+		auto guard = semaphore.AcquireGuard();
+		benchmark::DoNotOptimize(guard);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_CountingSemaphoreAcquireRelease)->ThreadRange(1, GetBenchmarkMaxThreads())->UseRealTime();
+BENCHMARK(BM_CountingSemaphoreUnlimited)->ThreadRange(1, GetBenchmarkMaxThreads())->UseRealTime();
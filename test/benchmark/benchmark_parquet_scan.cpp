@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_util.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/opener_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "fake_filesystem.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "rate_limit_stats.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *BENCHMARK_FS_NAME = "RateLimitFileSystem - RateLimitFsFakeFileSystem";
+// Lives in the fake filesystem's directory, created by its constructor.
+constexpr const char *BENCHMARK_DIRECTORY = "/tmp/fake_rate_limit_fs/benchmark_parquet";
+constexpr idx_t FILE_COUNT = 16;
+constexpr idx_t ROWS_PER_FILE = 256 * 1024;
+constexpr idx_t BYTES_PER_MB = 1024 * 1024;
+
+// A database whose fake filesystem is wrapped by a rate limit filesystem, registered like rate_limit_fs_wrap does.
+struct ParquetBenchmarkDatabase {
+	ParquetBenchmarkDatabase() : db(nullptr), con(db), config(make_shared_ptr<RateLimitConfig>()) {
+		auto inner_fs = make_uniq<RateLimitFsFakeFileSystem>();
+		fake_fs = inner_fs.get();
+		auto &vfs = db.instance->GetFileSystem().Cast<OpenerFileSystem>().GetFileSystem();
+		vfs.RegisterSubSystem(make_uniq<RateLimitFileSystem>(std::move(inner_fs), config));
+		// Every read reaches the filesystem, rather than DuckDB's cache of remote file blocks.
+		Run("SET enable_external_file_cache = false");
+	}
+
+	void Run(const string &query) {
+		auto result = con.Query(query);
+		if (result->HasError()) {
+			result->ThrowError();
+		}
+	}
+
+	DuckDB db;
+	Connection con;
+	shared_ptr<RateLimitConfig> config;
+	RateLimitFsFakeFileSystem *fake_fs;
+};
+
+// Writes the parquet files read by the benchmarks once per process, through the wrapper before any faults are set.
+void CreateBenchmarkFiles() {
+	static const bool created = [] {
+		ParquetBenchmarkDatabase database;
+		database.Run(StringUtil::Format("CREATE OR REPLACE TEMP TABLE rows AS SELECT (random() * 1e9)::BIGINT AS v, "
+		                                "md5(v::VARCHAR) AS s FROM range(%llu)",
+		                                static_cast<unsigned long long>(ROWS_PER_FILE)));
+		if (!database.fake_fs->DirectoryExists(BENCHMARK_DIRECTORY, nullptr)) {
+			database.fake_fs->CreateDirectory(BENCHMARK_DIRECTORY, nullptr);
+		}
+		for (idx_t idx = 0; idx < FILE_COUNT; ++idx) {
+			database.Run(StringUtil::Format("COPY rows TO '%s/file_%llu.parquet' (FORMAT parquet)", BENCHMARK_DIRECTORY,
+			                                static_cast<unsigned long long>(idx)));
+		}
+		return true;
+	}();
+	(void)created;
+}
+
+// Remote-storage-like behavior: a few milliseconds per read with jitter, and slower listings and metadata calls.
+void InjectRemoteLatency(RateLimitFsFakeFileSystem &fake_fs) {
+	FakeFsFaults read_faults;
+	read_faults.latency = 2ms;
+	read_faults.jitter = 2ms;
+	fake_fs.SetFaults(FileSystemOperation::READ, read_faults);
+	FakeFsFaults stat_faults;
+	stat_faults.latency = 1ms;
+	fake_fs.SetFaults(FileSystemOperation::STAT, stat_faults);
+	FakeFsFaults list_faults;
+	list_faults.latency = 5ms;
+	fake_fs.SetFaults(FileSystemOperation::LIST, list_faults);
+}
+
+// Scans every file with read_parquet at state.range(0) DuckDB threads, against a READ quota of state.range(1)
+// MB/s (0 for unlimited). Reports the bandwidth achieved next to the quota, and the p50 and p99 latency of the reads
+// reaching the fake filesystem and of the rate limiter waits in front of them. Throttle errors aren't injected, since
+// they fail the query.
+void BM_ReadParquetRemoteLatency(benchmark::State &state) {
+	CreateBenchmarkFiles();
+	const auto threads = state.range(0);
+	const auto quota_mb = static_cast<idx_t>(state.range(1));
+
+	ParquetBenchmarkDatabase database;
+	InjectRemoteLatency(*database.fake_fs);
+	database.config->SetTracing(BENCHMARK_FS_NAME, FileSystemOperation::READ, /*sample_every=*/1);
+	if (quota_mb > 0) {
+		database.config->SetQuota(BENCHMARK_FS_NAME, FileSystemOperation::READ, quota_mb * BYTES_PER_MB,
+		                          RateLimitMode::BLOCKING);
+		// A second worth of bandwidth, so no single parquet read exceeds the burst.
+		database.config->SetBurst(BENCHMARK_FS_NAME, FileSystemOperation::READ, quota_mb * BYTES_PER_MB);
+	}
+	database.Run(StringUtil::Format("SET threads = %lld", static_cast<long long>(threads)));
+	const auto query = StringUtil::Format("SELECT sum(v), max(s) FROM read_parquet('%s/*.parquet')",
+	                                      BENCHMARK_DIRECTORY);
+
+	auto &read_stats = database.config->GetOrCreateStats(BENCHMARK_FS_NAME)->Get(FileSystemOperation::READ);
+	read_stats.Reset();
+	const auto start = std::chrono::steady_clock::now();
+	for (auto _ : state) {
+		database.Run(query);
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const auto snapshot = read_stats.GetSnapshot();
+	const auto to_micros = [](Duration duration) {
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	};
+	state.SetBytesProcessed(static_cast<int64_t>(snapshot.bytes_admitted));
+	state.counters["achieved_mb_per_s"] = static_cast<double>(snapshot.bytes_admitted) / BYTES_PER_MB / elapsed;
+	state.counters["quota_mb_per_s"] = static_cast<double>(quota_mb);
+	state.counters["read_latency_p50_us"] =
+	    to_micros(OperationStats::GetDurationPercentile(snapshot.inner_latency_histogram, 50));
+	state.counters["read_latency_p99_us"] =
+	    to_micros(OperationStats::GetDurationPercentile(snapshot.inner_latency_histogram, 99));
+	state.counters["throttle_wait_p50_us"] =
+	    to_micros(OperationStats::GetDurationPercentile(snapshot.wait_histogram, 50));
+	state.counters["throttle_wait_p99_us"] =
+	    to_micros(OperationStats::GetDurationPercentile(snapshot.wait_histogram, 99));
+}
+
+// Doubles the thread count up to the hardware concurrency, each unlimited and against a 64 MB/s quota.
+void ParquetScanArguments(benchmark::internal::Benchmark *benchmark) {
+	for (int64_t threads = 1; threads <= GetBenchmarkMaxThreads(); threads *= 2) {
+		for (int64_t quota_mb : {0, 64}) {
+			benchmark->Args({threads, quota_mb});
+		}
+	}
+}
+
+} // namespace
+
+BENCHMARK(BM_ReadParquetRemoteLatency)
+    ->ArgNames({"threads", "quota_mb"})
+    ->Apply(ParquetScanArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
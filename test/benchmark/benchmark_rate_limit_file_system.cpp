@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_util.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "fake_filesystem.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *BENCHMARK_FS_NAME = "RateLimitFileSystem - RateLimitFsFakeFileSystem";
+constexpr idx_t FILE_SIZE = 1 << 20;
+constexpr idx_t READ_SIZE = 4096;
+
+// Lives in the fake filesystem's directory, created by its constructor.
+string GetBenchmarkFilePath() {
+	return "/tmp/fake_rate_limit_fs/benchmark_read.bin";
+}
+
+// Writes the file read by the benchmarks once per process.
+void CreateBenchmarkFile() {
+	static const bool created = [] {
+		RateLimitFsFakeFileSystem fs;
+		auto handle = fs.OpenFile(GetBenchmarkFilePath(),
+		                          FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE, nullptr);
+		string content(FILE_SIZE, 'x');
+		fs.Write(*handle, content.data(), static_cast<int64_t>(content.size()), 0);
+		handle->Close();
+		return true;
+	}();
+	(void)created;
+}
+
+// Shared by every thread: limits nobody runs into, so reads measure the bookkeeping of the wrapper, not waits.
+RateLimitFileSystem &GetFileSystem(bool configured) {
+	static auto unconfigured_fs = [] {
+		return make_uniq<RateLimitFileSystem>(make_uniq<RateLimitFsFakeFileSystem>(),
+		                                      make_shared_ptr<RateLimitConfig>());
+	}();
+	static auto configured_fs = [] {
+		auto config = make_shared_ptr<RateLimitConfig>();
+		config->SetQuota(BENCHMARK_FS_NAME, FileSystemOperation::READ, 1000000000000, RateLimitMode::BLOCKING);
+		config->SetBurst(BENCHMARK_FS_NAME, FileSystemOperation::READ, 1000000000000);
+		config->SetRequestQuota(BENCHMARK_FS_NAME, FileSystemOperation::READ, 1000000000);
+		config->SetMaxRequests(BENCHMARK_FS_NAME, FileSystemOperation::READ, 1024);
+		return make_uniq<RateLimitFileSystem>(make_uniq<RateLimitFsFakeFileSystem>(), std::move(config));
+	}();
+	return configured ? *configured_fs : *unconfigured_fs;
+}
+
+// Positional 4 KB reads through the wrapper, each thread on a handle of its own. Argument 0 wraps the filesystem
+// without any config, 1 with byte and request quotas and max_requests set on READ.
+void BM_RateLimitFileSystemRead(benchmark::State &state) {
+	CreateBenchmarkFile();
+	auto &fs = GetFileSystem(state.range(0) != 0);
+	auto handle = fs.OpenFile(GetBenchmarkFilePath(), FileOpenFlags::FILE_FLAGS_READ, nullptr);
+	string buffer(READ_SIZE, '\0');
+	idx_t location = 0;
+	for (auto _ : state) {
+		fs.Read(*handle, buffer.data(), READ_SIZE, location);
+		location = (location + READ_SIZE) % FILE_SIZE;
+	}
+	handle->Close();
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * READ_SIZE);
+}
+
+} // namespace
+
+BENCHMARK(BM_RateLimitFileSystemRead)
+    ->ArgName("configured")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, GetBenchmarkMaxThreads())
+    ->UseRealTime();
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_util.hpp"
+#include "mock_clock.hpp"
+#include "rate_limiter.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// A nanosecond per token with a second of burst: the limiter never runs out, so the benchmarks measure the admission
+// path rather than waits.
+Quota GetUnboundedQuota() {
+	return Quota(/*bandwidth_p=*/1000000000, /*burst_p=*/1000000000);
+}
+
+// Every thread charges a limiter of its own.
+void BM_TryAcquireImmediateUncontended(benchmark::State &state) {
+	auto limiter = RateLimiter::Direct(GetUnboundedQuota());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(limiter->TryAcquireImmediate(1));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Every thread charges the same limiter, so they contend on its state.
+void BM_TryAcquireImmediateContended(benchmark::State &state) {
+	static auto limiter = RateLimiter::Direct(GetUnboundedQuota());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(limiter->TryAcquireImmediate(1));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Like the contended case, but with a sharded limiter, so most acquisitions only touch the thread's own shard.
+void BM_TryAcquireImmediateSharded(benchmark::State &state) {
+	static auto limiter = RateLimiter::Direct(GetUnboundedQuota(), /*clock_p=*/nullptr, /*parent_p=*/nullptr,
+	                                          /*shard_lease_p=*/64);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(limiter->TryAcquireImmediate(1));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Every request has to wait, and the mock clock jumps to its deadline instead of sleeping, so this measures computing
+// and "sleeping" off a wait. Single threaded, since the mock clock isn't thread-safe.
+void BM_UntilNReadyMockClock(benchmark::State &state) {
+	auto clock = CreateMockClock();
+	auto limiter = RateLimiter::Direct(Quota(/*bandwidth_p=*/1000, /*burst_p=*/0), clock);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(limiter->UntilNReady(1));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_TryAcquireImmediateUncontended)->ThreadRange(1, GetBenchmarkMaxThreads())->UseRealTime();
+BENCHMARK(BM_TryAcquireImmediateContended)->ThreadRange(1, GetBenchmarkMaxThreads())->UseRealTime();
+BENCHMARK(BM_TryAcquireImmediateSharded)->ThreadRange(1, GetBenchmarkMaxThreads())->UseRealTime();
+BENCHMARK(BM_UntilNReadyMockClock);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+
+namespace duckdb {
+
+// Upper end of the thread ranges multi-threaded benchmarks scale over.
+inline int GetBenchmarkMaxThreads() {
+	return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} // namespace duckdb
@@ -0,0 +1,55 @@
+// Fixtures shared by the unit tests which read and write files through a RateLimitFileSystem wrapping the local
+// filesystem.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+// Creates a file with the given content inside the test directory, and returns its path.
+inline string CreateTempFile(const string &dir, const string &filename, const string &content) {
+	string path = StringUtil::Format("%s/%s", dir, filename);
+	LocalFileSystem fs;
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	fs.Write(*handle, const_cast<char *>(content.c_str()), static_cast<int64_t>(content.size()));
+	handle->Sync();
+	handle->Close();
+	return path;
+}
+
+// Returns 10000 bytes which differ from offset to offset, so misplaced buffer or block copies are caught.
+inline string CreateContent() {
+	string content;
+	for (idx_t idx = 0; idx < 10000; ++idx) {
+		content.push_back(static_cast<char>('a' + idx % 26));
+	}
+	return content;
+}
+
+// Local filesystem whose positional reads take a while, recording how many ran at once.
+class SlowReadFileSystem : public LocalFileSystem {
+public:
+	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		const auto running = ++in_flight;
+		auto observed = max_in_flight.load();
+		while (running > observed && !max_in_flight.compare_exchange_weak(observed, running)) {
+		}
+		++read_count;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		LocalFileSystem::Read(handle, buffer, nr_bytes, location);
+		--in_flight;
+	}
+
+	std::atomic<idx_t> in_flight {0};
+	std::atomic<idx_t> max_in_flight {0};
+	std::atomic<idx_t> read_count {0};
+};
+
+} // namespace duckdb
@@ -0,0 +1,176 @@
+#include "catch/catch.hpp"
+
+#include "adaptive_concurrency_limiter.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+// Fails every existence check the way S3 reports prefix throttling.
+class ThrottlingFileSystem : public LocalFileSystem {
+public:
+	bool FileExists(const string &filename, optional_ptr<FileOpener> opener) override {
+		throw IOException("HTTP HEAD error on '%s' (HTTP 503 SlowDown)", filename);
+	}
+};
+
+// Completes one full round of successes at the given latency.
+void CompleteRound(AdaptiveConcurrencyLimiter &limiter, Duration latency) {
+	const auto round = limiter.GetLimit();
+	for (int64_t idx = 0; idx < round; ++idx) {
+		limiter.OnSuccess(latency);
+	}
+}
+
+} // namespace
+
+TEST_CASE("Adaptive concurrency - rejects invalid bounds", "[adaptive_concurrency]") {
+	REQUIRE_THROWS_AS(AdaptiveConcurrencyLimiter(0, 10), InvalidInputException);
+	REQUIRE_THROWS_AS(AdaptiveConcurrencyLimiter(10, 5), InvalidInputException);
+	REQUIRE_NOTHROW(AdaptiveConcurrencyLimiter(4, 4));
+}
+
+TEST_CASE("Adaptive concurrency - grows by one per round while latency is stable", "[adaptive_concurrency]") {
+	AdaptiveConcurrencyLimiter limiter(2, 5);
+	REQUIRE(limiter.GetLimit() == 2);
+	REQUIRE(limiter.GetSemaphore()->GetMax() == 2);
+
+	CompleteRound(limiter, 10ms);
+	REQUIRE(limiter.GetLimit() == 3);
+	CompleteRound(limiter, 10ms);
+	REQUIRE(limiter.GetLimit() == 4);
+
+	// Capped at the maximum
+	for (int idx = 0; idx < 10; ++idx) {
+		CompleteRound(limiter, 10ms);
+	}
+	REQUIRE(limiter.GetLimit() == 5);
+	REQUIRE(limiter.GetSemaphore()->GetMax() == 5);
+}
+
+TEST_CASE("Adaptive concurrency - latency above tolerance shrinks the limit", "[adaptive_concurrency]") {
+	AdaptiveConcurrencyLimiter limiter(1, 100);
+	for (int idx = 0; idx < 40; ++idx) {
+		CompleteRound(limiter, 10ms);
+	}
+	const auto grown_limit = limiter.GetLimit();
+	REQUIRE(grown_limit == 41);
+
+	// Within tolerance of the 10ms baseline still grows
+	CompleteRound(limiter, 19ms);
+	REQUIRE(limiter.GetLimit() == grown_limit + 1);
+
+	// A slow completion shrinks the limit right away
+	limiter.OnSuccess(50ms);
+	const auto shrunk_limit = limiter.GetLimit();
+	REQUIRE(shrunk_limit == 37);
+
+	// Requests admitted under the old limit still complete slowly, but only shrink it again after a full round
+	for (int64_t idx = 0; idx + 1 < shrunk_limit; ++idx) {
+		limiter.OnSuccess(50ms);
+	}
+	REQUIRE(limiter.GetLimit() == shrunk_limit);
+	limiter.OnSuccess(50ms);
+	REQUIRE(limiter.GetLimit() == 33);
+}
+
+TEST_CASE("Adaptive concurrency - throttling halves the limit down to the minimum", "[adaptive_concurrency]") {
+	AdaptiveConcurrencyLimiter limiter(3, 100);
+	for (int idx = 0; idx < 17; ++idx) {
+		CompleteRound(limiter, 10ms);
+	}
+	REQUIRE(limiter.GetLimit() == 20);
+
+	limiter.OnFailure("HTTP GET error (HTTP 503 SlowDown)");
+	REQUIRE(limiter.GetLimit() == 10);
+	// At most one decrease per round
+	for (int idx = 0; idx < 9; ++idx) {
+		limiter.OnFailure("HTTP GET error (HTTP 503 SlowDown)");
+	}
+	REQUIRE(limiter.GetLimit() == 10);
+
+	// Errors which aren't throttling don't shrink the limit
+	for (int idx = 0; idx < 20; ++idx) {
+		limiter.OnFailure("No files found that match the pattern");
+	}
+	REQUIRE(limiter.GetLimit() == 10);
+
+	for (int idx = 0; idx < 100; ++idx) {
+		limiter.OnFailure("Too Many Requests");
+	}
+	REQUIRE(limiter.GetLimit() == 3);
+}
+
+TEST_CASE("Adaptive concurrency - recognizes throttling errors", "[adaptive_concurrency]") {
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("HTTP 503"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("<Code>SlowDown</Code>"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("HTTP 429 Too Many Requests"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("Request was throttled"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("HTTP GET error on 'x' (HTTP/1.1 503)"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("Unexpected response, status code: 429"));
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError("503 Service Unavailable"));
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("HTTP 404 Not Found"));
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("Permission denied"));
+	// The digits alone, in a file name or a count, aren't a status
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("No such file: part-00503.parquet"));
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("Expected to read 4290 bytes, got 12"));
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("HTTP 404 on 's3://bucket/429/data.csv'"));
+	REQUIRE_FALSE(AdaptiveConcurrencyLimiter::IsThrottleError("Could not open file '503'"));
+}
+
+TEST_CASE("Adaptive concurrency - latency is timed with the given clock", "[adaptive_concurrency]") {
+	auto clock = CreateMockClock();
+	AdaptiveConcurrencyLimiter limiter(1, 100, clock);
+	auto call = [&](Duration latency) {
+		AdaptiveConcurrencyLimiter::SuccessReporter reporter(limiter);
+		clock->Advance(latency);
+	};
+	for (int idx = 0; idx < 10; ++idx) {
+		call(10ms);
+	}
+	REQUIRE(limiter.GetLimit() == 5);
+
+	call(100ms);
+	REQUIRE(limiter.GetLimit() == 4);
+}
+
+TEST_CASE("Adaptive concurrency - filesystem feeds throttling errors back", "[adaptive_concurrency]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetAdaptiveMaxRequests(TEST_FS_NAME, FileSystemOperation::STAT, 1, 64);
+
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->max_requests == 64);
+	auto adaptive_limiter = op_config->adaptive_limiter;
+	REQUIRE(adaptive_limiter);
+	REQUIRE(op_config->semaphore == adaptive_limiter->GetSemaphore());
+
+	RateLimitFileSystem fs(make_uniq<ThrottlingFileSystem>(), config);
+	// Grow the limit first, with successful stats of a real file
+	for (int idx = 0; idx < 200; ++idx) {
+		fs.DirectoryExists("/tmp");
+	}
+	const auto grown_limit = adaptive_limiter->GetLimit();
+	REQUIRE(grown_limit > 1);
+
+	for (int idx = 0; idx < 200; ++idx) {
+		REQUIRE_THROWS_AS(fs.FileExists("/tmp/does_not_matter"), IOException);
+	}
+	REQUIRE(adaptive_limiter->GetLimit() == 1);
+	REQUIRE(adaptive_limiter->GetSemaphore()->GetCurrent() == 0);
+
+	// A static max requests replaces the adaptive limit
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::STAT, 8);
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE_FALSE(op_config->adaptive_limiter);
+	REQUIRE(op_config->semaphore != adaptive_limiter->GetSemaphore());
+	REQUIRE(op_config->semaphore->GetMax() == 8);
+}
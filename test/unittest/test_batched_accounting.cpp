@@ -0,0 +1,134 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - batch_recording";
+
+// Records the batches passed to RemoveFiles, and lists a configurable number of entries.
+class BatchRecordingFileSystem : public FileSystem {
+public:
+	void RemoveFiles(const vector<string> &filenames, optional_ptr<FileOpener> opener = nullptr) override {
+		batch_sizes.push_back(filenames.size());
+	}
+
+	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener = nullptr) override {
+		vector<OpenFileInfo> result;
+		for (idx_t idx = 0; idx < list_entries; ++idx) {
+			result.emplace_back(OpenFileInfo(StringUtil::Format("%s/file_%llu", path, idx)));
+		}
+		return result;
+	}
+
+	string GetName() const override {
+		return "batch_recording";
+	}
+
+	vector<idx_t> batch_sizes;
+	idx_t list_entries = 0;
+};
+
+vector<string> MakeFilenames(idx_t count) {
+	vector<string> filenames;
+	for (idx_t idx = 0; idx < count; ++idx) {
+		filenames.push_back(StringUtil::Format("s3://bucket/compacted/file_%llu", idx));
+	}
+	return filenames;
+}
+
+} // namespace
+
+TEST_CASE("Batched accounting - RemoveFiles without limits is a single call", "[batched_accounting]") {
+	auto inner_fs = make_uniq<BatchRecordingFileSystem>();
+	auto &recording_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), make_shared_ptr<RateLimitConfig>());
+
+	fs.RemoveFiles(MakeFilenames(2500));
+	REQUIRE(recording_fs.batch_sizes == vector<idx_t> {2500});
+}
+
+TEST_CASE("Batched accounting - RemoveFiles is split into burst-sized sub-batches", "[batched_accounting]") {
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	// Burst limits of metadata operations come from a limiter group
+	config->SetGroup("deletes", 10, 10, "");
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::DELETE, "deletes");
+
+	auto inner_fs = make_uniq<BatchRecordingFileSystem>();
+	auto &recording_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	const auto start_time = mock_clock->Now();
+	fs.RemoveFiles(MakeFilenames(25));
+	REQUIRE(recording_fs.batch_sizes == vector<idx_t> {10, 10, 5});
+	// The first two batches fit the burst tolerance, the last one only waits until the first batch's files are paid
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(1000));
+}
+
+TEST_CASE("Batched accounting - RemoveFiles without burst is split by one second of quota", "[batched_accounting]") {
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::DELETE, 100, RateLimitMode::BLOCKING);
+
+	auto inner_fs = make_uniq<BatchRecordingFileSystem>();
+	auto &recording_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	fs.RemoveFiles(MakeFilenames(250));
+	REQUIRE(recording_fs.batch_sizes == vector<idx_t> {100, 100, 50});
+}
+
+TEST_CASE("Batched accounting - RemoveFiles charges every file", "[batched_accounting]") {
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetGroup("deletes", 10, 10, "");
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::DELETE, "deletes");
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::DELETE, 1000000000, RateLimitMode::NON_BLOCKING);
+
+	auto inner_fs = make_uniq<BatchRecordingFileSystem>();
+	auto &recording_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	// Charged per call, there would be room for 8 more calls; charged per file, 11 files overdraw the burst of 10
+	fs.RemoveFiles(MakeFilenames(3));
+	mock_clock->Advance(std::chrono::milliseconds(1));
+	fs.RemoveFiles(MakeFilenames(8));
+	mock_clock->Advance(std::chrono::milliseconds(1));
+	REQUIRE_THROWS_AS(fs.RemoveFiles(MakeFilenames(1)), IOException);
+	REQUIRE(recording_fs.batch_sizes == vector<idx_t> {3, 8});
+
+	mock_clock->Advance(std::chrono::milliseconds(100));
+	fs.RemoveFiles(MakeFilenames(1));
+}
+
+TEST_CASE("Batched accounting - Glob charges one LIST call per page", "[batched_accounting]") {
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::LIST, 1, RateLimitMode::BLOCKING);
+
+	auto inner_fs = make_uniq<BatchRecordingFileSystem>();
+	auto &recording_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	// Three pages: one charged up front, two once the listing returned
+	recording_fs.list_entries = 2 * RateLimitFileSystem::LIST_PAGE_SIZE + 1;
+	const auto start_time = mock_clock->Now();
+	REQUIRE(fs.Glob("s3://bucket/compacted/*").size() == recording_fs.list_entries);
+	REQUIRE(mock_clock->Now() == start_time);
+
+	// The next listing is the fourth call at one call per second, with a tolerance of one call
+	recording_fs.list_entries = 1;
+	fs.Glob("s3://bucket/compacted/*");
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::seconds(2));
+}
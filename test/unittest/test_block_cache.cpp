@@ -0,0 +1,231 @@
+#include "catch/catch.hpp"
+
+#include "block_cache.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_block_cache";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+shared_ptr<const CachedBlock> MakeBlock(idx_t size) {
+	auto block = make_shared_ptr<CachedBlock>();
+	block->size = size;
+	block->data = make_unsafe_uniq_array<data_t>(size);
+	return block;
+}
+
+// Counts reads and reports a settable version tag, like an object store reporting ETags.
+class VersionedFileSystem : public LocalFileSystem {
+public:
+	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		++read_count;
+		LocalFileSystem::Read(handle, buffer, nr_bytes, location);
+	}
+
+	string GetVersionTag(FileHandle &handle) override {
+		return version_tag;
+	}
+
+	idx_t read_count = 0;
+	string version_tag = "v1";
+};
+
+} // namespace
+
+TEST_CASE("BlockCache - least recently used blocks are evicted first", "[block_cache]") {
+	BlockCache cache(100, 300);
+	for (idx_t idx = 0; idx < 3; ++idx) {
+		cache.Put(BlockCacheKey {"file", "v1", idx}, MakeBlock(100));
+	}
+	// Touch block 0, so block 1 is the least recently used
+	REQUIRE(cache.Get(BlockCacheKey {"file", "v1", 0}));
+	cache.Put(BlockCacheKey {"file", "v1", 3}, MakeBlock(100));
+
+	REQUIRE(cache.Get(BlockCacheKey {"file", "v1", 0}));
+	REQUIRE_FALSE(cache.Get(BlockCacheKey {"file", "v1", 1}));
+	REQUIRE(cache.Get(BlockCacheKey {"file", "v1", 2}));
+	REQUIRE(cache.Get(BlockCacheKey {"file", "v1", 3}));
+
+	auto stats = cache.GetStats();
+	REQUIRE(stats.memory_usage == 300);
+	REQUIRE(stats.block_count == 3);
+	REQUIRE(stats.hits == 4);
+	REQUIRE(stats.misses == 1);
+}
+
+TEST_CASE("BlockCache - keys include the version tag", "[block_cache]") {
+	BlockCache cache(100, 1000);
+	cache.Put(BlockCacheKey {"file", "v1", 0}, MakeBlock(100));
+	REQUIRE(cache.Get(BlockCacheKey {"file", "v1", 0}));
+	REQUIRE_FALSE(cache.Get(BlockCacheKey {"file", "v2", 0}));
+	REQUIRE_FALSE(cache.Get(BlockCacheKey {"other", "v1", 0}));
+
+	// Replacing a block doesn't count it twice
+	cache.Put(BlockCacheKey {"file", "v1", 0}, MakeBlock(50));
+	REQUIRE(cache.GetStats().memory_usage == 50);
+}
+
+TEST_CASE("BlockCache - erasing a path drops all of its versions", "[block_cache]") {
+	BlockCache cache(100, 1000);
+	cache.Put(BlockCacheKey {"file", "v1", 0}, MakeBlock(100));
+	cache.Put(BlockCacheKey {"file", "v2", 1}, MakeBlock(100));
+	cache.Put(BlockCacheKey {"other", "v1", 0}, MakeBlock(100));
+
+	cache.ErasePath("file");
+	REQUIRE_FALSE(cache.Get(BlockCacheKey {"file", "v1", 0}));
+	REQUIRE_FALSE(cache.Get(BlockCacheKey {"file", "v2", 1}));
+	REQUIRE(cache.Get(BlockCacheKey {"other", "v1", 0}));
+	REQUIRE(cache.GetStats().memory_usage == 100);
+}
+
+TEST_CASE("BlockCache - rejects empty blocks and capacity", "[block_cache]") {
+	REQUIRE_THROWS_AS(BlockCache(0, 100), InvalidInputException);
+	REQUIRE_THROWS_AS(BlockCache(100, 0), InvalidInputException);
+}
+
+TEST_CASE("BlockCache - repeated reads are served from the cache", "[block_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "repeated.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetBlockCache(TEST_FS_NAME, 1000, 1000000);
+	auto inner_fs = make_uniq<VersionedFileSystem>();
+	auto &versioned_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(2500, '\0');
+	// Blocks 1 to 3 are missing, and fetched with a single read
+	fs.Read(*handle, buffer.data(), 2500, 1200);
+	REQUIRE(buffer == content.substr(1200, 2500));
+	REQUIRE(versioned_fs.read_count == 1);
+
+	fs.Read(*handle, buffer.data(), 100, 3850);
+	REQUIRE(buffer.substr(0, 100) == content.substr(3850, 100));
+	REQUIRE(versioned_fs.read_count == 1);
+
+	// Only the missing block 0 is fetched; the last block of the file is short
+	fs.Read(*handle, buffer.data(), 1500, 500);
+	REQUIRE(buffer.substr(0, 1500) == content.substr(500, 1500));
+	REQUIRE(versioned_fs.read_count == 2);
+	fs.Read(*handle, buffer.data(), 100, 9900);
+	REQUIRE(buffer.substr(0, 100) == content.substr(9900, 100));
+	REQUIRE(versioned_fs.read_count == 3);
+	handle->Close();
+
+	// Another handle of the same version shares the blocks, a new version misses
+	handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	fs.Read(*handle, buffer.data(), 100, 1200);
+	REQUIRE(versioned_fs.read_count == 3);
+	handle->Close();
+	versioned_fs.version_tag = "v2";
+	handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	fs.Read(*handle, buffer.data(), 100, 1200);
+	REQUIRE(versioned_fs.read_count == 4);
+	handle->Close();
+}
+
+TEST_CASE("BlockCache - only misses are charged", "[block_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "charged.txt", content);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetBlockCache(TEST_FS_NAME, 1000, 1000000);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+	const auto start_time = mock_clock->Now();
+	for (idx_t iteration = 0; iteration < 10; ++iteration) {
+		for (idx_t location = 0; location < 3000; location += 1000) {
+			fs.Read(*handle, buffer.data(), 100, location);
+		}
+	}
+	// Three requests instead of thirty; the first two fit the tolerance of the request quota
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(100));
+
+	auto stats = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).block_cache->GetStats();
+	REQUIRE(stats.misses == 3);
+	REQUIRE(stats.hits == 27);
+	handle->Close();
+}
+
+TEST_CASE("BlockCache - writes through a handle drop the file's blocks", "[block_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "write.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetBlockCache(TEST_FS_NAME, 1000, 1000000);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	string buffer(100, '\0');
+	fs.Read(*handle, buffer.data(), 100, 0);
+
+	string update(100, 'Z');
+	fs.Write(*handle, update.data(), 100, 100);
+	fs.Read(*handle, buffer.data(), 100, 100);
+	REQUIRE(buffer == update);
+	handle->Close();
+}
+
+TEST_CASE("BlockCache - write-only handles and moves drop the file's blocks", "[block_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "write_only.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetBlockCache(TEST_FS_NAME, 1000, 1000000);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	// The writer is opened before the blocks are cached, so only its write can drop them
+	auto writer = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE);
+	auto reader = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+	fs.Read(*reader, buffer.data(), 100, 0);
+	REQUIRE(buffer == content.substr(0, 100));
+
+	string update(100, 'Z');
+	fs.Write(*writer, update.data(), 100, 0);
+	writer->Close();
+	fs.Read(*reader, buffer.data(), 100, 0);
+	REQUIRE(buffer == update);
+
+	// Moving another file onto the path drops its blocks as well
+	auto other = CreateTempFile(test_dir.GetPath(), "other.txt", string(100, 'Y'));
+	reader->Close();
+	fs.MoveFile(other, path);
+	reader = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	fs.Read(*reader, buffer.data(), 100, 0);
+	REQUIRE(buffer == string(100, 'Y'));
+	reader->Close();
+}
+
+TEST_CASE("BlockCache - configuration", "[block_cache]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetBlockCache(TEST_FS_NAME, 4096, 1048576);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->block_cache);
+	REQUIRE(op_config->block_cache->GetBlockSize() == 4096);
+	REQUIRE(op_config->mode == RateLimitMode::NONE);
+
+	REQUIRE_THROWS_AS(config->SetBlockCache(TEST_FS_NAME, 0, 1048576), InvalidInputException);
+	config->SetBlockCache(TEST_FS_NAME, 0, 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ) == nullptr);
+}
@@ -0,0 +1,90 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "coarse_clock.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limiter.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "test_fs";
+
+} // namespace
+
+TEST_CASE("CoarseClock - time never goes backwards and sleeping moves it forward", "[coarse_clock]") {
+	CoarseClock clock(std::chrono::milliseconds(50));
+	REQUIRE(clock.GetResolution() == std::chrono::milliseconds(50));
+
+	const auto start = clock.Now();
+	// Without a refresh in between, waking at a deadline still reads a time at or after it
+	const auto deadline = start + std::chrono::milliseconds(1);
+	clock.SleepUntil(deadline);
+	REQUIRE(clock.Now() >= deadline);
+
+	const auto before_sleep = clock.Now();
+	clock.SleepFor(std::chrono::milliseconds(1));
+	REQUIRE(clock.Now() >= before_sleep + std::chrono::milliseconds(1));
+
+	// Observing an earlier time leaves the clock where it is
+	const auto now = clock.Now();
+	clock.Observe(start);
+	REQUIRE(clock.Now() == now);
+	clock.Observe(now + std::chrono::seconds(1));
+	REQUIRE(clock.Now() == now + std::chrono::seconds(1));
+}
+
+TEST_CASE("CoarseClock - background refresh follows real time", "[coarse_clock]") {
+	CoarseClock clock(std::chrono::milliseconds(1));
+	const auto start = clock.Now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	REQUIRE(clock.Now() > start);
+	REQUIRE(clock.Now() <= std::chrono::steady_clock::now());
+}
+
+TEST_CASE("CoarseClock - invalid resolutions are rejected", "[coarse_clock]") {
+	REQUIRE_THROWS_AS(CoarseClock(Duration::zero()), InvalidInputException);
+	REQUIRE_THROWS_AS(CoarseClock(CoarseClock::MAX_RESOLUTION + std::chrono::milliseconds(1)), InvalidInputException);
+}
+
+TEST_CASE("CoarseClock - clocks are shared by resolution", "[coarse_clock]") {
+	auto first = GetCoarseClock(std::chrono::milliseconds(5));
+	auto second = GetCoarseClock(std::chrono::milliseconds(5));
+	auto other = GetCoarseClock(std::chrono::milliseconds(10));
+	REQUIRE(first == second);
+	REQUIRE(first != other);
+}
+
+TEST_CASE("CoarseClock - configured per operation", "[coarse_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000, RateLimitMode::BLOCKING);
+	config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::READ, std::chrono::milliseconds(1));
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config->clock_resolution == std::chrono::milliseconds(1));
+	auto coarse_clock = dynamic_cast<CoarseClock *>(op_config->rate_limiter->GetClock().get());
+	REQUIRE(coarse_clock != nullptr);
+	REQUIRE(coarse_clock->GetResolution() == std::chrono::milliseconds(1));
+
+	// A zero resolution goes back to the default clock
+	config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::READ, Duration::zero());
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(dynamic_cast<CoarseClock *>(op_config->rate_limiter->GetClock().get()) == nullptr);
+
+	// An explicitly set clock wins
+	auto mock_clock = CreateMockClock();
+	config->SetClock(mock_clock);
+	config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::READ, std::chrono::milliseconds(1));
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config->rate_limiter->GetClock() == mock_clock);
+
+	// A config with only a resolution is dropped once it goes back to zero
+	config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::WRITE, std::chrono::milliseconds(1));
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE) != nullptr);
+	config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::WRITE, Duration::zero());
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE) == nullptr);
+
+	REQUIRE_THROWS_AS(config->SetClockResolution(TEST_FS_NAME, FileSystemOperation::READ, std::chrono::seconds(1)),
+	                  InvalidInputException);
+}
@@ -71,3 +71,75 @@ TEST_CASE("CountingSemaphore - multiple threads respect limit", "[counting_semap
 	REQUIRE(max_observed.load() > 1);
 	REQUIRE(sem.GetCurrent() == 0);
 }
+
+TEST_CASE("CountingSemaphore - raising the max wakes waiters", "[counting_semaphore]") {
+	CountingSemaphore sem(1);
+	sem.Acquire();
+
+	std::atomic<int> acquired {0};
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 2; i++) {
+		threads.emplace_back([&] {
+			sem.Acquire();
+			++acquired;
+		});
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	REQUIRE(acquired.load() == 0);
+
+	// Both waiters fit once the max is raised, without any release
+	sem.SetMax(3);
+	for (auto &t : threads) {
+		t.join();
+	}
+	REQUIRE(acquired.load() == 2);
+	REQUIRE(sem.GetCurrent() == 3);
+}
+
+TEST_CASE("CountingSemaphore - switching to unlimited wakes waiters", "[counting_semaphore]") {
+	CountingSemaphore sem(1);
+	sem.Acquire();
+
+	std::atomic<bool> acquired {false};
+	std::thread t([&] {
+		sem.Acquire();
+		acquired.store(true);
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	REQUIRE_FALSE(acquired.load());
+
+	sem.SetMax(CountingSemaphore::UNLIMITED);
+	t.join();
+	REQUIRE(acquired.load());
+}
+
+TEST_CASE("CountingSemaphore - saturated handoff doesn't lose wakeups", "[counting_semaphore]") {
+	constexpr int NUM_THREADS = 8;
+	constexpr int ITERATIONS = 2000;
+	CountingSemaphore sem(1);
+
+	std::atomic<int64_t> concurrent_count {0};
+	std::atomic<bool> exceeded {false};
+
+	std::vector<std::thread> threads;
+	threads.reserve(NUM_THREADS);
+	for (int i = 0; i < NUM_THREADS; i++) {
+		threads.emplace_back([&] {
+			for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+				auto guard = sem.AcquireGuard();
+				if (++concurrent_count > 1) {
+					exceeded.store(true);
+				}
+				--concurrent_count;
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	REQUIRE_FALSE(exceeded.load());
+	REQUIRE(sem.GetCurrent() == 0);
+}
@@ -0,0 +1,98 @@
+#include "catch/catch.hpp"
+
+#include "adaptive_concurrency_limiter.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "fake_filesystem.hpp"
+#include "mock_clock.hpp"
+#include "scoped_directory.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Within the fake filesystem's directory, created by its constructor.
+constexpr const char *TEST_DIR = "/tmp/fake_rate_limit_fs/test_fake_filesystem";
+
+void CreateFile(RateLimitFsFakeFileSystem &fs, const string &path, const string &content) {
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE, nullptr);
+	fs.Write(*handle, const_cast<char *>(content.data()), static_cast<int64_t>(content.size()), 0);
+	handle->Close();
+}
+
+} // namespace
+
+TEST_CASE("Fake filesystem - injected latency and jitter", "[fake_filesystem]") {
+	auto clock = CreateMockClock();
+	RateLimitFsFakeFileSystem fs(clock);
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/latency.txt", test_dir.GetPath());
+	CreateFile(fs, path, string(100, 'a'));
+
+	FakeFsFaults faults;
+	faults.latency = 10ms;
+	faults.jitter = 5ms;
+	fs.SetFaults(FileSystemOperation::READ, faults);
+	REQUIRE(fs.GetFaults(FileSystemOperation::READ).latency == 10ms);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ, nullptr);
+	string buffer(100, '\0');
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		const auto start = clock->Now();
+		fs.Read(*handle, buffer.data(), 100, 0);
+		const auto delay = clock->Now() - start;
+		REQUIRE(delay >= 10ms);
+		REQUIRE(delay <= 15ms);
+	}
+	REQUIRE(buffer == string(100, 'a'));
+
+	// Other operations keep their own faults, none here
+	const auto start = clock->Now();
+	REQUIRE(fs.GetFileSize(*handle) == 100);
+	REQUIRE(clock->Now() == start);
+	handle->Close();
+}
+
+TEST_CASE("Fake filesystem - injected throttle errors", "[fake_filesystem]") {
+	RateLimitFsFakeFileSystem fs(CreateMockClock());
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/throttle.txt", test_dir.GetPath());
+	CreateFile(fs, path, string(100, 'a'));
+
+	FakeFsFaults faults;
+	faults.throttle_error_rate = 1;
+	fs.SetFaults(FileSystemOperation::STAT, faults);
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ, nullptr);
+	string error_message;
+	try {
+		fs.GetFileSize(*handle);
+	} catch (const IOException &ex) {
+		error_message = ex.what();
+	}
+	// Recognized like a throttle response of a remote backend
+	REQUIRE(AdaptiveConcurrencyLimiter::IsThrottleError(error_message));
+	REQUIRE_THROWS_AS(fs.FileExists(path, nullptr), IOException);
+	REQUIRE(fs.GetInjectedErrorCount() == 2);
+
+	// Reads have no faults set
+	string buffer(100, '\0');
+	fs.Read(*handle, buffer.data(), 100, 0);
+
+	faults.throttle_error_rate = 0;
+	fs.SetFaults(FileSystemOperation::STAT, faults);
+	REQUIRE(fs.GetFileSize(*handle) == 100);
+	REQUIRE(fs.GetInjectedErrorCount() == 2);
+	handle->Close();
+}
+
+TEST_CASE("Fake filesystem - invalid faults", "[fake_filesystem]") {
+	RateLimitFsFakeFileSystem fs(CreateMockClock());
+	FakeFsFaults faults;
+	faults.throttle_error_rate = 1.5;
+	REQUIRE_THROWS_AS(fs.SetFaults(FileSystemOperation::READ, faults), InvalidInputException);
+	faults.throttle_error_rate = 0;
+	faults.jitter = -1ms;
+	REQUIRE_THROWS_AS(fs.SetFaults(FileSystemOperation::READ, faults), InvalidInputException);
+	REQUIRE(fs.GetFaults(FileSystemOperation::READ).jitter == Duration::zero());
+}
@@ -80,6 +80,62 @@ private:
 	vector<OpenFileInfo> extended_glob_results;
 };
 
+// Lazy list of generated files, which records how far it has been expanded.
+class LazyMultiFileList : public MultiFileList {
+public:
+	LazyMultiFileList(idx_t file_count_p, idx_t &expanded_p)
+	    : MultiFileList(vector<OpenFileInfo> {OpenFileInfo("s3://bucket/*")}, FileGlobOptions::ALLOW_EMPTY),
+	      file_count(file_count_p), expanded(expanded_p) {
+	}
+
+	vector<OpenFileInfo> GetAllFiles() override {
+		vector<OpenFileInfo> result;
+		for (idx_t idx = 0; idx < file_count; ++idx) {
+			result.push_back(GetFile(idx));
+		}
+		return result;
+	}
+	FileExpandResult GetExpandResult() override {
+		return file_count > 1 ? FileExpandResult::MULTIPLE_FILES : FileExpandResult::SINGLE_FILE;
+	}
+	idx_t GetTotalFileCount() override {
+		return file_count;
+	}
+
+protected:
+	OpenFileInfo GetFile(idx_t i) override {
+		expanded = MaxValue<idx_t>(expanded, i + 1);
+		if (i >= file_count) {
+			return OpenFileInfo();
+		}
+		return OpenFileInfo("s3://bucket/file_" + std::to_string(i));
+	}
+
+private:
+	const idx_t file_count;
+	idx_t &expanded;
+};
+
+class MockFileSystemWithLazyGlob : public FileSystem {
+public:
+	string GetName() const override {
+		return "mock_with_lazy_glob";
+	}
+
+	bool SupportsGlobExtended() const override {
+		return true;
+	}
+
+	idx_t file_count = 0;
+	idx_t expanded = 0;
+
+protected:
+	unique_ptr<MultiFileList> GlobFilesExtended(const string &path, const FileGlobInput &input,
+	                                            optional_ptr<FileOpener> opener) override {
+		return make_uniq<LazyMultiFileList>(file_count, expanded);
+	}
+};
+
 } // namespace
 
 TEST_CASE("Test Glob with GlobFilesExtended unsupported", "[glob test]") {
@@ -120,3 +176,40 @@ TEST_CASE("Test Glob uses GlobFilesExtended", "[glob test]") {
 	REQUIRE(results[0].path == "s3://bucket/snapshots/file1.parquet");
 	REQUIRE(results[1].path == "s3://bucket/snapshots/file2.parquet");
 }
+
+TEST_CASE("Test extended Glob expands and charges one page at a time", "[glob test]") {
+	auto mock_filesystem = make_uniq<MockFileSystemWithLazyGlob>();
+	auto *mock_ptr = mock_filesystem.get();
+	mock_ptr->file_count = 2500;
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMaxRequests("RateLimitFileSystem - mock_with_lazy_glob", FileSystemOperation::LIST, 1);
+	auto rate_limit_fs = make_uniq<RateLimitFileSystem>(std::move(mock_filesystem), config);
+	auto &list_stats = config->GetOrCreateStats(rate_limit_fs->GetName())->Get(FileSystemOperation::LIST);
+
+	// DuckDB globs through the FileSystem interface, which dispatches to GlobFilesExtended
+	FileSystem &fs = *rate_limit_fs;
+	auto files = fs.Glob("s3://bucket/*", FileGlobOptions::ALLOW_EMPTY, nullptr);
+	REQUIRE(mock_ptr->expanded == 0);
+	REQUIRE(list_stats.GetSnapshot().ops_admitted == 1);
+
+	// The first file only needs the first page, and the concurrency slot isn't held between pages
+	REQUIRE(files->GetFirstFile().path == "s3://bucket/file_0");
+	REQUIRE(mock_ptr->expanded == RateLimitFileSystem::LIST_PAGE_SIZE);
+	REQUIRE(list_stats.GetSnapshot().ops_admitted == 1);
+	REQUIRE(list_stats.GetSnapshot().in_flight == 0);
+
+	MultiFileListScanData scan_data;
+	files->InitializeScan(scan_data);
+	OpenFileInfo file;
+	idx_t scanned = 0;
+	while (files->Scan(scan_data, file)) {
+		REQUIRE(file.path == "s3://bucket/file_" + std::to_string(scanned));
+		++scanned;
+	}
+	REQUIRE(scanned == 2500);
+	REQUIRE(files->GetExpandResult() == FileExpandResult::MULTIPLE_FILES);
+	REQUIRE(files->GetTotalFileCount() == 2500);
+	// One LIST call per page
+	REQUIRE(list_stats.GetSnapshot().ops_admitted == 3);
+}
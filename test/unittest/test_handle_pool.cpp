@@ -0,0 +1,232 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "handle_pool.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_handle_pool";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+PooledHandle OpenPooled(LocalFileSystem &fs, const string &path, const string &version_tag) {
+	PooledHandle pooled;
+	pooled.handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	pooled.version_tag = version_tag;
+	return pooled;
+}
+
+// Counts opens, and reports a version tag which tests can change to simulate an overwritten object.
+class OpenCountingFileSystem : public LocalFileSystem {
+public:
+	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags,
+	                                optional_ptr<FileOpener> opener = nullptr) override {
+		++open_count;
+		return LocalFileSystem::OpenFile(path, flags, opener);
+	}
+
+	string GetVersionTag(FileHandle &handle) override {
+		return version_tag;
+	}
+
+	idx_t open_count = 0;
+	string version_tag = "v1";
+};
+
+} // namespace
+
+TEST_CASE("HandlePool - handles are reused by path and flags until they expire", "[handle_pool]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = CreateTempFile(test_dir.GetPath(), "file.txt", "hello");
+	auto mock_clock = CreateMockClock();
+	HandlePool pool(std::chrono::seconds(10), 10, mock_clock);
+	LocalFileSystem fs;
+
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	REQUIRE(pool.GetStats().handle_count == 1);
+	// Another owner or other flags don't match
+	REQUIRE_FALSE(pool.Take(1, path, FileOpenFlags::FILE_FLAGS_READ, "").handle);
+	REQUIRE_FALSE(
+	    pool.Take(0, path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS, "").handle);
+
+	auto pooled = pool.Take(0, path, FileOpenFlags::FILE_FLAGS_READ, "v1");
+	REQUIRE(pooled.handle);
+	REQUIRE(pooled.version_tag == "v1");
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, std::move(pooled));
+	mock_clock->Advance(std::chrono::seconds(10));
+	REQUIRE_FALSE(pool.Take(0, path, FileOpenFlags::FILE_FLAGS_READ, "").handle);
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	auto stats = pool.GetStats();
+	REQUIRE(stats.hits == 1);
+	REQUIRE(stats.misses == 3);
+}
+
+TEST_CASE("HandlePool - changed version tags, erasure and capacity close handles", "[handle_pool]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = CreateTempFile(test_dir.GetPath(), "file.txt", "hello");
+	HandlePool pool(std::chrono::seconds(10), 2, CreateMockClock());
+	LocalFileSystem fs;
+
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	REQUIRE_FALSE(pool.Take(0, path, FileOpenFlags::FILE_FLAGS_READ, "v2").handle);
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	pool.Put(1, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	pool.Erase(path);
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	// The longest idle handle is closed first
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "first"));
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "second"));
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "third"));
+	REQUIRE(pool.GetStats().handle_count == 2);
+	REQUIRE_FALSE(pool.Take(0, path, FileOpenFlags::FILE_FLAGS_READ, "first").handle);
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	pool.Put(1, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	pool.EraseOwner(1);
+	REQUIRE(pool.GetStats().handle_count == 1);
+
+	// Handles put into a retired pool are closed
+	pool.Retire();
+	REQUIRE(pool.GetStats().handle_count == 0);
+	pool.Put(0, path, FileOpenFlags::FILE_FLAGS_READ, OpenPooled(fs, path, "v1"));
+	REQUIRE(pool.GetStats().handle_count == 0);
+
+	REQUIRE_THROWS_AS(HandlePool(std::chrono::seconds(0), 2, nullptr), InvalidInputException);
+	REQUIRE_THROWS_AS(HandlePool(std::chrono::seconds(1), 0, nullptr), InvalidInputException);
+}
+
+TEST_CASE("HandlePool - only read-only opens are pooled", "[handle_pool]") {
+	REQUIRE(HandlePool::CanPool(FileOpenFlags::FILE_FLAGS_READ));
+	REQUIRE(HandlePool::CanPool(FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS));
+	REQUIRE_FALSE(HandlePool::CanPool(FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE));
+	REQUIRE_FALSE(HandlePool::CanPool(FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE));
+	const auto locked = FileOpenFlags(FileOpenFlags::FILE_FLAGS_READ) | FileOpenFlags(FileLockType::READ_LOCK);
+	REQUIRE_FALSE(HandlePool::CanPool(locked));
+}
+
+TEST_CASE("HandlePool - reopening a file reuses its inner handle without an OPEN charge", "[handle_pool]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = CreateTempFile(test_dir.GetPath(), "file.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(CreateMockClock());
+	config->SetHandlePool(TEST_FS_NAME, std::chrono::seconds(10), 16);
+	// A non-blocking limit of one open, so a charged reopen throws
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::OPEN, 1, RateLimitMode::NON_BLOCKING);
+	auto inner_fs = make_uniq<OpenCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	REQUIRE(fs.GetFileSize(*handle) == 5);
+	char buffer[5];
+	REQUIRE(fs.Read(*handle, buffer, 5) == 5);
+	handle->Close();
+	handle.reset();
+
+	for (idx_t idx = 0; idx < 3; ++idx) {
+		handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+		// Rewound on reuse
+		REQUIRE(fs.Read(*handle, buffer, 5) == 5);
+		REQUIRE(string(buffer, 5) == "hello");
+		// Destroyed without being closed first
+		handle.reset();
+	}
+	REQUIRE(counting_fs.open_count == 1);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::OPEN)->handle_pool->GetStats().hits == 3);
+	// Metadata calls are still charged as STAT, which has no limit
+	REQUIRE(config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::OPEN).GetSnapshot().ops_admitted == 1);
+}
+
+TEST_CASE("HandlePool - writes and version changes close pooled handles", "[handle_pool]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = CreateTempFile(test_dir.GetPath(), "file.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetHandlePool(TEST_FS_NAME, std::chrono::seconds(10), 16);
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(10), 16);
+	auto inner_fs = make_uniq<OpenCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ)->Close();
+	auto write_handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE);
+	write_handle->Close();
+	fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ)->Close();
+	REQUIRE(counting_fs.open_count == 3);
+
+	// The object changes version, as reported by a listing
+	OpenFileInfo listed(path);
+	listed.extended_info = make_shared_ptr<ExtendedOpenFileInfo>();
+	listed.extended_info->options["etag"] = Value("v2");
+	counting_fs.version_tag = "v2";
+	auto &base_fs = static_cast<FileSystem &>(fs);
+	base_fs.OpenFile(listed, FileOpenFlags::FILE_FLAGS_READ)->Close();
+	REQUIRE(counting_fs.open_count == 4);
+	base_fs.OpenFile(listed, FileOpenFlags::FILE_FLAGS_READ)->Close();
+	REQUIRE(counting_fs.open_count == 4);
+
+	fs.RemoveFile(path);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::OPEN)->handle_pool->GetStats().handle_count == 0);
+}
+
+TEST_CASE("HandlePool - removing a directory closes the pooled handles under it", "[handle_pool]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	LocalFileSystem local_fs;
+	const auto nested_dir = test_dir.GetPath() + "/nested";
+	local_fs.CreateDirectory(nested_dir);
+	auto path = CreateTempFile(nested_dir, "file.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetHandlePool(TEST_FS_NAME, std::chrono::seconds(10), 16);
+	auto inner_fs = make_uniq<OpenCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	// Reports no version tag, like the local filesystem, so only the removal can tell the pool the file is gone
+	counting_fs.version_tag = "";
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+	fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ)->Close();
+	const auto &pool = config->GetConfig(TEST_FS_NAME, FileSystemOperation::OPEN)->handle_pool;
+	REQUIRE(pool->GetStats().handle_count == 1);
+
+	fs.RemoveDirectory(nested_dir);
+	REQUIRE(pool->GetStats().handle_count == 0);
+
+	// The recreated file is opened again rather than read through the handle of the removed one
+	local_fs.CreateDirectory(nested_dir);
+	CreateTempFile(nested_dir, "file.txt", "world");
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	REQUIRE(counting_fs.open_count == 2);
+	string buffer(5, '\0');
+	fs.Read(*handle, buffer.data(), 5, 0);
+	REQUIRE(buffer == "world");
+	handle->Close();
+}
+
+TEST_CASE("HandlePool - configuration", "[handle_pool]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetHandlePool(TEST_FS_NAME, std::chrono::seconds(10), 16);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::OPEN);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->handle_pool->GetStats().capacity == 16);
+
+	// A zero TTL disables the pool, and drops a config with nothing else set
+	config->SetHandlePool(TEST_FS_NAME, Duration::zero(), 16);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::OPEN) == nullptr);
+	REQUIRE(ParseFileSystemOperation("OPEN") == FileSystemOperation::OPEN);
+	REQUIRE(FileSystemOperationToString(FileSystemOperation::OPEN) == "open");
+}
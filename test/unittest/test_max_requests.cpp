@@ -2,10 +2,10 @@
 
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/local_file_system.hpp"
-#include "duckdb/common/string_util.hpp"
 #include "rate_limit_config.hpp"
 #include "rate_limit_file_system.hpp"
 #include "scoped_directory.hpp"
+#include "test_file_util.hpp"
 
 #include <atomic>
 #include <thread>
@@ -18,16 +18,6 @@ namespace {
 constexpr const char *TEST_DIR = "/tmp/test_max_requests";
 constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
 
-string CreateTempFile(const string &dir, const string &filename, const string &content) {
-	string path = StringUtil::Format("%s/%s", dir, filename);
-	LocalFileSystem fs;
-	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
-	fs.Write(*handle, const_cast<char *>(content.c_str()), static_cast<int64_t>(content.size()));
-	handle->Sync();
-	handle->Close();
-	return path;
-}
-
 class ConcurrencyTrackingFileSystem : public LocalFileSystem {
 public:
 	std::atomic<int64_t> concurrent_stat_count {0};
@@ -112,3 +102,55 @@ TEST_CASE("MaxRequests - limit=1 serializes operations", "[max_requests]") {
 	REQUIRE(tracking.max_observed_concurrency.load() <= 1);
 	REQUIRE(tracking.concurrent_stat_count.load() == 0);
 }
+
+TEST_CASE("MaxRequests - stream slot is kept between reads until the handle closes", "[max_requests][stream_slot]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::READ, 2);
+	config->SetStreamSlot(TEST_FS_NAME, std::chrono::seconds(60));
+	auto semaphore = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).semaphore;
+	REQUIRE(semaphore);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "stream.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	// Sequential and positional reads share the one slot the handle took on its first read
+	REQUIRE(fs.Read(*handle, buffer.data(), 10) == 10);
+	REQUIRE(semaphore->GetCurrent() == 1);
+	REQUIRE(fs.Read(*handle, buffer.data(), 10) == 10);
+	fs.Read(*handle, buffer.data(), 10, 50);
+	REQUIRE(semaphore->GetCurrent() == 1);
+
+	handle->Close();
+	REQUIRE(semaphore->GetCurrent() == 0);
+}
+
+TEST_CASE("MaxRequests - idle stream slot is released for other handles", "[max_requests][stream_slot]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::READ, 1);
+	config->SetStreamSlot(TEST_FS_NAME, std::chrono::milliseconds(20));
+	auto semaphore = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).semaphore;
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "idle_stream.txt", string(100, 'x'));
+	auto first_handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	auto second_handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	REQUIRE(fs.Read(*first_handle, buffer.data(), 10) == 10);
+	REQUIRE(semaphore->GetCurrent() == 1);
+
+	// The only slot is held by the first handle, so the second waits until the first goes idle
+	REQUIRE(fs.Read(*second_handle, buffer.data(), 10) == 10);
+	REQUIRE(semaphore->GetCurrent() == 1);
+
+	second_handle->Close();
+	REQUIRE(semaphore->GetCurrent() == 0);
+	first_handle->Close();
+	REQUIRE(semaphore->GetCurrent() == 0);
+}
@@ -0,0 +1,244 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "metadata_cache.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_metadata_cache";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+bool LookupSize(MetadataCache &cache, const string &path, int64_t &file_size) {
+	return cache.Get(path, [&](const CachedMetadata &metadata) {
+		file_size = metadata.file_size;
+		return file_size >= 0;
+	});
+}
+
+// Counts metadata calls, and attaches object store style metadata to glob results.
+class StatCountingFileSystem : public LocalFileSystem {
+public:
+	bool FileExists(const string &filename, optional_ptr<FileOpener> opener = nullptr) override {
+		++stat_count;
+		return LocalFileSystem::FileExists(filename, opener);
+	}
+
+	int64_t GetFileSize(FileHandle &handle) override {
+		++stat_count;
+		return LocalFileSystem::GetFileSize(handle);
+	}
+
+	string GetVersionTag(FileHandle &handle) override {
+		++stat_count;
+		return "v1";
+	}
+
+	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener = nullptr) override {
+		auto files = LocalFileSystem::Glob(path, opener);
+		for (auto &file : files) {
+			file.extended_info = make_shared_ptr<ExtendedOpenFileInfo>();
+			file.extended_info->options["file_size"] = Value::BIGINT(1234);
+			file.extended_info->options["etag"] = Value("listed");
+		}
+		return files;
+	}
+
+	idx_t stat_count = 0;
+};
+
+} // namespace
+
+TEST_CASE("MetadataCache - entries expire after the TTL", "[metadata_cache]") {
+	auto mock_clock = CreateMockClock();
+	MetadataCache cache(std::chrono::seconds(10), 100, mock_clock);
+	cache.Update("file", [](CachedMetadata &metadata) { metadata.file_size = 42; });
+
+	int64_t file_size = -1;
+	REQUIRE(LookupSize(cache, "file", file_size));
+	REQUIRE(file_size == 42);
+
+	// Merging another field doesn't extend the entry
+	mock_clock->Advance(std::chrono::seconds(6));
+	cache.Update("file", [](CachedMetadata &metadata) {
+		metadata.has_version_tag = true;
+		metadata.version_tag = "v1";
+	});
+	mock_clock->Advance(std::chrono::seconds(4));
+	REQUIRE_FALSE(LookupSize(cache, "file", file_size));
+
+	auto stats = cache.GetStats();
+	REQUIRE(stats.entry_count == 0);
+	REQUIRE(stats.hits == 1);
+	REQUIRE(stats.misses == 1);
+}
+
+TEST_CASE("MetadataCache - unknown fields miss", "[metadata_cache]") {
+	MetadataCache cache(std::chrono::seconds(10), 100, CreateMockClock());
+	cache.Update("file", [](CachedMetadata &metadata) {
+		metadata.has_exists = true;
+		metadata.exists = true;
+	});
+	int64_t file_size = -1;
+	REQUIRE_FALSE(LookupSize(cache, "file", file_size));
+	REQUIRE(cache.GetStats().misses == 1);
+
+	cache.Erase("file");
+	REQUIRE(cache.GetStats().entry_count == 0);
+}
+
+TEST_CASE("MetadataCache - new paths beyond max entries aren't cached", "[metadata_cache]") {
+	auto mock_clock = CreateMockClock();
+	MetadataCache cache(std::chrono::seconds(10), 2, mock_clock);
+	cache.Update("a", [](CachedMetadata &metadata) { metadata.file_size = 1; });
+	cache.Update("b", [](CachedMetadata &metadata) { metadata.file_size = 2; });
+	cache.Update("c", [](CachedMetadata &metadata) { metadata.file_size = 3; });
+	int64_t file_size = -1;
+	REQUIRE_FALSE(LookupSize(cache, "c", file_size));
+	REQUIRE(LookupSize(cache, "a", file_size));
+
+	// Expired entries make room
+	mock_clock->Advance(std::chrono::seconds(10));
+	cache.Update("c", [](CachedMetadata &metadata) { metadata.file_size = 3; });
+	REQUIRE(LookupSize(cache, "c", file_size));
+	REQUIRE(cache.GetStats().entry_count == 1);
+}
+
+TEST_CASE("MetadataCache - rejects empty TTL and capacity", "[metadata_cache]") {
+	REQUIRE_THROWS_AS(MetadataCache(Duration::zero(), 100, nullptr), InvalidInputException);
+	REQUIRE_THROWS_AS(MetadataCache(std::chrono::seconds(1), 0, nullptr), InvalidInputException);
+}
+
+TEST_CASE("MetadataCache - repeated lookups aren't charged", "[metadata_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	auto path = CreateTempFile(test_dir.GetPath(), "repeated.txt", "hello");
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 10, RateLimitMode::BLOCKING);
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(60), 100);
+	auto inner_fs = make_uniq<StatCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	const auto start_time = mock_clock->Now();
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		REQUIRE(fs.FileExists(path));
+		REQUIRE_FALSE(fs.FileExists(path + ".missing"));
+	}
+	REQUIRE(counting_fs.stat_count == 2);
+
+	// The open is charged, and proves the file exists; the size is looked up once
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		REQUIRE(fs.GetFileSize(*handle) == 5);
+		REQUIRE(fs.GetVersionTag(*handle) == "v1");
+	}
+	REQUIRE(counting_fs.stat_count == 4);
+	handle->Close();
+	// Five charged calls, the first two within the tolerance of the quota
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(300));
+
+	auto stats = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT).metadata_cache->GetStats();
+	REQUIRE(stats.hits == 36);
+	REQUIRE(stats.misses == 4);
+}
+
+TEST_CASE("MetadataCache - glob results seed the cache", "[metadata_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	auto path = CreateTempFile(test_dir.GetPath(), "listed.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(60), 100);
+	auto inner_fs = make_uniq<StatCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto files = fs.Glob(test_dir.GetPath() + "/*.txt");
+	REQUIRE(files.size() == 1);
+	REQUIRE(fs.FileExists(path));
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	REQUIRE(fs.GetFileSize(*handle) == 1234);
+	REQUIRE(fs.GetVersionTag(*handle) == "listed");
+	REQUIRE(counting_fs.stat_count == 0);
+	handle->Close();
+}
+
+TEST_CASE("MetadataCache - changes through the wrapper invalidate", "[metadata_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	auto path = CreateTempFile(test_dir.GetPath(), "changed.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(60), 100);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	REQUIRE(fs.GetFileSize(*handle) == 5);
+	string update = " world";
+	fs.Write(*handle, update.data(), static_cast<int64_t>(update.size()), 5);
+	REQUIRE(fs.GetFileSize(*handle) == 11);
+	fs.Truncate(*handle, 2);
+	REQUIRE(fs.GetFileSize(*handle) == 2);
+	handle->Close();
+
+	REQUIRE(fs.FileExists(path));
+	fs.RemoveFile(path);
+	REQUIRE_FALSE(fs.FileExists(path));
+
+	// Creating the file through the wrapper drops the cached absence
+	handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE);
+	handle->Close();
+	REQUIRE(fs.FileExists(path));
+}
+
+TEST_CASE("MetadataCache - removing a directory drops the entries under it", "[metadata_cache]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	LocalFileSystem local_fs;
+	const auto nested_dir = test_dir.GetPath() + "/nested";
+	const auto sibling_dir = test_dir.GetPath() + "/nested_sibling";
+	local_fs.CreateDirectory(nested_dir);
+	local_fs.CreateDirectory(sibling_dir);
+	auto path = CreateTempFile(nested_dir, "listed.txt", "hello");
+	auto sibling_path = CreateTempFile(sibling_dir, "listed.txt", "hello");
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(60), 100);
+	auto inner_fs = make_uniq<StatCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	REQUIRE(fs.Glob(nested_dir + "/*.txt").size() == 1);
+	REQUIRE(fs.Glob(sibling_dir + "/*.txt").size() == 1);
+	REQUIRE(fs.FileExists(path));
+	REQUIRE(counting_fs.stat_count == 0);
+
+	fs.RemoveDirectory(nested_dir);
+	REQUIRE_FALSE(fs.FileExists(path));
+	REQUIRE(counting_fs.stat_count == 1);
+
+	// A directory sharing the name as a prefix keeps its entries
+	REQUIRE(fs.FileExists(sibling_path));
+	REQUIRE(counting_fs.stat_count == 1);
+}
+
+TEST_CASE("MetadataCache - configuration", "[metadata_cache]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(30), 1000);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->metadata_cache);
+	REQUIRE(op_config->metadata_cache->GetStats().max_entries == 1000);
+	REQUIRE(op_config->mode == RateLimitMode::NONE);
+
+	REQUIRE_THROWS_AS(config->SetMetadataCache(TEST_FS_NAME, std::chrono::seconds(30), 0), InvalidInputException);
+	config->SetMetadataCache(TEST_FS_NAME, Duration::zero(), 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) == nullptr);
+}
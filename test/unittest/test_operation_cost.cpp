@@ -0,0 +1,157 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "mock_clock.hpp"
+#include "operation_cost.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_operation_cost";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+OperationCost MakeCost(double call_cost, double byte_cost, double item_cost) {
+	OperationCost cost;
+	cost.call_cost = call_cost;
+	cost.byte_cost = byte_cost;
+	cost.item_cost = item_cost;
+	return cost;
+}
+
+void CreateFile(const string &path, idx_t size) {
+	LocalFileSystem fs;
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	string content(size, 'x');
+	fs.Write(*handle, const_cast<char *>(content.data()), static_cast<int64_t>(content.size()));
+	handle->Close();
+}
+
+} // namespace
+
+TEST_CASE("Operation cost - tokens are rounded up per call", "[operation_cost]") {
+	REQUIRE_FALSE(OperationCost().IsSet());
+	REQUIRE(MakeCost(0, 0, 0.5).IsSet());
+
+	auto cost = MakeCost(2.5, 0.25, 0);
+	REQUIRE(cost.GetTokens(1, 0, 0) == 3);
+	REQUIRE(cost.GetTokens(2, 0, 0) == 5);
+	REQUIRE(cost.GetTokens(1, 10, 0) == 5);
+	REQUIRE(cost.GetTokens(0, 0, 100) == 0);
+	REQUIRE(MakeCost(0, 0, 0.1).GetTokens(0, 0, 25) == 3);
+}
+
+TEST_CASE("Operation cost - largest call fitting a budget", "[operation_cost]") {
+	auto cost = MakeCost(4, 0.5, 0);
+	REQUIRE(cost.GetMaxBytes(10) == 12);
+	REQUIRE(cost.GetMaxBytes(4) == 0);
+	// Not even an empty call fits
+	REQUIRE(cost.GetMaxBytes(3) == 0);
+	REQUIRE(cost.GetMaxCalls(10) == 2);
+
+	// Free bytes or calls are unbounded
+	REQUIRE(MakeCost(4, 0, 0).GetMaxBytes(10) == NumericLimits<idx_t>::Maximum());
+	REQUIRE(MakeCost(0, 1, 0).GetMaxCalls(10) == NumericLimits<idx_t>::Maximum());
+}
+
+TEST_CASE("Operation cost - configuration", "[operation_cost]") {
+	RateLimitConfig config;
+	config.SetCost(TEST_FS_NAME, FileSystemOperation::LIST, MakeCost(5, 0, 0.01));
+	auto op_config = config.GetConfig(TEST_FS_NAME, FileSystemOperation::LIST);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->cost.call_cost == 5);
+	REQUIRE(op_config->cost.item_cost == 0.01);
+	REQUIRE(config.GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::LIST).cost.call_cost == 5);
+
+	REQUIRE_THROWS_AS(config.SetCost(TEST_FS_NAME, FileSystemOperation::STAT, MakeCost(-1, 0, 0)),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(config.SetCost(TEST_FS_NAME, FileSystemOperation::STAT, MakeCost(1, 1, 0)),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(config.SetCost(TEST_FS_NAME, FileSystemOperation::READ, MakeCost(1, 1, 1)),
+	                  InvalidInputException);
+	config.SetCost(TEST_FS_NAME, FileSystemOperation::READ, MakeCost(1, 1, 0));
+
+	// All costs 0 remove the cost model, and with it the otherwise empty config
+	config.SetCost(TEST_FS_NAME, FileSystemOperation::LIST, OperationCost());
+	REQUIRE(config.GetConfig(TEST_FS_NAME, FileSystemOperation::LIST) == nullptr);
+}
+
+TEST_CASE("Operation cost - calls are charged by cost", "[operation_cost]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	// 10 cost units per second: a call costing 10 takes a second, where two calls of one token pass back to back
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 10, RateLimitMode::NON_BLOCKING);
+	config->SetCost(TEST_FS_NAME, FileSystemOperation::STAT, MakeCost(10, 0, 0));
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	const auto path = test_dir.GetPath() + "/missing";
+	fs.FileExists(path);
+	REQUIRE_THROWS_AS(fs.FileExists(path), IOException);
+	mock_clock->Advance(800ms);
+	REQUIRE_THROWS_AS(fs.FileExists(path), IOException);
+	mock_clock->Advance(100ms);
+	fs.FileExists(path);
+
+	// Stats keep counting calls
+	auto stats = config->GetOrCreateStats(TEST_FS_NAME);
+	REQUIRE(stats->Get(FileSystemOperation::STAT).GetSnapshot().ops_admitted == 2);
+	REQUIRE(stats->Get(FileSystemOperation::STAT).GetSnapshot().bytes_admitted == 2);
+}
+
+TEST_CASE("Operation cost - listed entries are booked as items", "[operation_cost]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	for (idx_t idx = 0; idx < 3; ++idx) {
+		CreateFile(test_dir.GetPath() + "/file_" + std::to_string(idx), 1);
+	}
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::LIST, 10, RateLimitMode::NON_BLOCKING);
+	config->SetCost(TEST_FS_NAME, FileSystemOperation::LIST, MakeCost(1, 0, 1));
+
+	// A glob costs 4 tokens of 100ms: the call up front, then its 3 entries
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	const auto pattern = test_dir.GetPath() + "/*";
+	REQUIRE(fs.Glob(pattern).size() == 3);
+	REQUIRE_THROWS_AS(fs.Glob(pattern), IOException);
+	mock_clock->Advance(200ms);
+	REQUIRE_THROWS_AS(fs.Glob(pattern), IOException);
+	mock_clock->Advance(100ms);
+	fs.Glob(pattern);
+}
+
+TEST_CASE("Operation cost - split mode chunks fit the call cost", "[operation_cost]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = test_dir.GetPath() + "/split.txt";
+	CreateFile(path, 30);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	// Chunks of 5 bytes, each charged 10
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::SPLIT);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetCost(TEST_FS_NAME, FileSystemOperation::READ, MakeCost(5, 1, 0));
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(30, '\0');
+	const auto start = mock_clock->Now();
+	fs.Read(*handle, buffer.data(), 30, 0);
+	REQUIRE(buffer == string(30, 'x'));
+
+	// 6 chunks cost 60, of which the tolerance covers the first 20
+	REQUIRE(mock_clock->Now() - start >= 4s);
+	REQUIRE(config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot().ops_admitted == 6);
+	handle->Close();
+}
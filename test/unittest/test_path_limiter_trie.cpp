@@ -0,0 +1,66 @@
+#include "catch/catch.hpp"
+
+#include "path_limiter_trie.hpp"
+#include "rate_limiter.hpp"
+
+using namespace duckdb;
+
+TEST_CASE("PathLimiterTrie - empty trie matches nothing", "[path_limiter_trie]") {
+	PathLimiterTrie trie;
+	REQUIRE(trie.IsEmpty());
+	REQUIRE_FALSE(trie.Match("s3://bucket/key", FileSystemOperation::READ));
+	for (const auto &rate_limiter : trie.MatchAll("s3://bucket/key")) {
+		REQUIRE_FALSE(rate_limiter);
+	}
+}
+
+TEST_CASE("PathLimiterTrie - longest prefix wins", "[path_limiter_trie]") {
+	auto bucket_limiter = CreateRateLimiter(100, 0);
+	auto logs_limiter = CreateRateLimiter(10, 0);
+
+	PathLimiterTrie trie;
+	trie.Insert("s3://bucket/", FileSystemOperation::READ, bucket_limiter);
+	trie.Insert("s3://bucket/logs/", FileSystemOperation::READ, logs_limiter);
+	REQUIRE_FALSE(trie.IsEmpty());
+
+	REQUIRE(trie.Match("s3://bucket/data/file.parquet", FileSystemOperation::READ) == bucket_limiter);
+	REQUIRE(trie.Match("s3://bucket/logs/2024/file.json", FileSystemOperation::READ) == logs_limiter);
+	// A path diverging below the longer rule falls back to the shorter one
+	REQUIRE(trie.Match("s3://bucket/logz", FileSystemOperation::READ) == bucket_limiter);
+	// The prefix itself matches, anything shorter doesn't
+	REQUIRE(trie.Match("s3://bucket/", FileSystemOperation::READ) == bucket_limiter);
+	REQUIRE_FALSE(trie.Match("s3://bucket", FileSystemOperation::READ));
+	REQUIRE_FALSE(trie.Match("s3://other/logs/file.json", FileSystemOperation::READ));
+}
+
+TEST_CASE("PathLimiterTrie - rules are per operation", "[path_limiter_trie]") {
+	auto read_limiter = CreateRateLimiter(100, 0);
+	auto list_limiter = CreateRateLimiter(10, 0);
+
+	PathLimiterTrie trie;
+	trie.Insert("s3://bucket/", FileSystemOperation::READ, read_limiter);
+	trie.Insert("s3://bucket/logs/", FileSystemOperation::LIST, list_limiter);
+
+	REQUIRE(trie.Match("s3://bucket/logs/a", FileSystemOperation::READ) == read_limiter);
+	REQUIRE(trie.Match("s3://bucket/logs/a", FileSystemOperation::LIST) == list_limiter);
+	REQUIRE_FALSE(trie.Match("s3://bucket/logs/a", FileSystemOperation::WRITE));
+
+	auto matches = trie.MatchAll("s3://bucket/logs/a");
+	REQUIRE(matches[static_cast<idx_t>(FileSystemOperation::READ)] == read_limiter);
+	REQUIRE(matches[static_cast<idx_t>(FileSystemOperation::LIST)] == list_limiter);
+	REQUIRE_FALSE(matches[static_cast<idx_t>(FileSystemOperation::STAT)]);
+
+	matches = trie.MatchAll("s3://bucket/data");
+	REQUIRE(matches[static_cast<idx_t>(FileSystemOperation::READ)] == read_limiter);
+	REQUIRE_FALSE(matches[static_cast<idx_t>(FileSystemOperation::LIST)]);
+}
+
+TEST_CASE("PathLimiterTrie - reinserting a rule replaces it", "[path_limiter_trie]") {
+	auto first_limiter = CreateRateLimiter(100, 0);
+	auto second_limiter = CreateRateLimiter(10, 0);
+
+	PathLimiterTrie trie;
+	trie.Insert("/data/", FileSystemOperation::STAT, first_limiter);
+	trie.Insert("/data/", FileSystemOperation::STAT, second_limiter);
+	REQUIRE(trie.Match("/data/file", FileSystemOperation::STAT) == second_limiter);
+}
@@ -0,0 +1,109 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_prefetch";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+} // namespace
+
+TEST_CASE("Prefetch - prefetched ranges are served without charging again", "[prefetch]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "ranges.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000000, RateLimitMode::BLOCKING);
+	auto inner_fs = make_uniq<SlowReadFileSystem>();
+	auto &slow_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+	auto &read_stats = config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	auto &rate_limit_handle = handle->Cast<RateLimitFileHandle>();
+	// The last range runs past the end of the file and is clamped
+	rate_limit_handle.Prefetch({{0, 1000}, {5000, 500}, {9900, 500}});
+	REQUIRE(slow_fs.read_count == 3);
+	REQUIRE(read_stats.GetSnapshot().ops_admitted == 3);
+	REQUIRE(read_stats.GetSnapshot().bytes_admitted == 1600);
+
+	string buffer(100, '\0');
+	fs.Read(*handle, buffer.data(), 100, 200);
+	REQUIRE(buffer == content.substr(200, 100));
+	fs.Read(*handle, buffer.data(), 100, 5400);
+	REQUIRE(buffer == content.substr(5400, 100));
+	fs.Read(*handle, buffer.data(), 100, 9900);
+	REQUIRE(buffer == content.substr(9900, 100));
+	REQUIRE(slow_fs.read_count == 3);
+	REQUIRE(read_stats.GetSnapshot().ops_admitted == 3);
+
+	// Reads not within a single range go to the inner filesystem
+	fs.Read(*handle, buffer.data(), 100, 950);
+	REQUIRE(buffer == content.substr(950, 100));
+	REQUIRE(slow_fs.read_count == 4);
+	REQUIRE(read_stats.GetSnapshot().ops_admitted == 4);
+
+	// A new prefetch replaces the ranges
+	rate_limit_handle.Prefetch({{2000, 100}});
+	fs.Read(*handle, buffer.data(), 100, 200);
+	REQUIRE(slow_fs.read_count == 6);
+	handle->Close();
+}
+
+TEST_CASE("Prefetch - reads are issued concurrently up to max requests", "[prefetch]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "concurrent.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::READ, 3);
+	auto inner_fs = make_uniq<SlowReadFileSystem>();
+	auto &slow_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	vector<PrefetchRange> ranges;
+	for (idx_t offset = 0; offset < content.size(); offset += 1000) {
+		ranges.push_back(PrefetchRange {offset, 1000});
+	}
+	handle->Cast<RateLimitFileHandle>().Prefetch(ranges);
+	REQUIRE(slow_fs.read_count == 10);
+	REQUIRE(slow_fs.max_in_flight > 1);
+	REQUIRE(slow_fs.max_in_flight <= 3);
+
+	string buffer(content.size(), '\0');
+	for (idx_t offset = 0; offset < content.size(); offset += 1000) {
+		fs.Read(*handle, buffer.data() + offset, 1000, offset);
+	}
+	REQUIRE(buffer == content);
+	REQUIRE(slow_fs.read_count == 10);
+	handle->Close();
+}
+
+TEST_CASE("Prefetch - writes drop prefetched ranges", "[prefetch]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "write.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	handle->Cast<RateLimitFileHandle>().Prefetch({{0, 1000}});
+
+	string update(10, 'Z');
+	fs.Write(*handle, const_cast<char *>(update.data()), 10, 0);
+	string buffer(10, '\0');
+	fs.Read(*handle, buffer.data(), 10, 0);
+	REQUIRE(buffer == update);
+	handle->Close();
+}
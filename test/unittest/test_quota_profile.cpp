@@ -0,0 +1,145 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "mock_clock.hpp"
+#include "quota_profile.hpp"
+#include "rate_limit_config.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+idx_t GetReadBandwidth(RateLimitConfig &config) {
+	auto snapshot = config.GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(snapshot.rate_limiter);
+	return snapshot.rate_limiter->GetQuota().GetBandwidth();
+}
+
+} // namespace
+
+TEST_CASE("Quota profile - time of day parsing", "[quota_profile]") {
+	REQUIRE(ParseTimeOfDay("00:00") == 0);
+	REQUIRE(ParseTimeOfDay("02:30") == 150);
+	REQUIRE(ParseTimeOfDay("23:59") == MINUTES_PER_DAY - 1);
+	REQUIRE(TimeOfDayToString(150) == "02:30");
+	REQUIRE(TimeOfDayToString(MINUTES_PER_DAY - 1) == "23:59");
+
+	REQUIRE_THROWS_AS(ParseTimeOfDay("24:00"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParseTimeOfDay("12:60"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParseTimeOfDay("2:30"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParseTimeOfDay("02-30"), InvalidInputException);
+
+	REQUIRE(GetCurrentMinuteOfDay() < MINUTES_PER_DAY);
+	REQUIRE(GetTimeUntilNextMinute() <= std::chrono::minutes(1));
+}
+
+TEST_CASE("Quota profile - windows may wrap around midnight", "[quota_profile]") {
+	QuotaProfile night;
+	night.start_minute = ParseTimeOfDay("23:00");
+	night.end_minute = ParseTimeOfDay("02:00");
+	REQUIRE(night.Contains(ParseTimeOfDay("23:00")));
+	REQUIRE(night.Contains(ParseTimeOfDay("00:30")));
+	REQUIRE_FALSE(night.Contains(ParseTimeOfDay("02:00")));
+	REQUIRE_FALSE(night.Contains(ParseTimeOfDay("22:59")));
+
+	QuotaProfile day;
+	day.start_minute = ParseTimeOfDay("08:00");
+	day.end_minute = ParseTimeOfDay("18:00");
+	REQUIRE(day.Contains(ParseTimeOfDay("08:00")));
+	REQUIRE_FALSE(day.Contains(ParseTimeOfDay("18:00")));
+}
+
+TEST_CASE("Quota profile - profiles switch limits at their window", "[quota_profile]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(CreateMockClock());
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 100);
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("01:00")) == 0);
+
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("02:00"), ParseTimeOfDay("04:00"),
+	                        /*bandwidth=*/20, /*burst=*/20);
+	REQUIRE(GetReadBandwidth(*config) == 100);
+
+	const auto version = config->GetVersion();
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("02:00")) == 1);
+	REQUIRE(config->GetVersion() > version);
+	REQUIRE(GetReadBandwidth(*config) == 20);
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("03:59")) == 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ)->quota == 100);
+
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("04:00")) == 1);
+	REQUIRE(GetReadBandwidth(*config) == 100);
+
+	// Without a quota of its own, the operation is unlimited outside of its profiles
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::STAT, ParseTimeOfDay("23:00"), ParseTimeOfDay("01:00"),
+	                        /*bandwidth=*/5, /*burst=*/0);
+	REQUIRE_FALSE(config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT).rate_limiter);
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("00:00")) == 1);
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(snapshot.rate_limiter);
+	REQUIRE(snapshot.mode == RateLimitMode::BLOCKING);
+	REQUIRE(snapshot.rate_limiter->GetQuota().GetBandwidth() == 5);
+
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::STAT, ParseTimeOfDay("23:00"), ParseTimeOfDay("01:00"),
+	                        /*bandwidth=*/0, /*burst=*/0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) == nullptr);
+}
+
+TEST_CASE("Quota profile - transitions keep the limiter's debt", "[quota_profile]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(CreateMockClock());
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 100);
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("02:00"), ParseTimeOfDay("04:00"),
+	                        /*bandwidth=*/20, /*burst=*/20);
+
+	auto limiter = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).rate_limiter;
+	while (!limiter->TryAcquireImmediate(10).has_value()) {
+	}
+
+	// A fresh limiter would admit a full burst right away
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("02:00")) == 1);
+	limiter = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).rate_limiter;
+	REQUIRE(limiter->TryAcquireImmediate(1).has_value());
+
+	// Quota changes keep the debt as well
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 200, RateLimitMode::NON_BLOCKING);
+	REQUIRE(config->ApplyQuotaProfiles(ParseTimeOfDay("04:00")) == 1);
+	limiter = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).rate_limiter;
+	REQUIRE(limiter->GetQuota().GetBandwidth() == 200);
+	REQUIRE(limiter->TryAcquireImmediate(1).has_value());
+}
+
+TEST_CASE("Quota profile - invalid profiles are rejected", "[quota_profile]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(CreateMockClock());
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("22:00"), ParseTimeOfDay("02:00"),
+	                        /*bandwidth=*/20, /*burst=*/0);
+
+	REQUIRE_THROWS_AS(config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("05:00"),
+	                                          ParseTimeOfDay("05:00"), 20, 0),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("01:00"),
+	                                          ParseTimeOfDay("03:00"), 20, 0),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("21:00"),
+	                                          ParseTimeOfDay("23:00"), 20, 0),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::STAT, ParseTimeOfDay("01:00"),
+	                                          ParseTimeOfDay("03:00"), 20, 20),
+	                  InvalidInputException);
+
+	// A profile with the same start replaces the existing one, and adjacent windows don't overlap
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("22:00"), ParseTimeOfDay("03:00"),
+	                        /*bandwidth=*/30, /*burst=*/0);
+	config->SetQuotaProfile(TEST_FS_NAME, FileSystemOperation::READ, ParseTimeOfDay("03:00"), ParseTimeOfDay("04:00"),
+	                        /*bandwidth=*/40, /*burst=*/0);
+	auto schedule = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ)->schedule;
+	REQUIRE(schedule.size() == 2);
+	REQUIRE(schedule[0].start_minute == ParseTimeOfDay("03:00"));
+	REQUIRE(schedule[0].bandwidth == 40);
+	REQUIRE(schedule[1].end_minute == ParseTimeOfDay("03:00"));
+	REQUIRE(schedule[1].bandwidth == 30);
+}
@@ -1,5 +1,7 @@
 #include "catch/catch.hpp"
 
+#include "duckdb/common/limits.hpp"
+
 #include "mock_clock.hpp"
 #include "rate_limiter.hpp"
 
@@ -136,6 +138,25 @@ TEST_CASE("Rate limit - delay tolerance calculation", "[rate][quota]") {
 	REQUIRE(delay_tolerance == expected);
 }
 
+TEST_CASE("Rate limit - sub-nanosecond emission intervals are enforced", "[rate][quota]") {
+	// 3 GB/s -> a third of a nanosecond per byte
+	Quota quota(/*bandwidth_p=*/3000000000ULL, /*burst_p=*/0);
+	REQUIRE(quota.GetEmissionInterval() == Duration::zero());
+	REQUIRE(quota.GetEmissionNanos(3) == 1);
+	REQUIRE(quota.GetEmissionNanos(3000000000ULL) == 1000000000);
+
+	// Huge requests on slow quotas saturate instead of overflowing
+	Quota slow_quota(/*bandwidth_p=*/1, /*burst_p=*/0);
+	REQUIRE(slow_quota.GetEmissionNanos(NumericLimits<idx_t>::Maximum()) > 0);
+
+	auto clock = CreateMockClock();
+	auto limiter = RateLimiter::Direct(Quota(/*bandwidth_p=*/4000000000ULL, /*burst_p=*/0), clock);
+	REQUIRE(limiter->UntilNReady(4000000000ULL) == RateLimitResult::Allowed);
+	auto wait_info = limiter->TryAcquireImmediate(1);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == std::chrono::seconds(1));
+}
+
 TEST_CASE("Rate limit - high bandwidth low burst scenario", "[rate]") {
 	auto clock = CreateMockClock();
 	// Can only do 100 byte requests at a time, but they process quickly
@@ -262,3 +283,408 @@ TEST_CASE("Rate limit - delay tolerance for special cases", "[rate][quota]") {
 	Quota quota2(/*bandwidth_p=*/0, /*burst_p=*/100);
 	REQUIRE(quota2.GetDelayTolerance() == Duration::max());
 }
+
+TEST_CASE("Rate limit - parent limiter caps children together", "[rate][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	auto child1 = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/1000, clock, parent);
+	auto child2 = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/1000, clock, parent);
+	REQUIRE(child1->GetParent() == parent);
+
+	// Each child has plenty of capacity of its own, but both draw from the parent's tolerance window
+	REQUIRE_FALSE(child1->TryAcquireImmediate(100).has_value());
+	REQUIRE_FALSE(child2->TryAcquireImmediate(100).has_value());
+
+	auto wait_info = child1->TryAcquireImmediate(100);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration > Duration::zero());
+	REQUIRE(wait_info->wait_duration < Duration::max());
+}
+
+TEST_CASE("Rate limit - rejection by parent consumes nothing on the child", "[rate][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	auto child = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock, parent);
+
+	// Exhaust the parent directly
+	REQUIRE(parent->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(parent->UntilNReady(100) == RateLimitResult::Allowed);
+
+	// Every attempt passes the child but is rejected by the parent
+	for (int i = 0; i < 10; i++) {
+		REQUIRE(child->TryAcquireImmediate(100).has_value());
+	}
+
+	// Once the parent is replenished the child still has its full capacity
+	clock->Advance(std::chrono::seconds(2));
+	REQUIRE_FALSE(child->TryAcquireImmediate(100).has_value());
+	REQUIRE_FALSE(child->TryAcquireImmediate(100).has_value());
+}
+
+TEST_CASE("Rate limit - UntilNReady waits for the parent", "[rate][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	auto child = CreateRateLimiter(/*bandwidth_p=*/0, /*burst_p=*/1000, clock, parent);
+
+	TimePoint start_time = clock->Now();
+	for (int i = 0; i < 3; i++) {
+		REQUIRE(child->UntilNReady(100) == RateLimitResult::Allowed);
+	}
+
+	// The child has no rate of its own, so only the parent can have made it wait
+	REQUIRE(clock->Now() > start_time);
+}
+
+TEST_CASE("Rate limit - burst is checked on every level", "[rate][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/0, /*burst_p=*/100, clock);
+	auto child = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/1000, clock, parent);
+
+	REQUIRE(child->GetEffectiveBurst() == 100);
+	REQUIRE(child->UntilNReady(200) == RateLimitResult::InsufficientCapacity);
+
+	auto wait_info = child->TryAcquireImmediate(200);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == Duration::max());
+
+	// Unlimited burst on every level
+	auto unlimited = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/0, clock);
+	REQUIRE(unlimited->GetEffectiveBurst() == 0);
+}
+
+TEST_CASE("Rate limit - fair mode books slots in arrival order", "[rate][fair]") {
+	auto clock = CreateMockClock();
+	// 1 byte takes 10ms, and the tolerance window holds 100 bytes
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	TimePoint start_time = clock->Now();
+
+	// First two requests fit the tolerance window and start right away
+	REQUIRE(limiter->UntilNReadyFair(100) == RateLimitResult::Allowed);
+	REQUIRE(limiter->UntilNReadyFair(100) == RateLimitResult::Allowed);
+	REQUIRE(clock->Now() == start_time);
+
+	// Each later request sleeps exactly until its booked slot, without retrying
+	REQUIRE(limiter->UntilNReadyFair(100) == RateLimitResult::Allowed);
+	REQUIRE(clock->Now() == start_time + std::chrono::seconds(1));
+	REQUIRE(limiter->UntilNReadyFair(50) == RateLimitResult::Allowed);
+	REQUIRE(clock->Now() == start_time + std::chrono::seconds(2));
+	REQUIRE(limiter->UntilNReadyFair(50) == RateLimitResult::Allowed);
+	REQUIRE(clock->Now() == start_time + std::chrono::milliseconds(2500));
+
+	REQUIRE(limiter->UntilNReadyFair(200) == RateLimitResult::InsufficientCapacity);
+}
+
+TEST_CASE("Rate limit - fair mode bookings are seen by other acquirers", "[rate][fair]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+
+	REQUIRE(limiter->UntilNReadyFair(100) == RateLimitResult::Allowed);
+	REQUIRE(limiter->UntilNReadyFair(100) == RateLimitResult::Allowed);
+
+	// The booked capacity is gone for non-fair acquirers as well
+	auto wait_info = limiter->TryAcquireImmediate(100);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == std::chrono::seconds(1));
+}
+
+TEST_CASE("Rate limit - fair mode waits for the slowest level", "[rate][fair][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	auto child = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, parent);
+	TimePoint start_time = clock->Now();
+
+	for (int i = 0; i < 3; i++) {
+		REQUIRE(child->UntilNReadyFair(100) == RateLimitResult::Allowed);
+	}
+	REQUIRE(clock->Now() == start_time + std::chrono::seconds(1));
+}
+
+TEST_CASE("Rate limit - bounded wait admits only requests making the deadline", "[rate][bounded]") {
+	auto clock = CreateMockClock();
+	// 1 byte takes 10ms, and the tolerance window holds 100 bytes
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	TimePoint start_time = clock->Now();
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+
+	// The next request is only admitted after 1 second, so a closer deadline fails without waiting or consuming
+	auto wait_info = limiter->UntilNReadyBy(100, start_time + std::chrono::milliseconds(500));
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->ready_at == start_time + std::chrono::seconds(1));
+	REQUIRE(clock->Now() == start_time);
+	wait_info = limiter->TryAcquireImmediate(100);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->ready_at == start_time + std::chrono::seconds(1));
+
+	// A deadline the request can make waits as in blocking mode
+	REQUIRE_FALSE(limiter->UntilNReadyBy(100, start_time + std::chrono::seconds(1)).has_value());
+	REQUIRE(clock->Now() == start_time + std::chrono::seconds(1));
+
+	// Requests above the burst never make it
+	wait_info = limiter->UntilNReadyBy(200, TimePoint::max());
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == Duration::max());
+}
+
+TEST_CASE("Rate limit - batch requests leave headroom for interactive ones", "[rate][priority]") {
+	auto clock = CreateMockClock();
+	// Tolerance window of 1 second, batch requests may only use half of it
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100, RateLimitPriority::BATCH).has_value());
+	auto wait_info = limiter->TryAcquireImmediate(50, RateLimitPriority::BATCH);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == std::chrono::milliseconds(500));
+
+	// Interactive requests still get admitted right away
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100, RateLimitPriority::INTERACTIVE).has_value());
+
+	// Blocking batch requests wait for the interactive headroom to be restored as well
+	TimePoint start_time = clock->Now();
+	REQUIRE(limiter->UntilNReady(50, RateLimitPriority::BATCH) == RateLimitResult::Allowed);
+	REQUIRE(clock->Now() == start_time + std::chrono::milliseconds(1500));
+}
+
+TEST_CASE("Rate limit - Refund returns capacity on every level", "[rate][parent]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	auto child = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock, parent);
+
+	REQUIRE(child->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(child->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(child->TryAcquireImmediate(100).has_value());
+	REQUIRE(parent->TryAcquireImmediate(100).has_value());
+
+	child->Refund(100);
+	REQUIRE_FALSE(child->TryAcquireImmediate(100).has_value());
+}
+
+TEST_CASE("Rate limit - late refund gives back no more than a full bucket", "[rate][refund]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+
+	// 40 of the bytes were earned back before the refund
+	clock->Advance(std::chrono::milliseconds(400));
+	limiter->Refund(100);
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	REQUIRE(limiter->TryAcquireImmediate(1).has_value());
+
+	// Refunding an idle limiter gives nothing
+	clock->Advance(std::chrono::seconds(10));
+	limiter->Refund(1000);
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	REQUIRE(limiter->TryAcquireImmediate(1).has_value());
+}
+
+TEST_CASE("Rate limit - sharded limiter serves small requests from its lease", "[rate][shard]") {
+	auto clock = CreateMockClock();
+	// 1 byte takes 10ms, and the burst tolerates 1s of debt
+	Quota quota(/*bandwidth_p=*/100, /*burst_p=*/100);
+	auto limiter = RateLimiter::Direct(quota, clock, /*parent_p=*/nullptr, /*shard_lease_p=*/10);
+	REQUIRE(limiter->GetShardLease() == 10);
+
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(limiter->GetLeasedBytes() == 9);
+	for (idx_t idx = 0; idx < 9; ++idx) {
+		REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+	}
+	REQUIRE(limiter->GetLeasedBytes() == 0);
+
+	// Requests of at least a lease go to the limiter directly
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(10).has_value());
+	REQUIRE(limiter->GetLeasedBytes() == 0);
+
+	// Leased bytes are charged up front, so the overshoot is bounded by the lease
+	idx_t allowed = 11;
+	while (!limiter->TryAcquireImmediate(1).has_value()) {
+		++allowed;
+	}
+	REQUIRE(allowed >= 101);
+	REQUIRE(allowed <= 101 + 10);
+
+	// The long-term rate is unchanged
+	clock->Advance(std::chrono::milliseconds(100));
+	REQUIRE(limiter->UntilNReady(1) == RateLimitResult::Allowed);
+	REQUIRE(limiter->TryAcquireImmediate(20).has_value());
+}
+
+TEST_CASE("Rate limit - shard lease is capped at the burst", "[rate][shard]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/5, clock);
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/0, clock, parent, /*shard_lease_p=*/64);
+	REQUIRE(limiter->GetShardLease() == 5);
+
+	auto unsharded = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/0, clock, nullptr, /*shard_lease_p=*/1);
+	REQUIRE(unsharded->GetShardLease() == 0);
+	REQUIRE_FALSE(unsharded->TryAcquireImmediate(1).has_value());
+	REQUIRE(unsharded->GetLeasedBytes() == 0);
+}
+
+TEST_CASE("Rate limit - quota changes rescale the debt", "[rate]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/0, clock);
+
+	// 100 bytes at 100 bytes/sec leave a second of debt, which takes 100ms at 1000 bytes/sec
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	limiter->SetQuota(Quota(/*bandwidth_p=*/1000, /*burst_p=*/0));
+	REQUIRE(limiter->GetQuota().GetBandwidth() == 1000);
+
+	clock->Advance(std::chrono::milliseconds(90));
+	auto wait_info = limiter->TryAcquireImmediate(1);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == std::chrono::milliseconds(9));
+	clock->Advance(std::chrono::milliseconds(9));
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+
+	// Going back to the lower rate stretches the debt again, instead of granting a fresh bucket
+	limiter->SetQuota(Quota(/*bandwidth_p=*/100, /*burst_p=*/0));
+	REQUIRE(limiter->TryAcquireImmediate(1).has_value());
+}
+
+TEST_CASE("Rate limit - quota changes apply to the burst and shard lease", "[rate][shard]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/64);
+	REQUIRE(limiter->GetShardLease() == 64);
+
+	limiter->SetQuota(Quota(/*bandwidth_p=*/100, /*burst_p=*/10));
+	REQUIRE(limiter->GetEffectiveBurst() == 10);
+	REQUIRE(limiter->GetShardLease() == 10);
+	REQUIRE(limiter->TryAcquireImmediate(11).has_value());
+
+	limiter->SetQuota(Quota(/*bandwidth_p=*/100, /*burst_p=*/1000));
+	REQUIRE(limiter->GetShardLease() == 64);
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(11).has_value());
+}
+
+TEST_CASE("Rate limit - expired leases are given back", "[rate][shard]") {
+	auto clock = CreateMockClock();
+	// 1 byte takes 100ms, so hardly anything is replenished before the lease expires
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/10, /*burst_p=*/5, clock, nullptr, /*shard_lease_p=*/5);
+
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(limiter->GetLeasedBytes() == 4);
+	REQUIRE(limiter->ReturnExpiredLeases() == 0);
+	REQUIRE(limiter->GetLeasedBytes() == 4);
+
+	// Only 1 of the 5 leased bytes was spent, so after giving back the rest a full lease fits again
+	clock->Advance(std::chrono::nanoseconds(RateLimiter::LEASE_EXPIRY_NANOS));
+	REQUIRE(limiter->ReturnExpiredLeases() == 0);
+	clock->Advance(std::chrono::nanoseconds(1));
+	REQUIRE(limiter->ReturnExpiredLeases() == 4);
+	REQUIRE(limiter->GetLeasedBytes() == 0);
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(5).has_value());
+	REQUIRE(limiter->TryAcquireImmediate(2).has_value());
+}
+
+TEST_CASE("Rate limit - destroyed limiter gives its leases back to the parent", "[rate][shard]") {
+	auto clock = CreateMockClock();
+	auto parent = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/10, clock);
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/0, clock, parent, /*shard_lease_p=*/10);
+
+	// The lease takes 10 of the 11 bytes the parent admits back to back
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE_FALSE(parent->TryAcquireImmediate(1).has_value());
+	REQUIRE(parent->TryAcquireImmediate(1).has_value());
+
+	limiter.reset();
+	REQUIRE_FALSE(parent->TryAcquireImmediate(9).has_value());
+	REQUIRE(parent->TryAcquireImmediate(1).has_value());
+}
+
+TEST_CASE("Rate limit - partitions split the bandwidth exactly", "[rate][partition]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/0,
+	                                 /*state_p=*/nullptr, /*partition_count_p=*/3);
+	REQUIRE(limiter->GetPartitionCount() == 3);
+	REQUIRE(limiter->GetLocalPartitionIndex() < 3);
+	// Rounding leftovers go to one partition, and the burst is split like the bandwidth
+	REQUIRE(limiter->GetPartitionQuota(0).GetBandwidth() == 334);
+	REQUIRE(limiter->GetPartitionQuota(1).GetBandwidth() == 333);
+	REQUIRE(limiter->GetPartitionQuota(2).GetBandwidth() == 333);
+	REQUIRE(limiter->GetPartitionQuota(0).GetBurst() == 34);
+	REQUIRE(limiter->GetPartitionQuota(2).GetBurst() == 33);
+	REQUIRE(limiter->GetQuota().GetBandwidth() == 1000);
+	REQUIRE(limiter->GetQuota().GetBurst() == 100);
+
+	// Never a partition without a rate
+	auto slow = CreateRateLimiter(/*bandwidth_p=*/1, /*burst_p=*/0, clock, nullptr, /*shard_lease_p=*/0,
+	                              /*state_p=*/nullptr, /*partition_count_p=*/2);
+	REQUIRE(slow->GetPartitionQuota(0).GetBandwidth() == 1);
+	REQUIRE(slow->GetPartitionQuota(1).GetBandwidth() == 1);
+
+	auto unpartitioned = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/0, clock, nullptr, /*shard_lease_p=*/0,
+	                                       /*state_p=*/nullptr, /*partition_count_p=*/1);
+	REQUIRE(unpartitioned->GetPartitionCount() == 0);
+	REQUIRE_THROWS_AS(CreateRateLimiter(1000, 0, clock, nullptr, 0, nullptr, RateLimiter::MAX_PARTITIONS + 1),
+	                  InvalidInputException);
+}
+
+TEST_CASE("Rate limit - partitions admit the configured burst once", "[rate][partition]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/0,
+	                                 /*state_p=*/nullptr, /*partition_count_p=*/2);
+	// Only requests beyond the configured burst are rejected, not those beyond the partition's 50
+	REQUIRE(limiter->TryAcquireImmediate(101)->wait_duration == Duration::max());
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+
+	// The 100 bytes take 200ms at the partition's 500 bytes/sec, and its tolerance for another request is only the
+	// 100ms of its 50 bytes, so the next one waits 100ms, where the full burst would have admitted it right away
+	auto wait_info = limiter->TryAcquireImmediate(1);
+	REQUIRE(wait_info.has_value());
+	REQUIRE(wait_info->wait_duration == std::chrono::milliseconds(100));
+}
+
+TEST_CASE("Rate limit - busy partition takes over the bandwidth of idle ones", "[rate][partition]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/1000, clock, nullptr, /*shard_lease_p=*/0,
+	                                 /*state_p=*/nullptr, /*partition_count_p=*/2);
+	const auto local = limiter->GetLocalPartitionIndex();
+	const auto other = 1 - local;
+	REQUIRE(limiter->GetPartitionQuota(local).GetBandwidth() == 500);
+
+	// 100 bytes within 10ms saturate a share of 500 bytes/sec, so the next acquisition splits the bandwidth again,
+	// leaving the idle partition its minimum of 1/16
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	clock->Advance(std::chrono::nanoseconds(RateLimiter::PARTITION_REBALANCE_NANOS));
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(limiter->GetPartitionQuota(local).GetBandwidth() == 938);
+	REQUIRE(limiter->GetPartitionQuota(other).GetBandwidth() == 62);
+
+	// Quota changes keep the split
+	limiter->SetQuota(Quota(/*bandwidth_p=*/2000, /*burst_p=*/1000));
+	REQUIRE(limiter->GetPartitionQuota(local).GetBandwidth() == 1875);
+	REQUIRE(limiter->GetPartitionQuota(other).GetBandwidth() == 125);
+
+	// Once idle, the partitions go back to an even split
+	clock->Advance(std::chrono::nanoseconds(RateLimiter::PARTITION_REBALANCE_NANOS));
+	limiter->RebalancePartitions();
+	REQUIRE(limiter->GetPartitionQuota(local).GetBandwidth() == 1000);
+	REQUIRE(limiter->GetPartitionQuota(other).GetBandwidth() == 1000);
+}
+
+TEST_CASE("Rate limit - partitions carry the debt of their state", "[rate][partition]") {
+	auto clock = CreateMockClock();
+	auto state = make_shared_ptr<LocalRateLimiterState>();
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/0, state,
+	                                 /*partition_count_p=*/2);
+	// The full burst takes 200ms at the local partition's 500 bytes/sec, half of which is the limiter's debt
+	REQUIRE_FALSE(limiter->TryAcquireImmediate(100).has_value());
+	limiter.reset();
+	REQUIRE(state->GetTatNanos() == 100 * 1000 * 1000);
+
+	// A limiter rebuilt from the state starts with its burst used up
+	auto rebuilt = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/0, state);
+	REQUIRE_FALSE(rebuilt->TryAcquireImmediate(1).has_value());
+	REQUIRE(rebuilt->TryAcquireImmediate(1).has_value());
+
+	// A partitioned one starts from the same debt, here 101ms, 1ms beyond the 100ms of its partitions' 50 bytes
+	auto partitioned = CreateRateLimiter(/*bandwidth_p=*/1000, /*burst_p=*/100, clock, nullptr, /*shard_lease_p=*/0,
+	                                     state, /*partition_count_p=*/2);
+	REQUIRE(partitioned->TryAcquireImmediate(1).has_value());
+	clock->Advance(std::chrono::milliseconds(1));
+	REQUIRE_FALSE(partitioned->TryAcquireImmediate(50).has_value());
+	REQUIRE(partitioned->TryAcquireImmediate(1).has_value());
+}
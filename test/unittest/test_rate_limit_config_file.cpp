@@ -0,0 +1,115 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_config_file.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - S3FileSystem";
+
+// Returns the message of the exception thrown by parsing the content, empty if it parses.
+string GetParseError(const string &content) {
+	try {
+		ParseRateLimitConfigFile(content);
+	} catch (const InvalidInputException &ex) {
+		return ex.what();
+	}
+	return "";
+}
+
+} // namespace
+
+TEST_CASE("Rate limit config file - parses wrapped filesystems and settings", "[config_file]") {
+	const auto file = ParseRateLimitConfigFile("# Throttle S3 from the start\n"
+	                                           "wrap = S3FileSystem, HTTPFileSystem\n"
+	                                           "\n"
+	                                           "[RateLimitFileSystem - S3FileSystem]\n"
+	                                           "read.quota = 1000 non_blocking\n"
+	                                           "  READ.burst=200  \r\n"
+	                                           "; per request limits\n"
+	                                           "write.request_quota = 10\n"
+	                                           "[other]\n"
+	                                           "write.max_requests = 4\n"
+	                                           "write.max_wait_ms = 500\n"
+	                                           "write.quota = 100\n");
+	REQUIRE(file.wrap == vector<string> {"S3FileSystem", "HTTPFileSystem"});
+	REQUIRE(file.settings.size() == 6);
+
+	const auto &quota = file.settings[0];
+	REQUIRE(quota.filesystem_name == TEST_FS_NAME);
+	REQUIRE(quota.operation == FileSystemOperation::READ);
+	REQUIRE(quota.key == RateLimitConfigFileKey::QUOTA);
+	REQUIRE(quota.value == 1000);
+	REQUIRE(quota.mode == RateLimitMode::NON_BLOCKING);
+	REQUIRE(quota.line == 5);
+
+	REQUIRE(file.settings[1].key == RateLimitConfigFileKey::BURST);
+	REQUIRE(file.settings[1].value == 200);
+	REQUIRE(file.settings[2].operation == FileSystemOperation::WRITE);
+	REQUIRE(file.settings[2].key == RateLimitConfigFileKey::REQUEST_QUOTA);
+	REQUIRE(file.settings[3].filesystem_name == "other");
+	REQUIRE(file.settings[3].key == RateLimitConfigFileKey::MAX_REQUESTS);
+	REQUIRE(file.settings[4].key == RateLimitConfigFileKey::MAX_WAIT_MS);
+	// The mode defaults to blocking
+	REQUIRE(file.settings[5].mode == RateLimitMode::BLOCKING);
+}
+
+TEST_CASE("Rate limit config file - malformed lines name their line", "[config_file]") {
+	REQUIRE(GetParseError("[fs]\nread.quota = 10\n").empty());
+	REQUIRE(StringUtil::Contains(GetParseError("read.quota = 10\n"), "line 1"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\n\nread.speed = 10\n"), "line 3: unknown key"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.quota = -1\n"), "expected a non-negative integer"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.quota = 99999999999999999999\n"), "out of range"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.max_wait_ms = 18446744073709551\n"), "out of range"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.burst = 10 blocking\n"), "only a quota takes a mode"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.quota\n"), "expected '<key> = <value>'"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nquota = 10\n"), "expected '<operation>.<key>'"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs\n"), "expected '[<filesystem>]'"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nrename.quota = 10\n"), "unknown operation"));
+	REQUIRE(StringUtil::Contains(GetParseError("[fs]\nread.quota = 10 fast\n"), "unknown mode"));
+}
+
+TEST_CASE("Rate limit config file - errors don't echo the file's content", "[config_file]") {
+	// The setting may point at any readable file, whose first line must not leak through the error
+	const vector<string> contents {"secret\n",
+	                               "[secret\n",
+	                               "secret = 1\n",
+	                               "[fs]\nsecret = 1\n",
+	                               "[fs]\nsecret.quota = 1\n",
+	                               "[fs]\nread.secret = 1\n",
+	                               "[fs]\nread.quota = secret\n",
+	                               "[fs]\nread.quota = 1 secret\n"};
+	for (const auto &content : contents) {
+		const auto error = GetParseError(content);
+		REQUIRE(StringUtil::Contains(error, "line"));
+		REQUIRE_FALSE(StringUtil::Contains(error, "secret"));
+	}
+}
+
+TEST_CASE("Rate limit config file - settings are applied in file order", "[config_file]") {
+	const auto file = ParseRateLimitConfigFile("[RateLimitFileSystem - S3FileSystem]\n"
+	                                           "read.quota = 1000\n"
+	                                           "read.burst = 200\n"
+	                                           "read.max_requests = 4\n"
+	                                           "read.max_wait_ms = 250\n"
+	                                           "read.request_quota = 10\n"
+	                                           "read.quota = 2000 non_blocking\n");
+	auto config = make_shared_ptr<RateLimitConfig>();
+	ApplyRateLimitConfigFile(file, *config);
+
+	auto read_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(read_config != nullptr);
+	REQUIRE(read_config->quota == 2000);
+	REQUIRE(read_config->mode == RateLimitMode::NON_BLOCKING);
+	REQUIRE(read_config->burst == 200);
+	REQUIRE(read_config->max_requests == 4);
+	REQUIRE(read_config->max_wait == std::chrono::milliseconds(250));
+	REQUIRE(read_config->request_quota == 10);
+
+	// The config's own checks still apply
+	const auto invalid = ParseRateLimitConfigFile("[fs]\nstat.burst = 10\n");
+	REQUIRE_THROWS_AS(ApplyRateLimitConfigFile(invalid, *config), InvalidInputException);
+}
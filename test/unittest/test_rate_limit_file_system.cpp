@@ -6,6 +6,7 @@
 #include "rate_limit_config.hpp"
 #include "rate_limit_file_system.hpp"
 #include "scoped_directory.hpp"
+#include "test_file_util.hpp"
 
 using namespace duckdb;
 
@@ -15,16 +16,29 @@ constexpr const char *TEST_DIR = "/tmp/test_rate_limit_fs";
 // Wrapped filesystem name used for config lookups
 constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
 
-// Helper to create a temporary file with content inside the test directory
-string CreateTempFile(const string &dir, const string &filename, const string &content) {
-	string path = StringUtil::Format("%s/%s", dir, filename);
-	LocalFileSystem fs;
-	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
-	fs.Write(*handle, const_cast<char *>(content.c_str()), static_cast<int64_t>(content.size()));
-	handle->Sync();
-	handle->Close();
-	return path;
-}
+class FileSizeCountingFileSystem : public LocalFileSystem {
+public:
+	int64_t GetFileSize(FileHandle &handle) override {
+		++get_file_size_count;
+		return LocalFileSystem::GetFileSize(handle);
+	}
+
+	idx_t get_file_size_count = 0;
+};
+
+// Reports its own path handling, so tests can tell whether the wrapper forwards it.
+class CustomPathFileSystem : public LocalFileSystem {
+public:
+	string GetHomeDirectory() override {
+		return "/custom/home";
+	}
+	string ExpandPath(const string &path) override {
+		return StringUtil::Replace(path, "~", GetHomeDirectory());
+	}
+	bool IsManuallySet() override {
+		return true;
+	}
+};
 
 } // namespace
 
@@ -345,3 +359,55 @@ TEST_CASE("RateLimitFileSystem - open file with blocking mode", "[rate_limit_fs]
 		REQUIRE(handle != nullptr);
 	}
 }
+
+TEST_CASE("RateLimitFileSystem - positional reads reuse the cached file size", "[rate_limit_fs]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000000, RateLimitMode::BLOCKING);
+
+	auto inner_fs = make_uniq<FileSizeCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content = "0123456789";
+	string temp_path = CreateTempFile(test_dir.GetPath(), "cached_size.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	string buffer(10, '\0');
+	for (idx_t i = 0; i < 10; i++) {
+		fs.Read(*handle, buffer.data(), 1, i);
+		REQUIRE(buffer[0] == test_content[i]);
+	}
+	REQUIRE(counting_fs.get_file_size_count == 1);
+
+	// Writing through the handle invalidates the cached size, so reading the new tail works.
+	string tail = "abc";
+	fs.Write(*handle, tail.data(), static_cast<int64_t>(tail.size()), 10);
+	fs.Read(*handle, buffer.data(), 3, 10);
+	REQUIRE(buffer.substr(0, 3) == tail);
+	REQUIRE(counting_fs.get_file_size_count == 2);
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - path handling and handle state come from the inner filesystem", "[rate_limit_fs]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 1, RateLimitMode::NON_BLOCKING);
+	RateLimitFileSystem fs(make_uniq<CustomPathFileSystem>(), config);
+
+	// None of these are charged, so they keep working at a quota that rejects a second STAT.
+	for (idx_t i = 0; i < 3; i++) {
+		REQUIRE(fs.GetHomeDirectory() == "/custom/home");
+		REQUIRE(fs.ExpandPath("~/data.csv") == "/custom/home/data.csv");
+		REQUIRE(fs.IsManuallySet());
+	}
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "forwarded.txt", "abc");
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	auto &inner_handle = handle->Cast<RateLimitFileHandle>().GetInnerHandle();
+	REQUIRE(handle->GetFileCompressionType() == inner_handle.GetFileCompressionType());
+	handle->Close();
+}
@@ -8,6 +8,7 @@
 #include "rate_limit_config.hpp"
 #include "rate_limit_file_system.hpp"
 #include "scoped_directory.hpp"
+#include "test_file_util.hpp"
 
 #include <atomic>
 
@@ -19,16 +20,13 @@ namespace {
 constexpr const char *TEST_DIR = "/tmp/test_rate_limit_fs_mock";
 constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
 
-// Helper to create a temporary file with content inside the test directory
-string CreateTempFile(const string &dir, const string &filename, const string &content) {
-	string path = StringUtil::Format("%s/%s", dir, filename);
-	LocalFileSystem fs;
-	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
-	fs.Write(*handle, const_cast<char *>(content.c_str()), static_cast<int64_t>(content.size()));
-	handle->Sync();
-	handle->Close();
-	return path;
-}
+// Fails every positional read, as a backend error would.
+class FailingReadFileSystem : public LocalFileSystem {
+public:
+	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		throw IOException("Read failed");
+	}
+};
 
 } // namespace
 
@@ -387,3 +385,847 @@ TEST_CASE("RateLimitFileSystem - MockClock: concurrent reads with time advance",
 
 	handle->Close();
 }
+
+// ==========================================================================
+// Config snapshot refresh tests
+// ==========================================================================
+
+TEST_CASE("RateLimitFileSystem - MockClock: config changes after first I/O are picked up",
+          "[rate_limit_fs][mock_clock][snapshot]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "snapshot_refresh.txt", "content");
+
+	// No config yet: unlimited, and the empty snapshot gets cached.
+	for (int i = 0; i < 5; i++) {
+		REQUIRE(fs.FileExists(temp_path));
+	}
+
+	// Setting a quota bumps the config version, so the cached snapshot must be refreshed.
+	const auto version_before = config->GetVersion();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 1, RateLimitMode::NON_BLOCKING);
+	REQUIRE(config->GetVersion() > version_before);
+
+	REQUIRE(fs.FileExists(temp_path));
+	REQUIRE(fs.FileExists(temp_path));
+	REQUIRE_THROWS_AS(fs.FileExists(temp_path), IOException);
+
+	// Clearing the config lifts the limit again.
+	config->ClearConfig(TEST_FS_NAME, FileSystemOperation::STAT);
+	for (int i = 0; i < 5; i++) {
+		REQUIRE(fs.FileExists(temp_path));
+	}
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: filesystem snapshot covers all operations",
+          "[rate_limit_fs][mock_clock][snapshot]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::BLOCKING);
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::STAT, 2);
+	config->SetQuota("OtherFS", FileSystemOperation::WRITE, 100, RateLimitMode::BLOCKING);
+
+	auto snapshot = config->GetFilesystemSnapshot(config->InternFilesystem(TEST_FS_NAME));
+	REQUIRE(snapshot->version == config->GetVersion());
+	REQUIRE(snapshot->Get(FileSystemOperation::READ).rate_limiter != nullptr);
+	REQUIRE(snapshot->Get(FileSystemOperation::READ).mode == RateLimitMode::BLOCKING);
+	REQUIRE(snapshot->Get(FileSystemOperation::STAT).rate_limiter == nullptr);
+	REQUIRE(snapshot->Get(FileSystemOperation::STAT).semaphore != nullptr);
+	REQUIRE(snapshot->Get(FileSystemOperation::WRITE).rate_limiter == nullptr);
+	REQUIRE(snapshot->Get(FileSystemOperation::LIST).rate_limiter == nullptr);
+}
+
+// ==========================================================================
+// Split mode tests
+// ==========================================================================
+
+TEST_CASE("RateLimitFileSystem - MockClock: split mode chunks reads larger than burst",
+          "[rate_limit_fs][mock_clock][split]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// 10 bytes/sec rate, 10 byte burst: a 36 byte read is split into 4 chunks.
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::SPLIT);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	string temp_path = CreateTempFile(test_dir.GetPath(), "split_read.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(test_content.size(), '\0');
+
+	const auto start = mock_clock->Now();
+	fs.Read(*handle, buffer.data(), static_cast<int64_t>(test_content.size()), 0);
+	REQUIRE(buffer == test_content);
+
+	// The tolerance covers the first 20 bytes, the remaining 16 bytes have to wait for tokens.
+	REQUIRE(mock_clock->Now() - start >= 1s);
+
+	// Streaming reads are split as well, and stop at end of file.
+	string stream_buffer(100, '\0');
+	auto bytes_read = fs.Read(*handle, stream_buffer.data(), 100);
+	REQUIRE(bytes_read == static_cast<int64_t>(test_content.size()));
+	REQUIRE(stream_buffer.substr(0, test_content.size()) == test_content);
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: split mode issues positional chunks concurrently",
+          "[rate_limit_fs][mock_clock][split]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// A 36 byte read is split into 4 chunks, of which at most 3 may be in flight.
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::SPLIT);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::READ, 3);
+
+	auto inner_fs = make_uniq<SlowReadFileSystem>();
+	auto &slow_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	string temp_path = CreateTempFile(test_dir.GetPath(), "split_concurrent.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(test_content.size(), '\0');
+	const auto start = mock_clock->Now();
+	fs.Read(*handle, buffer.data(), static_cast<int64_t>(test_content.size()), 0);
+	REQUIRE(buffer == test_content);
+	REQUIRE(slow_fs.read_count == 4);
+	REQUIRE(slow_fs.max_in_flight > 1);
+	REQUIRE(slow_fs.max_in_flight <= 3);
+	// Every chunk still waits for its own tokens
+	REQUIRE(mock_clock->Now() - start >= 1s);
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: split mode chunks writes larger than burst",
+          "[rate_limit_fs][mock_clock][split]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 10, RateLimitMode::SPLIT);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::WRITE, 10);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = test_dir.GetPath() + "/split_write.txt";
+	string content = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	{
+		auto handle =
+		    fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		auto bytes_written = fs.Write(*handle, content.data(), static_cast<int64_t>(content.size()));
+		REQUIRE(bytes_written == static_cast<int64_t>(content.size()));
+		handle->Close();
+	}
+
+	LocalFileSystem local_fs;
+	auto handle = local_fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(content.size(), '\0');
+	local_fs.Read(*handle, buffer.data(), static_cast<int64_t>(content.size()), 0);
+	REQUIRE(buffer == content);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: blocking mode still rejects reads larger than burst",
+          "[rate_limit_fs][mock_clock][split]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	string temp_path = CreateTempFile(test_dir.GetPath(), "blocking_oversized.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(test_content.size(), '\0');
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), static_cast<int64_t>(test_content.size()), 0), IOException);
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: bounded mode waits up to the max wait", "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// 1 byte takes 100ms, and a call may wait up to 500ms
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::BOUNDED);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetMaxWait(TEST_FS_NAME, FileSystemOperation::READ, 500ms);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "bounded.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	// Exhaust the tolerance window: the next read is only admitted after 1s
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	const auto start_time = mock_clock->Now();
+
+	// The read can't make the deadline, so it fails right away and consumes nothing
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 10, 0), IOException);
+	REQUIRE(mock_clock->Now() == start_time);
+
+	// 600ms later, the wait of 400ms fits the max wait
+	mock_clock->Advance(600ms);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	REQUIRE(mock_clock->Now() - start_time == 1s);
+
+	// The next read again waits 1s, which only the default max wait allows
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 10, 0), IOException);
+	config->SetMaxWait(TEST_FS_NAME, FileSystemOperation::READ, Duration::zero());
+	fs.Read(*handle, buffer.data(), 10, 0);
+	REQUIRE(mock_clock->Now() - start_time == 2s);
+
+	// Reads larger than the burst never make the deadline
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 20, 0), IOException);
+
+	auto snapshot = config->GetAllStats()[0]->Get(FileSystemOperation::READ).GetSnapshot();
+	REQUIRE(snapshot.rate_rejections == 2);
+	REQUIRE(snapshot.burst_rejections == 1);
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: limiter group is shared by reads and writes",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// 10 bytes/sec host budget with a 20 byte burst, charged by both reads and writes
+	config->SetGroup("host", 10, 20, "");
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::READ, "host");
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::WRITE, "host");
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000, RateLimitMode::NON_BLOCKING);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 1000, RateLimitMode::NON_BLOCKING);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content(100, 'x');
+	string temp_path = CreateTempFile(test_dir.GetPath(), "group_test.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	string buffer(100, '\0');
+
+	fs.Read(*handle, buffer.data(), 20, 0);
+	fs.Write(*handle, buffer.data(), 20, 0);
+
+	// Both operations have capacity of their own left, but the shared group is exhausted
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 1, 0), IOException);
+	REQUIRE_THROWS_AS(fs.Write(*handle, buffer.data(), 1, 0), IOException);
+
+	// Requests larger than the group burst can never pass
+	mock_clock->Advance(std::chrono::seconds(10));
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 21, 0), IOException);
+	fs.Read(*handle, buffer.data(), 20, 0);
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: limiter group configuration", "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+
+	config->SetGroup("host", 1000, 0, "");
+	config->SetGroup("fs", 0, 100, "host");
+	REQUIRE_THROWS_AS(config->SetGroup("other", 1000, 0, "missing"), InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetGroup("host", 1000, 0, "fs"), InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::READ, "missing"),
+	                  InvalidInputException);
+
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::READ, "fs");
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(snapshot.rate_limiter);
+	REQUIRE(snapshot.mode == RateLimitMode::BLOCKING);
+	REQUIRE(snapshot.rate_limiter->GetParent());
+	REQUIRE(snapshot.rate_limiter->GetEffectiveBurst() == 100);
+
+	// Referenced groups can't be removed
+	REQUIRE_THROWS_AS(config->SetGroup("fs", 0, 0, ""), InvalidInputException);
+	REQUIRE_THROWS_AS(config->SetGroup("host", 0, 0, ""), InvalidInputException);
+
+	// Unassigning the only setting removes the config entirely
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::READ, "");
+	REQUIRE(config->GetAllConfigs().empty());
+	config->SetGroup("fs", 0, 0, "");
+	config->SetGroup("host", 0, 0, "");
+	REQUIRE(config->GetAllGroups().empty());
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: connection limit applies on top of filesystem limit",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// The filesystem allows way more than the connection
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000000, RateLimitMode::NON_BLOCKING);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string test_content(100, 'x');
+	string temp_path = CreateTempFile(test_dir.GetPath(), "scope_test.txt", test_content);
+
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	auto &rate_limit_handle = handle->Cast<RateLimitFileHandle>();
+	REQUIRE_FALSE(rate_limit_handle.GetScope().connection_limiter);
+
+	// Two handles of one connection share its 10 bytes/sec budget
+	RateLimitClientState client_state;
+	auto connection_limiter = client_state.GetConnectionLimiter(10, mock_clock);
+	REQUIRE(client_state.GetConnectionLimiter(10, mock_clock) == connection_limiter);
+	RateLimitScope scope;
+	scope.connection_limiter = connection_limiter;
+	rate_limit_handle.SetScope(scope);
+	auto other_handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	other_handle->Cast<RateLimitFileHandle>().SetScope(scope);
+
+	string buffer(100, '\0');
+	TimePoint start_time = mock_clock->Now();
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*other_handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+
+	// The connection budget waits even though the filesystem is non-blocking, and the filesystem limit never kicks in.
+	// Each read after the first waits 1 second, minus the 100ms tolerance of one byte.
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(1900));
+
+	handle->Close();
+	other_handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: connection budget is refunded when the filesystem rejects",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "refund_test.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+
+	RateLimitScope scope;
+	scope.connection_limiter = CreateRateLimiter(/*bandwidth_p=*/10, /*burst_p=*/0, mock_clock);
+	handle->Cast<RateLimitFileHandle>().SetScope(scope);
+
+	string buffer(100, '\0');
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 20, 0), IOException);
+
+	// Nothing was charged to the connection
+	REQUIRE_FALSE(scope.connection_limiter->TryAcquireImmediate(10).has_value());
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: request quota bounds small reads the byte quota allows",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// The byte quota is generous, the request quota allows 10 calls/sec
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000000, RateLimitMode::BLOCKING);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "request_quota.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	const auto start_time = mock_clock->Now();
+	for (int idx = 0; idx < 12; ++idx) {
+		fs.Read(*handle, buffer.data(), 1, 0);
+	}
+	// Calls are spaced 100ms apart, except for the tolerance of one call
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(1000));
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: non-blocking request quota rejects and refunds",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 1);
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	string temp_path = CreateTempFile(test_dir.GetPath(), "request_quota.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	// A read larger than the burst is rejected by the byte limiter, and its request token is given back
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 20, 0), IOException);
+	fs.Read(*handle, buffer.data(), 1, 0);
+	fs.Read(*handle, buffer.data(), 1, 0);
+
+	// Plenty of bytes left, but no request tokens
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 1, 0), IOException);
+
+	mock_clock->Advance(std::chrono::seconds(1));
+	fs.Read(*handle, buffer.data(), 1, 0);
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: request quota configuration", "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	REQUIRE_THROWS_AS(config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::STAT, 10), InvalidInputException);
+
+	// A request quota alone makes the operation blocking
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 100);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->mode == RateLimitMode::BLOCKING);
+	REQUIRE(op_config->request_quota == 100);
+	REQUIRE(op_config->request_rate_limiter);
+	REQUIRE_FALSE(op_config->rate_limiter);
+
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::WRITE);
+	REQUIRE(snapshot.request_rate_limiter == op_config->request_rate_limiter);
+	REQUIRE_FALSE(snapshot.rate_limiter);
+
+	// Removing it removes the config
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE) == nullptr);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: path group paces calls under its prefix", "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// 10 calls/sec for metadata lookups under the hot prefix, unconfigured stats block
+	const string hot_prefix = StringUtil::Format("%s/hot", test_dir.GetPath());
+	config->SetGroup("hot", 10, 0, "");
+	config->SetPathGroup(hot_prefix, FileSystemOperation::STAT, "hot");
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	const auto start_time = mock_clock->Now();
+	for (int idx = 0; idx < 12; ++idx) {
+		fs.FileExists(StringUtil::Format("%s/file_%d", hot_prefix, idx));
+	}
+	// Calls are spaced 100ms apart, except for the tolerance of one call
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(1000));
+
+	// Paths outside the prefix aren't charged
+	for (int idx = 0; idx < 12; ++idx) {
+		fs.FileExists(StringUtil::Format("%s/cold/file_%d", test_dir.GetPath(), idx));
+	}
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(1000));
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: handles keep the path group they were opened with",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000000, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 1000000);
+
+	// 1 read call/sec on the hot file
+	string hot_path = CreateTempFile(test_dir.GetPath(), "hot.txt", string(100, 'x'));
+	string cold_path = CreateTempFile(test_dir.GetPath(), "cold.txt", string(100, 'x'));
+	config->SetGroup("hot", 1, 0, "");
+	config->SetPathGroup(hot_path, FileSystemOperation::READ, "hot");
+
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto hot_handle = fs.OpenFile(hot_path, FileOpenFlags::FILE_FLAGS_READ);
+	auto cold_handle = fs.OpenFile(cold_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	fs.Read(*hot_handle, buffer.data(), 10, 0);
+	fs.Read(*hot_handle, buffer.data(), 10, 0);
+	REQUIRE_THROWS_AS(fs.Read(*hot_handle, buffer.data(), 10, 0), IOException);
+	for (int idx = 0; idx < 10; ++idx) {
+		fs.Read(*cold_handle, buffer.data(), 10, 0);
+	}
+
+	// Removing the rule doesn't affect handles which are already open
+	config->SetPathGroup(hot_path, FileSystemOperation::READ, "");
+	REQUIRE_THROWS_AS(fs.Read(*hot_handle, buffer.data(), 10, 0), IOException);
+	auto reopened_handle = fs.OpenFile(hot_path, FileOpenFlags::FILE_FLAGS_READ);
+	fs.Read(*reopened_handle, buffer.data(), 10, 0);
+
+	mock_clock->Advance(std::chrono::seconds(1));
+	fs.Read(*hot_handle, buffer.data(), 10, 0);
+
+	hot_handle->Close();
+	cold_handle->Close();
+	reopened_handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: path group configuration", "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	REQUIRE_THROWS_AS(config->SetPathGroup("s3://bucket/", FileSystemOperation::READ, "missing"),
+	                  InvalidInputException);
+	config->SetGroup("bucket", 100, 0, "");
+	REQUIRE_THROWS_AS(config->SetPathGroup("", FileSystemOperation::READ, "bucket"), InvalidInputException);
+
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::READ, "bucket");
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::LIST, "bucket");
+	auto path_groups = config->GetAllPathGroups();
+	REQUIRE(path_groups.size() == 2);
+	REQUIRE(path_groups[0].prefix == "s3://bucket/");
+	REQUIRE(path_groups[0].operation == FileSystemOperation::READ);
+	REQUIRE(path_groups[0].group_name == "bucket");
+
+	auto snapshot = config->GetFilesystemSnapshot(config->InternFilesystem(TEST_FS_NAME));
+	REQUIRE(snapshot->path_limiters);
+	REQUIRE(snapshot->path_limiters->Match("s3://bucket/key", FileSystemOperation::LIST));
+	REQUIRE_FALSE(snapshot->path_limiters->Match("s3://bucket/key", FileSystemOperation::WRITE));
+
+	// Referenced groups can't be removed
+	REQUIRE_THROWS_AS(config->SetGroup("bucket", 0, 0, ""), InvalidInputException);
+
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::READ, "");
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::LIST, "");
+	REQUIRE(config->GetAllPathGroups().empty());
+	REQUIRE_FALSE(config->GetFilesystemSnapshot(config->InternFilesystem(TEST_FS_NAME))->path_limiters);
+	config->SetGroup("bucket", 0, 0, "");
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: filesystem names are interned to stable ids",
+          "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	const auto id = config->InternFilesystem(TEST_FS_NAME);
+	const auto other_id = config->InternFilesystem("other");
+	REQUIRE(id != other_id);
+	REQUIRE(config->InternFilesystem(TEST_FS_NAME) == id);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::BLOCKING);
+	REQUIRE(config->GetFilesystemSnapshot(id)->Get(FileSystemOperation::READ).rate_limiter);
+	REQUIRE_FALSE(config->GetFilesystemSnapshot(other_id)->Get(FileSystemOperation::READ).rate_limiter);
+
+	// Clearing every config keeps ids, which wrapped filesystems go on using
+	config->ClearAll();
+	REQUIRE_FALSE(config->GetFilesystemSnapshot(id)->Get(FileSystemOperation::READ).rate_limiter);
+	REQUIRE(config->InternFilesystem(TEST_FS_NAME) == id);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::BLOCKING);
+	REQUIRE(config->GetFilesystemSnapshot(id)->Get(FileSystemOperation::READ).rate_limiter);
+	REQUIRE(config->GetAllConfigs().size() == 1);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: configured operations track configs and path rules",
+          "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	auto configured = config->GetConfiguredOperations(config->InternFilesystem(TEST_FS_NAME));
+	auto other_configured = config->GetConfiguredOperations(config->InternFilesystem("other"));
+	REQUIRE(configured->load() == 0);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::BLOCKING);
+	REQUIRE(configured->load() == GetOperationBit(FileSystemOperation::READ));
+	REQUIRE(other_configured->load() == 0);
+
+	// Path rules apply to every filesystem
+	config->SetGroup("bucket", 100, 0, "");
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::STAT, "bucket");
+	REQUIRE(configured->load() ==
+	        (GetOperationBit(FileSystemOperation::READ) | GetOperationBit(FileSystemOperation::STAT)));
+	REQUIRE(other_configured->load() == GetOperationBit(FileSystemOperation::STAT));
+
+	config->SetPathGroup("s3://bucket/", FileSystemOperation::STAT, "");
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 0, RateLimitMode::BLOCKING);
+	REQUIRE(configured->load() == 0);
+	REQUIRE(other_configured->load() == 0);
+
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::WRITE, 100);
+	REQUIRE(configured->load() == GetOperationBit(FileSystemOperation::WRITE));
+	config->ClearAll();
+	REQUIRE(configured->load() == 0);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: shard lease rebuilds the rate limiter", "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetShardLease(TEST_FS_NAME, FileSystemOperation::STAT, 16);
+	auto only_lease = config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(only_lease != nullptr);
+	REQUIRE(only_lease->shard_lease == 16);
+	REQUIRE_FALSE(only_lease->rate_limiter);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 1000, RateLimitMode::BLOCKING);
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(snapshot.rate_limiter);
+	REQUIRE(snapshot.rate_limiter->GetShardLease() == 16);
+
+	config->SetShardLease(TEST_FS_NAME, FileSystemOperation::STAT, 0);
+	snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(snapshot.rate_limiter->GetShardLease() == 0);
+
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 0, RateLimitMode::BLOCKING);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) == nullptr);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: partitions rebuild the rate limiter", "[rate_limit_fs][mock_clock]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 1000, RateLimitMode::BLOCKING);
+	config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, 2);
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(snapshot.rate_limiter->GetPartitionCount() == 2);
+
+	// Quota changes split the new bandwidth
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 2000, RateLimitMode::BLOCKING);
+	REQUIRE(snapshot.rate_limiter->GetPartitionQuota(0).GetBandwidth() == 1000);
+
+	// A single partition is none
+	config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, 1);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT)->partitions == 0);
+	snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT);
+	REQUIRE(snapshot.rate_limiter->GetPartitionCount() == 0);
+	REQUIRE_THROWS_AS(config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, RateLimiter::MAX_PARTITIONS + 1),
+	                  InvalidInputException);
+
+	// Partitions alone keep the config
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 0, RateLimitMode::BLOCKING);
+	config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, 4);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) != nullptr);
+	config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) == nullptr);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: quota changes update the rate limiter in place",
+          "[rate_limit_fs][mock_clock]") {
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 100, RateLimitMode::NON_BLOCKING);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetGroup("host", 1000, 0, "");
+	auto limiter = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).rate_limiter;
+	auto request_limiter = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).request_rate_limiter;
+	auto group_limiter = config->GetAllGroups()[0].rate_limiter;
+
+	// Holders of the limiters, such as open handles, see the new limits right away
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 200, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 50);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 20);
+	config->SetGroup("host", 2000, 0, "");
+	auto snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(snapshot.rate_limiter == limiter);
+	REQUIRE(limiter->GetQuota().GetBandwidth() == 200);
+	REQUIRE(limiter->GetQuota().GetBurst() == 50);
+	REQUIRE(snapshot.request_rate_limiter == request_limiter);
+	REQUIRE(request_limiter->GetQuota().GetBandwidth() == 20);
+	REQUIRE(config->GetAllGroups()[0].rate_limiter == group_limiter);
+	REQUIRE(group_limiter->GetQuota().GetBandwidth() == 2000);
+
+	// Assigning a group changes the parent, which needs a new limiter
+	config->SetGroupAssignment(TEST_FS_NAME, FileSystemOperation::READ, "host");
+	snapshot = config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(snapshot.rate_limiter != limiter);
+	REQUIRE(snapshot.rate_limiter->GetParent() == group_limiter);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: file sync is charged as sync", "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::SYNC, 1, RateLimitMode::NON_BLOCKING);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto temp_path = CreateTempFile(test_dir.GetPath(), "sync.txt", "data");
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_WRITE);
+
+	// Without a burst, two calls pass back to back
+	fs.FileSync(*handle);
+	fs.FileSync(*handle);
+	REQUIRE_THROWS_AS(fs.FileSync(*handle), IOException);
+	mock_clock->Advance(1s);
+	fs.FileSync(*handle);
+
+	auto stats = config->GetOrCreateStats(TEST_FS_NAME);
+	REQUIRE(stats->Get(FileSystemOperation::SYNC).GetSnapshot().ops_admitted == 3);
+	REQUIRE(stats->Get(FileSystemOperation::WRITE).GetSnapshot().ops_admitted == 0);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: trim is charged as a write call", "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 1, RateLimitMode::NON_BLOCKING);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto temp_path = CreateTempFile(test_dir.GetPath(), "trim.txt", "data");
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_WRITE);
+
+	fs.Trim(*handle, 0, 4);
+	fs.Trim(*handle, 0, 4);
+	REQUIRE_THROWS_AS(fs.Trim(*handle, 0, 4), IOException);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: move is charged the source size as write bytes",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	// 100 bytes/sec, 100 byte burst, so moving 1000 bytes leaves 9s of debt
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::WRITE, 100, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::WRITE, 100);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto source = CreateTempFile(test_dir.GetPath(), "move_source.txt", string(1000, 'x'));
+	auto target = test_dir.GetPath() + "/move_target.txt";
+
+	fs.MoveFile(source, target);
+	REQUIRE(fs.FileExists(target));
+	auto stats = config->GetOrCreateStats(TEST_FS_NAME);
+	REQUIRE(stats->Get(FileSystemOperation::WRITE).GetSnapshot().bytes_admitted == 100);
+	// The size lookup plus the FileExists above
+	REQUIRE(stats->Get(FileSystemOperation::STAT).GetSnapshot().ops_admitted == 2);
+
+	auto handle = fs.OpenFile(target, FileOpenFlags::FILE_FLAGS_WRITE);
+	string buffer(10, 'y');
+	REQUIRE_THROWS_AS(fs.Write(*handle, const_cast<char *>(buffer.data()), 10, 0), IOException);
+	mock_clock->Advance(8s);
+	REQUIRE_THROWS_AS(fs.Write(*handle, const_cast<char *>(buffer.data()), 10, 0), IOException);
+	mock_clock->Advance(1s);
+	fs.Write(*handle, const_cast<char *>(buffer.data()), 10, 0);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: move without a byte limit is one write call",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::WRITE, 1);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	auto source = CreateTempFile(test_dir.GetPath(), "move_source.txt", string(1000, 'x'));
+	fs.MoveFile(source, test_dir.GetPath() + "/move_target.txt");
+
+	auto stats = config->GetOrCreateStats(TEST_FS_NAME);
+	REQUIRE(stats->Get(FileSystemOperation::WRITE).GetSnapshot().ops_admitted == 1);
+	REQUIRE(stats->Get(FileSystemOperation::WRITE).GetSnapshot().bytes_admitted == 1);
+	REQUIRE(stats->Get(FileSystemOperation::STAT).GetSnapshot().ops_admitted == 0);
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: short streaming reads refund the bytes past the end",
+          "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 20);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "short_read.txt", "abcde");
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+
+	string buffer(100, '\0');
+	REQUIRE(fs.Read(*handle, buffer.data(), 20) == 5);
+	// Reading at the end of the file transfers nothing, so it's refunded in full
+	REQUIRE(fs.Read(*handle, buffer.data(), 20) == 0);
+
+	// Only the 5 bytes transferred are charged, so a full burst fits and leaves their debt
+	auto rate_limiter = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ)->rate_limiter;
+	REQUIRE_FALSE(rate_limiter->TryAcquireImmediate(20).has_value());
+	REQUIRE(rate_limiter->TryAcquireImmediate(1).has_value());
+
+	auto stats = config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot();
+	REQUIRE(stats.ops_admitted == 2);
+	REQUIRE(stats.bytes_admitted == 5);
+
+	handle->Close();
+}
+
+TEST_CASE("RateLimitFileSystem - MockClock: failed inner calls refund their bytes", "[rate_limit_fs][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 20);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 1);
+
+	RateLimitFileSystem fs(make_uniq<FailingReadFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "failed_read.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+
+	RateLimitScope scope;
+	scope.connection_limiter = CreateRateLimiter(/*bandwidth_p=*/10, /*burst_p=*/0, mock_clock);
+	handle->Cast<RateLimitFileHandle>().SetScope(scope);
+
+	string buffer(100, '\0');
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 10, 0), IOException);
+
+	// The bytes are given back to the filesystem and the connection
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE_FALSE(op_config->rate_limiter->TryAcquireImmediate(20).has_value());
+	REQUIRE_FALSE(op_config->rate_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE_FALSE(scope.connection_limiter->TryAcquireImmediate(10).has_value());
+	// The request was issued, so its request token stays charged
+	REQUIRE_FALSE(op_config->request_rate_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(op_config->request_rate_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot().bytes_admitted == 0);
+
+	handle->Close();
+}
@@ -0,0 +1,280 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/vector.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "rate_limit_stats.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_rate_limit_stats";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+// Takes 5ms of mock time for every positional read.
+class MockLatencyFileSystem : public LocalFileSystem {
+public:
+	explicit MockLatencyFileSystem(shared_ptr<MockClock> clock_p) : clock(std::move(clock_p)) {
+	}
+
+	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		clock->Advance(5ms);
+		LocalFileSystem::Read(handle, buffer, nr_bytes, location);
+	}
+
+private:
+	shared_ptr<MockClock> clock;
+};
+
+} // namespace
+
+TEST_CASE("Operation stats - wait histogram buckets", "[rate_limit_stats]") {
+	REQUIRE(OperationStats::GetWaitBucket(Duration::zero()) == 0);
+	REQUIRE(OperationStats::GetWaitBucket(500ns) == 0);
+	REQUIRE(OperationStats::GetWaitBucket(1us) == 1);
+	REQUIRE(OperationStats::GetWaitBucket(3us) == 2);
+	REQUIRE(OperationStats::GetWaitBucket(4us) == 3);
+	REQUIRE(OperationStats::GetWaitBucket(1ms) == 10);
+	// Very long waits land in the last bucket
+	REQUIRE(OperationStats::GetWaitBucket(std::chrono::hours(24)) == OperationStatsSnapshot::WAIT_HISTOGRAM_BUCKETS - 1);
+}
+
+TEST_CASE("Operation stats - counters are summed over threads", "[rate_limit_stats]") {
+	OperationStats stats;
+	constexpr idx_t THREAD_COUNT = 8;
+	constexpr idx_t OPS_PER_THREAD = 1000;
+
+	vector<thread> threads;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&]() {
+			for (idx_t op = 0; op < OPS_PER_THREAD; ++op) {
+				stats.RecordAdmitted(10);
+				stats.RecordThrottleWait(op % 2 == 0 ? Duration::zero() : Duration(2us));
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	auto snapshot = stats.GetSnapshot();
+	REQUIRE(snapshot.ops_admitted == THREAD_COUNT * OPS_PER_THREAD);
+	REQUIRE(snapshot.bytes_admitted == THREAD_COUNT * OPS_PER_THREAD * 10);
+	REQUIRE(snapshot.throttled_ops == THREAD_COUNT * OPS_PER_THREAD / 2);
+	REQUIRE(snapshot.throttle_wait_nanos == THREAD_COUNT * OPS_PER_THREAD / 2 * 2000);
+	REQUIRE(snapshot.wait_histogram[0] == THREAD_COUNT * OPS_PER_THREAD / 2);
+	REQUIRE(snapshot.wait_histogram[2] == THREAD_COUNT * OPS_PER_THREAD / 2);
+}
+
+TEST_CASE("Operation stats - reset keeps operations in flight", "[rate_limit_stats]") {
+	OperationStats stats;
+	stats.RecordAdmitted(100);
+	stats.RecordRateRejection();
+	stats.RecordBurstRejection();
+	{
+		OperationSlot slot(SemaphoreGuard(), stats);
+		REQUIRE(stats.GetSnapshot().in_flight == 1);
+
+		stats.Reset();
+		auto snapshot = stats.GetSnapshot();
+		REQUIRE(snapshot.ops_admitted == 0);
+		REQUIRE(snapshot.bytes_admitted == 0);
+		REQUIRE(snapshot.rate_rejections == 0);
+		REQUIRE(snapshot.burst_rejections == 0);
+		REQUIRE(snapshot.in_flight == 1);
+	}
+	REQUIRE(stats.GetSnapshot().in_flight == 0);
+}
+
+TEST_CASE("Operation stats - filesystem records admissions, rejections and waits", "[rate_limit_stats][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+
+	// 10 bytes/sec rate, 10 byte burst
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "stats.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	// The first two reads fit the tolerance window, the third waits for 10 bytes worth of emission intervals
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	// Larger than the burst
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 20, 0), IOException);
+
+	auto all_stats = config->GetAllStats();
+	REQUIRE(all_stats.size() == 1);
+	REQUIRE(all_stats[0]->filesystem_name == TEST_FS_NAME);
+
+	auto snapshot = all_stats[0]->Get(FileSystemOperation::READ).GetSnapshot();
+	REQUIRE(snapshot.ops_admitted == 3);
+	REQUIRE(snapshot.bytes_admitted == 30);
+	REQUIRE(snapshot.burst_rejections == 1);
+	REQUIRE(snapshot.rate_rejections == 0);
+	REQUIRE(snapshot.throttled_ops == 1);
+	REQUIRE(snapshot.throttle_wait_nanos == static_cast<uint64_t>(std::chrono::nanoseconds(1s).count()));
+	REQUIRE(snapshot.in_flight == 0);
+
+	// Stats survive re-wrapping, since they're keyed by filesystem name
+	RateLimitFileSystem rewrapped_fs(make_uniq<LocalFileSystem>(), config);
+	REQUIRE(config->GetAllStats().size() == 1);
+
+	config->ResetStats();
+	REQUIRE(all_stats[0]->Get(FileSystemOperation::READ).GetSnapshot().ops_admitted == 0);
+
+	handle->Close();
+}
+
+TEST_CASE("Operation stats - non-blocking rejections are counted", "[rate_limit_stats][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 10, RateLimitMode::NON_BLOCKING);
+	config->SetBurst(TEST_FS_NAME, FileSystemOperation::READ, 10);
+
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "stats.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	REQUIRE_THROWS_AS(fs.Read(*handle, buffer.data(), 10, 0), IOException);
+
+	auto snapshot = config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot();
+	REQUIRE(snapshot.ops_admitted == 2);
+	REQUIRE(snapshot.rate_rejections == 1);
+	REQUIRE(snapshot.throttled_ops == 0);
+	REQUIRE(snapshot.wait_histogram[0] == 2);
+
+	handle->Close();
+}
+
+TEST_CASE("Operation stats - traced calls record inner latency", "[rate_limit_stats][mock_clock]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetTracing(TEST_FS_NAME, FileSystemOperation::READ, 2);
+	config->SetMaxRequests(TEST_FS_NAME, FileSystemOperation::READ, 4);
+
+	RateLimitFileSystem fs(make_uniq<MockLatencyFileSystem>(mock_clock), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "trace.txt", string(100, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		fs.Read(*handle, buffer.data(), 10, idx * 10);
+	}
+
+	// Every other read is traced
+	auto snapshot = config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot();
+	REQUIRE(snapshot.traced_calls == 2);
+	REQUIRE(snapshot.inner_latency_nanos == static_cast<uint64_t>(std::chrono::nanoseconds(10ms).count()));
+	REQUIRE(snapshot.inner_latency_histogram[OperationStats::GetWaitBucket(5ms)] == 2);
+	// Every read took a concurrency slot, traced or not
+	uint64_t semaphore_waits = 0;
+	for (auto bucket : snapshot.semaphore_wait_histogram) {
+		semaphore_waits += bucket;
+	}
+	REQUIRE(semaphore_waits == 4);
+
+	config->SetTracing(TEST_FS_NAME, FileSystemOperation::READ, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	fs.Read(*handle, buffer.data(), 10, 0);
+	REQUIRE(config->GetOrCreateStats(TEST_FS_NAME)->Get(FileSystemOperation::READ).GetSnapshot().traced_calls == 2);
+
+	handle->Close();
+}
+
+TEST_CASE("Operation stats - request size buckets", "[rate_limit_stats]") {
+	REQUIRE(OperationStats::GetSizeBucket(0) == 0);
+	REQUIRE(OperationStats::GetSizeBucket(1) == 1);
+	REQUIRE(OperationStats::GetSizeBucket(2) == 2);
+	REQUIRE(OperationStats::GetSizeBucket(3) == 3);
+	REQUIRE(OperationStats::GetSizeBucket(4) == 3);
+	REQUIRE(OperationStats::GetSizeBucket(5) == 4);
+	// Power-of-two sizes are the upper bound of their bucket
+	REQUIRE(OperationStats::GetSizeBucketUpperBound(OperationStats::GetSizeBucket(1 << 20)) == 1 << 20);
+	REQUIRE(OperationStats::GetSizeBucketUpperBound(OperationStats::GetSizeBucket((1 << 20) + 1)) == 1 << 21);
+	REQUIRE(OperationStats::GetSizeBucket(NumericLimits<idx_t>::Maximum()) ==
+	        OperationStatsSnapshot::SIZE_HISTOGRAM_BUCKETS - 1);
+
+	OperationStats stats;
+	REQUIRE(OperationStats::GetRequestSizePercentile(stats.GetSnapshot(), 50) == 0);
+	for (idx_t idx = 0; idx < 9; ++idx) {
+		stats.RecordRequestSize(10);
+	}
+	stats.RecordRequestSize(100);
+	const auto snapshot = stats.GetSnapshot();
+	REQUIRE(OperationStats::GetRequestSizePercentile(snapshot, 50) == 16);
+	REQUIRE(OperationStats::GetRequestSizePercentile(snapshot, 90) == 16);
+	REQUIRE(OperationStats::GetRequestSizePercentile(snapshot, 91) == 128);
+	REQUIRE(OperationStats::GetRequestSizePercentile(snapshot, 100) == 128);
+}
+
+TEST_CASE("Operation stats - duration percentiles", "[rate_limit_stats]") {
+	OperationStatsSnapshot::WaitHistogram histogram {};
+	REQUIRE(OperationStats::GetDurationPercentile(histogram, 50) == Duration::zero());
+
+	for (idx_t idx = 0; idx < 98; ++idx) {
+		++histogram[OperationStats::GetWaitBucket(3ms)];
+	}
+	++histogram[OperationStats::GetWaitBucket(100ms)];
+	++histogram[OperationStats::GetWaitBucket(500ns)];
+	// Reported as the end of the bucket, 3ms falling into [2048us, 4096us)
+	REQUIRE(OperationStats::GetDurationPercentile(histogram, 1) == 1us);
+	REQUIRE(OperationStats::GetDurationPercentile(histogram, 50) == 4096us);
+	REQUIRE(OperationStats::GetDurationPercentile(histogram, 99) == 4096us);
+	REQUIRE(OperationStats::GetDurationPercentile(histogram, 100) == 131072us);
+}
+
+TEST_CASE("Operation stats - burst is recommended from request sizes", "[rate_limit_stats]") {
+	ScopedDirectory test_dir(TEST_DIR);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+	string temp_path = CreateTempFile(test_dir.GetPath(), "sizes.txt", string(1000, 'x'));
+	auto handle = fs.OpenFile(temp_path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(1000, '\0');
+	for (idx_t idx = 0; idx < 9; ++idx) {
+		fs.Read(*handle, buffer.data(), 10, idx * 10);
+	}
+	fs.Read(*handle, buffer.data(), 100, 900);
+
+	REQUIRE(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::READ, 90) == 16);
+	REQUIRE(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::WRITE, 90) == 0);
+	REQUIRE_THROWS_AS(config->AutoTuneBurst(TEST_FS_NAME, FileSystemOperation::WRITE, 90), InvalidInputException);
+	REQUIRE_THROWS_AS(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::STAT, 90), InvalidInputException);
+	REQUIRE_THROWS_AS(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::READ, 0), InvalidInputException);
+	REQUIRE_THROWS_AS(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::READ, 101), InvalidInputException);
+
+	REQUIRE(config->AutoTuneBurst(TEST_FS_NAME, FileSystemOperation::READ, 100) == 128);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ)->burst == 128);
+
+	// With a cost model, the burst is in its tokens
+	OperationCost cost;
+	cost.call_cost = 100;
+	cost.byte_cost = 1;
+	config->SetCost(TEST_FS_NAME, FileSystemOperation::READ, cost);
+	REQUIRE(config->RecommendBurst(TEST_FS_NAME, FileSystemOperation::READ, 90) == 116);
+
+	handle->Close();
+}
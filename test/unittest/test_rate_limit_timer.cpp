@@ -0,0 +1,138 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/vector.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_timer.hpp"
+#include "rate_limiter.hpp"
+
+#include <atomic>
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+TEST_CASE("Rate limit timer - runs tasks once their deadline is due", "[rate_limit_timer]") {
+	auto clock = CreateMockClock();
+	RateLimitTimer timer(clock);
+
+	vector<int> order;
+	timer.Schedule(clock->Now() + 20ms, [&]() { order.push_back(2); });
+	timer.Schedule(clock->Now() + 10ms, [&]() { order.push_back(1); });
+	timer.Schedule(clock->Now() + 20ms, [&]() { order.push_back(3); });
+	REQUIRE(timer.GetPendingCount() == 3);
+
+	REQUIRE(timer.RunDueTasks() == 0);
+
+	clock->Advance(10ms);
+	REQUIRE(timer.RunDueTasks() == 1);
+
+	// Tasks with the same deadline run in scheduling order
+	clock->Advance(10ms);
+	REQUIRE(timer.RunDueTasks() == 2);
+	REQUIRE(order == vector<int> {1, 2, 3});
+	REQUIRE(timer.GetPendingCount() == 0);
+}
+
+TEST_CASE("Rate limit timer - background thread runs due tasks", "[rate_limit_timer]") {
+	RateLimitTimer timer;
+	timer.Start();
+
+	std::atomic<bool> done {false};
+	timer.Schedule(timer.GetClock()->Now() + 1ms, [&]() { done = true; });
+
+	for (int i = 0; i < 1000 && !done; i++) {
+		std::this_thread::sleep_for(1ms);
+	}
+	REQUIRE(done);
+	timer.Stop();
+}
+
+TEST_CASE("Rate limit timer - can be started repeatedly and restarted", "[rate_limit_timer]") {
+	RateLimitTimer timer;
+	timer.Start();
+	timer.Start();
+	timer.Stop();
+
+	std::atomic<bool> done {false};
+	timer.Schedule(timer.GetClock()->Now() + 1ms, [&]() { done = true; });
+	timer.Start();
+	for (int i = 0; i < 1000 && !done; i++) {
+		std::this_thread::sleep_for(1ms);
+	}
+	REQUIRE(done);
+	timer.Stop();
+
+	// The default timer is the same running instance on every call
+	REQUIRE(&RateLimitTimer::GetDefault() == &RateLimitTimer::GetDefault());
+}
+
+TEST_CASE("Rate limit - AcquireAsync is admitted inline within burst", "[rate][async]") {
+	auto clock = CreateMockClock();
+	RateLimitTimer timer(clock);
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+
+	bool called = false;
+	limiter->AcquireAsync(
+	    100,
+	    [&](RateLimitResult result) {
+		    REQUIRE(result == RateLimitResult::Allowed);
+		    called = true;
+	    },
+	    &timer);
+	REQUIRE(called);
+	REQUIRE(timer.GetPendingCount() == 0);
+
+	// Requests larger than the burst are rejected inline as well
+	auto future = limiter->AcquireFuture(200, &timer);
+	REQUIRE(future.get() == RateLimitResult::InsufficientCapacity);
+}
+
+TEST_CASE("Rate limit - AcquireAsync waits on the timer instead of sleeping", "[rate][async]") {
+	auto clock = CreateMockClock();
+	RateLimitTimer timer(clock);
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+
+	// Exhaust the tolerance window
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+
+	TimePoint start_time = clock->Now();
+	bool called = false;
+	limiter->AcquireAsync(
+	    100, [&](RateLimitResult result) { called = result == RateLimitResult::Allowed; }, &timer);
+
+	// The caller returns right away, and the clock isn't advanced on its behalf
+	REQUIRE_FALSE(called);
+	REQUIRE(clock->Now() == start_time);
+	REQUIRE(timer.GetPendingCount() == 1);
+
+	REQUIRE(timer.RunDueTasks() == 0);
+	REQUIRE_FALSE(called);
+
+	// 100 bytes replenish after 1 second
+	clock->Advance(1s);
+	REQUIRE(timer.RunDueTasks() == 1);
+	REQUIRE(called);
+	REQUIRE(timer.GetPendingCount() == 0);
+}
+
+TEST_CASE("Rate limit - AcquireAsync reschedules when capacity is taken first", "[rate][async]") {
+	auto clock = CreateMockClock();
+	RateLimitTimer timer(clock);
+	auto limiter = CreateRateLimiter(/*bandwidth_p=*/100, /*burst_p=*/100, clock);
+
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+	REQUIRE(limiter->UntilNReady(100) == RateLimitResult::Allowed);
+
+	auto future = limiter->AcquireFuture(100, &timer);
+
+	// A synchronous caller takes the replenished capacity before the timer fires
+	clock->Advance(1s);
+	REQUIRE(limiter->TryAcquireImmediate(100) == std::nullopt);
+	REQUIRE(timer.RunDueTasks() == 1);
+	REQUIRE(timer.GetPendingCount() == 1);
+	REQUIRE(future.wait_for(0s) == std::future_status::timeout);
+
+	clock->Advance(1s);
+	REQUIRE(timer.RunDueTasks() == 1);
+	REQUIRE(future.get() == RateLimitResult::Allowed);
+}
@@ -0,0 +1,141 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "test_file_util.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_read_ahead";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+class ReadCountingFileSystem : public LocalFileSystem {
+public:
+	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		++read_count;
+		LocalFileSystem::Read(handle, buffer, nr_bytes, location);
+	}
+
+	idx_t read_count = 0;
+};
+
+} // namespace
+
+TEST_CASE("ReadAhead - sequential small reads are coalesced", "[read_ahead]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "sequential.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetReadAhead(TEST_FS_NAME, 4096, 0);
+	auto inner_fs = make_uniq<ReadCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+	for (idx_t location = 0; location < content.size(); location += 100) {
+		fs.Read(*handle, buffer.data(), 100, location);
+		REQUIRE(buffer == content.substr(location, 100));
+	}
+	// Fetches at 0, 4000 and 8000, the last one clamped to the end of the file
+	REQUIRE(counting_fs.read_count == 3);
+	handle->Close();
+}
+
+TEST_CASE("ReadAhead - random and large reads bypass the buffer", "[read_ahead]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "random.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetReadAhead(TEST_FS_NAME, 4096, 512);
+	auto inner_fs = make_uniq<ReadCountingFileSystem>();
+	auto &counting_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(5000, '\0');
+
+	// A footer read far from the previous read isn't worth fetching ahead for
+	fs.Read(*handle, buffer.data(), 100, 9000);
+	fs.Read(*handle, buffer.data(), 100, 5000);
+	REQUIRE(counting_fs.read_count == 2);
+
+	// Reads at least as large as the buffer are issued as they are
+	fs.Read(*handle, buffer.data(), 4096, 5100);
+	REQUIRE(counting_fs.read_count == 3);
+
+	// A small gap within the window still counts as sequential
+	fs.Read(*handle, buffer.data(), 100, 9500);
+	REQUIRE(counting_fs.read_count == 4);
+	fs.Read(*handle, buffer.data(), 100, 9700);
+	REQUIRE(buffer.substr(0, 100) == content.substr(9700, 100));
+	REQUIRE(counting_fs.read_count == 4);
+	handle->Close();
+}
+
+TEST_CASE("ReadAhead - coalesced fetches are charged once", "[read_ahead]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "charged.txt", content);
+
+	auto mock_clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(mock_clock);
+	config->SetRequestQuota(TEST_FS_NAME, FileSystemOperation::READ, 10);
+	config->SetReadAhead(TEST_FS_NAME, 4096, 0);
+	auto inner_fs = make_uniq<LocalFileSystem>();
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string buffer(100, '\0');
+	const auto start_time = mock_clock->Now();
+	for (idx_t location = 0; location < content.size(); location += 100) {
+		fs.Read(*handle, buffer.data(), 100, location);
+	}
+	// Three requests instead of a hundred; the first two fit the tolerance of the request quota
+	REQUIRE(mock_clock->Now() == start_time + std::chrono::milliseconds(100));
+	handle->Close();
+}
+
+TEST_CASE("ReadAhead - writes through the handle drop the buffer", "[read_ahead]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto content = CreateContent();
+	auto path = CreateTempFile(test_dir.GetPath(), "write.txt", content);
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetReadAhead(TEST_FS_NAME, 4096, 0);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE);
+	string buffer(100, '\0');
+	fs.Read(*handle, buffer.data(), 100, 0);
+
+	string update(100, 'Z');
+	fs.Write(*handle, update.data(), 100, 100);
+	fs.Read(*handle, buffer.data(), 100, 100);
+	REQUIRE(buffer == update);
+	handle->Close();
+}
+
+TEST_CASE("ReadAhead - configuration", "[read_ahead]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetReadAhead(TEST_FS_NAME, 1048576, 4096);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->read_ahead_buffer_size == 1048576);
+	REQUIRE(op_config->read_ahead_window == 4096);
+	// Read-ahead alone doesn't rate limit
+	REQUIRE(op_config->mode == RateLimitMode::NONE);
+	REQUIRE_FALSE(config->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::READ).rate_limiter);
+
+	config->SetReadAhead(TEST_FS_NAME, 0, 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ) == nullptr);
+}
@@ -0,0 +1,137 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limiter.hpp"
+#include "scoped_directory.hpp"
+#include "shared_memory_rate_limiter_state.hpp"
+
+#include <fstream>
+
+using namespace duckdb;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_shared_memory_rate_limiter_state";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+} // namespace
+
+TEST_CASE("Shared memory state - mappings of the same key share the TAT", "[shared_state]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	SharedMemoryRateLimiterState first(test_dir.GetPath(), "fs:local:read");
+	SharedMemoryRateLimiterState second(test_dir.GetPath(), "fs:local:read");
+	SharedMemoryRateLimiterState other(test_dir.GetPath(), "fs:local:write");
+	REQUIRE(first.GetPath() == second.GetPath());
+
+	// A new file is a full bucket
+	REQUIRE(first.GetTatNanos() == 0);
+	int64_t expected = 0;
+	while (!first.CompareExchangeTat(expected, 1000)) {
+	}
+	REQUIRE(second.GetTatNanos() == 1000);
+	expected = 1000;
+	while (!second.CompareExchangeTat(expected, 600)) {
+	}
+	REQUIRE(first.GetTatNanos() == 600);
+	REQUIRE(other.GetTatNanos() == 0);
+
+	// State outlives the mappings
+	SharedMemoryRateLimiterState reopened(test_dir.GetPath(), "fs:local:read");
+	REQUIRE(reopened.GetTatNanos() == 600);
+}
+
+TEST_CASE("Shared memory state - a TAT from before a reboot is reset", "[shared_state]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/%s", test_dir.GetPath(),
+	                                     SharedMemoryRateLimiterState::GetFileName("fs:local:read"));
+	// As left behind by a previous boot: far in the future of the restarted monotonic clock, with another boot time
+	int64_t stale[SharedMemoryRateLimiterState::FILE_SIZE / sizeof(int64_t)] = {};
+	stale[0] = NumericLimits<int64_t>::Maximum() / 2;
+	stale[1] = 1;
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char *>(stale), sizeof(stale));
+	}
+
+	SharedMemoryRateLimiterState state(test_dir.GetPath(), "fs:local:read");
+	REQUIRE(state.GetTatNanos() == 0);
+
+	// Later mappings on this boot keep the TAT
+	int64_t expected = 0;
+	while (!state.CompareExchangeTat(expected, 1000)) {
+	}
+	SharedMemoryRateLimiterState reopened(test_dir.GetPath(), "fs:local:read");
+	REQUIRE(reopened.GetTatNanos() == 1000);
+}
+
+TEST_CASE("Shared memory state - file names are sanitized and unique", "[shared_state]") {
+	const auto name = SharedMemoryRateLimiterState::GetFileName("fs:RateLimitFileSystem - S3FileSystem:read");
+	REQUIRE(name.find('/') == string::npos);
+	REQUIRE(name.find(' ') == string::npos);
+	REQUIRE(name.find(':') == string::npos);
+	REQUIRE(name.rfind("fs_RateLimitFileSystem_-_S3FileSystem_read-", 0) == 0);
+	// Keys which sanitize to the same prefix still get distinct files
+	REQUIRE(SharedMemoryRateLimiterState::GetFileName("a:b") != SharedMemoryRateLimiterState::GetFileName("a/b"));
+	REQUIRE(SharedMemoryRateLimiterState::GetFileName("a:b") == SharedMemoryRateLimiterState::GetFileName("a:b"));
+}
+
+TEST_CASE("Shared memory state - missing directory throws", "[shared_state]") {
+	REQUIRE_THROWS_AS(SharedMemoryRateLimiterState("/tmp/test_shared_memory_missing/nested", "key"), IOException);
+	REQUIRE_FALSE(CreateSharedMemoryRateLimiterState("", "key"));
+}
+
+TEST_CASE("Shared memory state - limiters sharing state share the quota", "[shared_state]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	auto clock = CreateMockClock();
+	// Two limiters standing in for two processes
+	Quota quota(/*bandwidth_p=*/100, /*burst_p=*/100);
+	auto first = RateLimiter::Direct(quota, clock, nullptr, 0,
+	                                 CreateSharedMemoryRateLimiterState(test_dir.GetPath(), "group:bucket"));
+	auto second = RateLimiter::Direct(quota, clock, nullptr, 0,
+	                                  CreateSharedMemoryRateLimiterState(test_dir.GetPath(), "group:bucket"));
+
+	REQUIRE_FALSE(first->TryAcquireImmediate(100).has_value());
+	REQUIRE_FALSE(second->TryAcquireImmediate(100).has_value());
+	REQUIRE(first->TryAcquireImmediate(100).has_value());
+	REQUIRE(second->TryAcquireImmediate(100).has_value());
+
+	clock->Advance(std::chrono::seconds(1));
+	REQUIRE_FALSE(second->TryAcquireImmediate(100).has_value());
+	REQUIRE(first->TryAcquireImmediate(100).has_value());
+}
+
+TEST_CASE("Shared memory state - config shares limits between instances", "[shared_state]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	auto clock = CreateMockClock();
+	auto first = make_shared_ptr<RateLimitConfig>();
+	auto second = make_shared_ptr<RateLimitConfig>();
+	for (auto &config : {first, second}) {
+		config->SetClock(clock);
+		config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 1, RateLimitMode::NON_BLOCKING);
+		// Ignored, since partitions would bypass the shared state
+		config->SetPartitions(TEST_FS_NAME, FileSystemOperation::STAT, 2);
+		config->SetSharedStateDirectory(test_dir.GetPath());
+		REQUIRE(config->GetSharedStateDirectory() == test_dir.GetPath());
+	}
+
+	// Without a burst, two calls pass back to back across both instances together
+	auto first_limiter = first->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT).rate_limiter;
+	auto second_limiter = second->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT).rate_limiter;
+	REQUIRE_FALSE(first_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE_FALSE(second_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(first_limiter->TryAcquireImmediate(1).has_value());
+	REQUIRE(first_limiter->GetPartitionCount() == 0);
+
+	// An unusable directory is rejected without changing the config
+	REQUIRE_THROWS_AS(first->SetSharedStateDirectory("/tmp/test_shared_memory_missing/nested"), IOException);
+	REQUIRE(first->GetSharedStateDirectory() == test_dir.GetPath());
+
+	first->SetSharedStateDirectory("");
+	first_limiter = first->GetRateLimitSnapshot(TEST_FS_NAME, FileSystemOperation::STAT).rate_limiter;
+	REQUIRE(first_limiter->GetPartitionCount() == 2);
+	REQUIRE_FALSE(first_limiter->TryAcquireImmediate(1).has_value());
+}
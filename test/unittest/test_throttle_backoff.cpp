@@ -0,0 +1,256 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "fake_filesystem.hpp"
+#include "mock_clock.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "throttle_backoff.hpp"
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - RateLimitFsFakeFileSystem";
+// Within the fake filesystem's directory, created by its constructor.
+constexpr const char *TEST_DIR = "/tmp/fake_rate_limit_fs/test_throttle_backoff";
+constexpr const char *THROTTLE_ERROR = "HTTP GET error (HTTP 503 SlowDown)";
+
+idx_t GetBandwidth(const SharedRateLimiter &limiter) {
+	return limiter->GetQuota().GetBandwidth();
+}
+
+// Streaming writes write half of their bytes, then fail as if the backend throttled the rest.
+class PartialThrottleFileSystem : public LocalFileSystem {
+public:
+	int64_t Write(FileHandle &handle, void *buffer, int64_t nr_bytes) override {
+		++streaming_writes;
+		LocalFileSystem::Write(handle, buffer, nr_bytes / 2);
+		throw IOException(THROTTLE_ERROR);
+	}
+
+	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override {
+		++removals;
+		LocalFileSystem::RemoveFile(filename, opener);
+		throw IOException(THROTTLE_ERROR);
+	}
+
+	idx_t streaming_writes = 0;
+	idx_t removals = 0;
+};
+
+} // namespace
+
+TEST_CASE("Throttle backoff - rejects invalid settings", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	REQUIRE_THROWS_AS(ThrottleBackoff(0, 1s, 3, clock), InvalidInputException);
+	REQUIRE_THROWS_AS(ThrottleBackoff(1.5, 1s, 3, clock), InvalidInputException);
+	REQUIRE_THROWS_AS(ThrottleBackoff(0.5, 0s, 3, clock), InvalidInputException);
+	REQUIRE_NOTHROW(ThrottleBackoff(1, 1s, 0, clock));
+}
+
+TEST_CASE("Throttle backoff - throttling halves the quota down to the minimum", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(1000, 0, clock);
+	ThrottleBackoff backoff(0.2, 1s, 0, clock);
+	backoff.Attach(limiter, 1000, 0);
+	REQUIRE(GetBandwidth(limiter) == 1000);
+
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 500);
+	// Requests admitted before the cut fail within the cooldown without cutting again
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 500);
+
+	clock->Advance(250ms);
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 250);
+	clock->Advance(250ms);
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 200);
+
+	// Errors which aren't throttling don't cut the quota
+	clock->Advance(250ms);
+	REQUIRE_FALSE(backoff.OnFailure("No files found that match the pattern"));
+	REQUIRE(GetBandwidth(limiter) == 200);
+
+	const auto stats = backoff.GetStats();
+	REQUIRE(stats.ratio == 0.2);
+	REQUIRE(stats.throttle_errors == 4);
+}
+
+TEST_CASE("Throttle backoff - quota recovers after intervals without throttling", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	auto limiter = CreateRateLimiter(1000, 0, clock);
+	ThrottleBackoff backoff(0.1, 1s, 0, clock);
+	backoff.Attach(limiter, 1000, 0);
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 500);
+
+	// Nothing is given back before a whole interval
+	clock->Advance(999ms);
+	backoff.OnSuccess();
+	REQUIRE(GetBandwidth(limiter) == 500);
+	clock->Advance(1ms);
+	backoff.OnSuccess();
+	REQUIRE(GetBandwidth(limiter) == 600);
+
+	// A throttling error restarts the interval
+	clock->Advance(900ms);
+	REQUIRE(backoff.OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 300);
+	clock->Advance(900ms);
+	backoff.OnSuccess();
+	REQUIRE(GetBandwidth(limiter) == 300);
+
+	// Several idle intervals are given back at once, up to the configured quota
+	clock->Advance(10s);
+	backoff.OnSuccess();
+	REQUIRE(GetBandwidth(limiter) == 1000);
+	REQUIRE(backoff.GetStats().ratio == 1);
+}
+
+TEST_CASE("Throttle backoff - retries stop after the maximum", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	ThrottleBackoff backoff(0.5, 100ms, 2, clock);
+	const auto start = clock->Now();
+	REQUIRE(backoff.WaitToRetry(0));
+	REQUIRE(backoff.WaitToRetry(1));
+	REQUIRE_FALSE(backoff.WaitToRetry(2));
+	// Delays are capped at the recovery interval
+	REQUIRE(clock->Now() - start <= 150ms);
+	REQUIRE(backoff.GetStats().retries == 2);
+}
+
+TEST_CASE("Throttle backoff - config restores the quota when replaced or disabled", "[throttle_backoff]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(CreateMockClock());
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 1000, RateLimitMode::BLOCKING);
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::READ, 0.5, 1s, 3);
+
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config != nullptr);
+	auto backoff = op_config->throttle_backoff;
+	REQUIRE(backoff);
+	auto limiter = op_config->rate_limiter;
+	REQUIRE(backoff->OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 500);
+
+	// Changing the quota keeps the backoff ratio
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::READ, 2000, RateLimitMode::BLOCKING);
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config->throttle_backoff == backoff);
+	REQUIRE(GetBandwidth(op_config->rate_limiter) == 1000);
+
+	// A replaced backoff starts from the full quota and no longer changes the limiter
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::READ, 0.5, 2s, 3);
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE(op_config->throttle_backoff != backoff);
+	limiter = op_config->rate_limiter;
+	REQUIRE(GetBandwidth(limiter) == 2000);
+	REQUIRE(backoff->OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 2000);
+
+	REQUIRE(op_config->throttle_backoff->OnFailure(THROTTLE_ERROR));
+	REQUIRE(GetBandwidth(limiter) == 1000);
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::READ, 0.5, 0s, 0);
+	op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::READ);
+	REQUIRE_FALSE(op_config->throttle_backoff);
+	REQUIRE(GetBandwidth(op_config->rate_limiter) == 2000);
+
+	// A backoff alone doesn't keep the config around
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::STAT, 0.5, 1s, 3);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) != nullptr);
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::STAT, 0.5, 0s, 3);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT) == nullptr);
+}
+
+TEST_CASE("Throttle backoff - filesystem retries throttled calls", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(clock);
+	config->SetQuota(TEST_FS_NAME, FileSystemOperation::STAT, 100, RateLimitMode::BLOCKING);
+	config->SetThrottleBackoff(TEST_FS_NAME, FileSystemOperation::STAT, 0.25, 10s, 3);
+
+	auto inner_fs = make_uniq<RateLimitFsFakeFileSystem>(clock);
+	auto &fake_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/throttle.txt", test_dir.GetPath());
+	{
+		auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE);
+		handle->Close();
+	}
+
+	FakeFsFaults faults;
+	faults.throttle_error_rate = 1;
+	fake_fs.SetFaults(FileSystemOperation::STAT, faults);
+	REQUIRE_THROWS_AS(fs.FileExists(path), IOException);
+	// The first attempt and every retry hit the backend
+	REQUIRE(fake_fs.GetInjectedErrorCount() == 4);
+
+	auto backoff = config->GetConfig(TEST_FS_NAME, FileSystemOperation::STAT)->throttle_backoff;
+	auto stats = backoff->GetStats();
+	REQUIRE(stats.retries == 3);
+	REQUIRE(stats.throttle_errors == 4);
+	REQUIRE(stats.ratio < 1);
+
+	// Calls succeed again once the backend recovers
+	faults.throttle_error_rate = 0;
+	fake_fs.SetFaults(FileSystemOperation::STAT, faults);
+	REQUIRE(fs.FileExists(path));
+	REQUIRE(backoff->GetStats().retries == 3);
+}
+
+TEST_CASE("Throttle backoff - calls through the file pointer aren't retried", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(clock);
+	config->SetThrottleBackoff("RateLimitFileSystem - LocalFileSystem", FileSystemOperation::WRITE, 0.5, 1s, 3);
+
+	auto inner_fs = make_uniq<PartialThrottleFileSystem>();
+	auto &throttling_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+	ScopedDirectory test_dir("/tmp/test_throttle_backoff_partial");
+	const auto path = StringUtil::Format("%s/partial.txt", test_dir.GetPath());
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE);
+
+	string data = "0123456789";
+	REQUIRE_THROWS_AS(fs.Write(*handle, data.data(), static_cast<int64_t>(data.size())), IOException);
+	// A retry would append the first half again
+	REQUIRE(throttling_fs.streaming_writes == 1);
+	REQUIRE(fs.GetFileSize(*handle) == 5);
+
+	auto stats = config->GetConfig("RateLimitFileSystem - LocalFileSystem", FileSystemOperation::WRITE)
+	                 ->throttle_backoff->GetStats();
+	REQUIRE(stats.throttle_errors == 1);
+	REQUIRE(stats.retries == 0);
+	handle->Close();
+}
+
+TEST_CASE("Throttle backoff - deletes which went through aren't retried", "[throttle_backoff]") {
+	auto clock = CreateMockClock();
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetClock(clock);
+	config->SetThrottleBackoff("RateLimitFileSystem - LocalFileSystem", FileSystemOperation::DELETE, 0.5, 1s, 3);
+
+	auto inner_fs = make_uniq<PartialThrottleFileSystem>();
+	auto &throttling_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+	ScopedDirectory test_dir("/tmp/test_throttle_backoff_delete");
+	const auto path = StringUtil::Format("%s/deleted.txt", test_dir.GetPath());
+	fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE)->Close();
+
+	// A retry would fail as not found, hiding the throttling error
+	REQUIRE_THROWS_AS(fs.RemoveFile(path), IOException);
+	REQUIRE(throttling_fs.removals == 1);
+	REQUIRE_FALSE(fs.FileExists(path));
+
+	auto stats = config->GetConfig("RateLimitFileSystem - LocalFileSystem", FileSystemOperation::DELETE)
+	                 ->throttle_backoff->GetStats();
+	REQUIRE(stats.retries == 0);
+}
@@ -0,0 +1,134 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "worker_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Waits until the condition holds, for at most 10 seconds so a broken pool fails the test instead of hanging it.
+template <class CONDITION>
+bool WaitFor(CONDITION &&condition) {
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+} // namespace
+
+TEST_CASE("WorkerPool - runs copies on the caller and the workers at once", "[worker_pool]") {
+	WorkerPool pool(2);
+	REQUIRE(pool.GetStartedCount() == 0);
+
+	std::atomic<idx_t> running {0};
+	std::mutex ids_lock;
+	std::set<std::thread::id> ids;
+	// Catch assertions aren't thread-safe, so the workers only record whether all three runs overlapped.
+	std::atomic<bool> overlapped {true};
+	auto task = [&]() {
+		{
+			std::lock_guard<std::mutex> guard(ids_lock);
+			ids.insert(std::this_thread::get_id());
+		}
+		++running;
+		if (!WaitFor([&]() { return running.load() >= 3; })) {
+			overlapped = false;
+		}
+	};
+	pool.RunConcurrently(3, task);
+	REQUIRE(overlapped);
+	REQUIRE(ids.size() == 3);
+	REQUIRE(ids.count(std::this_thread::get_id()) == 1);
+	REQUIRE(pool.GetStartedCount() == 2);
+
+	// Later calls reuse the workers
+	running = 0;
+	ids.clear();
+	pool.RunConcurrently(3, task);
+	REQUIRE(overlapped);
+	REQUIRE(ids.size() == 3);
+	REQUIRE(pool.GetStartedCount() == 2);
+}
+
+TEST_CASE("WorkerPool - the caller runs alone without workers", "[worker_pool]") {
+	WorkerPool pool(0);
+	std::atomic<idx_t> runs {0};
+	pool.RunConcurrently(4, [&]() { ++runs; });
+	REQUIRE(runs == 1);
+	REQUIRE(pool.GetStartedCount() == 0);
+}
+
+TEST_CASE("WorkerPool - the caller doesn't wait for busy workers", "[worker_pool]") {
+	WorkerPool pool(1);
+	std::atomic<idx_t> blocked_running {0};
+	std::atomic<bool> released {false};
+	std::thread blocker([&]() {
+		pool.RunConcurrently(2, [&]() {
+			++blocked_running;
+			WaitFor([&]() { return released.load(); });
+		});
+	});
+	REQUIRE(WaitFor([&]() { return blocked_running.load() == 2; }));
+
+	// The only worker is busy, so the copies offered are dropped once the caller's own run returns
+	std::atomic<idx_t> runs {0};
+	pool.RunConcurrently(3, [&]() { ++runs; });
+	REQUIRE(runs == 1);
+
+	released = true;
+	blocker.join();
+	REQUIRE(pool.GetStartedCount() == 1);
+}
+
+TEST_CASE("WorkerPool - an exception of a worker is thrown to the caller", "[worker_pool]") {
+	WorkerPool pool(1);
+	const auto caller = std::this_thread::get_id();
+	std::atomic<bool> worker_started {false};
+	auto task = [&]() {
+		if (std::this_thread::get_id() == caller) {
+			// Keeps the copy from being dropped before the worker picks it up.
+			WaitFor([&]() { return worker_started.load(); });
+			return;
+		}
+		worker_started = true;
+		throw IOException("worker failed");
+	};
+	REQUIRE_THROWS_AS(pool.RunConcurrently(2, task), IOException);
+	REQUIRE(worker_started);
+
+	// The pool keeps working after a failed task
+	std::atomic<idx_t> runs {0};
+	pool.RunConcurrently(1, [&]() { ++runs; });
+	REQUIRE(runs == 1);
+}
+
+TEST_CASE("WorkerPool - submitted tasks run on a worker", "[worker_pool]") {
+	WorkerPool pool(1);
+	std::atomic<bool> ran {false};
+	std::atomic<bool> on_caller {false};
+	const auto caller = std::this_thread::get_id();
+	REQUIRE(pool.Submit([&]() {
+		on_caller = std::this_thread::get_id() == caller;
+		ran = true;
+	}));
+	REQUIRE(WaitFor([&]() { return ran.load(); }));
+	REQUIRE(!on_caller);
+	REQUIRE(pool.GetStartedCount() == 1);
+
+	// Without a worker the task is handed back
+	WorkerPool empty(0);
+	REQUIRE(!empty.Submit([]() {}));
+}
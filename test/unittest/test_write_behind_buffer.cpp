@@ -0,0 +1,241 @@
+#include "catch/catch.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "rate_limit_config.hpp"
+#include "rate_limit_file_system.hpp"
+#include "scoped_directory.hpp"
+#include "write_behind_buffer.hpp"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace duckdb;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char *TEST_DIR = "/tmp/test_write_behind_buffer";
+constexpr const char *TEST_FS_NAME = "RateLimitFileSystem - LocalFileSystem";
+
+// Blocks flushes until released, and signals once the first one has started.
+struct FlushGate {
+	std::atomic<bool> started {false};
+	std::atomic<bool> released {false};
+
+	void Pass() {
+		started = true;
+		while (!released) {
+			std::this_thread::sleep_for(1ms);
+		}
+	}
+
+	void WaitStarted() {
+		for (int i = 0; i < 1000 && !started; i++) {
+			std::this_thread::sleep_for(1ms);
+		}
+		REQUIRE(started);
+	}
+};
+
+class GatedWriteFileSystem : public LocalFileSystem {
+public:
+	void Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override {
+		gate.Pass();
+		++write_count;
+		LocalFileSystem::Write(handle, buffer, nr_bytes, location);
+	}
+
+	FlushGate gate;
+	std::atomic<idx_t> write_count {0};
+};
+
+string ReadFile(const string &path) {
+	LocalFileSystem fs;
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+	string content(static_cast<size_t>(fs.GetFileSize(*handle)), '\0');
+	fs.Read(*handle, content.data(), static_cast<int64_t>(content.size()), 0);
+	return content;
+}
+
+} // namespace
+
+TEST_CASE("WriteBehindBuffer - adjacent writes are coalesced", "[write_behind]") {
+	FlushGate gate;
+	vector<std::pair<idx_t, idx_t>> flushes;
+	WriteBehindBuffer buffer(1024, [&](const_data_ptr_t data, idx_t size, optional_idx location) {
+		gate.Pass();
+		flushes.emplace_back(location.GetIndex(), size);
+	});
+
+	string data(10, 'a');
+	auto bytes = reinterpret_cast<const_data_ptr_t>(data.data());
+	buffer.Write(bytes, 10, 0);
+	gate.WaitStarted();
+	// The write being flushed isn't extended, the ones queued behind it are.
+	buffer.Write(bytes, 10, 10);
+	buffer.Write(bytes, 10, 20);
+	// Not adjacent, so queued on its own
+	buffer.Write(bytes, 10, 100);
+	REQUIRE(buffer.GetBufferedBytes() == 40);
+
+	gate.released = true;
+	buffer.Drain();
+	REQUIRE(buffer.GetBufferedBytes() == 0);
+	REQUIRE(flushes == vector<std::pair<idx_t, idx_t>> {{0, 10}, {10, 20}, {100, 10}});
+}
+
+TEST_CASE("WriteBehindBuffer - writes wait while the buffer is full", "[write_behind]") {
+	FlushGate gate;
+	WriteBehindBuffer buffer(10, [&](const_data_ptr_t data, idx_t size, optional_idx location) { gate.Pass(); });
+
+	string data(10, 'a');
+	auto bytes = reinterpret_cast<const_data_ptr_t>(data.data());
+	buffer.Write(bytes, 10, optional_idx());
+	gate.WaitStarted();
+
+	std::atomic<bool> written {false};
+	std::thread writer([&]() {
+		buffer.Write(bytes, 5, optional_idx());
+		written = true;
+	});
+	std::this_thread::sleep_for(20ms);
+	REQUIRE_FALSE(written);
+
+	gate.released = true;
+	writer.join();
+	REQUIRE(written);
+	buffer.Drain();
+}
+
+TEST_CASE("WriteBehindBuffer - a failed flush is thrown by the next call", "[write_behind]") {
+	FlushGate gate;
+	std::atomic<idx_t> flush_count {0};
+	WriteBehindBuffer buffer(1024, [&](const_data_ptr_t data, idx_t size, optional_idx location) {
+		gate.Pass();
+		++flush_count;
+		if (location.GetIndex() == 0) {
+			throw IOException("flush failed");
+		}
+	});
+
+	string data(10, 'a');
+	auto bytes = reinterpret_cast<const_data_ptr_t>(data.data());
+	buffer.Write(bytes, 10, 0);
+	gate.WaitStarted();
+	buffer.Write(bytes, 10, 100);
+
+	gate.released = true;
+	REQUIRE_THROWS_AS(buffer.Drain(), IOException);
+	// The write queued behind the failed one was dropped, and the error is only thrown once.
+	REQUIRE(flush_count == 1);
+	REQUIRE(buffer.GetBufferedBytes() == 0);
+	buffer.Drain();
+}
+
+TEST_CASE("WriteBehindBuffer - buffers share the flushers of a pool", "[write_behind]") {
+	WorkerPool flushers(1);
+	std::atomic<idx_t> flushed {0};
+	auto flush = [&](const_data_ptr_t data, idx_t size, optional_idx location) { flushed += size; };
+	vector<unique_ptr<WriteBehindBuffer>> buffers;
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		buffers.push_back(make_uniq<WriteBehindBuffer>(1024, flush, &flushers));
+	}
+	// Idle buffers don't take a worker
+	REQUIRE(flushers.GetStartedCount() == 0);
+
+	string data(10, 'a');
+	for (auto &buffer : buffers) {
+		buffer->Write(reinterpret_cast<const_data_ptr_t>(data.data()), 10, 0);
+	}
+	for (auto &buffer : buffers) {
+		buffer->Drain();
+	}
+	REQUIRE(flushed == 100);
+	REQUIRE(flushers.GetStartedCount() == 1);
+}
+
+TEST_CASE("WriteBehindBuffer - without a flusher, writes are issued right away", "[write_behind]") {
+	WorkerPool flushers(0);
+	idx_t flush_count = 0;
+	WriteBehindBuffer buffer(
+	    1024,
+	    [&](const_data_ptr_t data, idx_t size, optional_idx location) {
+		    ++flush_count;
+		    if (location.GetIndex() == 100) {
+			    throw IOException("flush failed");
+		    }
+	    },
+	    &flushers);
+
+	string data(10, 'a');
+	auto bytes = reinterpret_cast<const_data_ptr_t>(data.data());
+	buffer.Write(bytes, 10, 0);
+	REQUIRE(flush_count == 1);
+	REQUIRE(buffer.GetBufferedBytes() == 0);
+	// A failure is thrown by the write which issued it
+	REQUIRE_THROWS_AS(buffer.Write(bytes, 10, 100), IOException);
+	buffer.Drain();
+}
+
+TEST_CASE("WriteBehind - writes return before the inner filesystem is done", "[write_behind]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/write_behind.txt", test_dir.GetPath());
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetWriteBehind(TEST_FS_NAME, 4096);
+	auto inner_fs = make_uniq<GatedWriteFileSystem>();
+	auto &gated_fs = *inner_fs;
+	RateLimitFileSystem fs(std::move(inner_fs), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	string expected;
+	for (idx_t idx = 0; idx < 100; ++idx) {
+		string chunk(10, static_cast<char>('a' + idx % 26));
+		fs.Write(*handle, chunk.data(), 10, idx * 10);
+		expected += chunk;
+	}
+	// Every write was accepted while the inner filesystem still held the first one back.
+	REQUIRE(gated_fs.write_count == 0);
+
+	gated_fs.gate.released = true;
+	fs.FileSync(*handle);
+	// The first write may have been taken before the others were queued, those behind it are issued as one.
+	REQUIRE(gated_fs.write_count <= 2);
+	REQUIRE(ReadFile(path) == expected);
+	handle->Close();
+}
+
+TEST_CASE("WriteBehind - close issues the queued writes", "[write_behind]") {
+	ScopedDirectory test_dir(TEST_DIR);
+	const auto path = StringUtil::Format("%s/close.txt", test_dir.GetPath());
+
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetWriteBehind(TEST_FS_NAME, 4096);
+	RateLimitFileSystem fs(make_uniq<LocalFileSystem>(), config);
+
+	auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	string content(1000, 'x');
+	REQUIRE(fs.Write(*handle, content.data(), 500) == 500);
+	REQUIRE(fs.Write(*handle, content.data() + 500, 500) == 500);
+	// Flushed before the file pointer is reported
+	REQUIRE(fs.SeekPosition(*handle) == 1000);
+	handle->Close();
+	REQUIRE(ReadFile(path) == content);
+}
+
+TEST_CASE("WriteBehind - configuration", "[write_behind]") {
+	auto config = make_shared_ptr<RateLimitConfig>();
+	config->SetWriteBehind(TEST_FS_NAME, 4096);
+	auto op_config = config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE);
+	REQUIRE(op_config != nullptr);
+	REQUIRE(op_config->write_behind_buffer_size == 4096);
+
+	// A zero size writes through, and drops a config with nothing else set
+	config->SetWriteBehind(TEST_FS_NAME, 0);
+	REQUIRE(config->GetConfig(TEST_FS_NAME, FileSystemOperation::WRITE) == nullptr);
+}